@@ -89,6 +89,14 @@ void Cell::highlightActive()
     this->rec.setFillColor(BABY_BLUE);
 }
 
+/**
+ * (ONLY FOR PLAYABLE CELLS) Highlight with GREEN the source or destination of the engine's hint
+ */
+void Cell::highlightHint()
+{
+    this->rec.setFillColor(HINT_GREEN);
+}
+
 /**
  * Restore the original color
  */
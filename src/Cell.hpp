@@ -26,6 +26,7 @@ class Cell final : public sf::Drawable
     void setEvenRow(bool val);
     bool getIsEvenRow() const;
     void highlightActive();
+    void highlightHint();
     void resetColor();
 
   private:
@@ -33,6 +34,7 @@ class Cell final : public sf::Drawable
     sf::RectangleShape rec;
     inline static const sf::Color DARK_BROWN{82, 55, 27};
     inline static const sf::Color BABY_BLUE{98, 174, 239};
+    inline static const sf::Color HINT_GREEN{92, 160, 72};
     bool isEvenRow = false;
     sf::Vector2f cell_pos;
     sf::Text sfText;
@@ -7,6 +7,8 @@
 #include "Cell.hpp"
 #include "CircularBuffer.hpp"
 #include "Player.hpp"
+#include "engine/AsyncSearch.hpp"
+#include "engine/Position.hpp"
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Window/Mouse.hpp>
@@ -31,6 +33,16 @@ using PlayerPtr = std::unique_ptr<chk::Player>;
 
 constexpr uint16_t NUM_ROWS{8};
 constexpr uint16_t NUM_COLS{8};
+// default thinking time of the hint engine
+constexpr int HINT_BUDGET_MS{2000};
+// most candidate moves the hint panel can rank
+constexpr int HINT_MAX_LINES{8};
+// size of the hint engine's transposition table
+constexpr size_t HINT_HASH_MB{32};
+// hint engine's table between sessions: loaded with the first hint, saved on exit (in the working directory)
+constexpr auto HINT_HASH_FILE = "hint.hash";
+// where the hint panel's "Dump JSON" button writes search statistics
+constexpr auto SEARCH_STATS_FILE = "search_stats.json";
 
 /**
  * Abstract game manager (Base Class)
@@ -39,7 +51,7 @@ class GameManager
 {
 
   public:
-    virtual ~GameManager() = default;
+    virtual ~GameManager();
     virtual void createAllPieces() = 0;
     virtual void handleEvents(chk::CircularBuffer<int32_t> &buffer) = 0;
     virtual void drawBoard() = 0;
@@ -60,6 +72,18 @@ class GameManager
     bool gameOver = false;
     // used for atomic updates
     std::mutex my_mutex;
+    // background search for the hint key (created on first use)
+    std::unique_ptr<chk::engine::AsyncSearch> hintSearch = nullptr;
+    // hint engine's table: shared by all ranked lines, and kept between hints
+    std::unique_ptr<chk::engine::TranspositionTable> hintTable = nullptr;
+    // position the current hint is for (nullopt: no hint shown)
+    std::optional<chk::engine::Position> hintPos{};
+    // cells currently painted by the hint {source, destination}
+    std::vector<int> hintCells{};
+    // hint thinking time, adjustable from the hint panel
+    int hintBudgetMs = chk::HINT_BUDGET_MS;
+    // number of best moves the hint panel ranks (multi-PV), adjustable from the panel
+    int hintLines = 1;
 
     [[nodiscard]] bool boardContainsCell(const int cell_idx) const;
     [[nodiscard]] bool awayFromEdge(const int cell_idx) const;
@@ -90,6 +114,14 @@ class GameManager
     [[nodiscard]] const std::vector<chk::Block> &getBlockList() const;
     [[nodiscard]] bool isHunterActive() const;
     [[nodiscard]] bool isGameOver() const;
+    [[nodiscard]] chk::engine::Position toEnginePosition(chk::PlayerType sideToMove) const;
+    void playEngineMove(chk::PlayerType side, const chk::engine::Position &pos, const chk::engine::Move &move);
+    void requestHint(chk::PlayerType sideToMove);
+    void drawHint(chk::PlayerType sideToMove);
+    void drawSearchStats(const chk::engine::Position &pos, const chk::engine::SearchResult &result);
+    void clearHint();
+    [[nodiscard]] virtual std::optional<chk::engine::SearchResult> getHintResult(
+        const chk::engine::Position &pos) const;
     void setSourceCell(const int src_cell);
     void doCleanup();
     void identifyTargets(const chk::PlayerPtr &hunter, const chk::Block &singleCell = nullptr);
@@ -9,6 +9,10 @@ Piece::Piece(const sf::CircleShape &circle, const PieceType pType, const int32_t
     this->setPosition(circle.getPosition());
 
     sf::Texture localTxr;
+    if (!Piece::texturesEnabled)
+    {
+        return;
+    }
     if (pieceType == PieceType::Red)
     {
         if (localTxr.loadFromFile(chk::getResourcePath(RED_NORMAL)))
@@ -51,6 +55,10 @@ const PieceType Piece::getPieceType() const
 void Piece::activateKing()
 {
     this->isKing = true;
+    if (!Piece::texturesEnabled)
+    {
+        return;
+    }
     if (pieceType == PieceType::Red)
     {
         if (this->texture.loadFromFile(chk::getResourcePath(RED_KING)))
@@ -67,6 +75,15 @@ void Piece::activateKing()
     }
 }
 
+/**
+ * Load (or skip) piece images for pieces created from now on. Headless clients (no display) must disable them
+ * @param enabled FALSE to draw nothing but plain circles
+ */
+void Piece::setTexturesEnabled(const bool enabled)
+{
+    Piece::texturesEnabled = enabled;
+}
+
 /**
  * Determines whether this piece is King
  * @return TRUE or FALSE
@@ -152,6 +169,21 @@ void Piece::updateAnimation(float deltaTime)
     this->myCircle.setPosition(currentPos);
 }
 
+/**
+ * Jump to the end of the current slide, so the next move is validated from where the piece really stands
+ * (e.g. the next jump of a chain played within one frame)
+ */
+void Piece::finishAnimation()
+{
+    if (this->animationProgress >= 1.0f)
+    {
+        return;
+    }
+    this->animationProgress = 1.0f;
+    this->setPosition(this->targetPosition);
+    this->myCircle.setPosition(this->targetPosition);
+}
+
 /**
  * Custom equality operator, compares ID of the pieces
  * @param other The other Piece
@@ -169,6 +201,7 @@ bool Piece::operator==(const Piece &other) const
  */
 bool Piece::moveSimple(const sf::Vector2f &destPos)
 {
+    this->finishAnimation();
     const float deltaX = destPos.x - this->getPosition().x;
     const float deltaY = destPos.y - this->getPosition().y;
 
@@ -205,6 +238,7 @@ bool Piece::moveSimple(const sf::Vector2f &destPos)
  */
 bool Piece::moveCapture(const sf::Vector2f &destPos)
 {
+    this->finishAnimation();
     const float deltaX = destPos.x - this->getPosition().x;
     const float deltaY = destPos.y - this->getPosition().y;
 
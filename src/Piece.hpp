@@ -43,9 +43,12 @@ class Piece final : public sf::Drawable, public sf::Transformable
     void removeOutline();
     int32_t getId() const;
     void updateAnimation(float deltaTime);
+    void finishAnimation();
+    static void setTexturesEnabled(bool enabled);
     bool operator==(const Piece &other) const;
 
   private:
+    inline static bool texturesEnabled = true; // off when running without a display (textures need one)
     sf::Texture texture;
     const int32_t pid; // random positive ID assigned at Launch
     const PieceType pieceType;
@@ -3,7 +3,12 @@
 namespace chk
 {
 
-chk::WsClient::WsClient()
+/**
+ * Custom constructor
+ * @param headless TRUE for a client without window (bot mode): no connect window or popups, and no public
+ * server list; the address comes from connectTo()
+ */
+chk::WsClient::WsClient(const bool headless) : headless(headless)
 {
     ix::initNetSystem();
     // Our websocket object
@@ -22,7 +27,10 @@ chk::WsClient::WsClient()
 #endif // _WIN32
     this->webSocketPtr->setTLSOptions(tlsOptions);
     // prefetch for public server list
-    this->asyncFetchPublicServers();
+    if (!this->headless)
+    {
+        this->asyncFetchPublicServers();
+    }
 }
 
 /**
@@ -193,6 +201,30 @@ void WsClient::resetAllStates()
     this->deathNote.clear();
 }
 
+/**
+ * Connect to the given server without the connection window, as if its address was typed and confirmed
+ * @param address server URL; "ws://" is assumed when it has no scheme
+ */
+void WsClient::connectTo(std::string_view address)
+{
+    const bool hasScheme = address.find("://") != std::string_view::npos;
+    this->final_address = (hasScheme ? "" : "ws://") + std::string{address};
+    this->connClicked = true;
+}
+
+/**
+ * Headless replacement for the error and winner popups: log the reason, then close the connection
+ */
+void WsClient::endHeadlessMatch()
+{
+    {
+        std::scoped_lock lg{this->mut};
+        spdlog::info("match over: {}", this->deathNote);
+    }
+    this->webSocketPtr->stop(); // before the reset: stopping reports a close, which would mark us dead again
+    this->resetAllStates();
+}
+
 /**
  * Run main loop of showing connection window, tryConnect, and handle exchanges
  */
@@ -201,7 +233,9 @@ void WsClient::runMainLoop()
     // clang-format off
     if (!isConnected) {
         if (!connClicked) {
-            this->showConnectWindow();
+            if (!this->headless) {
+                this->showConnectWindow();
+            }
         } else {
             this->tryConnect(final_address);
         }     
@@ -217,9 +251,9 @@ void WsClient::runMainLoop()
         if (this->_onDeathCallback != nullptr) {
             _onDeathCallback(deathNote);
         }
-        this->showErrorPopup();
+        this->headless ? this->endHeadlessMatch() : this->showErrorPopup();
     } else if (this->haveWinner) {
-        this->showWinnerPopup();
+        this->headless ? this->endHeadlessMatch() : this->showWinnerPopup();
     }
     // clang-format on
 }
@@ -231,7 +265,7 @@ void WsClient::runMainLoop()
 void WsClient::tryConnect(std::string_view address)
 {
     this->webSocketPtr->setUrl(address.data());
-    if (!this->isConnected)
+    if (!this->isConnected && !this->headless)
     {
         ImGui::SetNextWindowSize(ImVec2{400.0f, 100.0f});
         ImGui::Begin("Loading", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
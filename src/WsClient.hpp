@@ -39,7 +39,7 @@ constexpr auto cloudfront = "https://d1txhef4jwuosv.cloudfront.net/ws_server_loc
 class WsClient final
 {
   public:
-    WsClient();
+    explicit WsClient(bool headless = false);
     WsClient(const WsClient &) = delete;
     WsClient &operator=(const WsClient &) = delete;
     void runMainLoop();
@@ -50,8 +50,10 @@ class WsClient final
     void setOnCapturePieceCallback(const onCaptureCallback &callback);
     void setOnWinLoseCallback(const onWinLoseCallback &callback);
     bool replyServer(const chk::payload::BasePayload &payload) const;
+    void connectTo(std::string_view address);
 
   private:
+    const bool headless;                            // no ImGui at all: connect via connectTo(), log errors
     std::string final_address;                      // IP or URL of private server (input by User)
     std::atomic_bool isDead{false};                 // if connection closed
     std::atomic_bool haveWinner{false};             // whether server returned Winner or Loser
@@ -82,6 +84,7 @@ class WsClient final
     void asyncFetchPublicServers();
     void parseServerList(const cpr::Response &response);
     void resetAllStates();
+    void endHeadlessMatch();
 };
 
 } // namespace chk
@@ -0,0 +1,131 @@
+#include "AsyncMcts.hpp"
+
+namespace chk::engine
+{
+
+/**
+ * Custom constructor
+ * @param config MCTS behaviour (tree reuse should stay on: it is what pondering feeds)
+ */
+AsyncMcts::AsyncMcts(const MctsConfig &config) : mcts(config)
+{
+    this->mcts.setOnProgress([this](const MctsResult &result) {
+        std::scoped_lock lock{this->mutex};
+        if (this->cancelled)
+        {
+            this->mcts.stop(); // stop() may have landed just before this search began
+            return;
+        }
+        this->latest = result;
+    });
+}
+
+AsyncMcts::~AsyncMcts()
+{
+    this->stop();
+}
+
+/**
+ * Search `pos` in the background (replaces any running search or pondering). Returns immediately.
+ * `maxNodes` counts playouts
+ * @param pos position to analyse
+ * @param limits when to stop
+ */
+void AsyncMcts::start(const Position &pos, const SearchLimits &limits)
+{
+    this->launch(pos, limits, false);
+}
+
+/**
+ * Grow the tree on the opponent's time, until the next `start` or `stop`. Nothing is published
+ * meanwhile: `getLatest` stays empty and `isSearching` FALSE
+ * @param opponentToMove position after the move just played
+ */
+void AsyncMcts::ponder(const Position &opponentToMove)
+{
+    this->launch(opponentToMove, SearchLimits{}, true);
+}
+
+/**
+ * Abort the background search and wait for its thread. The tree is kept
+ */
+void AsyncMcts::stop()
+{
+    {
+        std::scoped_lock lock{this->mutex};
+        this->cancelled = true;
+    }
+    this->mcts.stop();
+    if (this->worker.joinable())
+    {
+        this->worker.join();
+    }
+}
+
+/**
+ * Latest verdict, if the search is (or was) working on `pos` (never while pondering)
+ * @param pos the position caller is interested in
+ */
+std::optional<SearchResult> AsyncMcts::getLatest(const Position &pos) const
+{
+    std::scoped_lock lock{this->mutex};
+    if (this->pondering || this->root != pos || !this->latest.has_value())
+    {
+        return std::nullopt;
+    }
+    return toSearchResult(this->latest.value());
+}
+
+/**
+ * Whether the background thread is still thinking about a position it was asked to `start` on
+ */
+bool AsyncMcts::isSearching() const
+{
+    std::scoped_lock lock{this->mutex};
+    return !this->finished && !this->pondering;
+}
+
+/**
+ * Whether the tree is being grown on the opponent's time
+ */
+bool AsyncMcts::isPondering() const
+{
+    std::scoped_lock lock{this->mutex};
+    return !this->finished && this->pondering;
+}
+
+/**
+ * Latest verdict of the tree itself, pondering included (visit counts, reused nodes)
+ */
+std::optional<MctsResult> AsyncMcts::getLatestTree() const
+{
+    std::scoped_lock lock{this->mutex};
+    return this->latest;
+}
+
+/**
+ * Replace any running search with one on `pos`
+ */
+void AsyncMcts::launch(const Position &pos, const SearchLimits &limits, const bool ponder)
+{
+    this->stop();
+    {
+        std::scoped_lock lock{this->mutex};
+        this->cancelled = false;
+        this->pondering = ponder;
+        this->root = pos;
+        this->latest = std::nullopt;
+    }
+    this->finished = false;
+    this->worker = std::thread([this, pos, limits] {
+        const MctsResult result = this->mcts.search(pos, limits);
+        std::scoped_lock lock{this->mutex};
+        if (!this->cancelled)
+        {
+            this->latest = result;
+        }
+        this->finished = true;
+    });
+}
+
+} // namespace chk::engine
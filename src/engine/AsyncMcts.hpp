@@ -0,0 +1,48 @@
+// created 2026-10-18
+#pragma once
+
+#include "Mcts.hpp"
+#include "SearchRunner.hpp"
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace chk::engine
+{
+/**
+ * Runs an MctsSearcher on its own thread, so callers (e.g. the render loop) never block. Its progress is
+ * published as a search result, and can be polled with `getLatest`. The tree outlives each search: after
+ * playing a move, `ponder` keeps growing it on the opponent's time, so the next `start` begins with the
+ * visits already gathered below the move they actually play.
+ */
+class AsyncMcts final : public SearchRunner
+{
+  public:
+    explicit AsyncMcts(const MctsConfig &config = MctsConfig{});
+    ~AsyncMcts() override;
+    AsyncMcts(const AsyncMcts &) = delete;
+    AsyncMcts &operator=(const AsyncMcts &) = delete;
+    void start(const Position &pos, const SearchLimits &limits) override;
+    void ponder(const Position &opponentToMove);
+    void stop() override;
+    [[nodiscard]] std::optional<SearchResult> getLatest(const Position &pos) const override;
+    [[nodiscard]] bool isSearching() const override;
+    [[nodiscard]] bool isPondering() const;
+    [[nodiscard]] std::optional<MctsResult> getLatestTree() const;
+
+  private:
+    MctsSearcher mcts;
+    std::thread worker;
+    std::atomic_bool finished{true};
+
+    mutable std::mutex mutex;               // guards everything below
+    bool cancelled = false;                 // stop() called: unwind as soon as possible
+    bool pondering = false;                 // searching the opponent's position: nothing to publish
+    std::optional<Position> root{};         // position being searched
+    std::optional<MctsResult> latest{};     // latest verdict on `root`
+
+    void launch(const Position &pos, const SearchLimits &limits, bool ponder);
+};
+
+} // namespace chk::engine
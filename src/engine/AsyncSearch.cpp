@@ -0,0 +1,103 @@
+#include "AsyncSearch.hpp"
+
+namespace chk::engine
+{
+
+/**
+ * Custom constructor
+ * @param config search behaviour
+ */
+AsyncSearch::AsyncSearch(const SearchConfig &config) : searcher(config)
+{
+    this->searcher.setOnIteration([this](const SearchResult &result) {
+        std::scoped_lock lock{this->mutex};
+        if (this->cancelled)
+        {
+            this->searcher.stop(); // stop() may have landed just before this search began
+            return;
+        }
+        this->latest = result;
+    });
+}
+
+AsyncSearch::~AsyncSearch()
+{
+    this->stop();
+}
+
+/**
+ * Search `pos` in the background (replaces any running search). Returns immediately
+ * @param pos position to analyse
+ * @param limits when to stop
+ */
+void AsyncSearch::start(const Position &pos, const SearchLimits &limits)
+{
+    this->stop();
+    {
+        std::scoped_lock lock{this->mutex};
+        this->cancelled = false;
+        this->root = pos;
+        this->latest = std::nullopt;
+    }
+    this->finished = false;
+    this->worker = std::thread([this, pos, limits] {
+        const SearchResult result = this->searcher.search(pos, limits);
+        std::scoped_lock lock{this->mutex};
+        if (!this->cancelled)
+        {
+            this->latest = result; // also covers forced moves, which return without an iteration
+        }
+        this->finished = true;
+    });
+}
+
+/**
+ * Abort the background search and wait for its thread. Returns quickly: search checks the flag every node
+ */
+void AsyncSearch::stop()
+{
+    {
+        std::scoped_lock lock{this->mutex};
+        this->cancelled = true;
+    }
+    this->searcher.stop();
+    if (this->worker.joinable())
+    {
+        this->worker.join();
+    }
+}
+
+/**
+ * Share a transposition table with the background searcher (stops any running search first).
+ * Kept across `start` calls, so re-analysing a position, or adding multi-PV lines, starts warm
+ * @param table table to use (caller keeps it alive), or nullptr for none
+ */
+void AsyncSearch::setTranspositionTable(TranspositionTable *table)
+{
+    this->stop();
+    this->searcher.setTranspositionTable(table);
+}
+
+/**
+ * Last completed iteration, if the search is (or was) working on `pos`
+ * @param pos the position caller is interested in
+ */
+std::optional<SearchResult> AsyncSearch::getLatest(const Position &pos) const
+{
+    std::scoped_lock lock{this->mutex};
+    if (this->root != pos)
+    {
+        return std::nullopt;
+    }
+    return this->latest;
+}
+
+/**
+ * Whether the background thread is still thinking
+ */
+bool AsyncSearch::isSearching() const
+{
+    return !this->finished;
+}
+
+} // namespace chk::engine
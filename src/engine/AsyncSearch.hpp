@@ -0,0 +1,41 @@
+// created 2026-10-18
+#pragma once
+
+#include "Search.hpp"
+#include "SearchRunner.hpp"
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace chk::engine
+{
+/**
+ * Runs a Searcher on its own thread, so callers (e.g. the render loop) never block.
+ * Each completed deepening iteration is published, and can be polled with `getLatest`.
+ */
+class AsyncSearch final : public SearchRunner
+{
+  public:
+    explicit AsyncSearch(const SearchConfig &config = SearchConfig{});
+    ~AsyncSearch() override;
+    AsyncSearch(const AsyncSearch &) = delete;
+    AsyncSearch &operator=(const AsyncSearch &) = delete;
+    void start(const Position &pos, const SearchLimits &limits) override;
+    void stop() override;
+    void setTranspositionTable(TranspositionTable *table);
+    [[nodiscard]] std::optional<SearchResult> getLatest(const Position &pos) const override;
+    [[nodiscard]] bool isSearching() const override;
+
+  private:
+    Searcher searcher;
+    std::thread worker;
+    std::atomic_bool finished{true};
+
+    mutable std::mutex mutex;             // guards everything below
+    bool cancelled = false;               // stop() called: unwind as soon as possible
+    std::optional<Position> root{};       // position being searched
+    std::optional<SearchResult> latest{}; // last completed iteration on `root`
+};
+
+} // namespace chk::engine
@@ -0,0 +1,101 @@
+#include "Bench.hpp"
+#include <array>
+#include <chrono>
+#include <memory>
+#include <random>
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr int PLIES_BETWEEN_SAMPLES{5}; // playout plies between two suite positions
+constexpr int MAX_PLAYOUT_PLIES{100};   // a playout is restarted from the initial position after this many
+constexpr uint64_t FNV_OFFSET{0xCBF29CE484222325ull}; // FNV-1a, for BenchResult::movesHash
+constexpr uint64_t FNV_PRIME{0x100000001B3ull};
+} // namespace
+
+/**
+ * Nodes per second over the whole run (0 if too fast to time)
+ */
+uint64_t BenchResult::nodesPerSecond() const
+{
+    return this->elapsedMs > 0 ? this->nodes * 1000 / static_cast<uint64_t>(this->elapsedMs) : 0;
+}
+
+/**
+ * The bench suite: the initial position, then positions sampled along random playouts from it. Only positions
+ * with a real choice are kept (a forced move is not searched). Same seed, same positions, on any platform
+ * @param seed playout seed
+ * @param count number of positions
+ */
+std::vector<Position> benchPositions(const uint32_t seed, const int count)
+{
+    std::mt19937 rng{seed};
+    std::vector<Position> positions;
+    if (count > 0)
+    {
+        positions.push_back(Position::initial());
+    }
+    Position pos = Position::initial();
+    int ply = 0;
+    while (static_cast<int>(positions.size()) < count)
+    {
+        MoveList moves;
+        generateMoves(pos, moves);
+        if (moves.empty() || ply >= MAX_PLAYOUT_PLIES)
+        {
+            pos = Position::initial(); // game over: start another playout
+            ply = 0;
+            continue;
+        }
+        if (ply > 0 && ply % PLIES_BETWEEN_SAMPLES == 0 && moves.size() > 1)
+        {
+            positions.push_back(pos);
+        }
+        pos = makeMove(pos, moves[static_cast<int>(rng() % moves.size())]);
+        ply++;
+    }
+    return positions;
+}
+
+/**
+ * Search every suite position to a fixed depth, on this thread, with a fresh searcher and a cleared
+ * table each time, and the built-in evaluation weights (never eval.weights): nothing carries over
+ * between positions or runs, so the node counts only change when the search itself does
+ * @param config suite and limits
+ */
+BenchResult runBench(const BenchConfig &config)
+{
+    static const EvalWeights builtInWeights{};
+    TranspositionTable tt{config.hashMegabytes};
+    SearchLimits limits{};
+    limits.maxDepth = config.depth;
+    limits.maxNodes = config.maxNodes;
+
+    BenchResult bench;
+    bench.movesHash = FNV_OFFSET;
+    const auto start = std::chrono::steady_clock::now();
+    for (const Position &pos : benchPositions(config.seed, config.positions))
+    {
+        tt.clear();
+        const auto searcher = std::make_unique<Searcher>(); // killers and history start empty
+        searcher->setEvalWeights(&builtInWeights);
+        searcher->setTranspositionTable(&tt);
+        const SearchResult result = searcher->search(pos, limits);
+
+        bench.entries.push_back(BenchEntry{pos, result.bestMove, result.score, result.depth, result.stats.nodes});
+        bench.nodes += result.stats.nodes;
+        const std::array<uint64_t, 4> parts{result.bestMove.from, result.bestMove.to, result.bestMove.captured,
+                                            static_cast<uint64_t>(static_cast<int64_t>(result.score))};
+        for (const uint64_t part : parts)
+        {
+            bench.movesHash = (bench.movesHash ^ part) * FNV_PRIME;
+        }
+    }
+    bench.elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    return bench;
+}
+
+} // namespace chk::engine
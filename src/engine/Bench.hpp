@@ -0,0 +1,59 @@
+// created 2026-10-18
+#pragma once
+
+#include "Search.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace chk::engine
+{
+constexpr uint32_t BENCH_SEED{20261018};       // random playouts that build the bench suite
+constexpr int BENCH_POSITIONS{24};             // suite size
+constexpr int BENCH_DEPTH{9};                  // every position is searched to exactly this depth
+constexpr uint64_t BENCH_MAX_NODES{2'000'000}; // per position: a cap, in case a change blows up the tree
+constexpr size_t BENCH_HASH_MB{16};            // cleared before each position
+// total nodes of the default bench. A change that moves it must say so (and update it) on purpose
+constexpr uint64_t BENCH_SIGNATURE{711183};
+
+/**
+ * What the bench searches, and how. Two runs with the same config search the same trees
+ */
+struct BenchConfig
+{
+    uint32_t seed = BENCH_SEED;
+    int positions = BENCH_POSITIONS;
+    int depth = BENCH_DEPTH;
+    uint64_t maxNodes = BENCH_MAX_NODES;
+    size_t hashMegabytes = BENCH_HASH_MB;
+};
+
+/**
+ * One suite position and what the search made of it
+ */
+struct BenchEntry
+{
+    Position pos{};
+    Move bestMove = NULL_MOVE;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+};
+
+/**
+ * Outcome of a bench run. `nodes` is the signature to compare: any change to move generation,
+ * ordering, pruning or evaluation changes it, while speed changes leave it alone
+ */
+struct BenchResult
+{
+    std::vector<BenchEntry> entries{};
+    uint64_t nodes = 0;     // total over the suite
+    uint64_t movesHash = 0; // best moves and scores folded together, to tell apart changes with equal node counts
+    int64_t elapsedMs = 0;
+
+    [[nodiscard]] uint64_t nodesPerSecond() const;
+};
+
+[[nodiscard]] std::vector<Position> benchPositions(uint32_t seed, int count);
+[[nodiscard]] BenchResult runBench(const BenchConfig &config = BenchConfig{});
+
+} // namespace chk::engine
@@ -0,0 +1,150 @@
+// created 2026-10-18
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace chk::engine
+{
+// one bit per playable (dark) cell. Bit `s` is the cell labelled `s + 1` on the board
+using Bitboard = uint32_t;
+
+constexpr int NUM_SQUARES{32};
+constexpr int NO_SQUARE{-1};
+
+// RED pieces are crowned on the top row (cells 29~32), BLACK pieces on the bottom row (cells 1~4)
+constexpr Bitboard RED_CROWN_ROW{0xF0000000u};
+constexpr Bitboard BLACK_CROWN_ROW{0x0000000Fu};
+
+/**
+ * Diagonal directions, seen from the screen. NORTH is towards the top row (RED's forward direction)
+ */
+enum Direction : uint8_t
+{
+    NORTH_WEST = 0,
+    NORTH_EAST,
+    SOUTH_WEST,
+    SOUTH_EAST,
+};
+
+/**
+ * Convert a cell index shown on the board [1~32] into a square [0~31]
+ */
+constexpr int toSquare(const int cellIdx)
+{
+    return cellIdx - 1;
+}
+
+/**
+ * Convert a square [0~31] into the cell index shown on the board [1~32]
+ */
+constexpr int toCellIndex(const int sq)
+{
+    return sq + 1;
+}
+
+/**
+ * Row of this square. Row 0 is the top of the screen (BLACK's home row)
+ */
+constexpr int rowOf(const int sq)
+{
+    return 7 - sq / 4;
+}
+
+/**
+ * Column of this square. Column 0 is the left edge of the screen
+ */
+constexpr int colOf(const int sq)
+{
+    const int p = sq % 4;
+    return rowOf(sq) % 2 == 0 ? 7 - 2 * p : 6 - 2 * p;
+}
+
+/**
+ * Find the square at this row and column (matches `GameManager::drawCheckerboard` numbering)
+ * @return square [0~31], or NO_SQUARE if off-board or a lighter cell
+ */
+constexpr int squareAt(const int row, const int col)
+{
+    if (row < 0 || row > 7 || col < 0 || col > 7 || (row + col) % 2 == 0)
+    {
+        return NO_SQUARE;
+    }
+    const int p = row % 2 == 0 ? (7 - col) / 2 : (6 - col) / 2;
+    return (7 - row) * 4 + p;
+}
+
+/**
+ * Build lookup table of neighbours at `distance` steps, in every direction
+ */
+constexpr std::array<std::array<int8_t, NUM_SQUARES>, 4> buildStepTable(const int distance)
+{
+    constexpr int dRow[4] = {-1, -1, +1, +1};
+    constexpr int dCol[4] = {-1, +1, -1, +1};
+    std::array<std::array<int8_t, NUM_SQUARES>, 4> table{};
+    for (int dir = 0; dir < 4; dir++)
+    {
+        for (int sq = 0; sq < NUM_SQUARES; sq++)
+        {
+            const int row = rowOf(sq) + dRow[dir] * distance;
+            const int col = colOf(sq) + dCol[dir] * distance;
+            table[dir][sq] = static_cast<int8_t>(squareAt(row, col));
+        }
+    }
+    return table;
+}
+
+// NEIGHBOUR[dir][sq]: adjacent square in that direction (or NO_SQUARE)
+constexpr auto NEIGHBOUR = buildStepTable(1);
+// JUMP_LANDING[dir][sq]: landing square after jumping over NEIGHBOUR[dir][sq] (or NO_SQUARE)
+constexpr auto JUMP_LANDING = buildStepTable(2);
+
+/**
+ * Bit of this single square
+ */
+constexpr Bitboard bitOf(const int sq)
+{
+    return Bitboard{1} << sq;
+}
+
+/**
+ * Count set bits
+ */
+inline int popCount(const Bitboard bb)
+{
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt(bb));
+#else
+    return __builtin_popcount(bb);
+#endif
+}
+
+/**
+ * Index of lowest set bit. `bb` MUST NOT be zero
+ */
+inline int lowestSquare(const Bitboard bb)
+{
+#if defined(_MSC_VER)
+    unsigned long idx = 0;
+    _BitScanForward(&idx, bb);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(bb);
+#endif
+}
+
+/**
+ * Remove the lowest set bit, and return its index. `bb` MUST NOT be zero
+ */
+inline int popLowest(Bitboard &bb)
+{
+    const int sq = lowestSquare(bb);
+    bb &= bb - 1;
+    return sq;
+}
+
+} // namespace chk::engine
@@ -0,0 +1,777 @@
+#include "DistributedSelfPlay.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <spdlog/spdlog.h>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace chk::engine
+{
+
+namespace
+{
+#if defined(_WIN32)
+using NativeSocket = SOCKET;
+using PollEntry = WSAPOLLFD;
+constexpr int SEND_FLAGS{0};
+#else
+using NativeSocket = int;
+using PollEntry = pollfd;
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS{MSG_NOSIGNAL}; // a dead peer must not kill us with SIGPIPE
+#else
+constexpr int SEND_FLAGS{0};
+#endif
+#endif
+
+constexpr size_t HEADER_BYTES{8}; // magic u32, version u8, type u8, payload size u16
+constexpr size_t MAX_PAYLOAD{64};
+constexpr int LISTEN_BACKLOG{64};
+constexpr int64_t POLL_MS{100}; // coordinator wakes up at least this often (timeouts, stop())
+
+using Clock = std::chrono::steady_clock;
+
+int64_t millisSince(const Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+NativeSocket native(const intptr_t handle)
+{
+    return static_cast<NativeSocket>(handle);
+}
+
+/**
+ * Start the socket library once (Windows only)
+ */
+void ensureNetworking()
+{
+#if defined(_WIN32)
+    static const bool started = [] {
+        WSADATA data{};
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    (void)started;
+#endif
+}
+
+void closeSocket(const intptr_t handle)
+{
+    if (handle == -1)
+    {
+        return;
+    }
+#if defined(_WIN32)
+    closesocket(native(handle));
+#else
+    ::close(native(handle));
+#endif
+}
+
+/**
+ * Small frames must leave at once, not wait for Nagle; a dead peer must not raise SIGPIPE (macOS)
+ */
+void tuneSocket(const intptr_t handle)
+{
+    int one = 1;
+    setsockopt(native(handle), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&one), sizeof(one));
+#ifdef SO_NOSIGPIPE
+    setsockopt(native(handle), SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+}
+
+/**
+ * Wait until `handle` has data (or a pending connection)
+ * @return TRUE if readable (or in error: the next read will tell)
+ */
+bool waitReadable(const intptr_t handle, const int64_t timeoutMs)
+{
+    PollEntry entry{};
+    entry.fd = native(handle);
+    entry.events = POLLIN;
+#if defined(_WIN32)
+    return WSAPoll(&entry, 1, static_cast<int>(timeoutMs)) > 0;
+#else
+    return ::poll(&entry, 1, static_cast<int>(timeoutMs)) > 0;
+#endif
+}
+
+template <typename T> void putLe(std::vector<uint8_t> &out, const T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++)
+    {
+        out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i)));
+    }
+}
+
+template <typename T> T getLe(const uint8_t *bytes)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); i++)
+    {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+/**
+ * Payload of a frame: only the fields its type uses
+ */
+std::vector<uint8_t> encodePayload(const SelfPlayFrame &frame)
+{
+    std::vector<uint8_t> out;
+    switch (frame.type)
+    {
+    case SelfPlayMessage::HELLO:
+        putLe(out, frame.fingerprint);
+        putLe(out, frame.threads);
+        break;
+    case SelfPlayMessage::BATCH:
+        putLe(out, frame.batchId);
+        putLe(out, frame.firstGame);
+        putLe(out, frame.games);
+        break;
+    case SelfPlayMessage::RESULT:
+        putLe(out, frame.batchId);
+        putLe(out, frame.games);
+        putLe(out, frame.score.wins);
+        putLe(out, frame.score.draws);
+        putLe(out, frame.score.losses);
+        putLe(out, frame.nodes);
+        break;
+    default:
+        break; // HEARTBEAT, STOP: header only
+    }
+    return out;
+}
+
+/**
+ * Read a payload back into `frame` (type already set)
+ * @return FALSE if the size does not match the type
+ */
+bool decodePayload(const uint8_t *bytes, const size_t size, SelfPlayFrame &frame)
+{
+    switch (frame.type)
+    {
+    case SelfPlayMessage::HELLO:
+        if (size != 12)
+        {
+            return false;
+        }
+        frame.fingerprint = getLe<uint64_t>(bytes);
+        frame.threads = getLe<uint32_t>(bytes + 8);
+        return true;
+    case SelfPlayMessage::BATCH:
+        if (size != 12)
+        {
+            return false;
+        }
+        frame.batchId = getLe<uint32_t>(bytes);
+        frame.firstGame = getLe<uint32_t>(bytes + 4);
+        frame.games = getLe<uint32_t>(bytes + 8);
+        return true;
+    case SelfPlayMessage::RESULT:
+        if (size != 28)
+        {
+            return false;
+        }
+        frame.batchId = getLe<uint32_t>(bytes);
+        frame.games = getLe<uint32_t>(bytes + 4);
+        frame.score.wins = getLe<uint32_t>(bytes + 8);
+        frame.score.draws = getLe<uint32_t>(bytes + 12);
+        frame.score.losses = getLe<uint32_t>(bytes + 16);
+        frame.nodes = getLe<uint64_t>(bytes + 20);
+        return true;
+    case SelfPlayMessage::HEARTBEAT:
+    case SelfPlayMessage::STOP:
+        return size == 0;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Add a finished batch to the match totals (and SPRT)
+ */
+void addBatch(SelfPlayReport &match, const SelfPlayFrame &result, const SprtConfig &sprt)
+{
+    match.score.wins += result.score.wins;
+    match.score.draws += result.score.draws;
+    match.score.losses += result.score.losses;
+    match.nodes += result.nodes;
+    if (sprt.enabled)
+    {
+        match.llr = match.score.llr(sprt.elo0, sprt.elo1);
+        if (match.decision == SprtDecision::CONTINUE)
+        {
+            match.decision = match.score.sprt(sprt);
+        }
+    }
+}
+} // namespace
+
+SelfPlayLink::~SelfPlayLink()
+{
+    this->close();
+}
+
+SelfPlayLink::SelfPlayLink(SelfPlayLink &&other) noexcept
+    : handle(std::exchange(other.handle, -1)), peer(std::move(other.peer)), inbox(std::move(other.inbox))
+{
+}
+
+SelfPlayLink &SelfPlayLink::operator=(SelfPlayLink &&other) noexcept
+{
+    if (this != &other)
+    {
+        this->close();
+        this->handle = std::exchange(other.handle, -1);
+        this->peer = std::move(other.peer);
+        this->inbox = std::move(other.inbox);
+    }
+    return *this;
+}
+
+/**
+ * Connect to a coordinator
+ * @param host name or address
+ * @param port TCP port
+ * @return TRUE if connected
+ */
+bool SelfPlayLink::connect(const std::string &host, const uint16_t port)
+{
+    ensureNetworking();
+    this->close();
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *found = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &found) != 0)
+    {
+        return false;
+    }
+    for (const addrinfo *addr = found; addr != nullptr && this->handle == -1; addr = addr->ai_next)
+    {
+        const auto sock = static_cast<intptr_t>(::socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol));
+        if (sock == -1)
+        {
+            continue;
+        }
+        if (::connect(native(sock), addr->ai_addr, static_cast<int>(addr->ai_addrlen)) == 0)
+        {
+            this->handle = sock;
+        }
+        else
+        {
+            closeSocket(sock);
+        }
+    }
+    freeaddrinfo(found);
+    if (this->handle == -1)
+    {
+        return false;
+    }
+    tuneSocket(this->handle);
+    this->peer = host + ":" + std::to_string(port);
+    return true;
+}
+
+/**
+ * Send one frame (blocking until it is handed to the system)
+ * @return FALSE if the connection is gone
+ */
+bool SelfPlayLink::send(const SelfPlayFrame &frame)
+{
+    if (this->handle == -1)
+    {
+        return false;
+    }
+    const std::vector<uint8_t> payload = encodePayload(frame);
+    std::vector<uint8_t> bytes;
+    bytes.reserve(HEADER_BYTES + payload.size());
+    putLe(bytes, SELFPLAY_LINK_MAGIC);
+    putLe(bytes, SELFPLAY_LINK_VERSION);
+    putLe(bytes, static_cast<uint8_t>(frame.type));
+    putLe(bytes, static_cast<uint16_t>(payload.size()));
+    bytes.insert(bytes.end(), payload.begin(), payload.end());
+
+    size_t sent = 0;
+    while (sent < bytes.size())
+    {
+        const auto n = ::send(native(this->handle), reinterpret_cast<const char *>(bytes.data() + sent),
+                              static_cast<int>(bytes.size() - sent), SEND_FLAGS);
+        if (n <= 0)
+        {
+            this->close();
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * Receive the next frame, waiting up to `timeoutMs` for it to arrive
+ * @param frame filled in on FRAME
+ * @param timeoutMs 0 = only what has already arrived
+ */
+LinkStatus SelfPlayLink::receive(SelfPlayFrame &frame, const int64_t timeoutMs)
+{
+    const auto start = Clock::now();
+    while (true)
+    {
+        bool bad = false;
+        if (this->takeFrame(frame, bad))
+        {
+            return LinkStatus::FRAME;
+        }
+        if (bad || this->handle == -1)
+        {
+            this->close();
+            return LinkStatus::CLOSED;
+        }
+        const int64_t left = std::max<int64_t>(0, timeoutMs - millisSince(start));
+        if (!waitReadable(this->handle, left))
+        {
+            return LinkStatus::TIMEOUT;
+        }
+        uint8_t chunk[512];
+        const auto n = ::recv(native(this->handle), reinterpret_cast<char *>(chunk), sizeof(chunk), 0);
+        if (n <= 0)
+        {
+            this->close();
+            return LinkStatus::CLOSED;
+        }
+        this->inbox.insert(this->inbox.end(), chunk, chunk + n);
+    }
+}
+
+/**
+ * Parse one complete frame off the front of the inbox
+ * @param bad set if the bytes are not our protocol (wrong magic/version, unknown type or size)
+ * @return TRUE if a frame was taken
+ */
+bool SelfPlayLink::takeFrame(SelfPlayFrame &frame, bool &bad)
+{
+    if (this->inbox.size() < HEADER_BYTES)
+    {
+        return false;
+    }
+    const auto size = getLe<uint16_t>(this->inbox.data() + 6);
+    if (getLe<uint32_t>(this->inbox.data()) != SELFPLAY_LINK_MAGIC || this->inbox[4] != SELFPLAY_LINK_VERSION ||
+        size > MAX_PAYLOAD)
+    {
+        bad = true;
+        return false;
+    }
+    if (this->inbox.size() < HEADER_BYTES + size)
+    {
+        return false;
+    }
+    frame = SelfPlayFrame{};
+    frame.type = static_cast<SelfPlayMessage>(this->inbox[5]);
+    if (!decodePayload(this->inbox.data() + HEADER_BYTES, size, frame))
+    {
+        bad = true;
+        return false;
+    }
+    this->inbox.erase(this->inbox.begin(), this->inbox.begin() + static_cast<long>(HEADER_BYTES + size));
+    return true;
+}
+
+void SelfPlayLink::close()
+{
+    closeSocket(this->handle);
+    this->handle = -1;
+    this->inbox.clear();
+}
+
+bool SelfPlayLink::isOpen() const
+{
+    return this->handle != -1;
+}
+
+/**
+ * Address of the other end, for logs
+ */
+const std::string &SelfPlayLink::getPeer() const
+{
+    return this->peer;
+}
+
+/**
+ * Identify a match: the openings, game count and lengths, plus a key for the engines (options,
+ * weights, networks) supplied by the caller. Coordinator and workers must agree on it, or the
+ * worker would play a different match than the one being scored
+ * @param config match settings
+ * @param enginesKey hash of whatever defines the two engines
+ */
+uint64_t selfPlayFingerprint(const SelfPlayConfig &config, const uint64_t enginesKey)
+{
+    uint64_t key = enginesKey ^ (static_cast<uint64_t>(config.maxGames) << 32) ^
+                   static_cast<uint64_t>(static_cast<uint32_t>(config.maxGamePlies));
+    for (const Position &opening : config.openings)
+    {
+        key = (key ^ hashPosition(opening)) * 0x100000001B3ull;
+    }
+    return key;
+}
+
+/**
+ * Custom constructor
+ * @param config the whole match (threads are the workers' business and ignored here)
+ * @param enginesKey hash of the engine settings, see selfPlayFingerprint()
+ * @param net port, batch size and failure handling
+ */
+SelfPlayCoordinator::SelfPlayCoordinator(SelfPlayConfig config, const uint64_t enginesKey, CoordinatorConfig net)
+    : config(std::move(config)), net(net)
+{
+    this->fingerprint = selfPlayFingerprint(this->config, enginesKey);
+    this->net.batchGames = std::max<uint32_t>(this->net.batchGames, 1);
+}
+
+SelfPlayCoordinator::~SelfPlayCoordinator()
+{
+    closeSocket(this->listener);
+}
+
+/**
+ * Open the listening socket (all interfaces). Workers may connect as soon as this returns,
+ * even before run() is called
+ * @return TRUE if successful, else FALSE
+ */
+bool SelfPlayCoordinator::listen()
+{
+    ensureNetworking();
+    closeSocket(this->listener);
+    this->listener = static_cast<intptr_t>(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    if (this->listener == -1)
+    {
+        spdlog::error("selfplay coordinator: cannot create socket");
+        return false;
+    }
+    int one = 1;
+    setsockopt(native(this->listener), SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&one), sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(this->net.port);
+    socklen_t addrLen = sizeof(addr);
+    if (::bind(native(this->listener), reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        ::listen(native(this->listener), LISTEN_BACKLOG) != 0 ||
+        getsockname(native(this->listener), reinterpret_cast<sockaddr *>(&addr), &addrLen) != 0)
+    {
+        spdlog::error("selfplay coordinator: cannot listen on port {}", this->net.port);
+        closeSocket(this->listener);
+        this->listener = -1;
+        return false;
+    }
+    this->port = ntohs(addr.sin_port);
+    return true;
+}
+
+/**
+ * Port workers should connect to (after listen())
+ */
+uint16_t SelfPlayCoordinator::getPort() const
+{
+    return this->port;
+}
+
+/**
+ * Serve workers until every batch is scored (or given up), SPRT has decided, or stop() is called.
+ * Then every worker is told to stop
+ * @param onBatch optional progress callback
+ */
+CoordinatorReport SelfPlayCoordinator::run(const ProgressCallback &onBatch)
+{
+    const uint32_t numBatches = (this->config.maxGames + this->net.batchGames - 1) / this->net.batchGames;
+    std::deque<uint32_t> pending;
+    for (uint32_t batch = 0; batch < numBatches; batch++)
+    {
+        pending.push_back(batch);
+    }
+    std::vector<int> attempts(numBatches, 0);
+    std::vector<bool> scored(numBatches, false);
+    std::vector<Worker> workers;
+    CoordinatorReport report;
+    const auto startTime = Clock::now();
+
+    const auto hand = [&](Worker &worker) {
+        if (!worker.ready || worker.batch != -1 || pending.empty())
+        {
+            return;
+        }
+        const uint32_t batch = pending.front();
+        pending.pop_front();
+        SelfPlayFrame frame;
+        frame.type = SelfPlayMessage::BATCH;
+        frame.batchId = batch;
+        frame.firstGame = batch * this->net.batchGames;
+        frame.games = std::min(this->net.batchGames, this->config.maxGames - frame.firstGame);
+        worker.batch = batch;
+        attempts[batch]++;
+        worker.link.send(frame); // a failed send shows up as a closed link below
+    };
+    const auto drop = [&](Worker &worker, const char *why) {
+        spdlog::warn("selfplay coordinator: worker {} {}", worker.link.getPeer(), why);
+        if (worker.batch != -1)
+        {
+            const auto batch = static_cast<uint32_t>(worker.batch);
+            report.workersLost++;
+            if (attempts[batch] < this->net.maxAttempts)
+            {
+                pending.push_front(batch); // next free worker takes it
+                report.batchesRetried++;
+            }
+            else
+            {
+                spdlog::error("selfplay coordinator: batch {} failed {} times, giving up", batch, attempts[batch]);
+                report.batchesFailed++;
+            }
+        }
+        worker.link.close();
+    };
+
+    while (!this->stopRequested && report.batchesDone + report.batchesFailed < numBatches &&
+           report.match.decision == SprtDecision::CONTINUE)
+    {
+        this->acceptWorkers(workers, report, millisSince(startTime));
+
+        // sleep until any worker speaks, or POLL_MS
+        std::vector<PollEntry> entries(workers.size() + 1);
+        entries[0].fd = native(this->listener);
+        entries[0].events = POLLIN;
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            entries[i + 1].fd = native(workers[i].link.handle);
+            entries[i + 1].events = POLLIN;
+        }
+#if defined(_WIN32)
+        WSAPoll(entries.data(), static_cast<ULONG>(entries.size()), static_cast<int>(POLL_MS));
+#else
+        ::poll(entries.data(), entries.size(), static_cast<int>(POLL_MS));
+#endif
+
+        const int64_t nowMs = millisSince(startTime);
+        for (Worker &worker : workers)
+        {
+            SelfPlayFrame frame;
+            LinkStatus status = LinkStatus::TIMEOUT;
+            while ((status = worker.link.receive(frame, 0)) == LinkStatus::FRAME)
+            {
+                worker.lastHeardMs = nowMs;
+                if (frame.type == SelfPlayMessage::HELLO)
+                {
+                    if (frame.fingerprint != this->fingerprint)
+                    {
+                        SelfPlayFrame refuse;
+                        refuse.type = SelfPlayMessage::STOP;
+                        worker.link.send(refuse);
+                        drop(worker, "plays a different match (check its options), refused");
+                        break;
+                    }
+                    worker.ready = true;
+                    spdlog::info("selfplay coordinator: worker {} joined ({} threads)", worker.link.getPeer(),
+                                 frame.threads);
+                }
+                else if (frame.type == SelfPlayMessage::RESULT && worker.batch == frame.batchId)
+                {
+                    worker.batch = -1;
+                    if (!scored[frame.batchId])
+                    {
+                        scored[frame.batchId] = true;
+                        report.batchesDone++;
+                        addBatch(report.match, frame, this->config.sprt);
+                        report.match.elapsedSec = static_cast<double>(nowMs) / 1000.0;
+                        if (onBatch)
+                        {
+                            onBatch(report);
+                        }
+                    }
+                }
+            }
+            if (status == LinkStatus::CLOSED)
+            {
+                drop(worker, "disconnected");
+            }
+            else if (worker.link.isOpen() && nowMs - worker.lastHeardMs > this->net.workerTimeoutMs)
+            {
+                drop(worker, "timed out");
+            }
+        }
+        workers.erase(std::remove_if(workers.begin(), workers.end(),
+                                     [](const Worker &worker) { return !worker.link.isOpen(); }),
+                      workers.end());
+        for (Worker &worker : workers)
+        {
+            hand(worker);
+        }
+        report.workersActive = static_cast<uint32_t>(workers.size());
+    }
+
+    SelfPlayFrame stopFrame;
+    stopFrame.type = SelfPlayMessage::STOP;
+    for (Worker &worker : workers)
+    {
+        worker.link.send(stopFrame);
+    }
+    report.workersActive = 0;
+    report.match.elapsedSec = std::chrono::duration<double>(Clock::now() - startTime).count();
+    return report;
+}
+
+/**
+ * Stop handing out batches and return from run() (within POLL_MS). Safe from any thread
+ */
+void SelfPlayCoordinator::stop()
+{
+    this->stopRequested = true;
+}
+
+/**
+ * Take every pending connection
+ */
+void SelfPlayCoordinator::acceptWorkers(std::vector<Worker> &workers, CoordinatorReport &report,
+                                        const int64_t nowMs) const
+{
+    while (waitReadable(this->listener, 0))
+    {
+        sockaddr_in addr{};
+        socklen_t addrLen = sizeof(addr);
+        const auto sock =
+            static_cast<intptr_t>(::accept(native(this->listener), reinterpret_cast<sockaddr *>(&addr), &addrLen));
+        if (sock == -1)
+        {
+            return;
+        }
+        tuneSocket(sock);
+        Worker worker;
+        worker.link.handle = sock;
+        char name[INET_ADDRSTRLEN] = "?";
+        inet_ntop(AF_INET, &addr.sin_addr, name, sizeof(name));
+        worker.link.peer = std::string{name} + ":" + std::to_string(ntohs(addr.sin_port));
+        worker.lastHeardMs = nowMs;
+        workers.push_back(std::move(worker));
+        report.workersSeen++;
+    }
+}
+
+/**
+ * Worker side: connect to a coordinator, then play the batches it hands out (each on `config.numThreads`
+ * threads) and send back their scores, until it says stop or goes away
+ * @param host coordinator address
+ * @param port coordinator port
+ * @param engineA engine under test
+ * @param engineB reference engine
+ * @param config the same match settings as the coordinator's (openings included), plus this worker's threads
+ * @param enginesKey the same key as the coordinator's
+ * @return TRUE if the coordinator ended the session normally
+ */
+bool runSelfPlayWorker(const std::string &host, const uint16_t port, const EngineSpec &engineA,
+                       const EngineSpec &engineB, SelfPlayConfig config, const uint64_t enginesKey)
+{
+    if (config.numThreads <= 0)
+    {
+        config.numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    SelfPlayLink link;
+    const auto connectStart = Clock::now();
+    while (!link.connect(host, port))
+    {
+        if (millisSince(connectStart) > SELFPLAY_CONNECT_TIMEOUT_MS)
+        {
+            spdlog::error("selfplay worker: cannot reach coordinator {}:{}", host, port);
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    SelfPlayFrame hello;
+    hello.type = SelfPlayMessage::HELLO;
+    hello.fingerprint = selfPlayFingerprint(config, enginesKey);
+    hello.threads = static_cast<uint32_t>(config.numThreads);
+    link.send(hello);
+
+    SelfPlayFrame heartbeat;
+    heartbeat.type = SelfPlayMessage::HEARTBEAT;
+    while (true)
+    {
+        SelfPlayFrame frame;
+        const LinkStatus status = link.receive(frame, SELFPLAY_HEARTBEAT_MS);
+        if (status == LinkStatus::CLOSED)
+        {
+            spdlog::error("selfplay worker: coordinator {} went away", link.getPeer());
+            return false;
+        }
+        if (status == LinkStatus::TIMEOUT || frame.type != SelfPlayMessage::BATCH)
+        {
+            if (status == LinkStatus::FRAME && frame.type == SelfPlayMessage::STOP)
+            {
+                return true;
+            }
+            link.send(heartbeat);
+            continue;
+        }
+
+        // play the batch on a helper thread; this one keeps the coordinator informed
+        SelfPlayConfig batchConfig = config;
+        batchConfig.firstGame = frame.firstGame;
+        batchConfig.maxGames = frame.games;
+        batchConfig.sprt.enabled = false; // the coordinator decides on the whole match
+        SelfPlayMatch match{engineA, engineB, batchConfig};
+        auto played = std::async(std::launch::async, [&match] { return match.run(); });
+        bool stopped = false;
+        while (played.wait_for(std::chrono::milliseconds(SELFPLAY_HEARTBEAT_MS)) != std::future_status::ready)
+        {
+            SelfPlayFrame incoming;
+            const LinkStatus news = link.receive(incoming, 0);
+            stopped = stopped || news == LinkStatus::CLOSED ||
+                      (news == LinkStatus::FRAME && incoming.type == SelfPlayMessage::STOP);
+            if (stopped)
+            {
+                match.stop(); // games in progress still finish
+            }
+            else
+            {
+                link.send(heartbeat);
+            }
+        }
+        const SelfPlayReport batch = played.get();
+        if (stopped)
+        {
+            return link.isOpen();
+        }
+        SelfPlayFrame result;
+        result.type = SelfPlayMessage::RESULT;
+        result.batchId = frame.batchId;
+        result.games = batch.score.total();
+        result.score = batch.score;
+        result.nodes = batch.nodes;
+        if (!link.send(result))
+        {
+            spdlog::error("selfplay worker: lost coordinator {}", link.getPeer());
+            return false;
+        }
+    }
+}
+
+} // namespace chk::engine
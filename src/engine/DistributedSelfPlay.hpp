@@ -0,0 +1,157 @@
+// created 2026-10-18
+#pragma once
+
+#include "SelfPlay.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace chk::engine
+{
+constexpr uint32_t SELFPLAY_LINK_MAGIC{0x50534353};  // "SCSP" in little-endian
+constexpr uint8_t SELFPLAY_LINK_VERSION{1};
+constexpr uint32_t SELFPLAY_BATCH_GAMES{16};          // games per batch handed to a worker
+constexpr int64_t SELFPLAY_HEARTBEAT_MS{1000};        // a worker reports in at least this often
+constexpr int64_t SELFPLAY_WORKER_TIMEOUT_MS{30000};  // silent for longer: dead, its batch goes to another worker
+constexpr int SELFPLAY_MAX_ATTEMPTS{5};               // a batch whose workers keep dying is given up after this
+constexpr int64_t SELFPLAY_CONNECT_TIMEOUT_MS{10000}; // a worker keeps trying to reach its coordinator this long
+
+/**
+ * Message types between coordinator and workers
+ */
+enum class SelfPlayMessage : uint8_t
+{
+    HELLO = 1, // worker -> coordinator: fingerprint, threads
+    BATCH,     // coordinator -> worker: batchId, firstGame, games
+    RESULT,    // worker -> coordinator: batchId, games, score, nodes
+    HEARTBEAT, // worker -> coordinator: still alive (busy with a long batch)
+    STOP,      // coordinator -> worker: no more work (or wrong fingerprint): disconnect
+};
+
+/**
+ * One message. Only the fields of its type go on the wire (see SelfPlayMessage), as little-endian
+ * integers behind an 8-byte header, so a RESULT is 36 bytes whatever the batch size
+ */
+struct SelfPlayFrame
+{
+    SelfPlayMessage type = SelfPlayMessage::HEARTBEAT;
+    uint64_t fingerprint = 0; // HELLO: match settings of the worker (must equal the coordinator's)
+    uint32_t threads = 0;     // HELLO: games the worker plays at once
+    uint32_t batchId = 0;     // BATCH, RESULT
+    uint32_t firstGame = 0;   // BATCH: games [firstGame, firstGame + games) of the match
+    uint32_t games = 0;       // BATCH, RESULT
+    MatchScore score{};       // RESULT: from engine A's point of view
+    uint64_t nodes = 0;       // RESULT: searched by both engines
+};
+
+enum class LinkStatus
+{
+    FRAME,   // a frame was received
+    TIMEOUT, // nothing complete yet
+    CLOSED,  // peer gone, or sent garbage
+};
+
+/**
+ * A TCP connection carrying SelfPlayFrames. Move-only; closes on destruction
+ */
+class SelfPlayLink final
+{
+  public:
+    SelfPlayLink() = default;
+    ~SelfPlayLink();
+    SelfPlayLink(const SelfPlayLink &) = delete;
+    SelfPlayLink &operator=(const SelfPlayLink &) = delete;
+    SelfPlayLink(SelfPlayLink &&other) noexcept;
+    SelfPlayLink &operator=(SelfPlayLink &&other) noexcept;
+    [[nodiscard]] bool connect(const std::string &host, uint16_t port);
+    bool send(const SelfPlayFrame &frame);
+    LinkStatus receive(SelfPlayFrame &frame, int64_t timeoutMs);
+    void close();
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] const std::string &getPeer() const;
+
+  private:
+    friend class SelfPlayCoordinator; // adopts accepted connections
+    intptr_t handle = -1;
+    std::string peer;
+    std::vector<uint8_t> inbox{}; // received bytes not yet parsed into a frame
+
+    [[nodiscard]] bool takeFrame(SelfPlayFrame &frame, bool &bad);
+};
+
+/**
+ * How the coordinator serves its workers
+ */
+struct CoordinatorConfig
+{
+    uint16_t port = 0; // 0 = any free port (see getPort)
+    uint32_t batchGames = SELFPLAY_BATCH_GAMES;
+    int64_t workerTimeoutMs = SELFPLAY_WORKER_TIMEOUT_MS;
+    int maxAttempts = SELFPLAY_MAX_ATTEMPTS;
+};
+
+/**
+ * Match totals over all workers, plus how the work was spread
+ */
+struct CoordinatorReport
+{
+    SelfPlayReport match{};
+    uint32_t batchesDone = 0;
+    uint32_t batchesRetried = 0; // handed out again after their worker died or went silent
+    uint32_t batchesFailed = 0;  // given up after maxAttempts: their games are missing from the score
+    uint32_t workersSeen = 0;
+    uint32_t workersLost = 0;   // disconnected or timed out while holding a batch
+    uint32_t workersActive = 0; // connected right now
+};
+
+[[nodiscard]] uint64_t selfPlayFingerprint(const SelfPlayConfig &config, uint64_t enginesKey);
+
+/**
+ * Self-play match spread over worker processes, on this host or others. The coordinator splits the
+ * games into batches, hands one batch at a time to each connected worker, and adds up the results.
+ * A worker that disconnects or stays silent past the timeout loses its batch to the next free worker.
+ * Runs on the calling thread; each worker plays its batch on all of its own cores (see SelfPlayMatch).
+ */
+class SelfPlayCoordinator final
+{
+  public:
+    // called after every finished batch
+    using ProgressCallback = std::function<void(const CoordinatorReport &)>;
+
+    SelfPlayCoordinator(SelfPlayConfig config, uint64_t enginesKey, CoordinatorConfig net = CoordinatorConfig{});
+    ~SelfPlayCoordinator();
+    SelfPlayCoordinator(const SelfPlayCoordinator &) = delete;
+    SelfPlayCoordinator &operator=(const SelfPlayCoordinator &) = delete;
+    [[nodiscard]] bool listen();
+    [[nodiscard]] uint16_t getPort() const;
+    CoordinatorReport run(const ProgressCallback &onBatch = nullptr);
+    void stop();
+
+  private:
+    /**
+     * A connected worker
+     */
+    struct Worker
+    {
+        SelfPlayLink link;
+        bool ready = false;      // HELLO accepted
+        int64_t batch = -1;      // batch it is playing, or -1
+        int64_t lastHeardMs = 0; // since run() started
+    };
+
+    SelfPlayConfig config;
+    CoordinatorConfig net;
+    uint64_t fingerprint = 0;
+    intptr_t listener = -1;
+    uint16_t port = 0;
+    std::atomic_bool stopRequested{false};
+
+    void acceptWorkers(std::vector<Worker> &workers, CoordinatorReport &report, int64_t nowMs) const;
+};
+
+bool runSelfPlayWorker(const std::string &host, uint16_t port, const EngineSpec &engineA, const EngineSpec &engineB,
+                       SelfPlayConfig config, uint64_t enginesKey);
+
+} // namespace chk::engine
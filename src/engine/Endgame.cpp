@@ -0,0 +1,116 @@
+#include "Endgame.hpp"
+#include <cstdlib>
+
+namespace chk::engine
+{
+
+namespace
+{
+using EndgameEval = int (*)(const Position &pos, int generic);
+
+/**
+ * King moves between two squares (diagonal steps, ignoring blockers)
+ */
+constexpr int kingDistance(const int a, const int b)
+{
+    const int rows = rowOf(a) > rowOf(b) ? rowOf(a) - rowOf(b) : rowOf(b) - rowOf(a);
+    const int cols = colOf(a) > colOf(b) ? colOf(a) - colOf(b) : colOf(b) - colOf(a);
+    return rows > cols ? rows : cols;
+}
+
+/**
+ * Steps from each square to the nearest double corner (top left and bottom right, where a lone
+ * king shuttles between two squares and cannot be trapped)
+ */
+constexpr std::array<int8_t, NUM_SQUARES> buildCornerDistance()
+{
+    const int corners[4] = {squareAt(0, 1), squareAt(1, 0), squareAt(7, 6), squareAt(6, 7)};
+    std::array<int8_t, NUM_SQUARES> table{};
+    for (int sq = 0; sq < NUM_SQUARES; sq++)
+    {
+        int best = 7;
+        for (const int corner : corners)
+        {
+            best = kingDistance(sq, corner) < best ? kingDistance(sq, corner) : best;
+        }
+        table[sq] = static_cast<int8_t>(best);
+    }
+    return table;
+}
+
+constexpr auto CORNER_DISTANCE = buildCornerDistance();
+
+/**
+ * +1 if the side to move is the one with more material, else -1
+ */
+int strongSign(const Position &pos)
+{
+    const MaterialKey key = MaterialKey::of(pos);
+    const int balance = (key.redMen - key.blackMen) * MAN_VALUE + (key.redKings - key.blackKings) * KING_VALUE;
+    return (balance > 0) == (pos.sideToMove == Side::RED) ? 1 : -1;
+}
+
+/**
+ * Kings only, equal numbers: a draw with correct play, whatever the generic terms say
+ */
+int kingsDraw(const Position &, const int generic)
+{
+    return generic / ENDGAME_DRAW_SCALE;
+}
+
+/**
+ * Kings only, one side has more: a win, but only if the strong kings close in and keep the weak
+ * ones out of the double corners, so reward exactly that
+ */
+int kingsWin(const Position &pos, const int generic)
+{
+    const int sign = strongSign(pos);
+    const bool redStrong = (sign > 0) == (pos.sideToMove == Side::RED);
+    const Bitboard strong = redStrong ? pos.red : pos.black;
+    const Bitboard weak = redStrong ? pos.black : pos.red;
+
+    int technique = 0;
+    Bitboard hunted = weak;
+    while (hunted != 0)
+    {
+        const int prey = popLowest(hunted);
+        technique += ENDGAME_CORNER_WEIGHT * CORNER_DISTANCE[prey];
+        Bitboard hunters = strong;
+        int nearest = 7;
+        while (hunters != 0)
+        {
+            const int distance = kingDistance(popLowest(hunters), prey);
+            nearest = distance < nearest ? distance : nearest;
+        }
+        technique += ENDGAME_CHASE_WEIGHT * (7 - nearest);
+    }
+    return generic + sign * (ENDGAME_WIN_BONUS + technique);
+}
+
+/**
+ * A man or more ahead with few pieces left: every exchange makes the extra material count for more
+ */
+int tradeDown(const Position &pos, const int generic)
+{
+    const int left = popCount(pos.occupied());
+    return generic + strongSign(pos) * ENDGAME_TRADE_WEIGHT * (2 * ENDGAME_MAX_PIECES - left);
+}
+
+// indexed by EndgameKind
+constexpr std::array<EndgameEval, static_cast<size_t>(EndgameKind::NUM_KINDS)> EVALUATORS{
+    nullptr, kingsDraw, kingsWin, tradeDown};
+} // namespace
+
+/**
+ * Specialised evaluation of an ending, from the point of view of the side to move
+ * @param kind what endgameKind() returned for `pos` (not NONE)
+ * @param pos the position
+ * @param generic score of the generic evaluation (hand-written or network)
+ * @return score in centi-men
+ */
+int evaluateEndgame(const EndgameKind kind, const Position &pos, const int generic)
+{
+    return EVALUATORS[static_cast<size_t>(kind)](pos, generic);
+}
+
+} // namespace chk::engine
@@ -0,0 +1,104 @@
+// created 2026-10-18
+#pragma once
+
+#include "Evaluation.hpp"
+#include "Position.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+
+namespace chk::engine
+{
+constexpr int ENDGAME_MAX_PIECES{4};                         // per side: smaller armies get a specialised evaluation
+constexpr int ENDGAME_COUNT_BUCKETS{ENDGAME_MAX_PIECES + 2}; // a count is exact up to the maximum, then "more"
+constexpr size_t ENDGAME_TABLE_SIZE{ENDGAME_COUNT_BUCKETS * ENDGAME_COUNT_BUCKETS * ENDGAME_COUNT_BUCKETS *
+                                    ENDGAME_COUNT_BUCKETS};
+
+constexpr int ENDGAME_WIN_BONUS{200};   // kings only, more kings: a win, given the technique
+constexpr int ENDGAME_CHASE_WEIGHT{4};  // per step the strong kings close in on the weak ones
+constexpr int ENDGAME_CORNER_WEIGHT{8}; // per step the weak king is kept from a double corner, its refuge
+constexpr int ENDGAME_TRADE_WEIGHT{12}; // per piece off the board, for the side ahead: simplify when winning
+constexpr int ENDGAME_DRAW_SCALE{8};    // equal kings only: the generic score shrinks this many times
+
+/**
+ * Kind of specialised evaluation a material signature gets
+ */
+enum class EndgameKind : uint8_t
+{
+    NONE = 0,   // generic evaluation (middlegame, or nothing known)
+    KINGS_DRAW, // kings only, equal numbers
+    KINGS_WIN,  // kings only, one side has more
+    TRADE_DOWN, // a man or more ahead with few pieces left
+    NUM_KINDS,
+};
+
+/**
+ * Which specialised evaluation these material counts call for
+ */
+constexpr EndgameKind classifyMaterial(const int redMen, const int redKings, const int blackMen, const int blackKings)
+{
+    const int red = redMen + redKings;
+    const int black = blackMen + blackKings;
+    if (red == 0 || black == 0 || red > ENDGAME_MAX_PIECES || black > ENDGAME_MAX_PIECES)
+    {
+        return EndgameKind::NONE; // game over (the search sees it), or too much material to tell
+    }
+    if (redMen == 0 && blackMen == 0)
+    {
+        return redKings == blackKings ? EndgameKind::KINGS_DRAW : EndgameKind::KINGS_WIN;
+    }
+    const int balance = (redMen - blackMen) * MAN_VALUE + (redKings - blackKings) * KING_VALUE;
+    return balance >= MAN_VALUE || balance <= -MAN_VALUE ? EndgameKind::TRADE_DOWN : EndgameKind::NONE;
+}
+
+/**
+ * Slot of these counts in the dispatch table. A count past ENDGAME_MAX_PIECES shares the last bucket
+ */
+constexpr size_t materialIndex(const int redMen, const int redKings, const int blackMen, const int blackKings)
+{
+    size_t index = 0;
+    for (const int count : {redMen, redKings, blackMen, blackKings})
+    {
+        index = index * ENDGAME_COUNT_BUCKETS + static_cast<size_t>(std::min(count, ENDGAME_MAX_PIECES + 1));
+    }
+    return index;
+}
+
+/**
+ * Classify every material signature once, at compile time. Bucketed counts ("more than the
+ * maximum") are already too much material, so the table is exact
+ */
+constexpr std::array<EndgameKind, ENDGAME_TABLE_SIZE> buildEndgameTable()
+{
+    std::array<EndgameKind, ENDGAME_TABLE_SIZE> table{};
+    for (int rm = 0; rm < ENDGAME_COUNT_BUCKETS; rm++)
+    {
+        for (int rk = 0; rk < ENDGAME_COUNT_BUCKETS; rk++)
+        {
+            for (int bm = 0; bm < ENDGAME_COUNT_BUCKETS; bm++)
+            {
+                for (int bk = 0; bk < ENDGAME_COUNT_BUCKETS; bk++)
+                {
+                    table[materialIndex(rm, rk, bm, bk)] = classifyMaterial(rm, rk, bm, bk);
+                }
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr auto ENDGAME_TABLE = buildEndgameTable();
+
+/**
+ * Specialised evaluation this position needs: one load from the dispatch table
+ */
+inline EndgameKind endgameKind(const Position &pos)
+{
+    const MaterialKey key = MaterialKey::of(pos);
+    return ENDGAME_TABLE[materialIndex(key.redMen, key.redKings, key.blackMen, key.blackKings)];
+}
+
+[[nodiscard]] int evaluateEndgame(EndgameKind kind, const Position &pos, int generic);
+
+} // namespace chk::engine
@@ -0,0 +1,543 @@
+#include "EngineProcess.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <csignal>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+extern char **environ;
+#endif
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds{1};
+constexpr int SEND_RETRIES{1000}; // ~1 s at POLL_INTERVAL: the reader is stuck or gone after that
+
+static_assert(std::is_trivially_copyable_v<SearchRequest> && sizeof(SearchRequest) <= CHANNEL_MAX_MESSAGE);
+static_assert(std::is_trivially_copyable_v<SearchReply> && sizeof(SearchReply) <= CHANNEL_MAX_MESSAGE);
+
+int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * Start `executable args...` without waiting for it
+ * @return process id (POSIX) or process HANDLE (Windows), 0 on failure
+ */
+int64_t spawnProcess(const std::string &executable, const std::vector<std::string> &args)
+{
+#if defined(_WIN32)
+    std::string commandLine = "\"" + executable + "\"";
+    for (const std::string &arg : args)
+    {
+        commandLine += " \"" + arg + "\"";
+    }
+    STARTUPINFOA startup{};
+    startup.cb = sizeof(startup);
+    PROCESS_INFORMATION info{};
+    if (!CreateProcessA(executable.c_str(), commandLine.data(), nullptr, nullptr, FALSE, CREATE_NO_WINDOW, nullptr,
+                        nullptr, &startup, &info))
+    {
+        return 0;
+    }
+    CloseHandle(info.hThread);
+    return reinterpret_cast<int64_t>(info.hProcess);
+#else
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(executable.c_str()));
+    for (const std::string &arg : args)
+    {
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    pid_t pid = 0;
+    if (posix_spawn(&pid, executable.c_str(), nullptr, nullptr, argv.data(), environ) != 0)
+    {
+        return 0;
+    }
+    return pid;
+#endif
+}
+
+/**
+ * Whether the process is still running
+ */
+bool processAlive(const int64_t process)
+{
+#if defined(_WIN32)
+    return WaitForSingleObject(reinterpret_cast<HANDLE>(process), 0) == WAIT_TIMEOUT;
+#else
+    siginfo_t info{};
+    // WNOWAIT: leave a dead child as a zombie, so its pid cannot be reused before killProcess reaps it
+    if (waitid(P_PID, static_cast<id_t>(process), &info, WEXITED | WNOHANG | WNOWAIT) != 0)
+    {
+        return false;
+    }
+    return info.si_pid == 0;
+#endif
+}
+
+/**
+ * Kill the process (if still running) and release it
+ */
+void killProcess(const int64_t process)
+{
+#if defined(_WIN32)
+    TerminateProcess(reinterpret_cast<HANDLE>(process), 1);
+    WaitForSingleObject(reinterpret_cast<HANDLE>(process), INFINITE);
+    CloseHandle(reinterpret_cast<HANDLE>(process));
+#else
+    kill(static_cast<pid_t>(process), SIGKILL);
+    int status = 0;
+    waitpid(static_cast<pid_t>(process), &status, 0);
+#endif
+}
+
+/**
+ * Send, retrying while the ring is full
+ * @return FALSE if the other side did not make room in time
+ */
+template <typename T> bool sendPatiently(SharedChannel &channel, const EngineMessage type, const T &payload)
+{
+    for (int i = 0; i < SEND_RETRIES; i++)
+    {
+        if (channel.send(static_cast<uint16_t>(type), payload))
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+    return false;
+}
+} // namespace
+
+/**
+ * Pack a search for the wire
+ * @param requestId echoed in every reply, so stale replies can be told apart
+ * @param pos position to search
+ * @param limits when to stop
+ */
+SearchRequest toRequest(const uint32_t requestId, const Position &pos, const SearchLimits &limits)
+{
+    SearchRequest request{};
+    request.requestId = requestId;
+    request.maxDepth = limits.maxDepth;
+    request.multiPv = limits.multiPv;
+    request.maxNodes = limits.maxNodes;
+    request.moveTimeMs = limits.moveTimeMs;
+    request.pos = pos;
+    return request;
+}
+
+/**
+ * Pack a (partial) search result for the wire; lines and PVs beyond the wire limits are dropped
+ * @param requestId from the request being answered
+ * @param result search outcome
+ */
+SearchReply toReply(const uint32_t requestId, const SearchResult &result)
+{
+    SearchReply reply{};
+    reply.requestId = requestId;
+    reply.depth = result.depth;
+    reply.nodes = result.stats.nodes;
+    reply.elapsedMs = result.elapsedMs;
+    reply.bestMove = result.bestMove;
+    reply.score = result.score;
+    reply.lineCount = static_cast<uint32_t>(std::min<size_t>(result.lines.size(), WIRE_MAX_LINES));
+    for (uint32_t i = 0; i < reply.lineCount; i++)
+    {
+        const PvLine &line = result.lines[i];
+        WireLine &wire = reply.lines[i];
+        wire.score = line.score;
+        wire.length = static_cast<uint32_t>(std::min<size_t>(line.pv.size(), WIRE_MAX_PV));
+        std::copy_n(line.pv.begin(), wire.length, wire.pv.begin());
+    }
+    return reply;
+}
+
+/**
+ * Unpack a reply. Only the fields carried on the wire are set: per-iteration statistics stay empty
+ * @param reply as received from the engine
+ */
+SearchResult toResult(const SearchReply &reply)
+{
+    SearchResult result{};
+    result.bestMove = reply.bestMove;
+    result.score = reply.score;
+    result.depth = reply.depth;
+    result.stats.nodes = reply.nodes;
+    result.elapsedMs = reply.elapsedMs;
+    for (uint32_t i = 0; i < std::min<uint32_t>(reply.lineCount, WIRE_MAX_LINES); i++)
+    {
+        const WireLine &wire = reply.lines[i];
+        const auto length = static_cast<long>(std::min<uint32_t>(wire.length, WIRE_MAX_PV));
+        result.lines.push_back(PvLine{wire.score, std::vector<Move>(wire.pv.begin(), wire.pv.begin() + length)});
+    }
+    if (!result.lines.empty())
+    {
+        result.pv = result.lines.front().pv;
+    }
+    return result;
+}
+
+/**
+ * Engine side: answer search requests on the named channel until told to quit, or until the client
+ * stops beating for ENGINE_ORPHAN_MS (it crashed or was killed: nobody is left to read the replies)
+ * @param name channel created by the client
+ * @return process exit code
+ */
+int serveEngineChannel(const std::string &name)
+{
+    SharedChannel channel;
+    if (!channel.open(name))
+    {
+        return EXIT_FAILURE;
+    }
+    TranspositionTable tt;
+    Searcher searcher;
+    searcher.setTranspositionTable(&tt);
+    std::thread worker;
+    std::atomic_bool stopPending{false};  // a STOP may land before the search begins (search() clears its flag)
+    std::atomic<uint32_t> activeRequest{0}; // only the worker thread sends, so the ring keeps one producer
+    searcher.setOnIteration([&](const SearchResult &result) {
+        if (stopPending)
+        {
+            searcher.stop();
+            return;
+        }
+        channel.send(static_cast<uint16_t>(EngineMessage::ITERATION), toReply(activeRequest, result)); // may drop
+    });
+    const auto finishSearch = [&] {
+        stopPending = true;
+        searcher.stop();
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    };
+
+    uint64_t lastPeer = channel.peerHeartbeat();
+    int64_t lastPeerMs = nowMs();
+    ChannelMessage message;
+    while (true)
+    {
+        channel.beat();
+        if (channel.receive(message))
+        {
+            switch (static_cast<EngineMessage>(message.type))
+            {
+            case EngineMessage::SEARCH: {
+                finishSearch();
+                const auto request = message.as<SearchRequest>();
+                stopPending = false;
+                activeRequest = request.requestId;
+                SearchLimits limits{};
+                limits.maxDepth = std::clamp(request.maxDepth, 1, MAX_PLY - 1);
+                limits.multiPv = std::clamp(request.multiPv, 1, WIRE_MAX_LINES);
+                limits.maxNodes = request.maxNodes;
+                limits.moveTimeMs = request.moveTimeMs;
+                worker = std::thread([&searcher, &channel, request, limits] {
+                    const SearchResult result = searcher.search(request.pos, limits);
+                    if (!sendPatiently(channel, EngineMessage::RESULT, toReply(request.requestId, result)))
+                    {
+                        spdlog::warn("engine: client is not reading, result {} dropped", request.requestId);
+                    }
+                });
+                break;
+            }
+            case EngineMessage::STOP:
+                stopPending = true;
+                searcher.stop();
+                break;
+            case EngineMessage::QUIT:
+                finishSearch();
+                return EXIT_SUCCESS;
+            default:
+                spdlog::warn("engine: unknown message type {}", message.type);
+                break;
+            }
+            continue;
+        }
+        if (const uint64_t peer = channel.peerHeartbeat(); peer != lastPeer)
+        {
+            lastPeer = peer;
+            lastPeerMs = nowMs();
+        }
+        else if (nowMs() - lastPeerMs > ENGINE_ORPHAN_MS)
+        {
+            spdlog::warn("engine: client {} went away, exiting", name);
+            finishSearch();
+            return EXIT_FAILURE;
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+}
+
+/**
+ * Full path of the running executable, so a program can start a copy of itself as its engine
+ * @return path, or empty if the OS will not tell
+ */
+std::string currentExecutablePath()
+{
+#if defined(_WIN32)
+    std::string path(MAX_PATH, '\0');
+    const DWORD length = GetModuleFileNameA(nullptr, path.data(), static_cast<DWORD>(path.size()));
+    path.resize(length);
+    return path;
+#elif defined(__APPLE__)
+    uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size);
+    std::string path(size, '\0');
+    if (_NSGetExecutablePath(path.data(), &size) != 0)
+    {
+        return {};
+    }
+    path.resize(std::strlen(path.c_str()));
+    return path;
+#else
+    std::string path(4096, '\0');
+    const ssize_t length = readlink("/proc/self/exe", path.data(), path.size());
+    path.resize(length > 0 ? static_cast<size_t>(length) : 0);
+    return path;
+#endif
+}
+
+/**
+ * Custom constructor: starts the engine process right away, so the first search does not wait for it
+ * @param executable program that understands ENGINE_CHANNEL_FLAG (e.g. currentExecutablePath())
+ * @param extraArgs passed before the channel flag
+ */
+EngineProcess::EngineProcess(std::string executable, std::vector<std::string> extraArgs)
+    : executable(std::move(executable)), extraArgs(std::move(extraArgs))
+{
+    {
+        std::scoped_lock lock{this->mutex};
+        this->launch();
+    }
+    this->pumpThread = std::thread([this] { this->pump(); });
+}
+
+/**
+ * Ask the engine to quit, then make sure it is gone
+ */
+EngineProcess::~EngineProcess()
+{
+    this->quitting = true;
+    if (this->pumpThread.joinable())
+    {
+        this->pumpThread.join();
+    }
+    std::scoped_lock lock{this->mutex};
+    this->channel.send(static_cast<uint16_t>(EngineMessage::QUIT), nullptr, 0);
+    for (int i = 0; i < 100 && this->child != 0 && processAlive(this->child); i++)
+    {
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+    this->terminate();
+}
+
+/**
+ * Search `pos` in the engine process (replaces any running search). Returns immediately
+ * @param pos position to analyse
+ * @param limits when to stop
+ */
+void EngineProcess::start(const Position &pos, const SearchLimits &limits)
+{
+    std::scoped_lock lock{this->mutex};
+    this->pending = toRequest(this->nextRequestId++, pos, limits);
+    this->root = pos;
+    this->latest = std::nullopt;
+    if (this->child == 0)
+    {
+        this->failures = 0; // gave up earlier: a new search deserves a new attempt
+        this->launch();
+        return; // launch() sends the pending search
+    }
+    if (!sendPatiently(this->channel, EngineMessage::SEARCH, this->pending.value()))
+    {
+        spdlog::warn("engine process is not reading its channel");
+    }
+}
+
+/**
+ * Abort the engine's search; replies still in flight are ignored. The last one received stays available
+ */
+void EngineProcess::stop()
+{
+    std::scoped_lock lock{this->mutex};
+    if (!this->pending.has_value())
+    {
+        return;
+    }
+    this->pending = std::nullopt;
+    this->channel.send(static_cast<uint16_t>(EngineMessage::STOP), nullptr, 0);
+}
+
+/**
+ * Last reply from the engine, if its search is (or was) working on `pos`
+ * @param pos the position caller is interested in
+ */
+std::optional<SearchResult> EngineProcess::getLatest(const Position &pos) const
+{
+    std::scoped_lock lock{this->mutex};
+    if (this->root != pos)
+    {
+        return std::nullopt;
+    }
+    return this->latest;
+}
+
+/**
+ * Whether a search is in progress (including while a crashed engine is being restarted)
+ */
+bool EngineProcess::isSearching() const
+{
+    std::scoped_lock lock{this->mutex};
+    return this->pending.has_value();
+}
+
+/**
+ * Whether an engine process is currently attached
+ */
+bool EngineProcess::isRunning() const
+{
+    std::scoped_lock lock{this->mutex};
+    return this->child != 0;
+}
+
+/**
+ * How many times the engine process had to be restarted
+ */
+uint32_t EngineProcess::getRestarts() const
+{
+    std::scoped_lock lock{this->mutex};
+    return this->restarts;
+}
+
+/**
+ * Process id of the current engine (0 if none); on Windows, the process HANDLE
+ */
+int64_t EngineProcess::getProcessId() const
+{
+    std::scoped_lock lock{this->mutex};
+    return this->child;
+}
+
+/**
+ * Create a fresh channel and start an engine on it; re-sends the pending search. Caller holds the mutex
+ * @return TRUE if the process was started (else the pending search is dropped)
+ */
+bool EngineProcess::launch()
+{
+    if (!this->channel.create(makeChannelName()))
+    {
+        this->pending = std::nullopt;
+        return false;
+    }
+    std::vector<std::string> args = this->extraArgs;
+    args.emplace_back(ENGINE_CHANNEL_FLAG);
+    args.push_back(this->channel.getName());
+    this->child = spawnProcess(this->executable, args);
+    if (this->child == 0)
+    {
+        spdlog::error("cannot start engine process {}", this->executable);
+        this->channel.close();
+        this->pending = std::nullopt;
+        return false;
+    }
+    this->lastHeartbeat = 0;
+    this->lastHeartbeatMs = nowMs();
+    if (this->pending.has_value())
+    {
+        // the ring is empty and large: this cannot fail
+        this->channel.send(static_cast<uint16_t>(EngineMessage::SEARCH), this->pending.value());
+    }
+    return true;
+}
+
+/**
+ * Kill the engine (if any) and drop its channel. Caller holds the mutex
+ */
+void EngineProcess::terminate()
+{
+    if (this->child != 0)
+    {
+        killProcess(this->child);
+        this->child = 0;
+    }
+    this->channel.close();
+}
+
+/**
+ * Background loop: collect replies, keep our heartbeat going, and restart the engine if it dies or hangs
+ */
+void EngineProcess::pump()
+{
+    ChannelMessage message;
+    while (!this->quitting)
+    {
+        {
+            std::scoped_lock lock{this->mutex};
+            while (this->channel.receive(message))
+            {
+                const auto type = static_cast<EngineMessage>(message.type);
+                const auto reply = message.as<SearchReply>();
+                if (this->pending.has_value() && reply.requestId == this->pending->requestId)
+                {
+                    this->latest = toResult(reply);
+                    this->failures = 0;
+                    if (type == EngineMessage::RESULT)
+                    {
+                        this->pending = std::nullopt;
+                    }
+                }
+            }
+            this->channel.beat();
+            if (this->child != 0)
+            {
+                if (const uint64_t beat = this->channel.peerHeartbeat(); beat != this->lastHeartbeat)
+                {
+                    this->lastHeartbeat = beat;
+                    this->lastHeartbeatMs = nowMs();
+                }
+                const bool hung = nowMs() - this->lastHeartbeatMs > ENGINE_HANG_MS;
+                if (hung || !processAlive(this->child))
+                {
+                    spdlog::warn("engine process {}, restarting", hung ? "stopped responding" : "died");
+                    this->terminate();
+                    if (++this->failures > ENGINE_MAX_FAILURES)
+                    {
+                        spdlog::error("engine process keeps failing, giving up");
+                        this->pending = std::nullopt;
+                    }
+                    else
+                    {
+                        this->restarts++;
+                        this->launch();
+                    }
+                }
+            }
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+}
+
+} // namespace chk::engine
@@ -0,0 +1,126 @@
+// created 2026-10-18
+#pragma once
+
+#include "SearchRunner.hpp"
+#include "SharedChannel.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace chk::engine
+{
+// command-line flag that turns an executable into a channel engine: `<exe> --engine-channel NAME`
+constexpr const char *ENGINE_CHANNEL_FLAG{"--engine-channel"};
+constexpr int64_t ENGINE_HANG_MS{3000};   // no heartbeat for this long: engine process is restarted
+constexpr int64_t ENGINE_ORPHAN_MS{5000}; // no heartbeat from the client for this long: engine exits
+constexpr int ENGINE_MAX_FAILURES{3};     // restarts in a row without a single reply before giving up
+
+/**
+ * Message tags on the engine channel
+ */
+enum class EngineMessage : uint16_t
+{
+    SEARCH = 1, // client -> engine: SearchRequest (replaces any running search)
+    STOP,       // client -> engine: no payload
+    QUIT,       // client -> engine: no payload
+    ITERATION,  // engine -> client: SearchReply after each completed iteration
+    RESULT,     // engine -> client: SearchReply once the search is over
+};
+
+constexpr int WIRE_MAX_LINES{8};
+constexpr int WIRE_MAX_PV{24};
+
+/**
+ * Fixed-size search request, copied as-is into shared memory
+ */
+struct SearchRequest
+{
+    uint32_t requestId = 0;
+    int32_t maxDepth = 0;
+    int32_t multiPv = 1;
+    uint64_t maxNodes = 0;
+    int64_t moveTimeMs = 0;
+    Position pos{};
+};
+
+/**
+ * One ranked line of a reply (PV truncated to WIRE_MAX_PV moves)
+ */
+struct WireLine
+{
+    int32_t score = 0;
+    uint32_t length = 0;
+    std::array<Move, WIRE_MAX_PV> pv{};
+};
+
+/**
+ * Fixed-size search reply: the subset of SearchResult a client needs to play and display a move
+ */
+struct SearchReply
+{
+    uint32_t requestId = 0;
+    int32_t depth = 0;
+    uint64_t nodes = 0;
+    int64_t elapsedMs = 0;
+    Move bestMove = NULL_MOVE;
+    int32_t score = 0;
+    uint32_t lineCount = 0;
+    std::array<WireLine, WIRE_MAX_LINES> lines{};
+};
+
+[[nodiscard]] SearchRequest toRequest(uint32_t requestId, const Position &pos, const SearchLimits &limits);
+[[nodiscard]] SearchReply toReply(uint32_t requestId, const SearchResult &result);
+[[nodiscard]] SearchResult toResult(const SearchReply &reply);
+int serveEngineChannel(const std::string &name);
+[[nodiscard]] std::string currentExecutablePath();
+
+/**
+ * Runs the engine in a child process and talks to it over a SharedChannel.
+ * A crash, hang or runaway allocation in the engine cannot take the client down: the child is
+ * watched, and if it dies (or stops answering) it is restarted on a fresh channel and the
+ * current search is sent again, so a game in progress only sees a short delay.
+ */
+class EngineProcess final : public SearchRunner
+{
+  public:
+    explicit EngineProcess(std::string executable, std::vector<std::string> extraArgs = {});
+    ~EngineProcess() override;
+    EngineProcess(const EngineProcess &) = delete;
+    EngineProcess &operator=(const EngineProcess &) = delete;
+    void start(const Position &pos, const SearchLimits &limits) override;
+    void stop() override;
+    [[nodiscard]] std::optional<SearchResult> getLatest(const Position &pos) const override;
+    [[nodiscard]] bool isSearching() const override;
+    [[nodiscard]] bool isRunning() const;
+    [[nodiscard]] uint32_t getRestarts() const;
+    [[nodiscard]] int64_t getProcessId() const;
+
+  private:
+    std::string executable;
+    std::vector<std::string> extraArgs; // before ENGINE_CHANNEL_FLAG, e.g. to pick a mode of a test binary
+    std::thread pumpThread;
+    std::atomic_bool quitting{false};
+
+    mutable std::mutex mutex;                // guards everything below
+    SharedChannel channel;                   // to the current child
+    int64_t child = 0;                       // pid (POSIX) or process HANDLE (Windows); 0 = none
+    uint64_t lastHeartbeat = 0;              // child's counter when last seen changing...
+    int64_t lastHeartbeatMs = 0;             // ...and when that was (steady clock)
+    std::optional<SearchRequest> pending{};  // search in progress: re-sent after a restart
+    std::optional<Position> root{};          // position of the latest search
+    std::optional<SearchResult> latest{};    // last reply for `root`
+    uint32_t nextRequestId = 1;
+    uint32_t restarts = 0;
+    int failures = 0; // restarts since the last reply
+
+    bool launch();
+    void terminate();
+    void pump();
+};
+
+} // namespace chk::engine
@@ -0,0 +1,89 @@
+// created 2026-10-18
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace chk::engine
+{
+/**
+ * Counters collected while the engine is running. Shared by all search threads, so every
+ * field is a relaxed atomic: values are only read for reporting, never for decisions.
+ */
+struct EngineStats
+{
+    std::atomic<uint64_t> tbProbes{0};      // tablebase lookups attempted
+    std::atomic<uint64_t> tbHits{0};        // lookups that returned a result
+    std::atomic<uint64_t> tbCacheHits{0};   // result block was already decompressed
+    std::atomic<uint64_t> tbCacheMisses{0}; // result block had to be decompressed
+
+    /**
+     * Fraction of tablebase block lookups served from cache
+     * @return value in [0, 1], or 0 if nothing probed yet
+     */
+    double tbCacheHitRate() const
+    {
+        const uint64_t hits = tbCacheHits.load(std::memory_order_relaxed);
+        const uint64_t total = hits + tbCacheMisses.load(std::memory_order_relaxed);
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+
+    /**
+     * Set all counters back to zero
+     */
+    void reset()
+    {
+        tbProbes.store(0, std::memory_order_relaxed);
+        tbHits.store(0, std::memory_order_relaxed);
+        tbCacheHits.store(0, std::memory_order_relaxed);
+        tbCacheMisses.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Counters of a single search, owned by one thread (plain integers, no synchronisation).
+ * Cache-line aligned, so the counters of searchers running side by side never share a line,
+ * nor does the line a searcher writes every node share with fields other threads write (stop flag)
+ */
+struct alignas(64) SearchStats
+{
+    uint64_t nodes = 0;            // all nodes visited, including quiescence
+    uint64_t qNodes = 0;           // nodes added by quiescence (capture chains past the depth limit)
+    uint64_t qDepthLimitHits = 0;  // quiescence stopped by `qsMaxPlies` with captures still pending
+    uint64_t qDeltaPrunes = 0;     // capture chains skipped by the stand-pat margin
+    int qMaxPlyReached = 0;        // deepest quiescence extension seen
+    uint64_t tbHits = 0;           // tablebase results used by this search
+    uint64_t ttProbes = 0;         // transposition table lookups
+    uint64_t ttHits = 0;           // lookups that found the position
+    uint64_t ttCutoffs = 0;        // hits whose bound settled the node without searching it
+    uint64_t betaCutoffs = 0;      // full-width nodes that failed high
+    uint64_t firstMoveCutoffs = 0; // ... on the first move searched (high share: good move ordering)
+
+    /**
+     * Share of nodes spent in quiescence
+     * @return value in [0, 1]
+     */
+    double qNodeRatio() const
+    {
+        return nodes == 0 ? 0.0 : static_cast<double>(qNodes) / static_cast<double>(nodes);
+    }
+
+    /**
+     * Share of fail-highs caused by the first move searched
+     * @return value in [0, 1]
+     */
+    double firstMoveCutoffRate() const
+    {
+        return betaCutoffs == 0 ? 0.0 : static_cast<double>(firstMoveCutoffs) / static_cast<double>(betaCutoffs);
+    }
+};
+
+/**
+ * Shorthand for relaxed increment of a counter
+ */
+inline void bump(std::atomic<uint64_t> &counter, const uint64_t amount = 1)
+{
+    counter.fetch_add(amount, std::memory_order_relaxed);
+}
+
+} // namespace chk::engine
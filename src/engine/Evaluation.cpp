@@ -0,0 +1,162 @@
+#include "Evaluation.hpp"
+#include "Endgame.hpp"
+#include <cstring>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr Bitboard CENTER{0x00666600u}; // cells 10,11,14,15,18,19,22,23
+constexpr size_t WEIGHTS_HEADER_SIZE{8}; // magic, version, term count
+constexpr size_t WEIGHTS_FILE_SIZE{WEIGHTS_HEADER_SIZE + NUM_EVAL_TERMS * sizeof(int32_t)};
+
+constexpr Bitboard buildEdgeMask()
+{
+    Bitboard mask = 0;
+    for (int sq = 0; sq < NUM_SQUARES; sq++)
+    {
+        if (colOf(sq) == 0 || colOf(sq) == 7)
+        {
+            mask |= bitOf(sq);
+        }
+    }
+    return mask;
+}
+
+constexpr Bitboard EDGE = buildEdgeMask();
+
+// weights used by evaluate(pos); replaced only at startup, before any search runs
+EvalWeights activeWeights{};
+
+/**
+ * Add (sign +1) or subtract (sign -1) one side's term counts
+ */
+void addSideFeatures(const Position &pos, const Side side, const int sign, EvalFeatures &features)
+{
+    const Bitboard mine = pos.piecesOf(side);
+    const Bitboard men = mine & ~pos.kings;
+    const Bitboard backRow = side == Side::RED ? BLACK_CROWN_ROW : RED_CROWN_ROW;
+
+    int advance = 0;
+    Bitboard bb = men;
+    while (bb != 0)
+    {
+        const int row = rowOf(popLowest(bb));
+        advance += side == Side::RED ? 7 - row : row;
+    }
+    features[TERM_MAN] += static_cast<int16_t>(sign * popCount(men));
+    features[TERM_KING] += static_cast<int16_t>(sign * popCount(mine & pos.kings));
+    features[TERM_BACK_ROW] += static_cast<int16_t>(sign * popCount(men & backRow));
+    features[TERM_ADVANCE] += static_cast<int16_t>(sign * advance);
+    features[TERM_CENTER] += static_cast<int16_t>(sign * popCount(mine & CENTER));
+    features[TERM_EDGE] += static_cast<int16_t>(sign * popCount(mine & EDGE));
+}
+} // namespace
+
+/**
+ * Term counts of a position, RED minus BLACK (so evaluation is their dot product with the weights)
+ */
+EvalFeatures extractFeatures(const Position &pos)
+{
+    EvalFeatures features{};
+    addSideFeatures(pos, Side::RED, +1, features);
+    addSideFeatures(pos, Side::BLACK, -1, features);
+    return features;
+}
+
+/**
+ * Static evaluation, from the point of view of the side to move (positive is good for the mover)
+ * @param pos the position
+ * @return score in centi-men
+ */
+int evaluate(const Position &pos)
+{
+    return evaluate(pos, activeWeights);
+}
+
+/**
+ * Static evaluation with the given weights, from the point of view of the side to move. Known
+ * endings (see Endgame.hpp) refine the weighted terms, so there it is no longer their plain sum
+ * @param pos the position
+ * @param weights term weights
+ * @return score in centi-men
+ */
+int evaluate(const Position &pos, const EvalWeights &weights)
+{
+    const EndgameKind kind = endgameKind(pos);
+    const EvalFeatures features = extractFeatures(pos);
+    int red = 0;
+    for (int term = 0; term < NUM_EVAL_TERMS; term++)
+    {
+        red += features[term] * weights.values[term];
+    }
+    const int generic = pos.sideToMove == Side::RED ? red : -red;
+    return kind == EndgameKind::NONE ? generic : evaluateEndgame(kind, pos, generic);
+}
+
+/**
+ * Replace the weights used by evaluate(pos). NOT thread-safe: call at startup, before searching
+ */
+void setEvalWeights(const EvalWeights &weights)
+{
+    activeWeights = weights;
+}
+
+const EvalWeights &getEvalWeights()
+{
+    return activeWeights;
+}
+
+/**
+ * Read a weights file written by saveEvalWeights (e.g. by the tuner)
+ * @param path location of weights file
+ * @return the weights, or std::nullopt if file is missing or invalid
+ */
+std::optional<EvalWeights> loadEvalWeights(const std::string &path)
+{
+    std::ifstream in{path, std::ios::binary};
+    uint8_t bytes[WEIGHTS_FILE_SIZE];
+    if (!in.read(reinterpret_cast<char *>(bytes), WEIGHTS_FILE_SIZE) || in.peek() != EOF)
+    {
+        spdlog::error("cannot load eval weights from {}", path);
+        return std::nullopt;
+    }
+    uint32_t magic = 0;
+    uint16_t version = 0, terms = 0;
+    std::memcpy(&magic, bytes, sizeof(magic));
+    std::memcpy(&version, bytes + 4, sizeof(version));
+    std::memcpy(&terms, bytes + 6, sizeof(terms));
+    if (magic != EVAL_WEIGHTS_MAGIC || version != EVAL_WEIGHTS_VERSION || terms != NUM_EVAL_TERMS)
+    {
+        spdlog::error("{} is not a valid eval weights file", path);
+        return std::nullopt;
+    }
+    EvalWeights weights;
+    std::memcpy(weights.values.data(), bytes + WEIGHTS_HEADER_SIZE, NUM_EVAL_TERMS * sizeof(int32_t));
+    return weights;
+}
+
+/**
+ * Write weights to disk, in the format loadEvalWeights expects
+ * @param weights the weights
+ * @param path destination
+ * @return TRUE if successful, else FALSE
+ */
+bool saveEvalWeights(const EvalWeights &weights, const std::string &path)
+{
+    uint8_t bytes[WEIGHTS_FILE_SIZE];
+    const uint16_t version = EVAL_WEIGHTS_VERSION;
+    const uint16_t terms = NUM_EVAL_TERMS;
+    std::memcpy(bytes, &EVAL_WEIGHTS_MAGIC, sizeof(EVAL_WEIGHTS_MAGIC));
+    std::memcpy(bytes + 4, &version, sizeof(version));
+    std::memcpy(bytes + 6, &terms, sizeof(terms));
+    std::memcpy(bytes + WEIGHTS_HEADER_SIZE, weights.values.data(), NUM_EVAL_TERMS * sizeof(int32_t));
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char *>(bytes), WEIGHTS_FILE_SIZE);
+    return static_cast<bool>(out);
+}
+
+} // namespace chk::engine
@@ -0,0 +1,55 @@
+// created 2026-10-18
+#pragma once
+
+#include "Position.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace chk::engine
+{
+constexpr int MAN_VALUE{100};
+constexpr int KING_VALUE{150};
+constexpr uint32_t EVAL_WEIGHTS_MAGIC{0x57454353}; // "SCEW" in little-endian
+constexpr uint16_t EVAL_WEIGHTS_VERSION{1};
+constexpr auto EVAL_WEIGHTS_FILE = "eval.weights";  // loaded at startup, if present
+
+/**
+ * Terms of the hand-written evaluation. Each is a count (RED minus BLACK) times a weight
+ */
+enum EvalTerm : uint8_t
+{
+    TERM_MAN = 0,  // men on board
+    TERM_KING,     // kings on board
+    TERM_BACK_ROW, // men guarding own back row (delay enemy kings)
+    TERM_ADVANCE,  // rows travelled, summed over men
+    TERM_CENTER,   // pieces in the 8 central cells
+    TERM_EDGE,     // pieces on the side columns
+    NUM_EVAL_TERMS,
+};
+
+using EvalFeatures = std::array<int16_t, NUM_EVAL_TERMS>;
+
+/**
+ * Weight of each evaluation term, in centi-men
+ */
+struct EvalWeights
+{
+    std::array<int32_t, NUM_EVAL_TERMS> values{MAN_VALUE, KING_VALUE, 8, 3, 4, 0};
+
+    bool operator==(const EvalWeights &other) const
+    {
+        return values == other.values;
+    }
+};
+
+[[nodiscard]] EvalFeatures extractFeatures(const Position &pos);
+[[nodiscard]] int evaluate(const Position &pos);
+[[nodiscard]] int evaluate(const Position &pos, const EvalWeights &weights);
+void setEvalWeights(const EvalWeights &weights);
+[[nodiscard]] const EvalWeights &getEvalWeights();
+[[nodiscard]] std::optional<EvalWeights> loadEvalWeights(const std::string &path);
+[[nodiscard]] bool saveEvalWeights(const EvalWeights &weights, const std::string &path);
+
+} // namespace chk::engine
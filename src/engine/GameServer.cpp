@@ -0,0 +1,243 @@
+#include "GameServer.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace chk::engine
+{
+
+namespace
+{
+/**
+ * Heap order for the queue: the earliest deadline on top
+ */
+template <typename JobT> bool laterDeadline(const JobT &a, const JobT &b)
+{
+    return a.deadline > b.deadline;
+}
+} // namespace
+
+/**
+ * Custom constructor: allocates the shared table and starts the workers
+ * @param config pool size, table size and time limits
+ * @param onReply receives every move found (from a worker thread; must be thread-safe)
+ */
+GameServer::GameServer(const ServerConfig &config, ReplyCallback onReply)
+    : config(config), onReply(std::move(onReply)), tt(config.hashMegabytes)
+{
+    int count = this->config.workers;
+    if (count <= 0)
+    {
+        count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    this->slots.resize(static_cast<size_t>(count));
+    for (int i = 0; i < count; i++)
+    {
+        auto searcher = std::make_unique<Searcher>();
+        searcher->setTranspositionTable(&this->tt, false); // the server ages the table, see workerLoop
+        Searcher *raw = searcher.get();
+        searcher->setOnIteration([this, raw, i](const SearchResult &) {
+            std::scoped_lock lock{this->mutex};
+            if (this->slots[i].discard || this->quitting)
+            {
+                raw->stop(); // stop() may have landed just before this search began
+            }
+        });
+        this->searchers.push_back(std::move(searcher));
+    }
+    for (int i = 0; i < count; i++)
+    {
+        this->workers.emplace_back([this, i] { this->workerLoop(i); });
+    }
+}
+
+/**
+ * Stop every search and wait for the workers. Queued requests get no reply
+ */
+GameServer::~GameServer()
+{
+    {
+        std::scoped_lock lock{this->mutex};
+        this->quitting = true;
+        this->metrics.cancelled += this->queue.size();
+        this->queue.clear();
+    }
+    this->wakeUp.notify_all();
+    for (auto &searcher : this->searchers)
+    {
+        searcher->stop();
+    }
+    for (std::thread &worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * Queue a move request. A request still pending for the same game is replaced (its position is stale)
+ * @param request game, position and clock
+ */
+void GameServer::submit(const MoveRequest &request)
+{
+    const auto now = Clock::now();
+    {
+        std::scoped_lock lock{this->mutex};
+        if (this->quitting)
+        {
+            return;
+        }
+        this->dropGame(request.gameId);
+        this->queue.push_back(Job{request, now, now + std::chrono::milliseconds(this->budgetFor(request))});
+        std::push_heap(this->queue.begin(), this->queue.end(), laterDeadline<Job>);
+        this->metrics.peakQueued = std::max(this->metrics.peakQueued, this->queue.size());
+    }
+    this->wakeUp.notify_one();
+}
+
+/**
+ * Forget a game's pending request (e.g. the game ended or the player left): no reply will be sent
+ * @param gameId the game
+ */
+void GameServer::cancel(const uint64_t gameId)
+{
+    std::scoped_lock lock{this->mutex};
+    this->dropGame(gameId);
+}
+
+/**
+ * Snapshot of the counters, with latency percentiles over the last SERVER_LATENCY_SAMPLES moves
+ */
+ServerMetrics GameServer::getMetrics() const
+{
+    std::vector<int64_t> samples;
+    ServerMetrics snapshot;
+    {
+        std::scoped_lock lock{this->mutex};
+        snapshot = this->metrics;
+        snapshot.queued = this->queue.size();
+        const auto filled = static_cast<size_t>(std::min<uint64_t>(snapshot.completed, SERVER_LATENCY_SAMPLES));
+        samples.assign(this->latencies.begin(), this->latencies.begin() + static_cast<long>(filled));
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - this->startTime).count();
+    snapshot.movesPerSecond = seconds > 0.0 ? static_cast<double>(snapshot.completed) / seconds : 0.0;
+    if (!samples.empty())
+    {
+        const auto percentile = [&samples](const size_t permille) {
+            const size_t idx = std::min(samples.size() - 1, samples.size() * permille / 1000);
+            std::nth_element(samples.begin(), samples.begin() + static_cast<long>(idx), samples.end());
+            return samples[idx];
+        };
+        snapshot.p50Ms = percentile(500);
+        snapshot.p99Ms = percentile(990);
+        snapshot.maxMs = *std::max_element(samples.begin(), samples.end());
+    }
+    return snapshot;
+}
+
+int GameServer::getWorkerCount() const
+{
+    return static_cast<int>(this->workers.size());
+}
+
+/**
+ * Time a game may spend on this move, queueing included: an even share of its clock plus most of
+ * the increment, within [minMoveMs, maxMoveMs], and never more than half of what is left
+ * @param request the move request
+ * @return milliseconds from submit to deadline
+ */
+int64_t GameServer::budgetFor(const MoveRequest &request) const
+{
+    if (request.remainingMs <= 0)
+    {
+        return this->config.maxMoveMs;
+    }
+    const int64_t share = request.remainingMs / SERVER_MOVES_TO_GO + request.incrementMs * 3 / 4;
+    const int64_t budget = std::clamp(share, this->config.minMoveMs, this->config.maxMoveMs);
+    return std::max<int64_t>(1, std::min(budget, request.remainingMs / 2));
+}
+
+/**
+ * One worker: take the request with the earliest deadline, think until just before it, reply
+ * @param index worker number (its searcher and slot)
+ */
+void GameServer::workerLoop(const int index)
+{
+    Searcher &searcher = *this->searchers[index];
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock lock{this->mutex};
+            this->wakeUp.wait(lock, [this] { return this->quitting || !this->queue.empty(); });
+            if (this->quitting)
+            {
+                return;
+            }
+            std::pop_heap(this->queue.begin(), this->queue.end(), laterDeadline<Job>);
+            job = this->queue.back();
+            this->queue.pop_back();
+            this->slots[index] = Slot{true, job.request.gameId, false};
+        }
+
+        // whatever the queue left of the budget; past the deadline already, a depth-1 search still answers
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(job.deadline - Clock::now()).count() -
+                          this->config.safetyMs;
+        SearchLimits limits{};
+        if (left > 0)
+        {
+            limits.moveTimeMs = left;
+        }
+        else
+        {
+            limits.maxDepth = 1;
+        }
+        const SearchResult result = searcher.search(job.request.pos, limits);
+
+        const auto done = Clock::now();
+        bool discard = false;
+        {
+            std::scoped_lock lock{this->mutex};
+            discard = this->slots[index].discard || this->quitting;
+            this->slots[index] = Slot{};
+            if (discard)
+            {
+                continue;
+            }
+            const auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(done - job.submitted).count();
+            this->latencies[this->metrics.completed % SERVER_LATENCY_SAMPLES] = latency;
+            this->metrics.completed++;
+            this->metrics.deadlineMisses += done > job.deadline ? 1 : 0;
+            if (done - this->lastAging >= std::chrono::milliseconds(this->config.tableAgingMs))
+            {
+                this->tt.newSearch(); // by the clock: entries age as fast however many games run
+                this->lastAging = done;
+            }
+        }
+        this->onReply(job.request, result);
+    }
+}
+
+/**
+ * Remove a game's queued request, and abandon its running search. Caller holds the mutex
+ */
+void GameServer::dropGame(const uint64_t gameId)
+{
+    const auto queued = std::find_if(this->queue.begin(), this->queue.end(),
+                                     [gameId](const Job &job) { return job.request.gameId == gameId; });
+    if (queued != this->queue.end())
+    {
+        this->queue.erase(queued);
+        std::make_heap(this->queue.begin(), this->queue.end(), laterDeadline<Job>);
+        this->metrics.cancelled++;
+    }
+    for (size_t i = 0; i < this->slots.size(); i++)
+    {
+        if (this->slots[i].busy && this->slots[i].gameId == gameId && !this->slots[i].discard)
+        {
+            this->slots[i].discard = true;
+            this->searchers[i]->stop();
+            this->metrics.cancelled++;
+        }
+    }
+}
+
+} // namespace chk::engine
@@ -0,0 +1,128 @@
+// created 2026-10-18
+#pragma once
+
+#include "Search.hpp"
+#include "TranspositionTable.hpp"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chk::engine
+{
+constexpr int SERVER_MOVES_TO_GO{30};         // a game's remaining clock is spread over this many moves
+constexpr size_t SERVER_LATENCY_SAMPLES{4096}; // latest moves kept for percentiles
+
+/**
+ * How the server splits its machine and each game's clock
+ */
+struct ServerConfig
+{
+    int workers = 0;             // search threads (0 = one per hardware thread)
+    size_t hashMegabytes = 256;  // one table, shared by every game
+    int64_t minMoveMs = 5;       // never answer faster than this (unless the clock says otherwise)
+    int64_t maxMoveMs = 2000;    // never think longer than this, however much clock is left
+    int64_t safetyMs = 5;        // kept back from every deadline for scheduling and reply overhead
+    int64_t tableAgingMs = 1000; // the shared table ages one generation per this much time, however many games run
+};
+
+/**
+ * One move to find: a game's position and what is left on its clock
+ */
+struct MoveRequest
+{
+    uint64_t gameId = 0;
+    Position pos{};
+    int64_t remainingMs = 0; // on the engine's clock in this game (0 = untimed: maxMoveMs)
+    int64_t incrementMs = 0; // added after each move
+};
+
+/**
+ * Server health since start: throughput, and latency (request to reply) over the latest moves
+ */
+struct ServerMetrics
+{
+    uint64_t completed = 0;      // moves answered
+    uint64_t cancelled = 0;      // requests dropped (replaced by a newer position, or cancel())
+    uint64_t deadlineMisses = 0; // answered after their deadline
+    double movesPerSecond = 0.0; // completed / time since start
+    int64_t p50Ms = 0;
+    int64_t p99Ms = 0;
+    int64_t maxMs = 0;
+    size_t queued = 0;     // waiting for a worker right now
+    size_t peakQueued = 0; // most ever waiting at once
+};
+
+/**
+ * Headless engine for many games at once: requests from any number of games go into one queue,
+ * ordered by deadline (earliest first), and a fixed pool of workers serves them.
+ * Each request's deadline comes from its game's clock, so a game never waits past its own budget:
+ * under load a request spends its time queued rather than thinking, and still answers on time.
+ * All workers share one transposition table. The server ages it on a clock, not per search, so
+ * entries last as long under load as when one game is played.
+ */
+class GameServer final
+{
+  public:
+    // called on a worker thread when a move has been found for `request`
+    using ReplyCallback = std::function<void(const MoveRequest &request, const SearchResult &result)>;
+
+    explicit GameServer(const ServerConfig &config, ReplyCallback onReply);
+    ~GameServer();
+    GameServer(const GameServer &) = delete;
+    GameServer &operator=(const GameServer &) = delete;
+    void submit(const MoveRequest &request);
+    void cancel(uint64_t gameId);
+    [[nodiscard]] ServerMetrics getMetrics() const;
+    [[nodiscard]] int getWorkerCount() const;
+    [[nodiscard]] int64_t budgetFor(const MoveRequest &request) const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * A queued request, with its deadline fixed at submit time
+     */
+    struct Job
+    {
+        MoveRequest request;
+        Clock::time_point submitted;
+        Clock::time_point deadline;
+    };
+
+    ServerConfig config;
+    ReplyCallback onReply;
+    TranspositionTable tt;
+    std::vector<std::unique_ptr<Searcher>> searchers; // one per worker
+    std::vector<std::thread> workers;
+    Clock::time_point startTime = Clock::now();
+    Clock::time_point lastAging = startTime; // guarded by mutex
+
+    /**
+     * What a worker is doing
+     */
+    struct Slot
+    {
+        bool busy = false;
+        uint64_t gameId = 0;  // game being searched, if busy
+        bool discard = false; // its request was replaced or cancelled: stop, and send no reply
+    };
+
+    mutable std::mutex mutex; // guards everything below
+    std::condition_variable wakeUp;
+    bool quitting = false;
+    std::vector<Job> queue{};  // min-heap on deadline
+    std::vector<Slot> slots{}; // per worker
+    std::array<int64_t, SERVER_LATENCY_SAMPLES> latencies{};
+    ServerMetrics metrics{};
+
+    void workerLoop(int index);
+    void dropGame(uint64_t gameId);
+};
+
+} // namespace chk::engine
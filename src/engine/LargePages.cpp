@@ -0,0 +1,192 @@
+#include "LargePages.hpp"
+#include <cerrno>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace chk::engine
+{
+
+namespace
+{
+size_t roundUp(const size_t value, const size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+} // namespace
+
+const char *pageKindName(const PageKind kind)
+{
+    switch (kind)
+    {
+    case PageKind::TRANSPARENT_HUGE:
+        return "transparent huge";
+    case PageKind::EXPLICIT_HUGE:
+        return "explicit huge";
+    default:
+        return "normal";
+    }
+}
+
+LargeBuffer::~LargeBuffer()
+{
+    this->release();
+}
+
+/**
+ * Get zero-filled memory from the OS, on huge pages if asked and possible (explicit huge pages
+ * first, then transparent ones). When huge pages are refused, normal pages are used and the
+ * reason is logged. Any previous block is released first.
+ * @param bytes size wanted
+ * @param tryHugePages FALSE to use normal pages only, THP opted out (huge pages are never tried below 2 MiB)
+ * @return TRUE if successful, else FALSE (out of memory)
+ */
+bool LargeBuffer::allocate(const size_t bytes, const bool tryHugePages)
+{
+    this->release();
+    const bool wantHuge = tryHugePages && bytes >= HUGE_PAGE_SIZE;
+    [[maybe_unused]] const size_t hugeBytes = roundUp(bytes, HUGE_PAGE_SIZE);
+    std::string refusal = wantHuge ? "not supported on this platform" : "";
+#if defined(_WIN32)
+    if (wantHuge)
+    {
+        const size_t largePage = GetLargePageMinimum();
+        void *ptr = largePage == 0 ? nullptr
+                                   : VirtualAlloc(nullptr, roundUp(bytes, largePage),
+                                                  MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (ptr != nullptr)
+        {
+            this->mapping = this->base = ptr;
+            this->length = this->mappedLength = roundUp(bytes, largePage);
+            this->kind = PageKind::EXPLICIT_HUGE;
+        }
+        else
+        {
+            refusal = "MEM_LARGE_PAGES needs the 'Lock pages in memory' privilege (error " +
+                      std::to_string(GetLastError()) + ")";
+        }
+    }
+    if (this->base == nullptr)
+    {
+        this->mapping = this->base = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        this->length = this->mappedLength = bytes;
+    }
+#else
+#if defined(MAP_HUGETLB)
+    if (wantHuge)
+    {
+        void *ptr = mmap(nullptr, hugeBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED)
+        {
+            this->mapping = this->base = ptr;
+            this->length = this->mappedLength = hugeBytes;
+            this->kind = PageKind::EXPLICIT_HUGE;
+        }
+        else
+        {
+            refusal = std::string{"no reserved huge pages, MAP_HUGETLB: "} + std::strerror(errno);
+        }
+    }
+#endif
+#if defined(MADV_HUGEPAGE)
+    if (wantHuge && this->base == nullptr)
+    {
+        // over-allocate by one huge page, so the usable block can start on a 2 MiB boundary
+        const size_t mapped = hugeBytes + HUGE_PAGE_SIZE;
+        void *ptr = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr != MAP_FAILED)
+        {
+            auto *aligned = reinterpret_cast<void *>(roundUp(reinterpret_cast<uintptr_t>(ptr), HUGE_PAGE_SIZE));
+            this->mapping = ptr;
+            this->mappedLength = mapped;
+            this->base = aligned;
+            this->length = hugeBytes;
+            if (madvise(aligned, hugeBytes, MADV_HUGEPAGE) == 0)
+            {
+                this->kind = PageKind::TRANSPARENT_HUGE;
+            }
+            else
+            {
+                refusal = std::string{"madvise(MADV_HUGEPAGE) failed: "} + std::strerror(errno);
+            }
+        }
+    }
+#endif
+    if (this->base == nullptr)
+    {
+        void *ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr != MAP_FAILED)
+        {
+            this->mapping = this->base = ptr;
+            this->length = this->mappedLength = bytes;
+#if defined(MADV_NOHUGEPAGE)
+            if (!tryHugePages)
+            {
+                // with THP set to "always" the kernel would back this with huge pages anyway, and a
+                // normal-page baseline that silently gets them measures nothing
+                madvise(ptr, bytes, MADV_NOHUGEPAGE);
+            }
+#endif
+        }
+    }
+#endif
+    if (this->base == nullptr)
+    {
+        spdlog::error("cannot allocate {} MB", bytes >> 20);
+        this->release();
+        return false;
+    }
+    if (wantHuge && this->kind == PageKind::NORMAL)
+    {
+        spdlog::warn("huge pages unavailable for {} MB table ({}), using normal pages", bytes >> 20, refusal);
+    }
+    else if (wantHuge)
+    {
+        spdlog::info("{} MB table on {} pages", bytes >> 20, pageKindName(this->kind));
+    }
+    return true;
+}
+
+/**
+ * Give the memory back to the OS
+ */
+void LargeBuffer::release()
+{
+    if (this->mapping != nullptr)
+    {
+#if defined(_WIN32)
+        VirtualFree(this->mapping, 0, MEM_RELEASE);
+#else
+        munmap(this->mapping, this->mappedLength);
+#endif
+    }
+    this->mapping = this->base = nullptr;
+    this->length = this->mappedLength = 0;
+    this->kind = PageKind::NORMAL;
+}
+
+void *LargeBuffer::data() const
+{
+    return this->base;
+}
+
+size_t LargeBuffer::size() const
+{
+    return this->length;
+}
+
+PageKind LargeBuffer::getKind() const
+{
+    return this->kind;
+}
+
+} // namespace chk::engine
@@ -0,0 +1,50 @@
+// created 2026-10-18
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chk::engine
+{
+constexpr size_t HUGE_PAGE_SIZE{2 * 1024 * 1024};
+
+/**
+ * What kind of pages back a LargeBuffer
+ */
+enum class PageKind : uint8_t
+{
+    NORMAL = 0,
+    TRANSPARENT_HUGE, // Linux THP, requested with madvise(MADV_HUGEPAGE)
+    EXPLICIT_HUGE,    // reserved huge pages: MAP_HUGETLB (Linux) or MEM_LARGE_PAGES (Windows)
+};
+
+[[nodiscard]] const char *pageKindName(PageKind kind);
+
+/**
+ * Big zero-filled block of memory for engine tables, taken straight from the OS (RAII). With huge pages,
+ * one TLB entry covers 2 MiB instead of 4 KiB, which matters for random probes into gigabyte tables.
+ * Pages are not touched here: the first thread to write a page decides its NUMA node, so callers
+ * should initialise the buffer from the threads that will use it.
+ */
+class LargeBuffer final
+{
+  public:
+    LargeBuffer() = default;
+    ~LargeBuffer();
+    LargeBuffer(const LargeBuffer &) = delete;
+    LargeBuffer &operator=(const LargeBuffer &) = delete;
+    [[nodiscard]] bool allocate(size_t bytes, bool tryHugePages);
+    void release();
+    [[nodiscard]] void *data() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] PageKind getKind() const;
+
+  private:
+    void *base = nullptr;    // start of usable region (huge-page aligned if huge)
+    void *mapping = nullptr; // what the OS returned
+    size_t length = 0;       // bytes usable from `base`
+    size_t mappedLength = 0; // bytes to give back
+    PageKind kind = PageKind::NORMAL;
+};
+
+} // namespace chk::engine
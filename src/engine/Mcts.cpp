@@ -0,0 +1,519 @@
+#include "Mcts.hpp"
+#include "Evaluation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr uint32_t WIN{2}; // playout results, in half-points
+constexpr uint32_t DRAW{1};
+constexpr uint32_t LOSS{0};
+constexpr int GREEDY_RANDOM_ONE_IN{8}; // greedy playouts still play a random move this often
+constexpr double MIN_REPORTED_WIN_RATE{0.001}; // keeps converted scores finite, and clear of mate scores
+} // namespace
+
+/**
+ * Express a win rate on the evaluation's scale, through the logistic curve sigmoid(score / 400)
+ * @param winRate expected score in [0, 1]
+ * @return score in points for the side to move
+ */
+int winRateToScore(const double winRate)
+{
+    const double rate = std::clamp(winRate, MIN_REPORTED_WIN_RATE, 1.0 - MIN_REPORTED_WIN_RATE);
+    return static_cast<int>(std::lround(400.0 * std::log10(rate / (1.0 - rate))));
+}
+
+/**
+ * Present an MCTS verdict like an alpha-beta one, for code that shows or plays either: one line (the most
+ * visited one), scored from its win rate, with playouts as nodes and the line's length as depth
+ * @param result MCTS outcome
+ * @return the same, as a search result
+ */
+SearchResult toSearchResult(const MctsResult &result)
+{
+    SearchResult converted;
+    converted.bestMove = result.bestMove;
+    converted.elapsedMs = result.elapsedMs;
+    converted.stats.nodes = result.playouts;
+    if (result.bestMove == NULL_MOVE)
+    {
+        converted.score = -SCORE_WIN; // no legal move
+        return converted;
+    }
+    converted.score = winRateToScore(result.winRate);
+    converted.depth = static_cast<int>(result.pv.size());
+    converted.pv = result.pv;
+    converted.lines.push_back(PvLine{converted.score, result.pv});
+    return converted;
+}
+
+/**
+ * Custom constructor. Allocates the whole node arena up front
+ * @param config search behaviour
+ */
+MctsSearcher::MctsSearcher(const MctsConfig &config)
+    : config(config), arena(std::make_unique<Node[]>(std::max<uint32_t>(config.maxTreeNodes, 2)))
+{
+    this->config.maxTreeNodes = std::max<uint32_t>(config.maxTreeNodes, 2);
+    this->config.numThreads = std::max(config.numThreads, 1);
+}
+
+/**
+ * Get current MCTS configuration
+ */
+const MctsConfig &MctsSearcher::getConfig() const
+{
+    return this->config;
+}
+
+/**
+ * Ask a running search to return as soon as possible (safe from any thread)
+ */
+void MctsSearcher::stop()
+{
+    this->stopRequested = true;
+}
+
+/**
+ * Set listener for the search's progress (e.g. to show it, or to publish it to another thread)
+ * @param callback the listener
+ */
+void MctsSearcher::setOnProgress(const ProgressCallback &callback)
+{
+    this->onProgress = callback;
+}
+
+/**
+ * Drop the whole tree. Next search starts from scratch
+ */
+void MctsSearcher::clear()
+{
+    this->hasTree = false;
+    this->arenaUsed = 0;
+}
+
+/**
+ * Nodes currently in the tree
+ */
+uint32_t MctsSearcher::getTreeSize() const
+{
+    return this->arenaUsed.load(std::memory_order_relaxed);
+}
+
+/**
+ * Run playouts from `root` on all worker threads until a limit is hit or `stop()` is called.
+ * `maxNodes` counts playouts, `maxDepth` is ignored. With no limit at all, runs until `stop()`
+ * (e.g. while waiting for the opponent).
+ *
+ * @param root position to analyse
+ * @param searchLimits playout / time limits
+ * @return most visited move and its line
+ */
+MctsResult MctsSearcher::search(const Position &root, const SearchLimits &searchLimits)
+{
+    this->stopRequested = false;
+    this->limits = searchLimits;
+    this->playouts = 0;
+    this->startTime = std::chrono::steady_clock::now();
+
+    this->reusedNodes = this->config.reuseTree ? this->reuseSubtree(root) : 0;
+    if (this->reusedNodes == 0)
+    {
+        this->resetRoot(root);
+    }
+
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < this->config.numThreads; i++)
+    {
+        helpers.emplace_back(&MctsSearcher::worker, this, static_cast<uint32_t>(i));
+    }
+    this->worker(0);
+    for (std::thread &t : helpers)
+    {
+        t.join();
+    }
+    return this->collectResult();
+}
+
+/**
+ * Read the tree's current verdict (safe while workers are running: every field read is atomic or
+ * published by the node's state)
+ * @return most visited move and its line
+ */
+MctsResult MctsSearcher::collectResult() const
+{
+    MctsResult result;
+    result.reusedNodes = this->reusedNodes;
+    result.playouts = this->playouts.load();
+    result.rootVisits = this->arena[0].visits.load();
+    result.treeNodes = this->getTreeSize();
+    result.elapsedMs = this->elapsedMs();
+    uint32_t node = this->mostVisitedChild(0);
+    if (node != NO_NODE)
+    {
+        result.bestMove = this->arena[node].move;
+        result.bestVisits = this->arena[node].visits.load();
+        result.winRate =
+            result.bestVisits == 0 ? 0.0 : this->arena[node].score.load() / (2.0 * result.bestVisits);
+    }
+    while (node != NO_NODE && this->arena[node].visits.load() > 0)
+    {
+        result.pv.push_back(this->arena[node].move);
+        node = this->mostVisitedChild(node);
+    }
+    return result;
+}
+
+/**
+ * Body of each search thread
+ * @param seed makes every worker's playouts different
+ */
+void MctsSearcher::worker(const uint32_t seed)
+{
+    std::mt19937 rng{0x9E3779B9u * (seed + 1)};
+    const bool reports = seed == 0 && this->onProgress;
+    int64_t nextReportMs = 0; // the first playout is always reported
+    while (!this->shouldStop())
+    {
+        this->runIteration(rng);
+        this->playouts.fetch_add(1, std::memory_order_relaxed);
+        if (reports && this->elapsedMs() >= nextReportMs)
+        {
+            this->onProgress(this->collectResult());
+            nextReportMs = this->elapsedMs() + MCTS_REPORT_MS;
+        }
+    }
+}
+
+/**
+ * One select -> expand -> playout -> backpropagate cycle
+ */
+void MctsSearcher::runIteration(std::mt19937 &rng)
+{
+    std::array<uint32_t, MAX_PLY + 2> path{};
+    int length = 0;
+    Position pos = this->rootPos;
+    uint32_t node = 0;
+    uint32_t result = LOSS; // for the side to move at `pos`, once the loop ends
+    while (true)
+    {
+        path[length++] = node;
+        this->arena[node].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+        uint8_t state = this->arena[node].state.load(std::memory_order_acquire);
+        bool expandedHere = false;
+        if (state == UNEXPANDED && this->arena[node].state.compare_exchange_strong(state, EXPANDING))
+        {
+            expandedHere = this->expand(node, pos);
+            state = expandedHere ? EXPANDED : UNEXPANDED;
+        }
+        if (state != EXPANDED || length > MAX_PLY)
+        {
+            // leaf (or another worker is expanding it): estimate by playout
+            result = static_cast<uint32_t>(this->playout(pos, rng));
+            break;
+        }
+        if (this->arena[node].numChildren == 0)
+        {
+            result = LOSS; // no moves left
+            break;
+        }
+        node = this->selectChild(node);
+        pos = makeMove(pos, this->arena[node].move);
+        if (expandedHere)
+        {
+            // one new node per iteration: play out from one of its fresh children
+            path[length++] = node;
+            this->arena[node].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+            result = static_cast<uint32_t>(this->playout(pos, rng));
+            break;
+        }
+    }
+
+    // walk back up, flipping the point of view each ply
+    uint32_t forMover = WIN - result; // score of the side that played INTO the leaf
+    for (int i = length - 1; i >= 0; i--)
+    {
+        Node &n = this->arena[path[i]];
+        n.score.fetch_add(forMover, std::memory_order_relaxed);
+        n.visits.fetch_add(1, std::memory_order_relaxed);
+        n.virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+        forMover = WIN - forMover;
+    }
+}
+
+/**
+ * UCT: pick child maximising mean score + C * sqrt(ln(N) / n). Virtual losses count as
+ * visits that scored nothing, so concurrent workers prefer different branches
+ * @return arena index of chosen child
+ */
+uint32_t MctsSearcher::selectChild(const uint32_t parent) const
+{
+    const Node &p = this->arena[parent];
+    const double parentVisits =
+        p.visits.load(std::memory_order_relaxed) + p.virtualLoss.load(std::memory_order_relaxed);
+    const double logParent = std::log(std::max(parentVisits, 1.0));
+    uint32_t best = p.firstChild;
+    double bestValue = -1.0;
+    for (uint32_t i = p.firstChild; i < p.firstChild + p.numChildren; i++)
+    {
+        const Node &child = this->arena[i];
+        const uint32_t n =
+            child.visits.load(std::memory_order_relaxed) + child.virtualLoss.load(std::memory_order_relaxed);
+        if (n == 0)
+        {
+            return i; // unvisited children first
+        }
+        const double mean = child.score.load(std::memory_order_relaxed) / (2.0 * n);
+        const double value = mean + this->config.exploration * std::sqrt(logParent / n);
+        if (value > bestValue)
+        {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * Create children of `node` (caller has claimed it by setting EXPANDING)
+ * @return TRUE if expanded, FALSE if the arena is full (node stays a leaf)
+ */
+bool MctsSearcher::expand(const uint32_t node, const Position &pos)
+{
+    MoveList moves;
+    generateMoves(pos, moves);
+    const auto count = static_cast<uint32_t>(moves.size());
+    uint32_t first = this->arenaUsed.load(std::memory_order_relaxed);
+    do
+    {
+        if (first + count > this->config.maxTreeNodes)
+        {
+            this->arena[node].state.store(UNEXPANDED, std::memory_order_release);
+            return false;
+        }
+    } while (!this->arenaUsed.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Node &child = this->arena[first + i];
+        child.move = moves[i];
+        child.firstChild = NO_NODE;
+        child.numChildren = 0;
+        child.state.store(UNEXPANDED, std::memory_order_relaxed);
+        child.visits.store(0, std::memory_order_relaxed);
+        child.score.store(0, std::memory_order_relaxed);
+        child.virtualLoss.store(0, std::memory_order_relaxed);
+    }
+    this->arena[node].firstChild = first;
+    this->arena[node].numChildren = static_cast<uint16_t>(count);
+    this->arena[node].state.store(EXPANDED, std::memory_order_release); // publishes the children
+    return true;
+}
+
+/**
+ * Play the game out with cheap moves. Too-long games are adjudicated by static eval
+ * @return WIN, DRAW or LOSS for the side to move at `pos`
+ */
+int MctsSearcher::playout(Position pos, std::mt19937 &rng) const
+{
+    const Side us = pos.sideToMove;
+    MoveList moves;
+    for (int ply = 0; ply < this->config.maxPlayoutPlies; ply++)
+    {
+        moves.clear();
+        generateMoves(pos, moves);
+        if (moves.empty())
+        {
+            return pos.sideToMove == us ? LOSS : WIN;
+        }
+        size_t pick = rng() % moves.size();
+        if (this->config.policy == PlayoutPolicy::GREEDY && moves.size() > 1 && rng() % GREEDY_RANDOM_ONE_IN != 0)
+        {
+            int bestScore = -SCORE_INFINITE;
+            for (size_t i = 0; i < moves.size(); i++)
+            {
+                const int score = -evaluate(makeMove(pos, moves[i]));
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    pick = i;
+                }
+            }
+        }
+        pos = makeMove(pos, moves[pick]);
+    }
+    int score = evaluate(pos);
+    if (pos.sideToMove != us)
+    {
+        score = -score;
+    }
+    if (score >= MAN_VALUE)
+    {
+        return WIN;
+    }
+    return score <= -MAN_VALUE ? LOSS : DRAW;
+}
+
+/**
+ * Child with the most (real) visits
+ * @return its arena index, or NO_NODE if `parent` has no children
+ */
+uint32_t MctsSearcher::mostVisitedChild(const uint32_t parent) const
+{
+    const Node &p = this->arena[parent];
+    if (p.state.load(std::memory_order_acquire) != EXPANDED || p.numChildren == 0)
+    {
+        return NO_NODE;
+    }
+    uint32_t best = p.firstChild;
+    for (uint32_t i = p.firstChild + 1; i < p.firstChild + p.numChildren; i++)
+    {
+        if (this->arena[i].visits.load(std::memory_order_relaxed) > this->arena[best].visits.load())
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * Find `root` in the existing tree (the old root itself, or 1-2 plies below) and keep only that subtree
+ * @return number of nodes kept, 0 if not found
+ */
+uint32_t MctsSearcher::reuseSubtree(const Position &root)
+{
+    if (!this->hasTree)
+    {
+        return 0;
+    }
+    if (this->rootPos == root)
+    {
+        return this->getTreeSize();
+    }
+    const Node &oldRoot = this->arena[0];
+    if (oldRoot.state.load() != EXPANDED)
+    {
+        return 0;
+    }
+    for (uint32_t i = oldRoot.firstChild; i < oldRoot.firstChild + oldRoot.numChildren; i++)
+    {
+        const Position child = makeMove(this->rootPos, this->arena[i].move);
+        uint32_t found = child == root ? i : NO_NODE;
+        if (found == NO_NODE && this->arena[i].state.load() == EXPANDED)
+        {
+            const Node &c = this->arena[i];
+            for (uint32_t j = c.firstChild; j < c.firstChild + c.numChildren && found == NO_NODE; j++)
+            {
+                found = makeMove(child, this->arena[j].move) == root ? j : NO_NODE;
+            }
+        }
+        if (found != NO_NODE)
+        {
+            this->compactFrom(found);
+            this->rootPos = root;
+            return this->getTreeSize();
+        }
+    }
+    return 0;
+}
+
+/**
+ * Move the subtree under `newRoot` to the front of the arena (breadth-first, so every
+ * node's children stay contiguous), dropping everything else
+ */
+void MctsSearcher::compactFrom(const uint32_t newRoot)
+{
+    struct Copy
+    {
+        Move move;
+        uint32_t oldIndex;
+        uint32_t firstChild;
+        uint16_t numChildren;
+        uint8_t state;
+        uint32_t visits;
+        uint32_t score;
+    };
+    std::vector<Copy> kept;
+    const auto snapshot = [this](const uint32_t idx) {
+        const Node &n = this->arena[idx];
+        return Copy{n.move, idx, NO_NODE, 0, UNEXPANDED, n.visits.load(), n.score.load()};
+    };
+    kept.push_back(snapshot(newRoot));
+    for (size_t head = 0; head < kept.size(); head++)
+    {
+        const Node &old = this->arena[kept[head].oldIndex];
+        if (old.state.load() != EXPANDED)
+        {
+            continue;
+        }
+        kept[head].state = EXPANDED;
+        kept[head].numChildren = old.numChildren;
+        kept[head].firstChild = static_cast<uint32_t>(kept.size());
+        for (uint32_t i = old.firstChild; i < old.firstChild + old.numChildren; i++)
+        {
+            kept.push_back(snapshot(i));
+        }
+    }
+    for (size_t i = 0; i < kept.size(); i++)
+    {
+        Node &n = this->arena[i];
+        n.move = kept[i].move;
+        n.firstChild = kept[i].firstChild;
+        n.numChildren = kept[i].numChildren;
+        n.state.store(kept[i].state);
+        n.visits.store(kept[i].visits);
+        n.score.store(kept[i].score);
+        n.virtualLoss.store(0);
+    }
+    this->arenaUsed = static_cast<uint32_t>(kept.size());
+}
+
+/**
+ * Start a fresh tree holding only `root`
+ */
+void MctsSearcher::resetRoot(const Position &root)
+{
+    Node &n = this->arena[0];
+    n.move = NULL_MOVE;
+    n.firstChild = NO_NODE;
+    n.numChildren = 0;
+    n.state.store(UNEXPANDED);
+    n.visits.store(0);
+    n.score.store(0);
+    n.virtualLoss.store(0);
+    this->arenaUsed = 1;
+    this->rootPos = root;
+    this->hasTree = true;
+}
+
+/**
+ * Check stop flag, playout budget and clock
+ * @return TRUE if workers must return now
+ */
+bool MctsSearcher::shouldStop() const
+{
+    if (this->stopRequested.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+    if (this->limits.maxNodes > 0 && this->playouts.load(std::memory_order_relaxed) >= this->limits.maxNodes)
+    {
+        return true;
+    }
+    return this->limits.moveTimeMs > 0 && this->elapsedMs() >= this->limits.moveTimeMs;
+}
+
+/**
+ * Milliseconds since current search started
+ */
+int64_t MctsSearcher::elapsedMs() const
+{
+    const auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - this->startTime).count();
+}
+
+} // namespace chk::engine
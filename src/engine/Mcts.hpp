@@ -0,0 +1,126 @@
+// created 2026-10-18
+#pragma once
+
+#include "MoveGen.hpp"
+#include "Position.hpp"
+#include "Search.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace chk::engine
+{
+constexpr int64_t MCTS_REPORT_MS{100}; // progress is published at most this often while searching
+
+/**
+ * How playouts pick their moves
+ */
+enum class PlayoutPolicy
+{
+    RANDOM, // uniformly random legal move (fastest)
+    GREEDY  // best move by static eval, with an occasional random move
+};
+
+/**
+ * Tunable MCTS behaviour
+ */
+struct MctsConfig
+{
+    int numThreads = 1;                          // workers sharing one tree (virtual loss keeps them apart)
+    double exploration = 1.4;                    // UCT constant C
+    PlayoutPolicy policy = PlayoutPolicy::RANDOM;
+    int maxPlayoutPlies = 120;                   // longer playouts are adjudicated by static eval
+    uint32_t maxTreeNodes = 1u << 20;            // arena capacity; when full, leaves are no longer expanded
+    bool reuseTree = true;                       // keep subtree of the moves actually played
+};
+
+/**
+ * Outcome of an MCTS search
+ */
+struct MctsResult
+{
+    Move bestMove = NULL_MOVE; // most visited root move
+    std::vector<Move> pv{};    // most visited line
+    double winRate = 0.0;      // expected score of bestMove for the side to move, in [0, 1]
+    uint32_t bestVisits = 0;   // visits of bestMove, including reused ones
+    uint64_t playouts = 0;     // done by this search
+    uint32_t rootVisits = 0;   // including those reused from earlier searches
+    uint32_t treeNodes = 0;
+    uint32_t reusedNodes = 0;  // carried over from the previous search
+    int64_t elapsedMs = 0;
+};
+
+[[nodiscard]] int winRateToScore(double winRate);
+[[nodiscard]] SearchResult toSearchResult(const MctsResult &result);
+
+/**
+ * Monte Carlo Tree Search with UCT selection. Nodes live in a fixed arena, indexed by uint32;
+ * all workers share the tree, using virtual loss to spread out. Between searches, the subtree
+ * of the position reached is kept (up to 2 plies below the previous root: our move + their reply).
+ */
+class MctsSearcher final
+{
+  public:
+    // called with the tree's current verdict, after the first playout and then every MCTS_REPORT_MS
+    // (from the first worker thread)
+    using ProgressCallback = std::function<void(const MctsResult &)>;
+
+    explicit MctsSearcher(const MctsConfig &config = MctsConfig{});
+    MctsSearcher(const MctsSearcher &) = delete;
+    MctsSearcher &operator=(const MctsSearcher &) = delete;
+    MctsResult search(const Position &root, const SearchLimits &limits);
+    void stop();
+    void clear();
+    void setOnProgress(const ProgressCallback &callback);
+    [[nodiscard]] uint32_t getTreeSize() const;
+    [[nodiscard]] const MctsConfig &getConfig() const;
+
+  private:
+    static constexpr uint8_t UNEXPANDED{0};
+    static constexpr uint8_t EXPANDING{1};
+    static constexpr uint8_t EXPANDED{2};
+    static constexpr uint32_t NO_NODE{UINT32_MAX};
+
+    struct Node
+    {
+        Move move{};                           // move that led here
+        uint32_t firstChild = NO_NODE;         // children are contiguous in the arena
+        uint16_t numChildren = 0;
+        std::atomic<uint8_t> state{UNEXPANDED};
+        std::atomic<uint32_t> visits{0};
+        std::atomic<uint32_t> score{0};        // half-points (win 2, draw 1) for the side that played `move`
+        std::atomic<uint32_t> virtualLoss{0};  // workers currently below this node
+    };
+
+    MctsConfig config;
+    std::unique_ptr<Node[]> arena;
+    std::atomic<uint32_t> arenaUsed{0};
+    Position rootPos{};
+    bool hasTree = false;
+    uint32_t reusedNodes = 0; // by the current search
+    ProgressCallback onProgress;
+
+    std::atomic_bool stopRequested{false};
+    std::atomic<uint64_t> playouts{0};
+    SearchLimits limits{};
+    std::chrono::steady_clock::time_point startTime{};
+
+    void worker(uint32_t seed);
+    void runIteration(std::mt19937 &rng);
+    [[nodiscard]] uint32_t selectChild(uint32_t parent) const;
+    [[nodiscard]] bool expand(uint32_t node, const Position &pos);
+    [[nodiscard]] int playout(Position pos, std::mt19937 &rng) const;
+    [[nodiscard]] uint32_t mostVisitedChild(uint32_t parent) const;
+    [[nodiscard]] MctsResult collectResult() const;
+    uint32_t reuseSubtree(const Position &root);
+    void compactFrom(uint32_t newRoot);
+    void resetRoot(const Position &root);
+    [[nodiscard]] bool shouldStop() const;
+    [[nodiscard]] int64_t elapsedMs() const;
+};
+
+} // namespace chk::engine
@@ -0,0 +1,300 @@
+#include "MoveGen.hpp"
+#include <algorithm>
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr Direction ALL_DIRS[4] = {NORTH_WEST, NORTH_EAST, SOUTH_WEST, SOUTH_EAST};
+constexpr Direction RED_FORWARD[2] = {NORTH_WEST, NORTH_EAST};
+constexpr Direction BLACK_FORWARD[2] = {SOUTH_WEST, SOUTH_EAST};
+
+/**
+ * Row on which men of this side get crowned
+ */
+constexpr Bitboard crownRowOf(const Side side)
+{
+    return side == Side::RED ? RED_CROWN_ROW : BLACK_CROWN_ROW;
+}
+
+/**
+ * Directions this piece may move in: men only forward, kings everywhere
+ */
+void directionsFor(const Side side, const bool isKing, const Direction *&dirs, int &numDirs)
+{
+    if (isKing)
+    {
+        dirs = ALL_DIRS;
+        numDirs = 4;
+    }
+    else
+    {
+        dirs = side == Side::RED ? RED_FORWARD : BLACK_FORWARD;
+        numDirs = 2;
+    }
+}
+
+/**
+ * Add a capture unless it is already listed: a king's chain round a loop is found once per direction
+ */
+void addCapture(MoveList &list, const Move &move)
+{
+    if (std::find(list.begin(), list.end(), move) == list.end())
+    {
+        list.add(move);
+    }
+}
+
+/**
+ * Depth-first walk of every jump chain starting at `sq`. Captured pieces stay on board until the
+ * move is over (they block landings and cannot be jumped twice). A man that gets crowned stops there.
+ * A king may end the chain on the square it started from.
+ */
+void collectJumps(const Position &pos, const int origin, const int sq, const Bitboard captured, const bool isKing,
+                  MoveList &list)
+{
+    const Side side = pos.sideToMove;
+    const Bitboard enemy = pos.enemy();
+    const Bitboard empty = pos.empty() | bitOf(origin); // hunter has left its source cell
+    const Direction *dirs = nullptr;
+    int numDirs = 0;
+    directionsFor(side, isKing, dirs, numDirs);
+
+    bool extended = false;
+    for (int i = 0; i < numDirs; i++)
+    {
+        const int prey = NEIGHBOUR[dirs[i]][sq];
+        const int landing = JUMP_LANDING[dirs[i]][sq];
+        if (landing == NO_SQUARE || (enemy & ~captured & bitOf(prey)) == 0 || (empty & bitOf(landing)) == 0)
+        {
+            continue;
+        }
+        extended = true;
+        const Bitboard nowCaptured = captured | bitOf(prey);
+        if (!isKing && (crownRowOf(side) & bitOf(landing)) != 0)
+        {
+            // just became King: turn ends immediately
+            addCapture(list, Move{nowCaptured, static_cast<uint8_t>(origin), static_cast<uint8_t>(landing)});
+            continue;
+        }
+        collectJumps(pos, origin, landing, nowCaptured, isKing, list);
+    }
+    if (!extended && captured != 0)
+    {
+        addCapture(list, Move{captured, static_cast<uint8_t>(origin), static_cast<uint8_t>(sq)});
+    }
+}
+
+/**
+ * Find the landing squares of `move`, in order (DFS that must remove exactly `move.captured`)
+ */
+bool findPath(const Position &pos, const Move &move, const int sq, const Bitboard captured, const bool isKing,
+              std::vector<int> &path)
+{
+    if (captured == move.captured)
+    {
+        return sq == move.to;
+    }
+    const Bitboard empty = pos.empty() | bitOf(move.from);
+    const Direction *dirs = nullptr;
+    int numDirs = 0;
+    directionsFor(pos.sideToMove, isKing, dirs, numDirs);
+    for (int i = 0; i < numDirs; i++)
+    {
+        const int prey = NEIGHBOUR[dirs[i]][sq];
+        const int landing = JUMP_LANDING[dirs[i]][sq];
+        if (landing == NO_SQUARE || (move.captured & ~captured & bitOf(prey)) == 0 || (empty & bitOf(landing)) == 0)
+        {
+            continue;
+        }
+        path.push_back(landing);
+        if (findPath(pos, move, landing, captured | bitOf(prey), isKing, path))
+        {
+            return true;
+        }
+        path.pop_back();
+    }
+    return false;
+}
+} // namespace
+
+/**
+ * Generate all legal moves. Captures are compulsory: if any exist, ONLY captures are returned
+ * @param pos current position
+ * @param list receives the moves (NOT cleared first)
+ */
+void generateMoves(const Position &pos, MoveList &list)
+{
+    const size_t before = list.size();
+    generateCaptures(pos, list);
+    if (list.size() == before)
+    {
+        generateQuietMoves(pos, list);
+    }
+}
+
+/**
+ * Generate capture moves only (complete jump chains)
+ * @param pos current position
+ * @param list receives the moves
+ */
+void generateCaptures(const Position &pos, MoveList &list)
+{
+    Bitboard own = pos.own();
+    while (own != 0)
+    {
+        const int sq = popLowest(own);
+        collectJumps(pos, sq, sq, 0, (pos.kings & bitOf(sq)) != 0, list);
+    }
+}
+
+/**
+ * Generate simple (non-capture) moves only. Does NOT check for compulsory captures
+ * @param pos current position
+ * @param list receives the moves
+ */
+void generateQuietMoves(const Position &pos, MoveList &list)
+{
+    const Bitboard empty = pos.empty();
+    Bitboard own = pos.own();
+    while (own != 0)
+    {
+        const int sq = popLowest(own);
+        const Direction *dirs = nullptr;
+        int numDirs = 0;
+        directionsFor(pos.sideToMove, (pos.kings & bitOf(sq)) != 0, dirs, numDirs);
+        for (int i = 0; i < numDirs; i++)
+        {
+            const int dest = NEIGHBOUR[dirs[i]][sq];
+            if (dest != NO_SQUARE && (empty & bitOf(dest)) != 0)
+            {
+                list.add(Move{0, static_cast<uint8_t>(sq), static_cast<uint8_t>(dest)});
+            }
+        }
+    }
+}
+
+/**
+ * Whether side to move has at least one capture available (cheaper than generating them)
+ */
+bool hasCaptures(const Position &pos)
+{
+    const Bitboard empty = pos.empty();
+    const Bitboard enemy = pos.enemy();
+    Bitboard own = pos.own();
+    while (own != 0)
+    {
+        const int sq = popLowest(own);
+        const Direction *dirs = nullptr;
+        int numDirs = 0;
+        directionsFor(pos.sideToMove, (pos.kings & bitOf(sq)) != 0, dirs, numDirs);
+        for (int i = 0; i < numDirs; i++)
+        {
+            const int landing = JUMP_LANDING[dirs[i]][sq];
+            if (landing != NO_SQUARE && (enemy & bitOf(NEIGHBOUR[dirs[i]][sq])) != 0 && (empty & bitOf(landing)) != 0)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Play this move, and return the resulting position (original is untouched)
+ * @param pos current position
+ * @param move a legal move
+ * @return new position, with the other side to move
+ */
+Position makeMove(const Position &pos, const Move &move)
+{
+    Position next = pos;
+    // a king whose chain ends where it started does not move: only its captures leave the board
+    const Bitboard fromTo = move.from == move.to ? 0 : bitOf(move.from) | bitOf(move.to);
+    if (pos.sideToMove == Side::RED)
+    {
+        next.red ^= fromTo;
+        next.black &= ~move.captured;
+    }
+    else
+    {
+        next.black ^= fromTo;
+        next.red &= ~move.captured;
+    }
+    next.kings &= ~move.captured;
+    if ((pos.kings & bitOf(move.from)) != 0)
+    {
+        next.kings ^= fromTo;
+    }
+    else if ((crownRowOf(pos.sideToMove) & bitOf(move.to)) != 0)
+    {
+        next.kings |= bitOf(move.to);
+    }
+    next.sideToMove = opposite(pos.sideToMove);
+    return next;
+}
+
+/**
+ * List every landing square of this move in order. Simple moves give just `{to}`
+ * @param pos position BEFORE the move
+ * @param move a legal move
+ * @return landing squares; last item is always `move.to`
+ */
+std::vector<int> expandPath(const Position &pos, const Move &move)
+{
+    std::vector<int> path;
+    if (!move.isCapture())
+    {
+        path.push_back(move.to);
+        return path;
+    }
+    findPath(pos, move, move.from, 0, (pos.kings & bitOf(move.from)) != 0, path);
+    return path;
+}
+
+/**
+ * Standard PDN notation using cell indices, e.g. "11-15" or "22x15x8"
+ * @param pos position BEFORE the move
+ * @param move a legal move
+ */
+std::string toNotation(const Position &pos, const Move &move)
+{
+    std::string text = std::to_string(toCellIndex(move.from));
+    if (!move.isCapture())
+    {
+        return text + "-" + std::to_string(toCellIndex(move.to));
+    }
+    for (const int sq : expandPath(pos, move))
+    {
+        text += "x" + std::to_string(toCellIndex(sq));
+    }
+    return text;
+}
+
+/**
+ * Count leaf nodes of the legal move tree (for validating the generator)
+ * @param pos root position
+ * @param depth plies to expand
+ */
+uint64_t perft(const Position &pos, const int depth)
+{
+    if (depth == 0)
+    {
+        return 1;
+    }
+    MoveList list;
+    generateMoves(pos, list);
+    if (depth == 1)
+    {
+        return list.size();
+    }
+    uint64_t total = 0;
+    for (const Move &move : list)
+    {
+        total += perft(makeMove(pos, move), depth - 1);
+    }
+    return total;
+}
+
+} // namespace chk::engine
@@ -0,0 +1,105 @@
+// created 2026-10-18
+#pragma once
+
+#include "Position.hpp"
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace chk::engine
+{
+/**
+ * One complete turn. For captures, `to` is the FINAL landing cell after the whole jump chain
+ */
+struct Move
+{
+    Bitboard captured{0}; // all enemy pieces removed by this move (0 for simple moves)
+    uint8_t from{0};      // source square [0~31]
+    uint8_t to{0};        // destination square [0~31]
+
+    constexpr bool isCapture() const
+    {
+        return captured != 0;
+    }
+
+    constexpr bool operator==(const Move &other) const
+    {
+        return from == other.from && to == other.to && captured == other.captured;
+    }
+
+    constexpr bool operator!=(const Move &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// no real move ever starts and ends on the same square without capturing
+constexpr Move NULL_MOVE{0, 0, 0};
+
+/**
+ * Fixed-capacity list of moves, lives on the stack (no heap allocation during search)
+ */
+class MoveList final
+{
+  public:
+    static constexpr size_t MAX_MOVES{128};
+
+    void add(const Move &move)
+    {
+        assert(count < MAX_MOVES && "MoveList overflow");
+        moves[count++] = move;
+    }
+    void clear()
+    {
+        count = 0;
+    }
+    [[nodiscard]] size_t size() const
+    {
+        return count;
+    }
+    [[nodiscard]] bool empty() const
+    {
+        return count == 0;
+    }
+    Move &operator[](const size_t idx)
+    {
+        return moves[idx];
+    }
+    const Move &operator[](const size_t idx) const
+    {
+        return moves[idx];
+    }
+    Move *begin()
+    {
+        return moves.data();
+    }
+    Move *end()
+    {
+        return moves.data() + count;
+    }
+    const Move *begin() const
+    {
+        return moves.data();
+    }
+    const Move *end() const
+    {
+        return moves.data() + count;
+    }
+
+  private:
+    std::array<Move, MAX_MOVES> moves{};
+    size_t count = 0;
+};
+
+void generateMoves(const Position &pos, MoveList &list);
+void generateCaptures(const Position &pos, MoveList &list);
+void generateQuietMoves(const Position &pos, MoveList &list);
+[[nodiscard]] bool hasCaptures(const Position &pos);
+[[nodiscard]] Position makeMove(const Position &pos, const Move &move);
+[[nodiscard]] std::vector<int> expandPath(const Position &pos, const Move &move);
+[[nodiscard]] std::string toNotation(const Position &pos, const Move &move);
+[[nodiscard]] uint64_t perft(const Position &pos, int depth);
+
+} // namespace chk::engine
@@ -0,0 +1,166 @@
+#include "MoveOrdering.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace chk::engine
+{
+
+namespace
+{
+// score bands, far apart so a band never overtakes the one above it
+constexpr int32_t HASH_MOVE_SCORE{1 << 30};
+constexpr int32_t CAPTURE_SCORE{1 << 24};
+constexpr int32_t CAPTURED_PIECE_SCORE{1 << 20}; // per piece taken: chain length dominates...
+constexpr int32_t CAPTURED_KING_SCORE{1 << 19};  // ...then how many of them are kings
+constexpr int32_t KILLER_SCORE{1 << 18};         // minus slot index
+constexpr int32_t HISTORY_BONUS_CAP{400};
+} // namespace
+
+/**
+ * Custom constructor
+ * @param config which heuristics to use
+ */
+MoveOrderer::MoveOrderer(const OrderingConfig &config) : config(config)
+{
+}
+
+/**
+ * Start of a new search: killers refer to old plies and are dropped; history is halved, so it keeps
+ * what it learnt but adapts quickly to the new position
+ */
+void MoveOrderer::newSearch()
+{
+    for (auto &slots : this->killers)
+    {
+        slots.fill(NULL_MOVE);
+    }
+    for (auto &bySide : this->history)
+    {
+        for (auto &byFrom : bySide)
+        {
+            for (int32_t &value : byFrom)
+            {
+                value /= 2;
+            }
+        }
+    }
+}
+
+/**
+ * Sort a node's moves, most promising first
+ * @param pos position the moves belong to
+ * @param moves all legal moves of `pos`; reordered in place
+ * @param hashMove move to try first (NULL_MOVE if none)
+ * @param ply distance from the root (for killers)
+ */
+void MoveOrderer::order(const Position &pos, MoveList &moves, const Move &hashMove, const int ply) const
+{
+    std::array<int32_t, MoveList::MAX_MOVES> scores{};
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        scores[i] = this->scoreMove(pos, moves[i], hashMove, ply);
+    }
+    // insertion sort: lists are short, often nearly sorted, and ties keep generation order
+    for (size_t i = 1; i < moves.size(); i++)
+    {
+        const Move move = moves[i];
+        const int32_t score = scores[i];
+        size_t j = i;
+        for (; j > 0 && scores[j - 1] < score; j--)
+        {
+            moves[j] = moves[j - 1];
+            scores[j] = scores[j - 1];
+        }
+        moves[j] = move;
+        scores[j] = score;
+    }
+}
+
+/**
+ * Learn from a beta cutoff: the quiet move that caused it becomes a killer at this ply and gains history;
+ * quiet moves searched before it (and that failed to cut off) lose some
+ * @param pos position of the node
+ * @param moves the node's moves, in the order they were searched
+ * @param cutoffIndex index of the move that failed high
+ * @param depth remaining depth of the node (deeper cutoffs weigh more)
+ * @param ply distance from the root
+ */
+void MoveOrderer::onCutoff(const Position &pos, const MoveList &moves, const size_t cutoffIndex, const int depth,
+                           const int ply)
+{
+    const Move &best = moves[cutoffIndex];
+    if (best.isCapture())
+    {
+        return;
+    }
+    if (this->config.killers && ply < KILLER_MAX_PLY && this->killers[ply][0] != best)
+    {
+        std::copy_backward(this->killers[ply].begin(), this->killers[ply].end() - 1, this->killers[ply].end());
+        this->killers[ply][0] = best;
+    }
+    if (this->config.history)
+    {
+        const int32_t bonus = std::min(depth * depth, HISTORY_BONUS_CAP);
+        this->addHistory(pos.sideToMove, best, bonus);
+        for (size_t i = 0; i < cutoffIndex; i++)
+        {
+            this->addHistory(pos.sideToMove, moves[i], -bonus);
+        }
+    }
+}
+
+const OrderingConfig &MoveOrderer::getConfig() const
+{
+    return this->config;
+}
+
+/**
+ * History score of a quiet move for `side`, in [-HISTORY_MAX, HISTORY_MAX]
+ */
+int32_t MoveOrderer::getHistory(const Side side, const Move &move) const
+{
+    return this->history[static_cast<int>(side)][move.from][move.to];
+}
+
+/**
+ * Ordering key of one move (higher = searched earlier)
+ */
+int32_t MoveOrderer::scoreMove(const Position &pos, const Move &move, const Move &hashMove, const int ply) const
+{
+    if (this->config.ttMove && move == hashMove)
+    {
+        return HASH_MOVE_SCORE;
+    }
+    if (move.isCapture())
+    {
+        if (!this->config.captureLength)
+        {
+            return CAPTURE_SCORE;
+        }
+        return CAPTURE_SCORE + popCount(move.captured) * CAPTURED_PIECE_SCORE +
+               popCount(move.captured & pos.kings) * CAPTURED_KING_SCORE;
+    }
+    if (this->config.killers && ply < KILLER_MAX_PLY)
+    {
+        for (int slot = 0; slot < KILLER_SLOTS; slot++)
+        {
+            if (this->killers[ply][slot] == move)
+            {
+                return KILLER_SCORE - slot;
+            }
+        }
+    }
+    return this->config.history ? this->getHistory(pos.sideToMove, move) : 0;
+}
+
+/**
+ * Move a history entry towards +/-HISTORY_MAX ("gravity"): big bonuses saturate instead of overflowing,
+ * and an entry that keeps getting bonuses moves less each time
+ */
+void MoveOrderer::addHistory(const Side side, const Move &move, const int32_t bonus)
+{
+    int32_t &entry = this->history[static_cast<int>(side)][move.from][move.to];
+    entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+}
+
+} // namespace chk::engine
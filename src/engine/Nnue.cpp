@@ -0,0 +1,345 @@
+#include "Nnue.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CHK_NNUE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CHK_NNUE_SSE2
+#endif
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr size_t FEATURE_WEIGHTS_OFFSET{NNUE_HEADER_SIZE};
+constexpr size_t FEATURE_BIAS_OFFSET{FEATURE_WEIGHTS_OFFSET + NNUE_INPUTS * NNUE_HIDDEN * sizeof(int16_t)};
+constexpr size_t OUTPUT_WEIGHTS_OFFSET{FEATURE_BIAS_OFFSET + NNUE_HIDDEN * sizeof(int16_t)};
+
+/**
+ * Input feature of a piece, as seen from `perspective`
+ */
+inline int featureIndex(const Side perspective, const Side owner, const bool isKing, const int sq)
+{
+    const int relSquare = perspective == Side::RED ? sq : NUM_SQUARES - 1 - sq;
+    const int kind = (owner == perspective ? 0 : 2) + (isKing ? 1 : 0);
+    return kind * NUM_SQUARES + relSquare;
+}
+
+/**
+ * acc[i] += column[i], for all hidden units
+ */
+inline void addColumn(int16_t *acc, const int16_t *column)
+{
+#if defined(CHK_NNUE_AVX2)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16)
+    {
+        const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i *>(acc + i));
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(column + i));
+        _mm256_store_si256(reinterpret_cast<__m256i *>(acc + i), _mm256_add_epi16(a, w));
+    }
+#elif defined(CHK_NNUE_SSE2)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8)
+    {
+        const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(acc + i));
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(column + i));
+        _mm_store_si128(reinterpret_cast<__m128i *>(acc + i), _mm_add_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; i++)
+    {
+        acc[i] = static_cast<int16_t>(acc[i] + column[i]);
+    }
+#endif
+}
+
+/**
+ * acc[i] -= column[i], for all hidden units
+ */
+inline void subColumn(int16_t *acc, const int16_t *column)
+{
+#if defined(CHK_NNUE_AVX2)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16)
+    {
+        const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i *>(acc + i));
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(column + i));
+        _mm256_store_si256(reinterpret_cast<__m256i *>(acc + i), _mm256_sub_epi16(a, w));
+    }
+#elif defined(CHK_NNUE_SSE2)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8)
+    {
+        const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(acc + i));
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(column + i));
+        _mm_store_si128(reinterpret_cast<__m128i *>(acc + i), _mm_sub_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; i++)
+    {
+        acc[i] = static_cast<int16_t>(acc[i] - column[i]);
+    }
+#endif
+}
+
+/**
+ * sum(clamp(acc[i], 0, 127) * weights[i]) over all hidden units
+ */
+inline int32_t clippedDot(const int16_t *acc, const int8_t *weights)
+{
+#if defined(CHK_NNUE_AVX2)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ceiling = _mm256_set1_epi16(NNUE_ACTIVATION_MAX);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < NNUE_HIDDEN; i += 16)
+    {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i *>(acc + i));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), ceiling);
+        const __m256i w = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + i)));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, w));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+#elif defined(CHK_NNUE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ceiling = _mm_set1_epi16(NNUE_ACTIVATION_MAX);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < NNUE_HIDDEN; i += 8)
+    {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(acc + i));
+        a = _mm_min_epi16(_mm_max_epi16(a, zero), ceiling);
+        // sign-extend 8 x int8 -> int16
+        const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(weights + i));
+        const __m128i w = _mm_srai_epi16(_mm_unpacklo_epi8(packed, packed), 8);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(a, w));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < NNUE_HIDDEN; i++)
+    {
+        const int32_t activation = std::clamp<int32_t>(acc[i], 0, NNUE_ACTIVATION_MAX);
+        sum += activation * weights[i];
+    }
+    return sum;
+#endif
+}
+
+template <typename T> void putRaw(std::vector<uint8_t> &bytes, const size_t offset, const T value)
+{
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+} // namespace
+
+/**
+ * Which SIMD kernels this build uses
+ */
+const char *NnueNetwork::getKernelName()
+{
+#if defined(CHK_NNUE_AVX2)
+    return "AVX2";
+#elif defined(CHK_NNUE_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ * Built-in network that reproduces a plain material + advancement evaluation.
+ * Used when no trained weights file is available.
+ */
+std::unique_ptr<NnueNetwork> NnueNetwork::createDefault()
+{
+    std::vector<uint8_t> bytes(NNUE_FILE_SIZE, 0);
+    putRaw<uint32_t>(bytes, 0, NNUE_MAGIC);
+    putRaw<uint16_t>(bytes, 4, NNUE_VERSION);
+    putRaw<uint16_t>(bytes, 6, NNUE_INPUTS);
+    putRaw<uint16_t>(bytes, 8, NNUE_HIDDEN);
+    putRaw<int32_t>(bytes, 12, 1);  // output scale
+    putRaw<int32_t>(bytes, 16, 0);  // output bias
+
+    // hidden units: 0 own men, 1 own kings, 2 enemy men, 3 enemy kings, 4 own advancement, 5 enemy advancement
+    const auto setWeight = [&bytes](const int feature, const int unit, const int16_t value) {
+        putRaw<int16_t>(bytes, FEATURE_WEIGHTS_OFFSET + (feature * NNUE_HIDDEN + unit) * sizeof(int16_t), value);
+    };
+    for (int sq = 0; sq < NUM_SQUARES; sq++)
+    {
+        const auto advance = static_cast<int16_t>(7 - rowOf(sq)); // rows travelled, seen from own side
+        setWeight(0 * NUM_SQUARES + sq, 0, 10);
+        setWeight(1 * NUM_SQUARES + sq, 1, 10);
+        setWeight(2 * NUM_SQUARES + sq, 2, 10);
+        setWeight(3 * NUM_SQUARES + sq, 3, 10);
+        setWeight(0 * NUM_SQUARES + sq, 4, advance);
+        setWeight(2 * NUM_SQUARES + (NUM_SQUARES - 1 - sq), 5, advance);
+    }
+    const int8_t ownOutputs[6] = {10, 15, -10, -15, 3, -3};
+    for (int unit = 0; unit < 6; unit++)
+    {
+        putRaw<int8_t>(bytes, OUTPUT_WEIGHTS_OFFSET + unit, ownOutputs[unit]);
+    }
+    return fromBytes(std::move(bytes));
+}
+
+/**
+ * Map a weights file from disk. Nothing is copied: weights are used straight from the mapping
+ * @param path location of weights file
+ * @return the network, or nullptr if file is missing or invalid
+ */
+std::unique_ptr<NnueNetwork> NnueNetwork::load(const std::string &path)
+{
+    std::unique_ptr<NnueNetwork> net{new NnueNetwork()};
+    if (!net->file.open(path) || !net->bind(net->file.data(), net->file.size()))
+    {
+        spdlog::error("cannot load NNUE weights from {}", path);
+        return nullptr;
+    }
+    spdlog::info("NNUE weights mapped from {} ({} kernels)", path, getKernelName());
+    return net;
+}
+
+/**
+ * Create network from weights held in memory (same layout as the file)
+ * @param bytes full file contents
+ * @return the network, or nullptr if invalid
+ */
+std::unique_ptr<NnueNetwork> NnueNetwork::fromBytes(std::vector<uint8_t> bytes)
+{
+    std::unique_ptr<NnueNetwork> net{new NnueNetwork()};
+    net->owned = std::move(bytes);
+    if (!net->bind(net->owned.data(), net->owned.size()))
+    {
+        return nullptr;
+    }
+    return net;
+}
+
+/**
+ * Validate header, then point the weight arrays into `data`
+ * @return TRUE if layout is valid
+ */
+bool NnueNetwork::bind(const uint8_t *data, const size_t size)
+{
+    if (data == nullptr || size != NNUE_FILE_SIZE)
+    {
+        return false;
+    }
+    uint32_t magic = 0;
+    uint16_t version = 0, inputs = 0, hidden = 0;
+    std::memcpy(&magic, data, sizeof(magic));
+    std::memcpy(&version, data + 4, sizeof(version));
+    std::memcpy(&inputs, data + 6, sizeof(inputs));
+    std::memcpy(&hidden, data + 8, sizeof(hidden));
+    std::memcpy(&this->outputScale, data + 12, sizeof(this->outputScale));
+    std::memcpy(&this->outputBias, data + 16, sizeof(this->outputBias));
+    if (magic != NNUE_MAGIC || version != NNUE_VERSION || inputs != NNUE_INPUTS || hidden != NNUE_HIDDEN ||
+        this->outputScale <= 0)
+    {
+        return false;
+    }
+    this->raw = data;
+    this->featureWeights = reinterpret_cast<const int16_t *>(data + FEATURE_WEIGHTS_OFFSET);
+    this->featureBias = reinterpret_cast<const int16_t *>(data + FEATURE_BIAS_OFFSET);
+    this->outputWeights = reinterpret_cast<const int8_t *>(data + OUTPUT_WEIGHTS_OFFSET);
+    return true;
+}
+
+/**
+ * Write weights to disk, in the format `load` expects
+ * @param path destination
+ * @return TRUE if successful, else FALSE
+ */
+bool NnueNetwork::save(const std::string &path) const
+{
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char *>(this->raw), static_cast<std::streamsize>(NNUE_FILE_SIZE));
+    return static_cast<bool>(out);
+}
+
+/**
+ * Build accumulator from scratch (at search root)
+ * @param pos the position
+ * @param acc receives both perspectives
+ */
+void NnueNetwork::refresh(const Position &pos, Accumulator &acc) const
+{
+    for (const Side perspective : {Side::RED, Side::BLACK})
+    {
+        int16_t *values = acc.values[static_cast<int>(perspective)];
+        std::memcpy(values, this->featureBias, NNUE_HIDDEN * sizeof(int16_t));
+        Bitboard pieces = pos.occupied();
+        while (pieces != 0)
+        {
+            const int sq = popLowest(pieces);
+            const Side owner = (pos.red & bitOf(sq)) != 0 ? Side::RED : Side::BLACK;
+            const int feature = featureIndex(perspective, owner, (pos.kings & bitOf(sq)) != 0, sq);
+            addColumn(values, this->featureWeights + feature * NNUE_HIDDEN);
+        }
+    }
+}
+
+/**
+ * Derive child accumulator from parent, touching only the features this move changes
+ * (moving piece, possible crowning, and every captured piece)
+ *
+ * @param parent accumulator of `before`
+ * @param child receives accumulator of the position after `move`
+ * @param before position BEFORE the move
+ * @param move the move
+ */
+void NnueNetwork::update(const Accumulator &parent, Accumulator &child, const Position &before,
+                         const Move &move) const
+{
+    child = parent;
+    const Side mover = before.sideToMove;
+    const bool wasKing = (before.kings & bitOf(move.from)) != 0;
+    const Bitboard crownRow = mover == Side::RED ? RED_CROWN_ROW : BLACK_CROWN_ROW;
+    const bool isKing = wasKing || (crownRow & bitOf(move.to)) != 0;
+    for (const Side perspective : {Side::RED, Side::BLACK})
+    {
+        int16_t *values = child.values[static_cast<int>(perspective)];
+        subColumn(values, this->featureWeights + featureIndex(perspective, mover, wasKing, move.from) * NNUE_HIDDEN);
+        addColumn(values, this->featureWeights + featureIndex(perspective, mover, isKing, move.to) * NNUE_HIDDEN);
+        Bitboard captured = move.captured;
+        while (captured != 0)
+        {
+            const int sq = popLowest(captured);
+            const int feature = featureIndex(perspective, opposite(mover), (before.kings & bitOf(sq)) != 0, sq);
+            subColumn(values, this->featureWeights + feature * NNUE_HIDDEN);
+        }
+    }
+}
+
+/**
+ * Run the output layer
+ * @param acc accumulator of the position
+ * @param sideToMove whose point of view to score from
+ * @return score in centi-men, positive is good for `sideToMove`
+ */
+int NnueNetwork::evaluate(const Accumulator &acc, const Side sideToMove) const
+{
+    const int us = static_cast<int>(sideToMove);
+    int32_t sum = this->outputBias;
+    sum += clippedDot(acc.values[us], this->outputWeights);
+    sum += clippedDot(acc.values[1 - us], this->outputWeights + NNUE_HIDDEN);
+    return sum / this->outputScale;
+}
+
+/**
+ * Full (non-incremental) evaluation, for callers without an accumulator stack
+ */
+int NnueNetwork::evaluate(const Position &pos) const
+{
+    Accumulator acc;
+    this->refresh(pos, acc);
+    return this->evaluate(acc, pos.sideToMove);
+}
+
+} // namespace chk::engine
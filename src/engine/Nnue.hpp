@@ -0,0 +1,65 @@
+// created 2026-10-18
+#pragma once
+
+#include "../utils/MappedFile.hpp"
+#include "MoveGen.hpp"
+#include "Position.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace chk::engine
+{
+constexpr int NNUE_INPUTS{4 * NUM_SQUARES}; // {own man, own king, enemy man, enemy king} x square
+constexpr int NNUE_HIDDEN{64};              // accumulator width per perspective (multiple of 16)
+constexpr int NNUE_ACTIVATION_MAX{127};     // clipped ReLU upper bound
+constexpr uint32_t NNUE_MAGIC{0x4E4E4353};  // "SCNN" in little-endian
+constexpr uint16_t NNUE_VERSION{1};
+constexpr size_t NNUE_HEADER_SIZE{64};
+constexpr size_t NNUE_FILE_SIZE{NNUE_HEADER_SIZE + NNUE_INPUTS * NNUE_HIDDEN * sizeof(int16_t) +
+                                NNUE_HIDDEN * sizeof(int16_t) + 2 * NNUE_HIDDEN * sizeof(int8_t)};
+
+/**
+ * First-layer output for both perspectives: values[0] is seen by RED, values[1] by BLACK
+ * (board rotated, so each side sees itself moving "up").
+ */
+struct alignas(32) Accumulator
+{
+    int16_t values[2][NNUE_HIDDEN];
+};
+
+/**
+ * Small NNUE-style evaluation network: 128 piece-square inputs -> 2 x 64 int16 accumulator
+ * -> clipped ReLU -> int8 output layer. The accumulator is updated incrementally per move.
+ */
+class NnueNetwork final
+{
+  public:
+    NnueNetwork(const NnueNetwork &) = delete;
+    NnueNetwork &operator=(const NnueNetwork &) = delete;
+    [[nodiscard]] static std::unique_ptr<NnueNetwork> createDefault();
+    [[nodiscard]] static std::unique_ptr<NnueNetwork> load(const std::string &path);
+    [[nodiscard]] static std::unique_ptr<NnueNetwork> fromBytes(std::vector<uint8_t> bytes);
+    [[nodiscard]] static const char *getKernelName();
+    [[nodiscard]] bool save(const std::string &path) const;
+    void refresh(const Position &pos, Accumulator &acc) const;
+    void update(const Accumulator &parent, Accumulator &child, const Position &before, const Move &move) const;
+    [[nodiscard]] int evaluate(const Accumulator &acc, Side sideToMove) const;
+    [[nodiscard]] int evaluate(const Position &pos) const;
+
+  private:
+    NnueNetwork() = default;
+    chk::MappedFile file;       // weights mapped from disk, OR
+    std::vector<uint8_t> owned; // weights held in memory
+    const uint8_t *raw = nullptr;
+    const int16_t *featureWeights = nullptr; // [NNUE_INPUTS][NNUE_HIDDEN]
+    const int16_t *featureBias = nullptr;    // [NNUE_HIDDEN]
+    const int8_t *outputWeights = nullptr;   // [2 * NNUE_HIDDEN]: own perspective first
+    int32_t outputBias = 0;
+    int32_t outputScale = 1;
+
+    bool bind(const uint8_t *data, size_t size);
+};
+
+} // namespace chk::engine
@@ -0,0 +1,253 @@
+#include "OpeningBook.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <spdlog/spdlog.h>
+
+namespace chk::engine
+{
+
+/**
+ * Map the book file. No entry is parsed or copied: only the header and file size are checked
+ * @param path location of book file
+ * @return TRUE if successful, else FALSE
+ */
+bool OpeningBook::open(const std::string &path)
+{
+    this->entries = nullptr;
+    this->numEntries = 0;
+    if (!this->file.open(path))
+    {
+        return false;
+    }
+    const uint8_t *base = this->file.data();
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    uint64_t count = 0;
+    if (this->file.size() >= BOOK_HEADER_SIZE)
+    {
+        std::memcpy(&magic, base, sizeof(magic));
+        std::memcpy(&version, base + 4, sizeof(version));
+        std::memcpy(&count, base + 8, sizeof(count));
+    }
+    if (magic != BOOK_MAGIC || version != BOOK_VERSION ||
+        this->file.size() != BOOK_HEADER_SIZE + count * sizeof(BookEntry))
+    {
+        spdlog::error("{} is not a valid opening book", path);
+        this->file.close();
+        return false;
+    }
+    this->file.adviseRandomAccess();
+    this->entries = reinterpret_cast<const BookEntry *>(base + BOOK_HEADER_SIZE);
+    this->numEntries = static_cast<size_t>(count);
+    spdlog::info("opening book loaded: {} entries", this->numEntries);
+    return true;
+}
+
+/**
+ * Unmap the book: every lookup is empty until the next open()
+ */
+void OpeningBook::close()
+{
+    this->entries = nullptr;
+    this->numEntries = 0;
+    this->file.close();
+}
+
+/**
+ * Whether a book is mapped
+ */
+bool OpeningBook::isOpen() const
+{
+    return this->entries != nullptr;
+}
+
+/**
+ * Total (position, move) entries
+ */
+size_t OpeningBook::size() const
+{
+    return this->numEntries;
+}
+
+/**
+ * Find all book moves of this position (binary search over mapped entries)
+ * @param pos the position
+ * @return range of entries, best weight first. Empty if position is not in book
+ */
+BookRange OpeningBook::lookup(const Position &pos) const
+{
+    if (this->entries == nullptr)
+    {
+        return BookRange{};
+    }
+    const uint64_t key = hashPosition(pos);
+    const BookEntry *begin = this->entries;
+    const BookEntry *end = this->entries + this->numEntries;
+    const auto [first, last] = std::equal_range(
+        begin, end, BookEntry{key, 0, 0, 0, 0}, [](const BookEntry &a, const BookEntry &b) { return a.key < b.key; });
+    return BookRange{first, last};
+}
+
+/**
+ * All entries of this book, in file order
+ */
+BookRange OpeningBook::getAllEntries() const
+{
+    return BookRange{this->entries, this->entries + this->numEntries};
+}
+
+/**
+ * Pick a book move at random, proportional to weight. Entries that are not legal here
+ * (hash collision) are ignored.
+ * @param pos the position
+ * @param rng random generator
+ * @return the chosen move, or empty if out of book
+ */
+std::optional<Move> OpeningBook::pickMove(const Position &pos, std::mt19937 &rng) const
+{
+    MoveList legal;
+    generateMoves(pos, legal);
+    std::vector<Move> candidates;
+    std::vector<uint32_t> weights;
+    for (const BookEntry &entry : this->lookup(pos))
+    {
+        const Move move = entry.toMove();
+        if (entry.weight > 0 && std::find(legal.begin(), legal.end(), move) != legal.end())
+        {
+            candidates.push_back(move);
+            weights.push_back(entry.weight);
+        }
+    }
+    if (candidates.empty())
+    {
+        return std::nullopt;
+    }
+    std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
+    return candidates[dist(rng)];
+}
+
+/**
+ * Custom constructor
+ * @param maxPly only the first `maxPly` moves of each game are recorded
+ */
+OpeningBookBuilder::OpeningBookBuilder(const int maxPly) : maxPly(maxPly)
+{
+}
+
+/**
+ * Record one game. Each move earns 2 points if its side went on to win, 1 for a draw, and 0 for a loss.
+ * @param moves all moves of the game
+ * @param result final result (games without one are ignored)
+ * @param start position the game started from (self-play games start from varied openings)
+ * @return TRUE if game was recorded
+ */
+bool OpeningBookBuilder::addGame(const std::vector<Move> &moves, const GameResult result, const Position &start)
+{
+    if (result == GameResult::UNKNOWN)
+    {
+        return false;
+    }
+    Position pos = start;
+    const int plies = std::min(this->maxPly, static_cast<int>(moves.size()));
+    for (int ply = 0; ply < plies; ply++)
+    {
+        uint32_t earned = 1;
+        if (result != GameResult::DRAW)
+        {
+            const bool moverWon = (result == GameResult::RED_WIN) == (pos.sideToMove == Side::RED);
+            earned = moverWon ? 2 : 0;
+        }
+        this->points[EntryKey{hashPosition(pos), moves[ply]}] += earned;
+        pos = makeMove(pos, moves[ply]);
+    }
+    return true;
+}
+
+/**
+ * Record every finished game of a PDN stream
+ * @param in PDN text
+ * @return number of games recorded
+ */
+size_t OpeningBookBuilder::addPdn(std::istream &in)
+{
+    size_t added = 0;
+    for (const PdnGame &game : readPdnGames(in))
+    {
+        added += this->addGame(game.moves, game.result) ? 1 : 0;
+    }
+    return added;
+}
+
+/**
+ * Merge the weights of an existing book into this one
+ * @param book a mapped book
+ */
+void OpeningBookBuilder::addBook(const OpeningBook &book)
+{
+    for (const BookEntry &entry : book.getAllEntries())
+    {
+        this->points[EntryKey{entry.key, entry.toMove()}] += entry.weight;
+    }
+}
+
+/**
+ * Number of distinct (position, move) pairs recorded so far
+ */
+size_t OpeningBookBuilder::size() const
+{
+    return this->points.size();
+}
+
+/**
+ * Sort all entries by key (best weight first within a key) and write the book file
+ * @param path destination
+ * @param minWeight entries scoring below this are dropped
+ * @return TRUE if successful, else FALSE
+ */
+bool OpeningBookBuilder::save(const std::string &path, const uint32_t minWeight) const
+{
+    std::vector<BookEntry> sorted;
+    sorted.reserve(this->points.size());
+    for (const auto &[ek, pts] : this->points)
+    {
+        if (pts < minWeight || pts == 0)
+        {
+            continue;
+        }
+        const auto weight = static_cast<uint16_t>(std::min<uint32_t>(pts, std::numeric_limits<uint16_t>::max()));
+        sorted.push_back(BookEntry{ek.key, ek.move.captured, ek.move.from, ek.move.to, weight});
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const BookEntry &a, const BookEntry &b) {
+        if (a.key != b.key)
+        {
+            return a.key < b.key;
+        }
+        if (a.weight != b.weight)
+        {
+            return a.weight > b.weight;
+        }
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    });
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if (!out)
+    {
+        spdlog::error("cannot write opening book {}", path);
+        return false;
+    }
+    const uint16_t reserved = 0;
+    const uint64_t count = sorted.size();
+    out.write(reinterpret_cast<const char *>(&BOOK_MAGIC), sizeof(BOOK_MAGIC));
+    out.write(reinterpret_cast<const char *>(&BOOK_VERSION), sizeof(BOOK_VERSION));
+    out.write(reinterpret_cast<const char *>(&reserved), sizeof(reserved));
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char *>(sorted.data()),
+              static_cast<std::streamsize>(sorted.size() * sizeof(BookEntry)));
+    spdlog::info("opening book saved: {} entries", count);
+    return static_cast<bool>(out);
+}
+
+} // namespace chk::engine
@@ -0,0 +1,126 @@
+// created 2026-10-18
+#pragma once
+
+#include "../utils/MappedFile.hpp"
+#include "MoveGen.hpp"
+#include "Pdn.hpp"
+#include "Position.hpp"
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace chk::engine
+{
+constexpr uint32_t BOOK_MAGIC{0x4B424353}; // "SCBK" in little-endian
+constexpr uint16_t BOOK_VERSION{1};
+constexpr uint32_t BOOK_HEADER_SIZE{16};
+constexpr auto BOOK_FILE = "opening.book"; // loaded at startup, if present
+
+/**
+ * One (position, move) pair of the book. The file is a flat array of these, sorted by `key`,
+ * so it can be used straight from the mapped bytes.
+ */
+struct BookEntry
+{
+    uint64_t key;      // Zobrist hash of the position BEFORE the move
+    uint32_t captured; // Move::captured
+    uint8_t from;      // Move::from
+    uint8_t to;        // Move::to
+    uint16_t weight;   // popularity/success score, higher is better
+
+    Move toMove() const
+    {
+        return Move{captured, from, to};
+    }
+};
+static_assert(sizeof(BookEntry) == 16, "BookEntry layout must match the file format");
+static_assert(std::is_trivially_copyable_v<BookEntry>, "BookEntry is read in place from mapped memory");
+
+/**
+ * Contiguous run of entries sharing the same key
+ */
+struct BookRange
+{
+    const BookEntry *first = nullptr;
+    const BookEntry *last = nullptr;
+
+    const BookEntry *begin() const
+    {
+        return first;
+    }
+    const BookEntry *end() const
+    {
+        return last;
+    }
+    bool empty() const
+    {
+        return first == last;
+    }
+};
+
+/**
+ * Read-only opening book. Opening it only maps the file and checks the header: lookups are binary searches
+ * directly over the mapped entries.
+ */
+class OpeningBook final
+{
+  public:
+    OpeningBook() = default;
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+    [[nodiscard]] bool open(const std::string &path);
+    void close();
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] BookRange lookup(const Position &pos) const;
+    [[nodiscard]] BookRange getAllEntries() const;
+    [[nodiscard]] std::optional<Move> pickMove(const Position &pos, std::mt19937 &rng) const;
+
+  private:
+    chk::MappedFile file;
+    const BookEntry *entries = nullptr;
+    size_t numEntries = 0;
+};
+
+/**
+ * Accumulates played games (self-play results, PDN imports, older books) and writes a new book file
+ */
+class OpeningBookBuilder final
+{
+  public:
+    explicit OpeningBookBuilder(int maxPly = 24);
+    bool addGame(const std::vector<Move> &moves, GameResult result, const Position &start = Position::initial());
+    size_t addPdn(std::istream &in);
+    void addBook(const OpeningBook &book);
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool save(const std::string &path, uint32_t minWeight = 1) const;
+
+  private:
+    struct EntryKey
+    {
+        uint64_t key;
+        Move move;
+        bool operator==(const EntryKey &other) const
+        {
+            return key == other.key && move == other.move;
+        }
+    };
+    struct EntryKeyHash
+    {
+        size_t operator()(const EntryKey &k) const
+        {
+            return std::hash<uint64_t>{}(k.key ^ (uint64_t{k.move.captured} << 16) ^ (k.move.from << 8) ^ k.move.to);
+        }
+    };
+
+    const int maxPly;
+    // (position, move) -> accumulated points
+    std::unordered_map<EntryKey, uint32_t, EntryKeyHash> points;
+};
+
+} // namespace chk::engine
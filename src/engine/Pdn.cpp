@@ -0,0 +1,387 @@
+#include "Pdn.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <spdlog/spdlog.h>
+#include <string>
+
+namespace chk::engine
+{
+
+namespace
+{
+/**
+ * Convert a PDN result token. PDN lists the first player (our RED) first
+ * @return result, or empty if this token is not a result at all
+ */
+std::optional<GameResult> parseResultToken(std::string_view token)
+{
+    if (token == "1-0" || token == "2-0")
+    {
+        return GameResult::RED_WIN;
+    }
+    if (token == "0-1" || token == "0-2")
+    {
+        return GameResult::BLACK_WIN;
+    }
+    if (token == "1/2-1/2" || token == "1-1")
+    {
+        return GameResult::DRAW;
+    }
+    if (token == "*")
+    {
+        return GameResult::UNKNOWN;
+    }
+    return std::nullopt;
+}
+
+std::string_view resultToken(const GameResult result)
+{
+    switch (result)
+    {
+    case GameResult::RED_WIN:
+        return "1-0";
+    case GameResult::BLACK_WIN:
+        return "0-1";
+    case GameResult::DRAW:
+        return "1/2-1/2";
+    default:
+        return "*";
+    }
+}
+
+/**
+ * Skip over a bracketed section, honouring nesting, e.g. comments `{...}` or variations `(...)`
+ */
+size_t skipSection(std::string_view text, size_t pos, const char open, const char close)
+{
+    int depth = 0;
+    for (; pos < text.size(); pos++)
+    {
+        if (text[pos] == open)
+        {
+            depth++;
+        }
+        else if (text[pos] == close && --depth == 0)
+        {
+            return pos + 1;
+        }
+    }
+    return pos;
+}
+} // namespace
+
+/**
+ * Parse one move in PDN notation ("11-15", "22x15", "9x18x27") and match it against legal moves
+ * @param pos position BEFORE the move
+ * @param text move text
+ * @return the legal move, or empty if text is invalid or illegal here
+ */
+std::optional<Move> parseMove(const Position &pos, std::string_view text)
+{
+    std::vector<int> squares;
+    bool isCapture = false;
+    int number = 0;
+    bool inNumber = false;
+    for (const char c : text)
+    {
+        if (std::isdigit(static_cast<unsigned char>(c)))
+        {
+            number = number * 10 + (c - '0');
+            inNumber = true;
+            continue;
+        }
+        if (!inNumber || (c != '-' && c != 'x' && c != 'X'))
+        {
+            return std::nullopt;
+        }
+        isCapture = isCapture || c != '-';
+        squares.push_back(toSquare(number));
+        number = 0;
+        inNumber = false;
+    }
+    if (!inNumber)
+    {
+        return std::nullopt;
+    }
+    squares.push_back(toSquare(number));
+    if (squares.size() < 2)
+    {
+        return std::nullopt;
+    }
+
+    MoveList legal;
+    generateMoves(pos, legal);
+    for (const Move &move : legal)
+    {
+        if (move.from != squares.front() || move.to != squares.back() || move.isCapture() != isCapture)
+        {
+            continue;
+        }
+        if (squares.size() == 2)
+        {
+            return move;
+        }
+        const std::vector<int> path = expandPath(pos, move);
+        if (std::equal(squares.begin() + 1, squares.end(), path.begin(), path.end()))
+        {
+            return move;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * Read every game in a PDN stream. Games with a custom setup ([FEN] tag) or illegal moves are skipped
+ * @param in PDN text
+ * @return all valid games, in file order
+ */
+std::vector<PdnGame> readPdnGames(std::istream &in)
+{
+    const std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    const std::string_view text{content};
+
+    std::vector<PdnGame> games;
+    PdnGame current;
+    Position pos = Position::initial();
+    bool valid = true;
+    bool inMoves = false;
+    GameResult tagResult = GameResult::UNKNOWN; // from [Result "..."], used if movetext ends with "*"
+    size_t skipped = 0;
+
+    const auto finishGame = [&](const GameResult result) {
+        if (valid && !current.moves.empty())
+        {
+            current.result = result == GameResult::UNKNOWN ? tagResult : result;
+            games.emplace_back(std::move(current));
+        }
+        else if (!current.moves.empty() || !valid)
+        {
+            skipped++;
+        }
+        current = PdnGame{};
+        pos = Position::initial();
+        valid = true;
+        inMoves = false;
+        tagResult = GameResult::UNKNOWN;
+    };
+
+    size_t i = 0;
+    while (i < text.size())
+    {
+        const char c = text[i];
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            i++;
+            continue;
+        }
+        if (c == '[')
+        {
+            if (inMoves)
+            {
+                // new tag section without result token: close previous game
+                finishGame(GameResult::UNKNOWN);
+            }
+            const size_t end = text.find(']', i);
+            const std::string_view tag = text.substr(i + 1, end == std::string_view::npos ? end : end - i - 1);
+            if (tag.rfind("FEN", 0) == 0)
+            {
+                valid = false; // only games from the standard start are supported
+            }
+            else if (tag.rfind("Result", 0) == 0)
+            {
+                const size_t open = tag.find('"');
+                const size_t close = tag.rfind('"');
+                if (open != std::string_view::npos && close > open)
+                {
+                    tagResult = parseResultToken(tag.substr(open + 1, close - open - 1)).value_or(GameResult::UNKNOWN);
+                }
+            }
+            i = end == std::string_view::npos ? text.size() : end + 1;
+            continue;
+        }
+        if (c == '{')
+        {
+            i = skipSection(text, i, '{', '}');
+            continue;
+        }
+        if (c == '(')
+        {
+            i = skipSection(text, i, '(', ')');
+            continue;
+        }
+        // plain token
+        size_t end = i;
+        while (end < text.size() && !std::isspace(static_cast<unsigned char>(text[end])) && text[end] != '{' &&
+               text[end] != '(' && text[end] != '[')
+        {
+            end++;
+        }
+        std::string_view token = text.substr(i, end - i);
+        i = end;
+
+        if (const auto result = parseResultToken(token); result.has_value())
+        {
+            finishGame(result.value());
+            continue;
+        }
+        // strip move number prefix: "12." or "12..."
+        const size_t dot = token.find_last_of('.');
+        if (dot != std::string_view::npos)
+        {
+            token = token.substr(dot + 1);
+        }
+        if (token.empty() || !valid)
+        {
+            continue;
+        }
+        inMoves = true;
+        const auto move = parseMove(pos, token);
+        if (!move.has_value())
+        {
+            valid = false;
+            continue;
+        }
+        current.moves.push_back(move.value());
+        pos = makeMove(pos, move.value());
+    }
+    if (inMoves)
+    {
+        finishGame(GameResult::UNKNOWN);
+    }
+    if (skipped > 0)
+    {
+        spdlog::warn("skipped {} PDN games (custom setup or illegal moves)", skipped);
+    }
+    return games;
+}
+
+/**
+ * Write one game as PDN, with full capture paths
+ * @param out destination stream
+ * @param game the game
+ */
+void writePdnGame(std::ostream &out, const PdnGame &game)
+{
+    out << "[Event \"SpaceCheckers\"]\n";
+    out << "[Result \"" << resultToken(game.result) << "\"]\n";
+    Position pos = Position::initial();
+    for (size_t ply = 0; ply < game.moves.size(); ply++)
+    {
+        if (ply % 2 == 0)
+        {
+            out << (ply / 2 + 1) << ". ";
+        }
+        out << toNotation(pos, game.moves[ply]) << ' ';
+        pos = makeMove(pos, game.moves[ply]);
+    }
+    out << resultToken(game.result) << "\n\n";
+}
+
+/**
+ * Parse a PDN FEN position string, e.g. "B:W21,22,K30:B1-12". The first letter is the side to move.
+ * PDN "B" is our RED, "W" is our BLACK. Ranges ("1-12") and kings ("K30") are accepted
+ * @param text the FEN (surrounding quotes and trailing '.' allowed)
+ * @return the position, or empty if malformed or illegal (a man on its crown row)
+ */
+std::optional<Position> parseFen(std::string_view text)
+{
+    const auto isJunk = [](const char c) {
+        return std::isspace(static_cast<unsigned char>(c)) || c == '"' || c == '.';
+    };
+    const auto isNumber = [](const std::string &token) {
+        return !token.empty() && std::all_of(token.begin(), token.end(),
+                                             [](const char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+    };
+    while (!text.empty() && isJunk(text.front()))
+    {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isJunk(text.back()))
+    {
+        text.remove_suffix(1);
+    }
+    if (text.size() < 2 || (text[0] != 'B' && text[0] != 'W') || text[1] != ':')
+    {
+        return std::nullopt;
+    }
+    Position pos{0, 0, 0, text[0] == 'B' ? Side::RED : Side::BLACK};
+    size_t start = 2;
+    while (start < text.size())
+    {
+        const size_t end = std::min(text.find(':', start), text.size());
+        const std::string_view group = text.substr(start, end - start);
+        start = end + 1;
+        if (group.empty() || (group[0] != 'B' && group[0] != 'W'))
+        {
+            return std::nullopt;
+        }
+        Bitboard &pieces = group[0] == 'B' ? pos.red : pos.black;
+        size_t i = 1;
+        while (i < group.size())
+        {
+            const size_t comma = std::min(group.find(',', i), group.size());
+            std::string_view item = group.substr(i, comma - i);
+            i = comma + 1;
+            const bool isKing = !item.empty() && item[0] == 'K';
+            if (isKing)
+            {
+                item.remove_prefix(1);
+            }
+            const size_t dash = item.find('-');
+            const std::string first{item.substr(0, dash)};
+            const std::string last{dash == std::string_view::npos ? item : item.substr(dash + 1)};
+            if (!isNumber(first) || !isNumber(last) || first.size() > 2 || last.size() > 2)
+            {
+                return std::nullopt;
+            }
+            const int from = std::stoi(first);
+            const int to = std::stoi(last);
+            if (from < 1 || to > NUM_SQUARES || from > to)
+            {
+                return std::nullopt;
+            }
+            for (int cell = from; cell <= to; cell++)
+            {
+                pieces |= bitOf(toSquare(cell));
+                pos.kings |= isKing ? bitOf(toSquare(cell)) : 0;
+            }
+        }
+    }
+    if ((pos.red & pos.black) != 0)
+    {
+        return std::nullopt;
+    }
+    if ((pos.red & ~pos.kings & RED_CROWN_ROW) != 0 || (pos.black & ~pos.kings & BLACK_CROWN_ROW) != 0)
+    {
+        return std::nullopt; // a man on its own crown row would have been crowned
+    }
+    return pos;
+}
+
+/**
+ * Write position as a PDN FEN string (inverse of `parseFen`)
+ * @param pos the position
+ * @return e.g. "B:W21,22,K30:B1,2,3"
+ */
+std::string toFen(const Position &pos)
+{
+    std::string fen{pos.sideToMove == Side::RED ? "B" : "W"};
+    for (const Side side : {Side::BLACK, Side::RED})
+    {
+        fen += side == Side::RED ? ":B" : ":W";
+        Bitboard pieces = pos.piecesOf(side);
+        bool first = true;
+        while (pieces != 0)
+        {
+            const int sq = popLowest(pieces);
+            fen += first ? "" : ",";
+            fen += (pos.kings & bitOf(sq)) != 0 ? "K" : "";
+            fen += std::to_string(toCellIndex(sq));
+            first = false;
+        }
+    }
+    return fen;
+}
+
+} // namespace chk::engine
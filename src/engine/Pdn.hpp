@@ -0,0 +1,31 @@
+// created 2026-10-18
+#pragma once
+
+#include "MoveGen.hpp"
+#include "Position.hpp"
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace chk::engine
+{
+/**
+ * A game played from the standard starting position.
+ * Board numbering is identical to PDN for English draughts; PDN's first player ("Black") is our RED.
+ */
+struct PdnGame
+{
+    std::vector<Move> moves;
+    GameResult result = GameResult::UNKNOWN;
+};
+
+[[nodiscard]] std::optional<Move> parseMove(const Position &pos, std::string_view text);
+[[nodiscard]] std::vector<PdnGame> readPdnGames(std::istream &in);
+void writePdnGame(std::ostream &out, const PdnGame &game);
+[[nodiscard]] std::optional<Position> parseFen(std::string_view text);
+[[nodiscard]] std::string toFen(const Position &pos);
+
+} // namespace chk::engine
@@ -0,0 +1,191 @@
+#include "Ponderer.hpp"
+#include <spdlog/spdlog.h>
+
+namespace chk::engine
+{
+
+/**
+ * Custom constructor
+ * @param config search behaviour
+ * @param predictTimeMs time spent guessing the opponent's reply, before pondering it
+ */
+Ponderer::Ponderer(const SearchConfig &config, const int64_t predictTimeMs)
+    : searcher(config), predictTimeMs(predictTimeMs)
+{
+    this->searcher.setOnIteration([this](const SearchResult &result) { this->onIteration(result); });
+}
+
+Ponderer::~Ponderer()
+{
+    this->stop();
+}
+
+/**
+ * Begin thinking on the opponent's time (replaces any running search)
+ * @param opponentToMove current position, opponent to move
+ */
+void Ponderer::start(const Position &opponentToMove)
+{
+    this->stop();
+    this->launch(opponentToMove, true, 0);
+}
+
+/**
+ * The opponent's real move has been played: keep the warm search if it was predicted, else restart.
+ * Either way, a search of `actual` is running (or done) afterwards, see `getLatest`
+ *
+ * @param actual position after opponent's move (our side to move)
+ * @param budgetMs how much longer to think
+ * @return whether the prediction was a hit
+ */
+PonderOutcome Ponderer::onOpponentMove(const Position &actual, const int64_t budgetMs)
+{
+    {
+        std::scoped_lock lock{this->mutex};
+        if (!this->cancelled && this->target == actual && (!this->finished || this->latest.has_value()))
+        {
+            if (this->finished)
+            {
+                spdlog::info("ponder hit: search had already finished");
+            }
+            else if (this->targetStarted)
+            {
+                this->searcher.setRemainingTime(budgetMs);
+            }
+            else
+            {
+                this->pendingBudget = budgetMs; // applied by first iteration
+            }
+            return PonderOutcome::HIT;
+        }
+    }
+    const bool wasPondering = !this->finished;
+    this->stop();
+    this->launch(actual, false, budgetMs);
+    return wasPondering ? PonderOutcome::MISS : PonderOutcome::IDLE;
+}
+
+/**
+ * Abort the background search and wait for its thread. Returns quickly: search checks the flag every node
+ */
+void Ponderer::stop()
+{
+    {
+        std::scoped_lock lock{this->mutex};
+        this->cancelled = true;
+    }
+    this->searcher.stop();
+    if (this->worker.joinable())
+    {
+        this->worker.join();
+    }
+}
+
+/**
+ * Last completed iteration, if the background search is working on `pos`
+ * @param pos the position caller is interested in
+ */
+std::optional<SearchResult> Ponderer::getLatest(const Position &pos) const
+{
+    std::scoped_lock lock{this->mutex};
+    if (this->target != pos)
+    {
+        return std::nullopt;
+    }
+    return this->latest;
+}
+
+/**
+ * Position being searched: after the predicted reply while pondering, or the actual one after a miss
+ */
+std::optional<Position> Ponderer::getPrediction() const
+{
+    std::scoped_lock lock{this->mutex};
+    return this->target;
+}
+
+/**
+ * Whether the background thread is still thinking
+ */
+bool Ponderer::isSearching() const
+{
+    return !this->finished;
+}
+
+/**
+ * Reset state and start the worker thread (caller has stopped the previous one)
+ */
+void Ponderer::launch(const Position &pos, const bool predictFirst, const int64_t budgetMs)
+{
+    {
+        std::scoped_lock lock{this->mutex};
+        this->cancelled = false;
+        this->targetStarted = false;
+        this->target = predictFirst ? std::nullopt : std::optional<Position>{pos};
+        this->pendingBudget = std::nullopt;
+        this->latest = std::nullopt;
+    }
+    this->finished = false;
+    this->worker = std::thread(&Ponderer::run, this, pos, predictFirst, budgetMs);
+}
+
+/**
+ * Worker thread body
+ * @param pos position to search (opponent to move, if `predictFirst`)
+ * @param predictFirst guess opponent's reply first, then search the position after it without limit
+ * @param budgetMs time limit of a direct (non-ponder) search
+ */
+void Ponderer::run(const Position pos, const bool predictFirst, const int64_t budgetMs)
+{
+    Position searchPos = pos;
+    if (predictFirst)
+    {
+        const SearchResult guess = this->searcher.search(pos, SearchLimits{MAX_PLY - 1, 0, this->predictTimeMs});
+        std::scoped_lock lock{this->mutex};
+        if (this->cancelled || guess.bestMove == NULL_MOVE)
+        {
+            this->finished = true;
+            return;
+        }
+        searchPos = makeMove(pos, guess.bestMove);
+        this->target = searchPos;
+        spdlog::debug("pondering on predicted reply {}", toNotation(pos, guess.bestMove));
+    }
+    const SearchLimits limits{MAX_PLY - 1, 0, predictFirst ? 0 : budgetMs}; // pondering: open-ended until hit
+    const SearchResult result = this->searcher.search(searchPos, limits);
+    std::scoped_lock lock{this->mutex};
+    if (!this->cancelled)
+    {
+        this->latest = result;
+    }
+    this->finished = true;
+}
+
+/**
+ * Called by the searcher after each iteration (on the worker thread)
+ */
+void Ponderer::onIteration(const SearchResult &result)
+{
+    std::scoped_lock lock{this->mutex};
+    if (this->cancelled)
+    {
+        this->searcher.stop(); // stop() may have landed just before this search began
+        return;
+    }
+    if (!this->target.has_value())
+    {
+        return; // still predicting the reply
+    }
+    this->latest = result;
+    if (!this->targetStarted)
+    {
+        this->targetStarted = true;
+        if (this->pendingBudget.has_value())
+        {
+            this->searcher.setRemainingTime(this->pendingBudget.value());
+            this->pendingBudget = std::nullopt;
+        }
+    }
+}
+
+} // namespace chk::engine
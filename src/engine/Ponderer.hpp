@@ -0,0 +1,60 @@
+// created 2026-10-18
+#pragma once
+
+#include "Search.hpp"
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace chk::engine
+{
+/**
+ * What happened to the background search when the opponent's real move arrived
+ */
+enum class PonderOutcome
+{
+    IDLE, // nothing was being pondered: a fresh search was started
+    HIT,  // opponent played the predicted move: the running search continues, now with a time budget
+    MISS  // prediction was wrong: it was discarded, and a fresh search was started
+};
+
+/**
+ * Thinks on the opponent's time. While they are to move, a background thread predicts their reply
+ * (short search), then searches the position after it with no time limit. When the real move comes:
+ * on a hit the warm search simply continues with a time budget; on a miss it is stopped and
+ * replaced by a fresh search of the actual position.
+ */
+class Ponderer final
+{
+  public:
+    explicit Ponderer(const SearchConfig &config = SearchConfig{}, int64_t predictTimeMs = 200);
+    ~Ponderer();
+    Ponderer(const Ponderer &) = delete;
+    Ponderer &operator=(const Ponderer &) = delete;
+    void start(const Position &opponentToMove);
+    PonderOutcome onOpponentMove(const Position &actual, int64_t budgetMs);
+    void stop();
+    [[nodiscard]] std::optional<SearchResult> getLatest(const Position &pos) const;
+    [[nodiscard]] std::optional<Position> getPrediction() const;
+    [[nodiscard]] bool isSearching() const;
+
+  private:
+    Searcher searcher;
+    int64_t predictTimeMs;
+    std::thread worker;
+    std::atomic_bool finished{true};
+
+    mutable std::mutex mutex;             // guards everything below
+    bool cancelled = false;               // stop() called: unwind as soon as possible
+    bool targetStarted = false;           // first iteration on `target` has completed
+    std::optional<Position> target{};     // position being (or about to be) searched
+    std::optional<int64_t> pendingBudget; // hit arrived before the target search got going
+    std::optional<SearchResult> latest{}; // last completed iteration on `target`
+
+    void launch(const Position &pos, bool predictFirst, int64_t budgetMs);
+    void run(Position pos, bool predictFirst, int64_t budgetMs);
+    void onIteration(const SearchResult &result);
+};
+
+} // namespace chk::engine
@@ -0,0 +1,132 @@
+// created 2026-10-18
+#pragma once
+
+#include "Bitboard.hpp"
+#include <cstdint>
+
+namespace chk::engine
+{
+
+enum class Side : uint8_t
+{
+    RED = 0, // always moves first
+    BLACK,
+};
+
+/**
+ * Get the opposing side
+ */
+constexpr Side opposite(const Side side)
+{
+    return side == Side::RED ? Side::BLACK : Side::RED;
+}
+
+/**
+ * Final outcome of a finished game
+ */
+enum class GameResult : uint8_t
+{
+    UNKNOWN = 0, // unfinished, or not recorded
+    RED_WIN,
+    BLACK_WIN,
+    DRAW,
+};
+
+/**
+ * Compact, SFML-free snapshot of the board used by the engine. Piece IDs are irrelevant here
+ */
+struct Position
+{
+    Bitboard red{0};   // all RED pieces (men and kings)
+    Bitboard black{0}; // all BLACK pieces (men and kings)
+    Bitboard kings{0}; // crowned pieces of either side
+    Side sideToMove{Side::RED};
+
+    /**
+     * Standard starting position: RED on cells 1~12, BLACK on cells 21~32, RED to move
+     */
+    static constexpr Position initial()
+    {
+        return Position{0x00000FFFu, 0xFFF00000u, 0, Side::RED};
+    }
+
+    constexpr Bitboard occupied() const
+    {
+        return red | black;
+    }
+
+    constexpr Bitboard empty() const
+    {
+        return ~(red | black);
+    }
+
+    constexpr Bitboard piecesOf(const Side side) const
+    {
+        return side == Side::RED ? red : black;
+    }
+
+    constexpr Bitboard own() const
+    {
+        return piecesOf(sideToMove);
+    }
+
+    constexpr Bitboard enemy() const
+    {
+        return piecesOf(opposite(sideToMove));
+    }
+
+    constexpr bool operator==(const Position &other) const
+    {
+        return red == other.red && black == other.black && kings == other.kings && sideToMove == other.sideToMove;
+    }
+
+    constexpr bool operator!=(const Position &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Material signature of a position: how many men and kings each side has
+ */
+struct MaterialKey
+{
+    uint8_t redMen{0};
+    uint8_t redKings{0};
+    uint8_t blackMen{0};
+    uint8_t blackKings{0};
+
+    /**
+     * Count material of this position
+     */
+    static MaterialKey of(const Position &pos)
+    {
+        return MaterialKey{static_cast<uint8_t>(popCount(pos.red & ~pos.kings)),
+                           static_cast<uint8_t>(popCount(pos.red & pos.kings)),
+                           static_cast<uint8_t>(popCount(pos.black & ~pos.kings)),
+                           static_cast<uint8_t>(popCount(pos.black & pos.kings))};
+    }
+
+    /**
+     * Total pieces on board
+     */
+    constexpr int total() const
+    {
+        return redMen + redKings + blackMen + blackKings;
+    }
+
+    /**
+     * Pack into a single integer, usable as hash key
+     */
+    constexpr uint32_t packed() const
+    {
+        return (uint32_t{redMen} << 24) | (uint32_t{redKings} << 16) | (uint32_t{blackMen} << 8) | blackKings;
+    }
+
+    constexpr bool operator==(const MaterialKey &other) const
+    {
+        return packed() == other.packed();
+    }
+};
+
+} // namespace chk::engine
@@ -0,0 +1,376 @@
+#include "ProofSearch.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <new>
+
+namespace chk::engine
+{
+
+namespace
+{
+// solved positions share the alpha-beta table: salting the keys keeps them apart (one salt per attacker,
+// since "RED can force a win" and "BLACK can force a win" are different questions about the same position)
+constexpr uint64_t PN_KEY_SALT{0x50524F4F464E554Dull}; // "PROOFNUM"
+constexpr uint64_t PN_BLACK_ATTACKS{0x9B4C2E7D13F0A865ull};
+constexpr int PN_SOLVED_DEPTH{255}; // solved for good: outranks any search result on replacement
+constexpr int PN_PROVEN_SCORE{1};
+constexpr int PN_DISPROVEN_SCORE{-1};
+constexpr uint64_t CLOCK_CHECK_EVERY{256}; // expansions
+
+uint32_t addSaturated(const uint32_t a, const uint32_t b)
+{
+    return std::min<uint64_t>(uint64_t{a} + b, PN_INFINITE);
+}
+
+Bitboard menOf(const Position &pos, const Side side)
+{
+    return pos.piecesOf(side) & ~pos.kings;
+}
+} // namespace
+
+const char *proofResultName(const ProofResult result)
+{
+    switch (result)
+    {
+    case ProofResult::PROVEN:
+        return "win";
+    case ProofResult::DISPROVEN:
+        return "no win";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * Custom constructor. Reserves the whole node arena up front (pages are only committed once used)
+ * @param config search budgets
+ */
+ProofSearcher::ProofSearcher(const ProofConfig &config) : config(config)
+{
+    const size_t bytes = std::max<size_t>(config.memoryMegabytes, 1) << 20;
+    if (this->memory.allocate(bytes, true))
+    {
+        this->arena = static_cast<Node *>(this->memory.data());
+        this->capacity = static_cast<uint32_t>(std::min<size_t>(bytes / sizeof(Node), NO_NODE - 1));
+    }
+}
+
+/**
+ * Share a transposition table: solved positions are stored there and looked up before expanding
+ * @param table table to use (caller keeps it alive), or nullptr for none
+ */
+void ProofSearcher::setTranspositionTable(TranspositionTable *table)
+{
+    this->tt = table;
+}
+
+const ProofConfig &ProofSearcher::getConfig() const
+{
+    return this->config;
+}
+
+/**
+ * Ask a running search to return as soon as possible (safe from any thread)
+ */
+void ProofSearcher::stop()
+{
+    this->stopRequested = true;
+}
+
+/**
+ * Prove or disprove that the side to move can force a win. Runs until solved or out of budget
+ * @param root the position
+ * @return verdict, winning line if proven, and search statistics
+ */
+ProofOutcome ProofSearcher::prove(const Position &root)
+{
+    this->stopRequested = false;
+    this->startTime = std::chrono::steady_clock::now();
+    this->outcome = ProofOutcome{};
+    this->attacker = root.sideToMove;
+    this->used = 0;
+    if (this->capacity == 0)
+    {
+        this->outcome.outOfMemory = true;
+        return this->outcome;
+    }
+    this->initNode(0, root, NO_NODE);
+    this->used = 1;
+
+    const Node &rootNode = this->arena[0];
+    while (rootNode.proof != 0 && rootNode.disproof != 0 && !this->shouldStop())
+    {
+        const uint32_t leaf = this->selectMostProving(0);
+        if (!this->expand(leaf))
+        {
+            this->outcome.outOfMemory = true;
+            break;
+        }
+        this->updateAncestors(leaf);
+    }
+
+    this->outcome.result = rootNode.proof == 0      ? ProofResult::PROVEN
+                           : rootNode.disproof == 0 ? ProofResult::DISPROVEN
+                                                    : ProofResult::UNKNOWN;
+    this->outcome.rootProof = rootNode.proof;
+    this->outcome.rootDisproof = rootNode.disproof;
+    this->outcome.nodes = this->used;
+    this->outcome.elapsedMs = this->elapsedMs();
+    // winning line: attacker's proven move, then any defence (all of them lose)
+    for (uint32_t idx = 0; this->outcome.result == ProofResult::PROVEN && (this->arena[idx].flags & EXPANDED);)
+    {
+        const Node &node = this->arena[idx];
+        MoveList moves;
+        generateMoves(node.pos, moves);
+        const auto first = this->arena + node.firstChild;
+        const auto chosen = std::find_if(first, first + node.numChildren, [](const Node &c) { return c.proof == 0; });
+        const auto i = static_cast<int>(chosen - first);
+        if (i == node.numChildren)
+        {
+            break;
+        }
+        this->outcome.line.push_back(moves[i]);
+        idx = node.firstChild + static_cast<uint32_t>(i);
+    }
+    if (!this->outcome.line.empty())
+    {
+        this->outcome.bestMove = this->outcome.line.front();
+    }
+    return this->outcome;
+}
+
+/**
+ * Fill a fresh node, and solve it straight away if it is terminal, repeated, too deep, or already
+ * in the table. Otherwise its numbers start from its mobility: many moves are easy to have one work
+ * out for the side to move, and hard to refute all of them for the other
+ * @param idx arena slot
+ * @param pos the position
+ * @param parent parent slot (NO_NODE for the root)
+ */
+void ProofSearcher::initNode(const uint32_t idx, const Position &pos, const uint32_t parent)
+{
+    Node &node = *new (this->arena + idx) Node{};
+    node.pos = pos;
+    node.key = hashPosition(pos);
+    node.parent = parent;
+    node.ply = parent == NO_NODE ? 0 : static_cast<uint16_t>(this->arena[parent].ply + 1);
+
+    const bool attackerToMove = pos.sideToMove == this->attacker;
+    const auto solve = [&node](const bool proven) {
+        node.proof = proven ? 0 : PN_INFINITE;
+        node.disproof = proven ? PN_INFINITE : 0;
+    };
+    MoveList moves;
+    generateMoves(pos, moves);
+    TtEntry entry;
+    if (moves.empty())
+    {
+        solve(!attackerToMove); // side to move has lost
+    }
+    else if (parent != NO_NODE && this->repeatsOnPath(parent, node))
+    {
+        this->outcome.repetitions++;
+        solve(false);
+        node.flags |= PATH_DEPENDENT;
+    }
+    else if (node.ply >= this->config.maxPlies)
+    {
+        solve(false);
+        node.flags |= PATH_DEPENDENT;
+    }
+    else if (parent != NO_NODE && this->tt != nullptr && this->tt->probe(this->tableKey(node.key), entry) &&
+             entry.bound == TtBound::EXACT && entry.depth == PN_SOLVED_DEPTH &&
+             (entry.score == PN_PROVEN_SCORE || entry.score == PN_DISPROVEN_SCORE))
+    {
+        this->outcome.ttHits++;
+        solve(entry.score == PN_PROVEN_SCORE);
+    }
+    else
+    {
+        const auto mobility = static_cast<uint32_t>(moves.size());
+        node.proof = attackerToMove ? 1 : mobility;
+        node.disproof = attackerToMove ? mobility : 1;
+    }
+}
+
+/**
+ * Whether `node` already occurred on the way down from the root. Stops at the last irreversible
+ * move: men only go forward, and captured pieces never come back
+ * @param parent the node's parent
+ * @param node the new node
+ */
+bool ProofSearcher::repeatsOnPath(const uint32_t parent, const Node &node) const
+{
+    for (uint32_t idx = parent; idx != NO_NODE; idx = this->arena[idx].parent)
+    {
+        const Position &earlier = this->arena[idx].pos;
+        if (menOf(earlier, Side::RED) != menOf(node.pos, Side::RED) ||
+            menOf(earlier, Side::BLACK) != menOf(node.pos, Side::BLACK) ||
+            popCount(earlier.occupied()) != popCount(node.pos.occupied()))
+        {
+            return false;
+        }
+        if (this->arena[idx].key == node.key && earlier == node.pos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Walk down to the leaf whose solution would help the root most: the attacker tries the child
+ * closest to a proof, the defender the child closest to a disproof
+ * @param idx start node (unsolved)
+ */
+uint32_t ProofSearcher::selectMostProving(uint32_t idx) const
+{
+    while (this->arena[idx].flags & EXPANDED)
+    {
+        const Node &node = this->arena[idx];
+        const bool attackerToMove = node.pos.sideToMove == this->attacker;
+        uint32_t best = node.firstChild;
+        for (uint32_t child = node.firstChild; child < node.firstChild + node.numChildren; child++)
+        {
+            const Node &c = this->arena[child];
+            const Node &b = this->arena[best];
+            if (attackerToMove ? c.proof < b.proof : c.disproof < b.disproof)
+            {
+                best = child;
+            }
+        }
+        idx = best;
+    }
+    return idx;
+}
+
+/**
+ * Create all children of a leaf
+ * @param idx the leaf
+ * @return FALSE if the arena has no room left
+ */
+bool ProofSearcher::expand(const uint32_t idx)
+{
+    MoveList moves;
+    generateMoves(this->arena[idx].pos, moves);
+    if (this->capacity - this->used < moves.size())
+    {
+        return false;
+    }
+    const uint32_t first = this->used;
+    this->used += static_cast<uint32_t>(moves.size());
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        this->initNode(first + static_cast<uint32_t>(i), makeMove(this->arena[idx].pos, moves[i]), idx);
+    }
+    Node &node = this->arena[idx];
+    node.firstChild = first;
+    node.numChildren = static_cast<uint16_t>(moves.size());
+    node.flags |= EXPANDED;
+    this->outcome.expansions++;
+    return true;
+}
+
+/**
+ * Recompute numbers from `idx` up to the root, storing nodes that became solved.
+ * Stops early once a node's numbers no longer change
+ * @param idx the node just expanded
+ */
+void ProofSearcher::updateAncestors(uint32_t idx)
+{
+    while (idx != NO_NODE)
+    {
+        Node &node = this->arena[idx];
+        const uint32_t oldProof = node.proof;
+        const uint32_t oldDisproof = node.disproof;
+        this->recompute(node);
+        const bool changed = node.proof != oldProof || node.disproof != oldDisproof;
+        if (changed && (node.proof == 0 || node.disproof == 0))
+        {
+            this->storeSolved(node);
+        }
+        if (!changed)
+        {
+            break; // nothing above can change either
+        }
+        idx = node.parent;
+    }
+}
+
+/**
+ * Numbers of an expanded node from its children. Attacker to move: proof is the easiest child's, disproof
+ * needs every child. Defender to move: the other way round. A disproof is path-dependent when it rests on
+ * path-dependent children (proofs never do: repetitions and the ply limit only ever disprove)
+ * @param node the node
+ */
+void ProofSearcher::recompute(Node &node) const
+{
+    const bool attackerToMove = node.pos.sideToMove == this->attacker;
+    uint32_t minimum = PN_INFINITE;
+    uint32_t sum = 0;
+    bool anyDependent = false; // among disproven children
+    bool allDependent = true;
+    for (uint32_t child = node.firstChild; child < node.firstChild + node.numChildren; child++)
+    {
+        const Node &c = this->arena[child];
+        minimum = std::min(minimum, attackerToMove ? c.proof : c.disproof);
+        sum = addSaturated(sum, attackerToMove ? c.disproof : c.proof);
+        if (c.disproof == 0)
+        {
+            anyDependent = anyDependent || (c.flags & PATH_DEPENDENT);
+            allDependent = allDependent && (c.flags & PATH_DEPENDENT);
+        }
+    }
+    node.proof = attackerToMove ? minimum : sum;
+    node.disproof = attackerToMove ? sum : minimum;
+    const bool dependent = node.disproof == 0 && (attackerToMove ? anyDependent : allDependent);
+    node.flags = static_cast<uint8_t>(dependent ? node.flags | PATH_DEPENDENT : node.flags & ~PATH_DEPENDENT);
+}
+
+/**
+ * Record a solved node in the table, unless its disproof only holds on this path
+ * @param node the solved node
+ */
+void ProofSearcher::storeSolved(const Node &node)
+{
+    if (this->tt == nullptr || (node.flags & PATH_DEPENDENT))
+    {
+        return;
+    }
+    const int score = node.proof == 0 ? PN_PROVEN_SCORE : PN_DISPROVEN_SCORE;
+    this->tt->store(this->tableKey(node.key), score, PN_SOLVED_DEPTH, TtBound::EXACT, NULL_MOVE);
+}
+
+bool ProofSearcher::shouldStop() const
+{
+    if (this->stopRequested.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+    if (this->config.maxNodes > 0 && this->used >= this->config.maxNodes)
+    {
+        return true;
+    }
+    return this->config.maxTimeMs > 0 && this->outcome.expansions % CLOCK_CHECK_EVERY == 0 &&
+           this->elapsedMs() >= this->config.maxTimeMs;
+}
+
+/**
+ * Table key of a solved position: its hash, moved out of alpha-beta's key space
+ * @param key position hash
+ */
+uint64_t ProofSearcher::tableKey(const uint64_t key) const
+{
+    return key ^ PN_KEY_SALT ^ (this->attacker == Side::BLACK ? PN_BLACK_ATTACKS : 0);
+}
+
+/**
+ * Milliseconds since current search started
+ */
+int64_t ProofSearcher::elapsedMs() const
+{
+    const auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - this->startTime).count();
+}
+
+} // namespace chk::engine
@@ -0,0 +1,120 @@
+// created 2026-10-18
+#pragma once
+
+#include "LargePages.hpp"
+#include "MoveGen.hpp"
+#include "Position.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace chk::engine
+{
+constexpr uint32_t PN_INFINITE{UINT32_MAX / 2}; // proof / disproof number of a solved node
+
+/**
+ * Verdict of a proof-number search, for the side to move at the root
+ */
+enum class ProofResult : uint8_t
+{
+    UNKNOWN = 0, // budget ran out first
+    PROVEN,      // side to move can force a win
+    DISPROVEN,   // it cannot (the other side wins, or holds the draw)
+};
+
+[[nodiscard]] const char *proofResultName(ProofResult result);
+
+/**
+ * Budgets of a proof-number search. The search stops at whichever runs out first
+ */
+struct ProofConfig
+{
+    uint64_t maxNodes = 10'000'000; // tree nodes created (0 = no limit, memory still applies)
+    size_t memoryMegabytes = 256;   // arena size: the tree never grows beyond it
+    int maxPlies = 120;             // deeper lines count as "no win" (not stored in the table)
+    int64_t maxTimeMs = 0;          // 0 = no limit
+};
+
+/**
+ * Outcome of a proof-number search
+ */
+struct ProofOutcome
+{
+    ProofResult result = ProofResult::UNKNOWN;
+    Move bestMove = NULL_MOVE; // winning move, if proven
+    std::vector<Move> line{};  // winning line, as far as the tree shows it (defender's replies are arbitrary)
+    uint32_t rootProof = 0;    // root proof & disproof numbers when the search stopped
+    uint32_t rootDisproof = 0;
+    uint64_t nodes = 0;        // tree nodes created
+    uint64_t expansions = 0;
+    uint64_t ttHits = 0;       // subtrees skipped: position already solved (transposition, or earlier search)
+    uint64_t repetitions = 0;  // lines cut as drawn by repetition
+    bool outOfMemory = false;  // arena was full
+    int64_t elapsedMs = 0;
+};
+
+/**
+ * Proof-number search (Allis): proves or disproves that the side to move can force a win. Always expands
+ * the most-proving leaf, so narrow forcing lines (captures, few replies) are followed first, without any
+ * evaluation function. Draws by repetition and lines longer than `maxPlies` count as "no win".
+ *
+ * Nodes live in one arena taken from the OS (huge pages when possible), indexed by uint32, and are never
+ * freed during a search. Solved positions go to a transposition table (the same table alpha-beta uses, under
+ * a separate key space), so transpositions, and later searches, reuse them. Disproofs that rest on the path
+ * (repetition, ply limit) are never stored.
+ */
+class ProofSearcher final
+{
+  public:
+    explicit ProofSearcher(const ProofConfig &config = ProofConfig{});
+    ProofSearcher(const ProofSearcher &) = delete;
+    ProofSearcher &operator=(const ProofSearcher &) = delete;
+    void setTranspositionTable(TranspositionTable *table);
+    ProofOutcome prove(const Position &root);
+    void stop();
+    [[nodiscard]] const ProofConfig &getConfig() const;
+
+  private:
+    static constexpr uint32_t NO_NODE{UINT32_MAX};
+    static constexpr uint8_t EXPANDED{1};
+    static constexpr uint8_t PATH_DEPENDENT{2}; // solved via repetition / ply limit somewhere below
+
+    struct Node
+    {
+        Position pos;
+        uint64_t key = 0;
+        uint32_t parent = NO_NODE;
+        uint32_t firstChild = NO_NODE; // children are contiguous, in move generation order
+        uint32_t proof = 1;
+        uint32_t disproof = 1;
+        uint16_t numChildren = 0;
+        uint16_t ply = 0;
+        uint8_t flags = 0;
+    };
+
+    ProofConfig config;
+    LargeBuffer memory; // the arena (zero pages are valid empty nodes)
+    Node *arena = nullptr;
+    uint32_t capacity = 0;
+    uint32_t used = 0;
+    TranspositionTable *tt = nullptr;
+    Side attacker{Side::RED};
+    ProofOutcome outcome{};
+    std::atomic_bool stopRequested{false};
+    std::chrono::steady_clock::time_point startTime{};
+
+    void initNode(uint32_t idx, const Position &pos, uint32_t parent);
+    [[nodiscard]] bool repeatsOnPath(uint32_t parent, const Node &node) const;
+    [[nodiscard]] uint32_t selectMostProving(uint32_t idx) const;
+    [[nodiscard]] bool expand(uint32_t idx);
+    void updateAncestors(uint32_t idx);
+    void recompute(Node &node) const;
+    void storeSolved(const Node &node);
+    [[nodiscard]] bool shouldStop() const;
+    [[nodiscard]] uint64_t tableKey(uint64_t key) const;
+    [[nodiscard]] int64_t elapsedMs() const;
+};
+
+} // namespace chk::engine
@@ -0,0 +1,541 @@
+#include "Protocol.hpp"
+#include "../AppVersion.hpp"
+#include "Pdn.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr int MAX_MULTI_PV{16};
+constexpr int DEFAULT_HASH_MB{16};
+constexpr int MAX_HASH_MB{1 << 16};
+
+/**
+ * Score as "cp <n>", or "mate <moves>" (negative when losing) for forced wins
+ */
+std::string formatScore(const int score)
+{
+    if (std::abs(score) < SCORE_WIN - MAX_PLY)
+    {
+        return "cp " + std::to_string(score);
+    }
+    const int plies = SCORE_WIN - std::abs(score);
+    const int moves = (plies + 1) / 2;
+    return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+/**
+ * Time-manager decision as an "info string time ..." line
+ */
+std::string formatTimeDecision(const TimeDecision &decision)
+{
+    if (decision.depth == 0)
+    {
+        return "info string time budget optimum " + std::to_string(decision.targetMs) + " maximum " +
+               std::to_string(decision.maximumMs);
+    }
+    return "info string time depth " + std::to_string(decision.depth) + " elapsed " +
+           std::to_string(decision.elapsedMs) + " target " + std::to_string(decision.targetMs) + " stable " +
+           std::to_string(decision.stableIterations) + " swing " + std::to_string(decision.scoreSwing) +
+           (decision.stop ? " stop" : " continue");
+}
+} // namespace
+
+/**
+ * Custom constructor
+ * @param out where replies are written (stdout for the engine executable)
+ */
+EngineProtocol::EngineProtocol(std::ostream &out) : out(out), tt(DEFAULT_HASH_MB)
+{
+}
+
+EngineProtocol::~EngineProtocol()
+{
+    this->stopSearch();
+    this->tt.waitForSave();
+}
+
+/**
+ * Execute one command line
+ * @param line the command
+ * @return FALSE if the engine should exit ("quit"), else TRUE
+ */
+bool EngineProtocol::handleLine(std::string_view line)
+{
+    std::istringstream args{std::string{line}};
+    std::string command;
+    if (!(args >> command))
+    {
+        return true; // blank line
+    }
+    if (command == "uci")
+    {
+        this->send(std::string{"id name SpaceCheckers "} + chk::APP_VERSION);
+        this->send("id author SpaceCheckers contributors");
+        this->send("option name MultiPV type spin default 1 min 1 max " + std::to_string(MAX_MULTI_PV));
+        this->send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) + " min 1 max " +
+                   std::to_string(MAX_HASH_MB));
+        this->send("option name HashFile type string default <empty>");
+        this->send("option name NnueFile type string default <empty>");
+        this->send("option name EvalFile type string default <empty>");
+        this->send("option name TablebaseDir type string default <empty>");
+        this->send("option name BookFile type string default <empty>");
+        this->send("option name LogTime type check default false");
+        this->send("option name EngineMode type combo default alphabeta var alphabeta var mcts");
+        this->send("uciok");
+    }
+    else if (command == "isready")
+    {
+        this->send("readyok");
+    }
+    else if (command == "setoption")
+    {
+        this->cmdSetOption(args);
+    }
+    else if (command == "ucinewgame")
+    {
+        this->stopSearch();
+        this->position = Position::initial();
+        if (this->mcts != nullptr)
+        {
+            this->mcts->clear();
+        }
+    }
+    else if (command == "position")
+    {
+        this->cmdPosition(args);
+    }
+    else if (command == "go")
+    {
+        this->cmdGo(args);
+    }
+    else if (command == "stop")
+    {
+        this->stopSearch();
+    }
+    else if (command == "savehash")
+    {
+        this->cmdSaveHash();
+    }
+    else if (command == "d")
+    {
+        this->send("fen " + toFen(this->position));
+    }
+    else if (command == "stats")
+    {
+        this->cmdStats();
+    }
+    else if (command == "quit")
+    {
+        this->stopSearch();
+        if (!this->hashFile.empty() && !this->tt.save(this->hashFile))
+        {
+            this->send("info string cannot save hash to " + this->hashFile);
+        }
+        return false;
+    }
+    else
+    {
+        this->send("info string unknown command " + command);
+    }
+    return true;
+}
+
+/**
+ * Block until the current search (if any) has finished on its own
+ */
+void EngineProtocol::waitForSearch()
+{
+    if (this->worker.joinable())
+    {
+        this->worker.join();
+    }
+}
+
+/**
+ * Use this opening book from now on (an empty path, or one that fails to open, means no book)
+ * @param path location of book file
+ * @return TRUE if the book is open
+ */
+bool EngineProtocol::openBook(const std::string &path)
+{
+    this->stopSearch();
+    if (path.empty() || path == "<empty>")
+    {
+        this->book.close();
+        return false;
+    }
+    return this->book.open(path);
+}
+
+/**
+ * Write one reply line and flush (GUIs read line by line)
+ */
+void EngineProtocol::send(const std::string &line)
+{
+    std::scoped_lock lock{this->outMutex};
+    this->out << line << '\n';
+    this->out.flush();
+}
+
+/**
+ * setoption name <Name> value <Value>
+ */
+void EngineProtocol::cmdSetOption(std::istringstream &args)
+{
+    std::string token, name, value;
+    args >> token >> name >> token; // "name" <Name> "value"
+    std::getline(args >> std::ws, value);
+    this->stopSearch();
+    if (name == "MultiPV")
+    {
+        this->multiPv = std::clamp(std::atoi(value.c_str()), 1, MAX_MULTI_PV);
+    }
+    else if (name == "LogTime")
+    {
+        this->logTime = value == "true";
+    }
+    else if (name == "EngineMode")
+    {
+        this->useMcts = value == "mcts";
+    }
+    else if (name == "NnueFile")
+    {
+        this->network = value.empty() || value == "<empty>" ? nullptr : NnueNetwork::load(value);
+        if (this->network == nullptr && !value.empty() && value != "<empty>")
+        {
+            this->send("info string cannot load NNUE file " + value);
+        }
+    }
+    else if (name == "Hash")
+    {
+        this->tt.resize(static_cast<size_t>(std::clamp(std::atoi(value.c_str()), 1, MAX_HASH_MB)));
+    }
+    else if (name == "HashFile")
+    {
+        // restore now (if the file exists yet), save again on "quit"
+        this->hashFile = value == "<empty>" ? "" : value;
+        std::error_code error;
+        if (!this->hashFile.empty() && std::filesystem::exists(this->hashFile, error))
+        {
+            if (!this->tt.load(this->hashFile))
+            {
+                this->send("info string cannot load hash from " + this->hashFile);
+            }
+        }
+    }
+    else if (name == "EvalFile")
+    {
+        const auto weights = value.empty() || value == "<empty>" ? std::nullopt : loadEvalWeights(value);
+        this->evalWeights = weights.has_value() ? std::make_unique<EvalWeights>(weights.value()) : nullptr;
+        if (!weights.has_value() && !value.empty() && value != "<empty>")
+        {
+            this->send("info string cannot load eval weights " + value);
+        }
+    }
+    else if (name == "BookFile")
+    {
+        if (!this->openBook(value) && !value.empty() && value != "<empty>")
+        {
+            this->send("info string cannot load opening book " + value);
+        }
+    }
+    else if (name == "TablebaseDir")
+    {
+        this->tablebase = std::make_unique<Tablebase>();
+        const size_t count = this->tablebase->loadDirectory(value);
+        this->send("info string " + std::to_string(count) + " tablebase slices loaded");
+        this->searcher = nullptr; // searcher holds the tablebase pointer
+    }
+    else
+    {
+        this->send("info string unknown option " + name);
+    }
+}
+
+/**
+ * position (startpos | fen <FEN>) [moves <m1> <m2> ...]
+ */
+void EngineProtocol::cmdPosition(std::istringstream &args)
+{
+    this->stopSearch();
+    std::string token;
+    args >> token;
+    Position pos = Position::initial();
+    if (token == "fen")
+    {
+        std::string fen;
+        while (args >> token && token != "moves")
+        {
+            fen += token;
+        }
+        const auto parsed = parseFen(fen);
+        if (!parsed.has_value())
+        {
+            this->send("info string invalid fen " + fen);
+            return;
+        }
+        pos = parsed.value();
+    }
+    else if (token == "startpos")
+    {
+        args >> token; // "moves", if any
+    }
+    else
+    {
+        this->send("info string expected startpos or fen");
+        return;
+    }
+    while (args >> token)
+    {
+        const auto move = parseMove(pos, token);
+        if (!move.has_value())
+        {
+            this->send("info string illegal move " + token);
+            return;
+        }
+        pos = makeMove(pos, move.value());
+    }
+    this->position = pos;
+}
+
+/**
+ * go [depth <N>] [nodes <N>] [movetime <ms>] [time <ms> [inc <ms>] [movestogo <N>]] [multipv <N>] [infinite].
+ * `time` is the engine's clock: the time manager decides how much of it this move gets (unless movetime is given).
+ * Returns at once; search runs on its own thread
+ */
+void EngineProtocol::cmdGo(std::istringstream &args)
+{
+    this->stopSearch();
+    SearchLimits limits{};
+    limits.multiPv = this->multiPv;
+    bool infinite = false;
+    std::string token;
+    while (args >> token)
+    {
+        int64_t value = 0;
+        if (token == "infinite")
+        {
+            infinite = true; // same as no limit, but analysis: no book move
+            continue;
+        }
+        if (!(args >> value))
+        {
+            break;
+        }
+        if (token == "depth")
+        {
+            limits.maxDepth = static_cast<int>(std::clamp<int64_t>(value, 1, MAX_PLY - 1));
+        }
+        else if (token == "nodes")
+        {
+            limits.maxNodes = static_cast<uint64_t>(std::max<int64_t>(value, 1));
+        }
+        else if (token == "movetime")
+        {
+            limits.moveTimeMs = std::max<int64_t>(value, 1);
+        }
+        else if (token == "time")
+        {
+            limits.clock.remainingMs = std::max<int64_t>(value, 1);
+        }
+        else if (token == "inc")
+        {
+            limits.clock.incrementMs = std::max<int64_t>(value, 0);
+        }
+        else if (token == "movestogo")
+        {
+            limits.clock.movesToGo = static_cast<int>(std::clamp<int64_t>(value, 0, 1000));
+        }
+        else if (token == "multipv")
+        {
+            limits.multiPv = static_cast<int>(std::clamp<int64_t>(value, 1, MAX_MULTI_PV));
+        }
+    }
+    if (!infinite && limits.multiPv == 1 && this->book.isOpen())
+    {
+        if (const auto move = this->book.pickMove(this->position, this->bookRng))
+        {
+            this->send("info string book move");
+            this->send("bestmove " + toNotation(this->position, move.value()));
+            return;
+        }
+    }
+    if (this->useMcts)
+    {
+        this->goMcts(this->position, limits);
+        return;
+    }
+    if (this->searcher == nullptr)
+    {
+        this->searcher = std::make_unique<Searcher>(SearchConfig{}, this->tablebase.get(), &this->engineStats);
+    }
+    this->searcher->setNetwork(this->network.get());
+    this->searcher->setEvalWeights(this->evalWeights.get());
+    this->searcher->setTranspositionTable(&this->tt);
+    const Position root = this->position;
+    this->stopPending = false;
+    this->searcher->setOnIteration([this, root](const SearchResult &result) {
+        if (this->stopPending)
+        {
+            this->searcher->stop(); // stop arrived before search() started, and was reset by it
+        }
+        {
+            std::scoped_lock lock{this->resultMutex};
+            this->lastRoot = root;
+            this->lastResult = result;
+        }
+        this->sendInfo(root, result);
+    });
+    this->searcher->setOnTimeDecision(nullptr);
+    if (this->logTime)
+    {
+        this->searcher->setOnTimeDecision(
+            [this](const TimeDecision &decision) { this->send(formatTimeDecision(decision)); });
+    }
+    this->worker = std::thread([this, root, limits] {
+        const SearchResult result = this->searcher->search(root, limits);
+        if (result.depth == 0 && result.bestMove != NULL_MOVE)
+        {
+            this->sendInfo(root, result); // forced move: no iteration was reported
+        }
+        this->sendBestMove(root, result);
+    });
+}
+
+/**
+ * "go" for the MCTS engine. Returns at once; search runs on its own thread. A clock is turned into a fixed
+ * time by the time manager's budget for the move (MCTS has no iterations for it to judge on the way)
+ * @param root position to search
+ * @param limits as parsed by "go"
+ */
+void EngineProtocol::goMcts(const Position &root, SearchLimits limits)
+{
+    if (this->mcts == nullptr)
+    {
+        this->mcts = std::make_unique<MctsSearcher>();
+    }
+    if (limits.moveTimeMs <= 0 && limits.clock.remainingMs > 0)
+    {
+        TimeManager timeManager;
+        timeManager.start(root, limits.clock);
+        limits.moveTimeMs = timeManager.getOptimumMs();
+    }
+    this->stopPending = false;
+    this->mcts->setOnProgress([this, root](const MctsResult &progress) {
+        if (this->stopPending)
+        {
+            this->mcts->stop(); // stop arrived before search() started, and was reset by it
+        }
+        const SearchResult result = toSearchResult(progress);
+        {
+            std::scoped_lock lock{this->resultMutex};
+            this->lastRoot = root;
+            this->lastResult = result;
+        }
+        this->sendInfo(root, result);
+    });
+    this->worker = std::thread([this, root, limits] {
+        const SearchResult result = toSearchResult(this->mcts->search(root, limits));
+        this->sendInfo(root, result); // progress is only sampled: report the final tree too
+        this->sendBestMove(root, result);
+    });
+}
+
+/**
+ * stats: counters of the latest search (or of its last completed iteration, while it still runs) as JSON
+ */
+void EngineProtocol::cmdStats()
+{
+    std::unique_lock lock{this->resultMutex};
+    if (!this->lastResult.has_value())
+    {
+        lock.unlock();
+        this->send("info string no search yet");
+        return;
+    }
+    const std::string json = toJson(this->lastRoot, this->lastResult.value());
+    lock.unlock();
+    this->send("stats " + json);
+}
+
+/**
+ * savehash: write the table to HashFile on a background thread; searching can go on meanwhile
+ */
+void EngineProtocol::cmdSaveHash()
+{
+    if (this->hashFile.empty())
+    {
+        this->send("info string set HashFile first");
+        return;
+    }
+    this->tt.saveInBackground(this->hashFile);
+}
+
+/**
+ * Stop current search (its thread still reports "bestmove") and wait for it
+ */
+void EngineProtocol::stopSearch()
+{
+    this->stopPending = true;
+    if (this->searcher != nullptr)
+    {
+        this->searcher->stop();
+    }
+    if (this->mcts != nullptr)
+    {
+        this->mcts->stop();
+    }
+    this->waitForSearch();
+}
+
+/**
+ * One "info" line per multi-PV line
+ */
+void EngineProtocol::sendInfo(const Position &root, const SearchResult &result)
+{
+    const uint64_t nps = result.nodesPerSecond();
+    for (size_t k = 0; k < result.lines.size(); k++)
+    {
+        std::string line = "info depth " + std::to_string(result.depth) + " multipv " + std::to_string(k + 1) +
+                           " score " + formatScore(result.lines[k].score) + " nodes " +
+                           std::to_string(result.stats.nodes) + " nps " + std::to_string(nps) + " time " +
+                           std::to_string(result.elapsedMs) + " pv";
+        Position pos = root;
+        for (const Move &move : result.lines[k].pv)
+        {
+            line += " " + toNotation(pos, move);
+            pos = makeMove(pos, move);
+        }
+        this->send(line);
+    }
+}
+
+/**
+ * Keep the finished search for "stats", then reply "bestmove <move> [ponder <move>]" (or "bestmove none")
+ */
+void EngineProtocol::sendBestMove(const Position &root, const SearchResult &result)
+{
+    {
+        std::scoped_lock lock{this->resultMutex};
+        this->lastRoot = root;
+        this->lastResult = result;
+    }
+    if (result.bestMove == NULL_MOVE)
+    {
+        this->send("bestmove none");
+        return;
+    }
+    std::string reply = "bestmove " + toNotation(root, result.bestMove);
+    if (result.pv.size() >= 2)
+    {
+        reply += " ponder " + toNotation(makeMove(root, result.bestMove), result.pv[1]);
+    }
+    this->send(reply);
+}
+
+} // namespace chk::engine
@@ -0,0 +1,100 @@
+// created 2026-10-18
+#pragma once
+
+#include "EngineStats.hpp"
+#include "Evaluation.hpp"
+#include "Mcts.hpp"
+#include "Nnue.hpp"
+#include "OpeningBook.hpp"
+#include "Search.hpp"
+#include "Tablebase.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace chk::engine
+{
+/**
+ * Line-based text protocol for external GUIs and tournament managers, modelled on UCI.
+ * Moves are in PDN notation ("11-15", "22x15"), positions are PDN FEN strings.
+ *
+ * Commands:
+ *   uci                                    -> id lines, options, "uciok"
+ *   isready                                -> "readyok"
+ *   setoption name <Name> value <Value>    (MultiPV, Hash, HashFile, NnueFile, EvalFile, TablebaseDir, BookFile,
+ *                                           LogTime, EngineMode)
+ *   ucinewgame
+ *   position (startpos | fen <FEN>) [moves <m1> <m2> ...]
+ *   go [depth <N>] [nodes <N>] [movetime <ms>] [time <ms> [inc <ms>] [movestogo <N>]] [multipv <N>] [infinite]
+ *   stop
+ *   savehash                               write the table to HashFile in the background (also done on quit)
+ *   d                                      -> "fen <FEN>" of the current position
+ *   stats                                  -> "stats <JSON>": counters of the latest (or running) search
+ *   quit
+ * Replies while searching, one per multi-PV line and iteration:
+ *   info depth <D> multipv <K> score (cp <S> | mate <M>) nodes <N> nps <N> time <ms> pv <moves...>
+ * and when done: "bestmove <move> [ponder <move>]" (or "bestmove none" if there is no legal move).
+ * With LogTime on, a clocked "go" also reports how the time manager spends the clock:
+ *   info string time budget optimum <ms> maximum <ms>
+ *   info string time depth <D> elapsed <ms> target <ms> stable <N> swing <S> (continue | stop)
+ * With EngineMode "mcts", "go" runs Monte Carlo Tree Search instead: "nodes" counts playouts, "depth" is
+ * ignored, and a clock becomes a fixed time for the move. Info lines then report the most visited line,
+ * its win rate as a score, and playouts as nodes, every 100 ms. The tree is kept between moves.
+ * With a book open, "go" plays a book move at once while the position is in book (except for
+ * "go infinite" and multi-PV, which ask for analysis): "info string book move", then "bestmove <move>"
+ */
+class EngineProtocol final
+{
+  public:
+    explicit EngineProtocol(std::ostream &out);
+    ~EngineProtocol();
+    EngineProtocol(const EngineProtocol &) = delete;
+    EngineProtocol &operator=(const EngineProtocol &) = delete;
+    bool handleLine(std::string_view line);
+    void waitForSearch();
+    bool openBook(const std::string &path);
+
+  private:
+    std::ostream &out;
+    std::mutex outMutex; // search thread & caller both write replies
+    Position position = Position::initial();
+    int multiPv = 1;
+    bool logTime = false; // report time-manager decisions as "info string time ..."
+    bool useMcts = false; // EngineMode: "alphabeta" (default) or "mcts"
+    EngineStats engineStats{};
+    std::unique_ptr<Tablebase> tablebase = nullptr;
+    std::unique_ptr<NnueNetwork> network = nullptr;
+    std::unique_ptr<EvalWeights> evalWeights = nullptr; // null = weights loaded at startup
+    std::unique_ptr<Searcher> searcher = nullptr; // rebuilt when tablebase changes
+    std::unique_ptr<MctsSearcher> mcts = nullptr; // created on first use, keeps its tree between moves
+    TranspositionTable tt;
+    std::string hashFile{}; // persistent table: loaded when set, saved on quit
+    OpeningBook book;       // probed by "go" before searching, while open
+    std::mt19937 bookRng{std::random_device{}()};
+    std::thread worker;
+    std::atomic_bool stopPending{false}; // "stop" may arrive before the search has even begun
+    std::mutex resultMutex;              // guards the two below
+    Position lastRoot{};
+    std::optional<SearchResult> lastResult{}; // latest iteration of the latest search
+
+    void send(const std::string &line);
+    void cmdSetOption(std::istringstream &args);
+    void cmdPosition(std::istringstream &args);
+    void cmdGo(std::istringstream &args);
+    void goMcts(const Position &root, SearchLimits limits);
+    void cmdSaveHash();
+    void cmdStats();
+    void stopSearch();
+    void sendInfo(const Position &root, const SearchResult &result);
+    void sendBestMove(const Position &root, const SearchResult &result);
+};
+
+} // namespace chk::engine
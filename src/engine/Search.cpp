@@ -0,0 +1,616 @@
+#include "Search.hpp"
+#include "Endgame.hpp"
+#include "Evaluation.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace chk::engine
+{
+static_assert(MAX_PLY <= KILLER_MAX_PLY, "killer table must cover every ply");
+
+/**
+ * Custom constructor
+ * @param config search behaviour
+ * @param tablebase optional endgame tablebase (may be nullptr)
+ * @param engineStats optional shared counters, receives tablebase probe stats (may be nullptr)
+ */
+Searcher::Searcher(const SearchConfig &config, const Tablebase *tablebase, EngineStats *engineStats)
+    : config(config), tablebase(tablebase), engineStats(engineStats), orderer(config.ordering),
+      timeManager(config.time), rootExcluded(this->arena.resource()), linePvs(this->arena.resource()),
+      lineScores(this->arena.resource()), lineLengths(this->arena.resource()), lineOrder(this->arena.resource())
+{
+}
+
+/**
+ * Set listener for each completed iteration (e.g. to show progress)
+ * @param callback the listener
+ */
+void Searcher::setOnIteration(const IterationCallback &callback)
+{
+    this->onIteration = callback;
+}
+
+/**
+ * Set listener for the time manager's decisions: the budget of each clocked move, then the verdict
+ * after each iteration (e.g. to report them, since they are otherwise only logged at debug level)
+ * @param callback the listener
+ */
+void Searcher::setOnTimeDecision(const TimeCallback &callback)
+{
+    this->onTimeDecision = callback;
+}
+
+/**
+ * Use this network for evaluation instead of the hand-written one (nullptr to switch back)
+ * @param net the network. MUST outlive this searcher
+ */
+void Searcher::setNetwork(const NnueNetwork *net)
+{
+    this->network = net;
+}
+
+/**
+ * Use these weights for the hand-written evaluation (nullptr to go back to the startup weights)
+ * @param weights the weights. MUST outlive this searcher
+ */
+void Searcher::setEvalWeights(const EvalWeights *weights)
+{
+    this->evalWeights = weights != nullptr ? weights : &getEvalWeights();
+}
+
+/**
+ * Share this transposition table (nullptr for none). Several searchers may use the same table at once
+ * @param table the table. MUST outlive this searcher
+ * @param ownsAging start a new table generation with each search. Searchers that share a table with
+ *                  concurrent searches should leave aging to the owner of the table, else every move of
+ *                  every game ages the entries of the searches still running
+ */
+void Searcher::setTranspositionTable(TranspositionTable *table, const bool ownsAging)
+{
+    this->tt = table;
+    this->agesTable = ownsAging;
+}
+
+/**
+ * Get current search configuration
+ */
+const SearchConfig &Searcher::getConfig() const
+{
+    return this->config;
+}
+
+/**
+ * Ask a running search to return as soon as possible (safe from any thread)
+ */
+void Searcher::stop()
+{
+    this->stopRequested = true;
+}
+
+/**
+ * Replace the time limit of a running search: stop `ms` from now (e.g. on a ponder hit, to turn
+ * an open-ended search into a timed one). Safe from any thread. Only affects the current search
+ * @param ms remaining time in milliseconds
+ */
+void Searcher::setRemainingTime(const int64_t ms)
+{
+    this->timeLimitMs = this->elapsedMs() + std::max<int64_t>(ms, 1);
+}
+
+/**
+ * Run iterative deepening from `root` until a limit is hit, or `stop()` is called
+ *
+ * @param root position to analyse
+ * @param searchLimits depth / node / time limits
+ * @return best move and score of the deepest completed iteration
+ */
+SearchResult Searcher::search(const Position &root, const SearchLimits &searchLimits)
+{
+    this->stopRequested = false;
+    this->limits = searchLimits;
+    this->timeLimitMs = searchLimits.moveTimeMs;
+    this->stats = SearchStats{};
+    this->startTime = std::chrono::steady_clock::now();
+    this->orderer.newSearch();
+    if (this->tt != nullptr && this->agesTable)
+    {
+        this->tt->newSearch();
+    }
+
+    SearchResult result;
+    MoveList rootMoves;
+    generateMoves(root, rootMoves);
+    if (rootMoves.empty())
+    {
+        result.score = -SCORE_WIN;
+        return result;
+    }
+    if (this->network != nullptr)
+    {
+        this->network->refresh(root, this->accStack[0]);
+    }
+    if (rootMoves.size() == 1)
+    {
+        // forced move: nothing to think about
+        result.bestMove = rootMoves[0];
+        result.pv.push_back(rootMoves[0]);
+        result.score = this->staticEval(root, 0);
+        result.lines.push_back(PvLine{result.score, result.pv});
+        return result;
+    }
+    const bool managed = this->limits.moveTimeMs <= 0 && this->limits.clock.remainingMs > 0;
+    if (managed)
+    {
+        this->timeManager.start(root, this->limits.clock);
+        this->timeLimitMs = this->timeManager.getMaximumMs();
+        if (this->onTimeDecision)
+        {
+            this->onTimeDecision(this->timeManager.getLastDecision());
+        }
+    }
+
+    // fallback if stopped during the very first iteration: no line is trusted, so judge the position as it stands
+    result.bestMove = rootMoves[0];
+    result.score = this->staticEval(root, 0);
+    const auto numLines =
+        static_cast<size_t>(std::clamp<int>(this->limits.multiPv, 1, static_cast<int>(rootMoves.size())));
+    const int maxDepth = std::clamp(this->limits.maxDepth, 1, MAX_PLY - 1);
+    // all storage the iterations need is set aside now: from here on, the search never touches the heap
+    this->resetScratch(numLines);
+    result.pv.reserve(MAX_PLY);
+    result.pv.push_back(rootMoves[0]);
+    result.iterations.reserve(static_cast<size_t>(maxDepth));
+    result.lines.resize(numLines);
+    for (PvLine &line : result.lines)
+    {
+        line.pv.reserve(MAX_PLY);
+    }
+    this->heapExempt = 0;
+    [[maybe_unused]] const uint64_t heapBefore = threadHeapAllocations();
+
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        const uint64_t nodesBefore = this->stats.nodes;
+        const int64_t msBefore = this->elapsedMs();
+        // multi-PV: search the root again for each line, excluding moves already ranked
+        size_t found = 0;
+        this->rootExcluded.clear();
+        while (found < numLines)
+        {
+            const size_t k = found;
+            this->rootBest = result.depth > 0 ? result.lines[k].pv.front() : NULL_MOVE;
+            // line k cannot beat line k-1, so search under that bound first (cheap cutoffs); should the
+            // table make it fail high anyway, repeat with the full window
+            const int ceiling = k > 0 ? this->lineScores[k - 1] + 1 : SCORE_INFINITE;
+            int score = this->negamax(root, depth, -SCORE_INFINITE, ceiling, 0);
+            if (score >= ceiling && ceiling < SCORE_INFINITE && !this->stopRequested)
+            {
+                score = this->negamax(root, depth, -SCORE_INFINITE, SCORE_INFINITE, 0);
+            }
+            if (this->stopRequested || this->pvLength[0] == 0)
+            {
+                break; // aborted: its score is whatever the interrupted search returned
+            }
+            this->lineScores[k] = score;
+            this->lineLengths[k] = this->pvLength[0];
+            std::copy_n(this->pvTable[0].begin(), this->pvLength[0], this->linePvs.begin() + k * MAX_PLY);
+            this->rootExcluded.push_back(this->pvTable[0][0]);
+            found++;
+        }
+        if (found == 0 || (found < numLines && depth > 1))
+        {
+            break; // iteration is incomplete, keep previous result
+        }
+        // best first; ties keep the order they were found in
+        for (size_t i = 0; i < found; i++)
+        {
+            this->lineOrder[i] = i;
+            const auto slot = std::upper_bound(
+                this->lineOrder.begin(), this->lineOrder.begin() + i, i,
+                [this](const size_t a, const size_t b) { return this->lineScores[a] > this->lineScores[b]; });
+            std::rotate(slot, this->lineOrder.begin() + i, this->lineOrder.begin() + i + 1);
+        }
+        result.lines.resize(found); // only ever shrinks: a partial first iteration is also the last
+        for (size_t i = 0; i < found; i++)
+        {
+            const size_t k = this->lineOrder[i];
+            const auto pvBegin = this->linePvs.begin() + k * MAX_PLY;
+            result.lines[i].score = this->lineScores[k];
+            result.lines[i].pv.assign(pvBegin, pvBegin + this->lineLengths[k]);
+        }
+        const int score = result.lines.front().score;
+        result.bestMove = result.lines.front().pv.front();
+        result.score = score;
+        result.depth = depth;
+        result.pv.assign(result.lines.front().pv.begin(), result.lines.front().pv.end());
+        result.stats = this->stats;
+        result.elapsedMs = this->elapsedMs();
+        result.iterations.push_back(
+            IterationStats{depth, score, this->stats.nodes - nodesBefore, result.elapsedMs - msBefore});
+        if (this->onIteration)
+        {
+            this->exemptFromHeapCheck([this, &result] { this->onIteration(result); });
+        }
+        if (this->stopRequested || std::abs(score) >= SCORE_WIN - MAX_PLY)
+        {
+            break; // out of budget, or forced win/loss found
+        }
+        const auto judge = [this, &result, depth, score] {
+            const bool stop = this->timeManager.onIteration(depth, result.bestMove, score, result.elapsedMs,
+                                                            result.iterations.back().elapsedMs);
+            if (this->onTimeDecision)
+            {
+                this->onTimeDecision(this->timeManager.getLastDecision());
+            }
+            return stop;
+        };
+        if (managed && this->exemptFromHeapCheck(judge))
+        {
+            break; // settled enough for the time spent
+        }
+    }
+    assert(threadHeapAllocations() - heapBefore == this->heapExempt && "search allocated from the heap");
+    if (result.depth == 0)
+    {
+        result.lines.clear(); // stopped before the first iteration completed
+    }
+    result.stats = this->stats;
+    result.elapsedMs = this->elapsedMs();
+    return result;
+}
+
+/**
+ * Fail-soft alpha-beta (negamax form)
+ * @return score from the point of view of the side to move at `pos`
+ */
+int Searcher::negamax(const Position &pos, const int depth, int alpha, const int beta, const int ply)
+{
+    this->pvLength[ply] = ply;
+    if (depth <= 0)
+    {
+        if (this->config.useQuiescence)
+        {
+            return this->quiescence(pos, alpha, beta, ply, 0);
+        }
+        this->stats.nodes++;
+        return this->staticEval(pos, ply);
+    }
+    this->stats.nodes++;
+    if (this->shouldStop())
+    {
+        return 0;
+    }
+    if (ply >= MAX_PLY - 1)
+    {
+        return this->staticEval(pos, ply);
+    }
+
+    // exact result from tablebase (never at root: we still need a move there)
+    if (ply > 0 && this->tablebase != nullptr && popCount(pos.occupied()) <= this->tablebase->getMaxPieces() &&
+        !hasCaptures(pos))
+    {
+        const auto probe = [this, &pos] {
+            return this->engineStats != nullptr ? this->tablebase->probe(pos, *this->engineStats)
+                                                : this->tablebase->probe(pos);
+        };
+        if (const auto wdl = this->exemptFromHeapCheck(probe); wdl.has_value())
+        {
+            this->stats.tbHits++;
+            switch (wdl.value())
+            {
+            case Wdl::WIN:
+                return SCORE_TB_WIN - ply;
+            case Wdl::LOSS:
+                return -SCORE_TB_WIN + ply;
+            default:
+                return 0;
+            }
+        }
+    }
+
+    // transposition table: cut off on a bound that settles this node (never at root, nor with a score
+    // inside the window, so the PV stays complete); otherwise its move is searched first
+    uint64_t key = 0;
+    TtEntry ttEntry{};
+    if (this->tt != nullptr)
+    {
+        key = hashPosition(pos);
+        this->stats.ttProbes++;
+        if (this->tt->probe(key, ttEntry))
+        {
+            this->stats.ttHits++;
+            const int ttScore = fromTtScore(ttEntry.score, ply);
+            if (ply > 0 && ttEntry.depth >= depth &&
+                ((ttEntry.bound != TtBound::UPPER && ttScore >= beta) ||
+                 (ttEntry.bound != TtBound::LOWER && ttScore <= alpha)))
+            {
+                this->stats.ttCutoffs++;
+                return ttScore;
+            }
+        }
+    }
+
+    MoveList moves;
+    generateMoves(pos, moves);
+    if (moves.empty())
+    {
+        return -SCORE_WIN + ply; // no pieces or no moves left: side to move loses
+    }
+    // search previous iteration's best move first (at root), else the table's move; then the rest by heuristics
+    Move hashMove = this->rootBest;
+    if (ply > 0 || hashMove == NULL_MOVE)
+    {
+        const auto found =
+            std::find_if(moves.begin(), moves.end(), [&ttEntry](const Move &move) { return ttEntry.matches(move); });
+        hashMove = found != moves.end() ? *found : NULL_MOVE;
+    }
+    this->orderer.order(pos, moves, hashMove, ply);
+
+    const int alphaOrig = alpha;
+    Move bestMove = NULL_MOVE;
+    int best = -SCORE_INFINITE;
+    int searched = 0;
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        const Move &move = moves[i];
+        const auto &excluded = this->rootExcluded;
+        if (ply == 0 && std::find(excluded.begin(), excluded.end(), move) != excluded.end())
+        {
+            continue; // already ranked by an earlier multi-PV line
+        }
+        searched++;
+        const int score = -this->negamax(this->playMove(pos, move, ply), depth - 1, -beta, -alpha, ply + 1);
+        if (this->stopRequested)
+        {
+            return 0;
+        }
+        if (score > best)
+        {
+            best = score;
+            bestMove = move;
+            if (score > alpha)
+            {
+                alpha = score;
+                this->updatePv(ply, move);
+                if (alpha >= beta)
+                {
+                    this->stats.betaCutoffs++;
+                    this->stats.firstMoveCutoffs += searched == 1 ? 1 : 0;
+                    this->orderer.onCutoff(pos, moves, i, depth, ply);
+                    break;
+                }
+            }
+        }
+    }
+    // multi-PV root searches skip moves, so their result is not the node's true value
+    if (this->tt != nullptr && (ply > 0 || this->rootExcluded.empty()))
+    {
+        const TtBound bound = best <= alphaOrig ? TtBound::UPPER : best >= beta ? TtBound::LOWER : TtBound::EXACT;
+        this->tt->store(key, toTtScore(best, ply), depth, bound, bestMove);
+    }
+    return best;
+}
+
+/**
+ * Quiescence search over forced capture chains only. Quiet positions (no capture pending) return the
+ * static eval; otherwise captures are compulsory, so there is no stand-pat and every capture is searched.
+ * @param qply plies since the nominal depth ran out
+ * @return score from the point of view of the side to move
+ */
+int Searcher::quiescence(const Position &pos, int alpha, const int beta, const int ply, const int qply)
+{
+    this->stats.nodes++;
+    this->stats.qNodes++;
+    this->stats.qMaxPlyReached = std::max(this->stats.qMaxPlyReached, qply);
+    this->pvLength[ply] = ply;
+    if (this->shouldStop())
+    {
+        return 0;
+    }
+    if (pos.own() == 0)
+    {
+        return -SCORE_WIN + ply;
+    }
+    if (!hasCaptures(pos) || ply >= MAX_PLY - 1)
+    {
+        return this->staticEval(pos, ply);
+    }
+    if (qply >= this->config.qsMaxPlies)
+    {
+        this->stats.qDepthLimitHits++;
+        return this->staticEval(pos, ply);
+    }
+
+    MoveList captures;
+    generateCaptures(pos, captures);
+    this->orderer.order(pos, captures, NULL_MOVE, ply);
+    const int standPat = this->config.qsDeltaMargin > 0 ? this->staticEval(pos, ply) : 0;
+    int best = -SCORE_INFINITE;
+    for (const Move &move : captures)
+    {
+        if (this->config.qsDeltaMargin > 0)
+        {
+            // optimistic bound: win every captured piece as if it were a king
+            const int bound = standPat + popCount(move.captured) * KING_VALUE + this->config.qsDeltaMargin;
+            if (bound <= alpha)
+            {
+                this->stats.qDeltaPrunes++;
+                best = std::max(best, bound);
+                continue;
+            }
+        }
+        const int score = -this->quiescence(this->playMove(pos, move, ply), -beta, -alpha, ply + 1, qply + 1);
+        if (this->stopRequested)
+        {
+            return 0;
+        }
+        if (score > best)
+        {
+            best = score;
+            if (score > alpha)
+            {
+                alpha = score;
+                this->updatePv(ply, move);
+                if (alpha >= beta)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * Static evaluation of the position at this ply (network if set, else hand-written), refined in known endings
+ */
+int Searcher::staticEval(const Position &pos, const int ply) const
+{
+    if (this->network != nullptr)
+    {
+        // the network sees no more of an ending than the weighted terms do
+        const int score = this->network->evaluate(this->accStack[ply], pos.sideToMove);
+        const EndgameKind kind = endgameKind(pos);
+        return kind == EndgameKind::NONE ? score : evaluateEndgame(kind, pos, score);
+    }
+    return evaluate(pos, *this->evalWeights);
+}
+
+/**
+ * Make move for the child at `ply + 1`, keeping its NNUE accumulator in step
+ * @return position after the move
+ */
+Position Searcher::playMove(const Position &pos, const Move &move, const int ply)
+{
+    if (this->network != nullptr)
+    {
+        this->network->update(this->accStack[ply], this->accStack[ply + 1], pos, move);
+    }
+    return makeMove(pos, move);
+}
+
+/**
+ * Check stop flag, node budget, and (every 1024 nodes) the clock
+ * @return TRUE if search must unwind now
+ */
+bool Searcher::shouldStop()
+{
+    if (this->stopRequested)
+    {
+        return true;
+    }
+    if (this->limits.maxNodes > 0 && this->stats.nodes >= this->limits.maxNodes)
+    {
+        this->stopRequested = true;
+    }
+    else if ((this->stats.nodes & 1023) == 0 && this->timeLimitMs.load(std::memory_order_relaxed) > 0 &&
+             this->elapsedMs() >= this->timeLimitMs.load(std::memory_order_relaxed))
+    {
+        this->stopRequested = true;
+    }
+    return this->stopRequested;
+}
+
+/**
+ * Milliseconds since current search started
+ */
+int64_t Searcher::elapsedMs() const
+{
+    const auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - this->startTime).count();
+}
+
+/**
+ * Nodes per second over the whole search
+ */
+uint64_t SearchResult::nodesPerSecond() const
+{
+    return this->elapsedMs > 0 ? this->stats.nodes * 1000 / static_cast<uint64_t>(this->elapsedMs) : 0;
+}
+
+/**
+ * Effective branching factor: growth in nodes from the second-to-last iteration to the last one
+ * @return the ratio, or 0 with fewer than 2 iterations
+ */
+double SearchResult::branchingFactor() const
+{
+    if (this->iterations.size() < 2 || this->iterations[this->iterations.size() - 2].nodes == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(this->iterations.back().nodes) /
+           static_cast<double>(this->iterations[this->iterations.size() - 2].nodes);
+}
+
+/**
+ * Search statistics as one JSON object (for bug reports, and scripts comparing engine versions)
+ * @param root the searched position (to write moves in PDN notation)
+ * @param result the search outcome
+ */
+std::string toJson(const Position &root, const SearchResult &result)
+{
+    const SearchStats &stats = result.stats;
+    std::string json = "{\"depth\":" + std::to_string(result.depth) + ",\"score\":" + std::to_string(result.score) +
+                       ",\"timeMs\":" + std::to_string(result.elapsedMs) + ",\"nodes\":" +
+                       std::to_string(stats.nodes) + ",\"qNodes\":" + std::to_string(stats.qNodes) + ",\"nps\":" +
+                       std::to_string(result.nodesPerSecond()) + ",\"ttProbes\":" + std::to_string(stats.ttProbes) +
+                       ",\"ttHits\":" + std::to_string(stats.ttHits) + ",\"ttCutoffs\":" +
+                       std::to_string(stats.ttCutoffs) + ",\"betaCutoffs\":" + std::to_string(stats.betaCutoffs) +
+                       ",\"firstMoveCutoffRate\":" + std::to_string(stats.firstMoveCutoffRate()) +
+                       ",\"branchingFactor\":" + std::to_string(result.branchingFactor()) +
+                       ",\"tbHits\":" + std::to_string(stats.tbHits) + ",\"pv\":[";
+    Position pos = root;
+    for (size_t i = 0; i < result.pv.size(); i++)
+    {
+        json += (i == 0 ? "\"" : ",\"") + toNotation(pos, result.pv[i]) + "\"";
+        pos = makeMove(pos, result.pv[i]);
+    }
+    json += "],\"iterations\":[";
+    for (size_t i = 0; i < result.iterations.size(); i++)
+    {
+        const IterationStats &iteration = result.iterations[i];
+        json += (i == 0 ? "{\"depth\":" : ",{\"depth\":") + std::to_string(iteration.depth) +
+                ",\"score\":" + std::to_string(iteration.score) + ",\"nodes\":" +
+                std::to_string(iteration.nodes) + ",\"timeMs\":" + std::to_string(iteration.elapsedMs) + "}";
+    }
+    return json + "]}";
+}
+
+/**
+ * Store `move` as best at this ply, followed by the child's best line
+ */
+void Searcher::updatePv(const int ply, const Move &move)
+{
+    this->pvTable[ply][ply] = move;
+    for (int i = ply + 1; i < this->pvLength[ply + 1]; i++)
+    {
+        this->pvTable[ply][i] = this->pvTable[ply + 1][i];
+    }
+    this->pvLength[ply] = this->pvLength[ply + 1];
+}
+
+/**
+ * Rewind the arena and set aside the scratch of a new search
+ * @param numLines multi-PV lines per iteration
+ */
+void Searcher::resetScratch(const size_t numLines)
+{
+    // containers let go of their arena storage before it is rewound under them
+    const auto release = [this](auto &scratch) {
+        std::decay_t<decltype(scratch)>{this->arena.resource()}.swap(scratch);
+    };
+    release(this->rootExcluded);
+    release(this->linePvs);
+    release(this->lineScores);
+    release(this->lineLengths);
+    release(this->lineOrder);
+    this->arena.reset();
+    this->rootExcluded.reserve(MoveList::MAX_MOVES);
+    this->linePvs.resize(numLines * MAX_PLY);
+    this->lineScores.resize(numLines);
+    this->lineLengths.resize(numLines);
+    this->lineOrder.resize(numLines);
+}
+
+} // namespace chk::engine
@@ -0,0 +1,184 @@
+// created 2026-10-18
+#pragma once
+
+#include "EngineStats.hpp"
+#include "Evaluation.hpp"
+#include "MoveGen.hpp"
+#include "MoveOrdering.hpp"
+#include "Nnue.hpp"
+#include "Position.hpp"
+#include "SearchArena.hpp"
+#include "Tablebase.hpp"
+#include "TimeManager.hpp"
+#include "TranspositionTable.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace chk::engine
+{
+constexpr int MAX_PLY{128};
+constexpr int SCORE_INFINITE{32000};
+constexpr int SCORE_WIN{30000};    // win in 0 plies; actual wins are SCORE_WIN - ply
+constexpr int SCORE_TB_WIN{20000}; // proven by tablebase, minus ply
+
+/**
+ * When to stop searching. Zero means "no limit" for that field
+ */
+struct SearchLimits
+{
+    int maxDepth = MAX_PLY - 1;
+    uint64_t maxNodes = 0;
+    int64_t moveTimeMs = 0;
+    int multiPv = 1;   // number of best root moves to score exactly (1 = normal search)
+    GameClock clock{}; // without moveTimeMs: let the time manager budget this move from the clock
+};
+
+/**
+ * Tunable search behaviour
+ */
+struct SearchConfig
+{
+    bool useQuiescence = true; // extend pending capture chains past the nominal depth
+    int qsMaxPlies = 16;       // longest capture extension; beyond it the static eval is returned
+    int qsDeltaMargin = 0;     // >0: skip chains that cannot lift eval + margin above alpha (0 = off)
+    OrderingConfig ordering{}; // move-ordering heuristics in use
+    TimeConfig time{};         // how a game clock is turned into thinking time
+};
+
+/**
+ * One ranked root line (multi-PV)
+ */
+struct PvLine
+{
+    int score = 0;
+    std::vector<Move> pv{};
+};
+
+/**
+ * Cost of one completed deepening iteration
+ */
+struct IterationStats
+{
+    int depth = 0;
+    int score = 0;
+    uint64_t nodes = 0;    // spent on this iteration alone
+    int64_t elapsedMs = 0; // ditto
+};
+
+/**
+ * Outcome of a (possibly interrupted) search
+ */
+struct SearchResult
+{
+    Move bestMove = NULL_MOVE;
+    int score = 0;
+    int depth = 0;                            // last fully completed iteration
+    std::vector<Move> pv{};                   // principal variation, starting with bestMove
+    std::vector<PvLine> lines{};              // best first; lines[0] matches score & pv. Size is `multiPv` (or fewer)
+    std::vector<IterationStats> iterations{}; // completed iterations, shallowest first
+    SearchStats stats{};
+    int64_t elapsedMs = 0;
+
+    [[nodiscard]] uint64_t nodesPerSecond() const;
+    [[nodiscard]] double branchingFactor() const;
+};
+
+[[nodiscard]] std::string toJson(const Position &root, const SearchResult &result);
+
+/**
+ * Single-threaded iterative-deepening alpha-beta searcher
+ */
+class Searcher final
+{
+  public:
+    // called after each completed iteration (from the searching thread)
+    using IterationCallback = std::function<void(const SearchResult &)>;
+    // called with each time-manager decision of a clocked search (from the searching thread)
+    using TimeCallback = std::function<void(const TimeDecision &)>;
+
+    explicit Searcher(const SearchConfig &config = SearchConfig{}, const Tablebase *tablebase = nullptr,
+                      EngineStats *engineStats = nullptr);
+    Searcher(const Searcher &) = delete;
+    Searcher &operator=(const Searcher &) = delete;
+    SearchResult search(const Position &root, const SearchLimits &limits);
+    void stop();
+    void setRemainingTime(int64_t ms);
+    void setOnIteration(const IterationCallback &callback);
+    void setOnTimeDecision(const TimeCallback &callback);
+    void setNetwork(const NnueNetwork *net);
+    void setEvalWeights(const EvalWeights *weights);
+    void setTranspositionTable(TranspositionTable *table, bool ownsAging = true);
+    [[nodiscard]] const SearchConfig &getConfig() const;
+
+  private:
+    SearchConfig config;
+    const Tablebase *tablebase = nullptr;
+    EngineStats *engineStats = nullptr;
+    const NnueNetwork *network = nullptr; // if set, replaces the hand-written evaluation
+    const EvalWeights *evalWeights = &getEvalWeights();
+    TranspositionTable *tt = nullptr; // optional, possibly shared with other searchers
+    bool agesTable = true;            // each search starts a new table generation
+    IterationCallback onIteration;
+    TimeCallback onTimeDecision;
+    MoveOrderer orderer;
+    TimeManager timeManager;
+
+    std::atomic_bool stopRequested{false};
+    std::atomic<int64_t> timeLimitMs{0}; // from search start; starts as limits.moveTimeMs (or the clock's maximum)
+    SearchLimits limits{};
+    SearchStats stats{};
+    std::chrono::steady_clock::time_point startTime{};
+    // triangular PV table: pvTable[ply] holds the best line found from that ply
+    std::array<std::array<Move, MAX_PLY>, MAX_PLY> pvTable{};
+    std::array<int, MAX_PLY> pvLength{};
+    Move rootBest = NULL_MOVE; // best move of previous iteration, searched first
+    // scratch of the iterations, drawn from the arena and given back at each new search
+    SearchArena arena;
+    std::pmr::vector<Move> rootExcluded; // multi-PV: root moves already ranked in this iteration
+    std::pmr::vector<Move> linePvs;      // lines of the iteration in progress: line k at [k * MAX_PLY, ...)
+    std::pmr::vector<int> lineScores;
+    std::pmr::vector<int> lineLengths;
+    std::pmr::vector<size_t> lineOrder; // line numbers, best first
+    uint64_t heapExempt = 0;            // allocations of callbacks and shared caches this search (debug check)
+    // accStack[ply]: NNUE accumulator of the position at that ply (copy-make, like positions)
+    std::array<Accumulator, MAX_PLY> accStack{};
+
+    int negamax(const Position &pos, int depth, int alpha, int beta, int ply);
+    int quiescence(const Position &pos, int alpha, int beta, int ply, int qply);
+    int staticEval(const Position &pos, int ply) const;
+    Position playMove(const Position &pos, const Move &move, int ply);
+    bool shouldStop();
+    [[nodiscard]] int64_t elapsedMs() const;
+    void updatePv(int ply, const Move &move);
+    void resetScratch(size_t numLines);
+
+    /**
+     * Run `work`, leaving its heap allocations out of the check that the search itself makes none
+     * (callbacks, logging, the tablebase block cache shared by all searchers)
+     * @return whatever `work` returns
+     */
+    template <typename Work> auto exemptFromHeapCheck(Work &&work)
+    {
+        const uint64_t before = threadHeapAllocations();
+        if constexpr (std::is_void_v<decltype(work())>)
+        {
+            work();
+            this->heapExempt += threadHeapAllocations() - before;
+        }
+        else
+        {
+            auto value = work();
+            this->heapExempt += threadHeapAllocations() - before;
+            return value;
+        }
+    }
+};
+
+} // namespace chk::engine
@@ -0,0 +1,87 @@
+#include "SearchArena.hpp"
+#include <cstdlib>
+#include <new>
+
+#ifndef NDEBUG
+namespace chk::engine
+{
+thread_local uint64_t threadHeapAllocationCount = 0;
+} // namespace chk::engine
+
+// debug builds count every global allocation per thread, so the search can check it never makes one
+void *operator new(const std::size_t size)
+{
+    chk::engine::threadHeapAllocationCount++;
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+#endif
+
+namespace chk::engine
+{
+
+/**
+ * Custom constructor
+ * @param bytes size of the preallocated buffer
+ */
+SearchArena::SearchArena(const size_t bytes)
+    : capacity(bytes), buffer(std::make_unique<std::byte[]>(bytes)), pool(this->buffer.get(), bytes, &this->spill)
+{
+}
+
+/**
+ * Take back everything handed out: containers drawing from the arena must be emptied first
+ */
+void SearchArena::reset()
+{
+    this->pool.release();
+}
+
+std::pmr::memory_resource *SearchArena::resource()
+{
+    return &this->pool;
+}
+
+size_t SearchArena::getCapacity() const
+{
+    return this->capacity;
+}
+
+/**
+ * Times the buffer ran out and the heap stepped in (0 for a well-sized arena)
+ */
+uint64_t SearchArena::getSpills() const
+{
+    return this->spill.spills;
+}
+
+void *SearchArena::SpillResource::do_allocate(const size_t bytes, const size_t alignment)
+{
+    this->spills++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void SearchArena::SpillResource::do_deallocate(void *p, const size_t bytes, const size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool SearchArena::SpillResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+} // namespace chk::engine
@@ -0,0 +1,71 @@
+// created 2026-10-18
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+namespace chk::engine
+{
+constexpr size_t SEARCH_ARENA_BYTES{64 * 1024}; // per searcher; multi-PV lines and root bookkeeping fit easily
+
+// debug builds replace the global operator new (SearchArena.cpp) to count allocations per thread
+#ifndef NDEBUG
+constexpr bool HEAP_ALLOCATIONS_COUNTED{true};
+extern thread_local uint64_t threadHeapAllocationCount;
+
+/**
+ * Global heap allocations made so far by the calling thread
+ */
+inline uint64_t threadHeapAllocations()
+{
+    return threadHeapAllocationCount;
+}
+#else
+constexpr bool HEAP_ALLOCATIONS_COUNTED{false};
+
+constexpr uint64_t threadHeapAllocations()
+{
+    return 0; // not counted in release builds
+}
+#endif
+
+/**
+ * Scratch memory of one searcher: a preallocated buffer handed out front to back, and taken
+ * back all at once by reset() when a new search starts. Should a search ever need more than the
+ * buffer, the overflow comes from the heap and is counted as a spill
+ */
+class SearchArena final
+{
+  public:
+    explicit SearchArena(size_t bytes = SEARCH_ARENA_BYTES);
+    SearchArena(const SearchArena &) = delete;
+    SearchArena &operator=(const SearchArena &) = delete;
+    void reset();
+    [[nodiscard]] std::pmr::memory_resource *resource();
+    [[nodiscard]] size_t getCapacity() const;
+    [[nodiscard]] uint64_t getSpills() const;
+
+  private:
+    /**
+     * Heap fallback that counts its use
+     */
+    class SpillResource final : public std::pmr::memory_resource
+    {
+      public:
+        uint64_t spills = 0;
+
+      private:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+    };
+
+    size_t capacity;
+    std::unique_ptr<std::byte[]> buffer;
+    SpillResource spill;
+    std::pmr::monotonic_buffer_resource pool;
+};
+
+} // namespace chk::engine
@@ -0,0 +1,23 @@
+// created 2026-10-18
+#pragma once
+
+#include "Search.hpp"
+#include <optional>
+
+namespace chk::engine
+{
+/**
+ * A search that runs in the background and is polled: on a thread of this process (AsyncSearch),
+ * or in a separate engine process (EngineProcess). Callers never block on either.
+ */
+class SearchRunner
+{
+  public:
+    virtual ~SearchRunner() = default;
+    virtual void start(const Position &pos, const SearchLimits &limits) = 0;
+    virtual void stop() = 0;
+    [[nodiscard]] virtual std::optional<SearchResult> getLatest(const Position &pos) const = 0;
+    [[nodiscard]] virtual bool isSearching() const = 0;
+};
+
+} // namespace chk::engine
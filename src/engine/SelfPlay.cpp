@@ -0,0 +1,401 @@
+#include "SelfPlay.hpp"
+#include "MoveGen.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr int NO_PROGRESS_DRAW_PLIES{80}; // 40 moves each of king moves without capture
+constexpr double Z_95{1.959964};
+
+/**
+ * Expected score of the stronger side for an Elo difference (logistic model)
+ */
+double expectedScore(const double elo)
+{
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+/**
+ * Elo difference that gives this expected score
+ */
+double eloFromScore(const double score)
+{
+    const double clamped = std::clamp(score, 1e-6, 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / clamped - 1.0);
+}
+
+/**
+ * Game jobs of one worker. Owner takes from the back, thieves from the front
+ */
+struct alignas(64) JobQueue
+{
+    std::mutex mutex;
+    std::deque<uint32_t> jobs;
+};
+
+/**
+ * Take the next game for this worker: own queue first, then steal from the others
+ * @return FALSE if every queue is empty
+ */
+bool takeJob(std::vector<std::unique_ptr<JobQueue>> &queues, const size_t self, uint32_t &job, bool &stolen)
+{
+    {
+        JobQueue &own = *queues[self];
+        std::scoped_lock lock{own.mutex};
+        if (!own.jobs.empty())
+        {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            stolen = false;
+            return true;
+        }
+    }
+    for (size_t k = 1; k < queues.size(); k++)
+    {
+        JobQueue &victim = *queues[(self + k) % queues.size()];
+        std::scoped_lock lock{victim.mutex};
+        if (!victim.jobs.empty())
+        {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+uint32_t MatchScore::total() const
+{
+    return this->wins + this->draws + this->losses;
+}
+
+/**
+ * Average points per game of engine A (win 1, draw 0.5)
+ * @return value in [0, 1], or 0.5 if no games yet
+ */
+double MatchScore::scoreRate() const
+{
+    const uint32_t n = this->total();
+    return n == 0 ? 0.5 : (this->wins + 0.5 * this->draws) / n;
+}
+
+/**
+ * Estimated Elo of A relative to B
+ */
+double MatchScore::eloDiff() const
+{
+    return eloFromScore(this->scoreRate());
+}
+
+/**
+ * Half-width of the 95% confidence interval of eloDiff() (trinomial model, normal approximation)
+ */
+double MatchScore::eloError95() const
+{
+    const uint32_t n = this->total();
+    if (n < 2)
+    {
+        return 0.0;
+    }
+    const double s = this->scoreRate();
+    const double variance =
+        (this->wins * (1.0 - s) * (1.0 - s) + this->draws * (0.5 - s) * (0.5 - s) + this->losses * s * s) / n;
+    const double margin = Z_95 * std::sqrt(variance / n);
+    return (eloFromScore(s + margin) - eloFromScore(s - margin)) / 2.0;
+}
+
+/**
+ * Log-likelihood ratio of H1 (elo1) over H0 (elo0), generalised SPRT with normal approximation
+ */
+double MatchScore::llr(const double elo0, const double elo1) const
+{
+    const uint32_t n = this->total();
+    if (n < 2)
+    {
+        return 0.0;
+    }
+    const double s = this->scoreRate();
+    const double s0 = expectedScore(elo0);
+    const double s1 = expectedScore(elo1);
+    const double variance = std::max(
+        (this->wins + 0.25 * this->draws) / n - s * s, 1e-6); // E[x^2] - E[x]^2, floored for all-draw runs
+    return n * (s1 - s0) * (2.0 * s - s0 - s1) / (2.0 * variance);
+}
+
+/**
+ * Compare the LLR with the SPRT bounds
+ */
+SprtDecision MatchScore::sprt(const SprtConfig &sprt) const
+{
+    const double value = this->llr(sprt.elo0, sprt.elo1);
+    if (value >= sprtUpperBound(sprt))
+    {
+        return SprtDecision::ACCEPT_H1;
+    }
+    if (value <= sprtLowerBound(sprt))
+    {
+        return SprtDecision::ACCEPT_H0;
+    }
+    return SprtDecision::CONTINUE;
+}
+
+double SelfPlayReport::gamesPerSec() const
+{
+    return this->elapsedSec > 0.0 ? this->score.total() / this->elapsedSec : 0.0;
+}
+
+double sprtLowerBound(const SprtConfig &sprt)
+{
+    return std::log(sprt.beta / (1.0 - sprt.alpha));
+}
+
+double sprtUpperBound(const SprtConfig &sprt)
+{
+    return std::log((1.0 - sprt.beta) / sprt.alpha);
+}
+
+/**
+ * Balanced, distinct start positions: a few random plies from the initial position, kept only if
+ * a shallow search scores them close to equal
+ * @param count how many to make (fewer if the random walk cannot find enough)
+ * @param randomPlies plies of random play from the initial position
+ * @param maxImbalance largest |score| accepted, in centi-men
+ * @param seed random seed (same seed, same openings)
+ */
+std::vector<Position> generateOpenings(const int count, const int randomPlies, const int maxImbalance,
+                                       const uint32_t seed)
+{
+    constexpr int CHECK_DEPTH{6};
+    std::mt19937 rng{seed};
+    Searcher searcher;
+    std::vector<Position> openings;
+    std::unordered_set<uint64_t> seen;
+    for (int attempt = 0; attempt < count * 50 && static_cast<int>(openings.size()) < count; attempt++)
+    {
+        Position pos = Position::initial();
+        MoveList moves;
+        for (int ply = 0; ply < randomPlies; ply++)
+        {
+            moves.clear();
+            generateMoves(pos, moves);
+            if (moves.empty())
+            {
+                break;
+            }
+            pos = makeMove(pos, moves[rng() % moves.size()]);
+        }
+        moves.clear();
+        generateMoves(pos, moves);
+        if (moves.empty() || !seen.insert(hashPosition(pos)).second)
+        {
+            continue;
+        }
+        if (std::abs(searcher.search(pos, SearchLimits{CHECK_DEPTH, 0, 0}).score) <= maxImbalance)
+        {
+            openings.push_back(pos);
+        }
+    }
+    return openings;
+}
+
+/**
+ * Play one game to the end. A side with no legal move loses; threefold repetition, 40 king moves
+ * each without a capture, or reaching `maxPlies` is a draw
+ * @param nodes if not null, nodes searched by both sides are added to it
+ * @param positions if not null, every position where a move was searched is appended to it
+ * @param moves if not null, every move played is appended to it
+ */
+GameResult playGame(const Position &opening, Searcher &red, const SearchLimits &redLimits, Searcher &black,
+                    const SearchLimits &blackLimits, const int maxPlies, uint64_t *nodes,
+                    std::vector<Position> *positions, std::vector<Move> *moves)
+{
+    Position pos = opening;
+    std::vector<uint64_t> sinceIrreversible{hashPosition(pos)};
+    for (int ply = 0; ply < maxPlies; ply++)
+    {
+        const bool redToMove = pos.sideToMove == Side::RED;
+        const GameResult moverLoses = redToMove ? GameResult::BLACK_WIN : GameResult::RED_WIN;
+        MoveList legal;
+        generateMoves(pos, legal);
+        if (legal.empty())
+        {
+            return moverLoses;
+        }
+        if (positions != nullptr)
+        {
+            positions->push_back(pos);
+        }
+        const SearchResult result = redToMove ? red.search(pos, redLimits) : black.search(pos, blackLimits);
+        if (nodes != nullptr)
+        {
+            *nodes += result.stats.nodes;
+        }
+        if (result.bestMove == NULL_MOVE)
+        {
+            return moverLoses;
+        }
+        if (moves != nullptr)
+        {
+            moves->push_back(result.bestMove);
+        }
+        const bool irreversible = result.bestMove.isCapture() || (pos.kings & bitOf(result.bestMove.from)) == 0;
+        pos = makeMove(pos, result.bestMove);
+        if (irreversible)
+        {
+            sinceIrreversible.clear();
+        }
+        const uint64_t hash = hashPosition(pos);
+        sinceIrreversible.push_back(hash);
+        if (std::count(sinceIrreversible.begin(), sinceIrreversible.end(), hash) >= 3 ||
+            static_cast<int>(sinceIrreversible.size()) > NO_PROGRESS_DRAW_PLIES)
+        {
+            return GameResult::DRAW;
+        }
+    }
+    return GameResult::DRAW;
+}
+
+/**
+ * Custom constructor
+ * @param engineA the engine under test (scores are from its point of view)
+ * @param engineB the reference engine
+ * @param config match settings
+ */
+SelfPlayMatch::SelfPlayMatch(EngineSpec engineA, EngineSpec engineB, SelfPlayConfig config)
+    : engineA(std::move(engineA)), engineB(std::move(engineB)), config(std::move(config))
+{
+}
+
+/**
+ * Receive every finished game, moves included (from a worker thread, one game at a time). Set before run()
+ * @param callback the callback
+ */
+void SelfPlayMatch::setOnGameRecord(const GameRecordCallback &callback)
+{
+    this->onGameRecord = callback;
+}
+
+/**
+ * Play the match on the calling thread plus workers; returns when all games are done, SPRT has
+ * decided, or stop() was called (games in progress are still finished and counted)
+ * @param onGame optional progress callback, called after every game (one at a time)
+ */
+SelfPlayReport SelfPlayMatch::run(const ProgressCallback &onGame)
+{
+    const size_t numThreads =
+        this->config.numThreads > 0 ? this->config.numThreads : std::max(1u, std::thread::hardware_concurrency());
+    const std::vector<Position> openings =
+        this->config.openings.empty() ? std::vector<Position>{Position::initial()} : this->config.openings;
+
+    // deal jobs round-robin; game 2k and 2k+1 share an opening, with colours reversed
+    std::vector<std::unique_ptr<JobQueue>> queues;
+    for (size_t t = 0; t < numThreads; t++)
+    {
+        queues.push_back(std::make_unique<JobQueue>());
+    }
+    for (uint32_t job = 0; job < this->config.maxGames; job++)
+    {
+        queues[job % numThreads]->jobs.push_back(this->config.firstGame + job);
+    }
+
+    std::mutex reportMutex;
+    SelfPlayReport report{};
+    const auto startTime = std::chrono::steady_clock::now();
+    auto worker = [&](const size_t self) {
+        Searcher searcherA{this->engineA.config};
+        Searcher searcherB{this->engineB.config};
+        searcherA.setNetwork(this->engineA.network.get());
+        searcherB.setNetwork(this->engineB.network.get());
+        searcherA.setEvalWeights(this->engineA.evalWeights.get());
+        searcherB.setEvalWeights(this->engineB.evalWeights.get());
+        uint32_t job = 0;
+        bool stolen = false;
+        std::vector<Move> moves;
+        while (!this->stopRequested && takeJob(queues, self, job, stolen))
+        {
+            const Position &opening = openings[(job / 2) % openings.size()];
+            const bool aIsRed = job % 2 == 0;
+            uint64_t nodes = 0;
+            std::vector<Move> *record = this->onGameRecord ? &moves : nullptr;
+            moves.clear();
+            const GameResult result =
+                aIsRed ? playGame(opening, searcherA, this->engineA.limits, searcherB, this->engineB.limits,
+                                  this->config.maxGamePlies, &nodes, nullptr, record)
+                       : playGame(opening, searcherB, this->engineB.limits, searcherA, this->engineA.limits,
+                                  this->config.maxGamePlies, &nodes, nullptr, record);
+
+            std::scoped_lock lock{reportMutex};
+            if (result == GameResult::DRAW)
+            {
+                report.score.draws++;
+            }
+            else if ((result == GameResult::RED_WIN) == aIsRed)
+            {
+                report.score.wins++;
+            }
+            else
+            {
+                report.score.losses++;
+            }
+            report.nodes += nodes;
+            report.steals += stolen ? 1 : 0;
+            report.elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            if (this->config.sprt.enabled)
+            {
+                report.llr = report.score.llr(this->config.sprt.elo0, this->config.sprt.elo1);
+                if (report.decision == SprtDecision::CONTINUE)
+                {
+                    report.decision = report.score.sprt(this->config.sprt);
+                    if (report.decision != SprtDecision::CONTINUE)
+                    {
+                        this->stopRequested = true;
+                    }
+                }
+            }
+            if (this->onGameRecord)
+            {
+                this->onGameRecord(opening, moves, result);
+            }
+            if (onGame)
+            {
+                onGame(report);
+            }
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    for (size_t t = 1; t < numThreads; t++)
+    {
+        helpers.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread &helper : helpers)
+    {
+        helper.join();
+    }
+    report.elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return report;
+}
+
+/**
+ * Ask workers not to start any more games. Safe from any thread
+ */
+void SelfPlayMatch::stop()
+{
+    this->stopRequested = true;
+}
+
+} // namespace chk::engine
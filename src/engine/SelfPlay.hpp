@@ -0,0 +1,128 @@
+// created 2026-10-18
+#pragma once
+
+#include "Evaluation.hpp"
+#include "Nnue.hpp"
+#include "Position.hpp"
+#include "Search.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace chk::engine
+{
+/**
+ * One contestant of a self-play match: search settings, evaluation and time control
+ */
+struct EngineSpec
+{
+    std::string name = "engine";
+    SearchConfig config{};
+    std::shared_ptr<const NnueNetwork> network = nullptr;     // null = hand-written evaluation
+    std::shared_ptr<const EvalWeights> evalWeights = nullptr; // null = weights loaded at startup
+    SearchLimits limits{MAX_PLY - 1, 20000, 0};               // per move: fixed nodes and/or fixed time
+};
+
+/**
+ * Sequential probability ratio test: H0 "A is elo0 stronger than B" vs H1 "A is elo1 stronger"
+ */
+struct SprtConfig
+{
+    bool enabled = false;
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05; // false positive rate (accept H1 when H0 is true)
+    double beta = 0.05;  // false negative rate (accept H0 when H1 is true)
+};
+
+enum class SprtDecision
+{
+    CONTINUE,
+    ACCEPT_H0, // A is not elo1 stronger: reject the change
+    ACCEPT_H1, // A is at least elo0 stronger: accept the change
+};
+
+/**
+ * Win/draw/loss counts, from the point of view of engine A
+ */
+struct MatchScore
+{
+    uint32_t wins = 0;
+    uint32_t draws = 0;
+    uint32_t losses = 0;
+
+    [[nodiscard]] uint32_t total() const;
+    [[nodiscard]] double scoreRate() const;
+    [[nodiscard]] double eloDiff() const;
+    [[nodiscard]] double eloError95() const;
+    [[nodiscard]] double llr(double elo0, double elo1) const;
+    [[nodiscard]] SprtDecision sprt(const SprtConfig &sprt) const;
+};
+
+/**
+ * How a self-play match is run
+ */
+struct SelfPlayConfig
+{
+    int numThreads = 0;          // concurrent games; 0 = all cores
+    uint32_t maxGames = 1000;    // upper bound; SPRT may stop earlier
+    uint32_t firstGame = 0;      // number of the first game (a distributed batch plays a slice of the match)
+    int maxGamePlies = 300;      // longer games are adjudicated a draw
+    SprtConfig sprt{};
+    std::vector<Position> openings{}; // each is played twice, colours reversed; empty = initial position
+};
+
+/**
+ * Outcome of a match (or a snapshot of one still running)
+ */
+struct SelfPlayReport
+{
+    MatchScore score{};
+    SprtDecision decision = SprtDecision::CONTINUE;
+    double llr = 0.0;
+    uint64_t nodes = 0;   // searched by both engines
+    uint64_t steals = 0;  // games a worker took from another worker's queue
+    double elapsedSec = 0.0;
+
+    [[nodiscard]] double gamesPerSec() const;
+};
+
+[[nodiscard]] double sprtLowerBound(const SprtConfig &sprt);
+[[nodiscard]] double sprtUpperBound(const SprtConfig &sprt);
+[[nodiscard]] std::vector<Position> generateOpenings(int count, int randomPlies, int maxImbalance, uint32_t seed);
+GameResult playGame(const Position &opening, Searcher &red, const SearchLimits &redLimits, Searcher &black,
+                     const SearchLimits &blackLimits, int maxPlies, uint64_t *nodes = nullptr,
+                     std::vector<Position> *positions = nullptr, std::vector<Move> *moves = nullptr);
+
+/**
+ * Engine-vs-engine match played on all cores. Game jobs are dealt out to per-worker queues; a worker
+ * whose queue runs dry steals from the others, so long games do not leave cores idle at the end.
+ */
+class SelfPlayMatch final
+{
+  public:
+    // called from a worker thread after every finished game
+    using ProgressCallback = std::function<void(const SelfPlayReport &)>;
+    // same, with the game itself (e.g. to build an opening book from the match)
+    using GameRecordCallback =
+        std::function<void(const Position &opening, const std::vector<Move> &moves, GameResult result)>;
+
+    SelfPlayMatch(EngineSpec engineA, EngineSpec engineB, SelfPlayConfig config);
+    SelfPlayMatch(const SelfPlayMatch &) = delete;
+    SelfPlayMatch &operator=(const SelfPlayMatch &) = delete;
+    SelfPlayReport run(const ProgressCallback &onGame = nullptr);
+    void stop();
+    void setOnGameRecord(const GameRecordCallback &callback);
+
+  private:
+    EngineSpec engineA;
+    EngineSpec engineB;
+    SelfPlayConfig config;
+    GameRecordCallback onGameRecord;
+    std::atomic_bool stopRequested{false};
+};
+
+} // namespace chk::engine
@@ -0,0 +1,134 @@
+// created 2026-10-18
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace chk::engine
+{
+/**
+ * (THREAD SAFE) Least-recently-used cache split into independent shards, each with its own lock,
+ * so that many search threads rarely wait on each other. Keys are spread across shards by hash.
+ */
+template <typename K, typename V> class ShardedLruCache
+{
+
+  public:
+    // Constructor, sets total capacity (in items) and number of shards
+    explicit ShardedLruCache(const size_t maxItems, const size_t numShards = 16)
+    {
+        const size_t shardCount = numShards == 0 ? 1 : numShards;
+        const size_t perShard = std::max<size_t>(1, maxItems / shardCount);
+        this->shards.reserve(shardCount);
+        for (size_t i = 0; i < shardCount; i++)
+        {
+            this->shards.emplace_back(std::make_unique<Shard>(perShard));
+        }
+    }
+    ShardedLruCache() = delete;
+    ShardedLruCache(const ShardedLruCache &) = delete;
+    ShardedLruCache &operator=(const ShardedLruCache &) = delete;
+    std::optional<V> get(const K &key);
+    void put(const K &key, V value);
+    void clear();
+    [[nodiscard]] size_t size() const;
+
+  private:
+    struct Shard
+    {
+        explicit Shard(const size_t cap) : capacity(cap)
+        {
+        }
+        const size_t capacity;
+        mutable std::mutex mtx;
+        std::list<std::pair<K, V>> items; // front is most recently used
+        std::unordered_map<K, typename std::list<std::pair<K, V>>::iterator> lookup;
+    };
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    Shard &shardFor(const K &key)
+    {
+        return *this->shards[std::hash<K>{}(key) % this->shards.size()];
+    }
+};
+
+/**
+ * Find an item, and mark it as most recently used
+ * @param key the key
+ * @return copy of value, or empty if not cached
+ */
+template <typename K, typename V> std::optional<V> ShardedLruCache<K, V>::get(const K &key)
+{
+    Shard &shard = this->shardFor(key);
+    std::scoped_lock<std::mutex> lg{shard.mtx};
+    const auto it = shard.lookup.find(key);
+    if (it == shard.lookup.end())
+    {
+        return std::nullopt;
+    }
+    shard.items.splice(shard.items.begin(), shard.items, it->second);
+    return it->second->second;
+}
+
+/**
+ * Insert (or replace) an item. If the shard is full, evict its least recently used item first
+ * @param key the key
+ * @param value the value
+ */
+template <typename K, typename V> void ShardedLruCache<K, V>::put(const K &key, V value)
+{
+    Shard &shard = this->shardFor(key);
+    std::scoped_lock<std::mutex> lg{shard.mtx};
+    const auto it = shard.lookup.find(key);
+    if (it != shard.lookup.end())
+    {
+        it->second->second = std::move(value);
+        shard.items.splice(shard.items.begin(), shard.items, it->second);
+        return;
+    }
+    if (shard.items.size() >= shard.capacity)
+    {
+        shard.lookup.erase(shard.items.back().first);
+        shard.items.pop_back();
+    }
+    shard.items.emplace_front(key, std::move(value));
+    shard.lookup.emplace(key, shard.items.begin());
+}
+
+/**
+ * Remove all items from every shard
+ */
+template <typename K, typename V> void ShardedLruCache<K, V>::clear()
+{
+    for (auto &shard : this->shards)
+    {
+        std::scoped_lock<std::mutex> lg{shard->mtx};
+        shard->lookup.clear();
+        shard->items.clear();
+    }
+}
+
+/**
+ * Total items currently cached (across all shards)
+ */
+template <typename K, typename V> size_t ShardedLruCache<K, V>::size() const
+{
+    size_t total = 0;
+    for (const auto &shard : this->shards)
+    {
+        std::scoped_lock<std::mutex> lg{shard->mtx};
+        total += shard->items.size();
+    }
+    return total;
+}
+
+} // namespace chk::engine
@@ -0,0 +1,304 @@
+#include "SharedChannel.hpp"
+#include <new>
+#include <spdlog/spdlog.h>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace chk::engine
+{
+
+namespace
+{
+static_assert((CHANNEL_RING_BYTES & (CHANNEL_RING_BYTES - 1)) == 0, "ring size must be a power of 2");
+
+/**
+ * Every record starts 8-byte aligned with this header; the payload follows, padded to 8 bytes
+ */
+struct RecordHeader
+{
+    uint16_t type;
+    uint16_t reserved;
+    uint32_t size;
+};
+static_assert(sizeof(RecordHeader) == 8);
+
+constexpr uint64_t recordBytes(const uint32_t payloadSize)
+{
+    return sizeof(RecordHeader) + ((static_cast<uint64_t>(payloadSize) + 7) & ~uint64_t{7});
+}
+
+/**
+ * Copy into the ring at a running offset, wrapping around the end
+ */
+void ringWrite(uint8_t *ring, const uint64_t offset, const void *source, const size_t count)
+{
+    const size_t start = offset & (CHANNEL_RING_BYTES - 1);
+    const size_t first = std::min(count, CHANNEL_RING_BYTES - start);
+    std::memcpy(ring + start, source, first);
+    std::memcpy(ring, static_cast<const uint8_t *>(source) + first, count - first);
+}
+
+/**
+ * Copy out of the ring at a running offset, wrapping around the end
+ */
+void ringRead(const uint8_t *ring, const uint64_t offset, void *target, const size_t count)
+{
+    const size_t start = offset & (CHANNEL_RING_BYTES - 1);
+    const size_t first = std::min(count, CHANNEL_RING_BYTES - start);
+    std::memcpy(target, ring + start, first);
+    std::memcpy(static_cast<uint8_t *>(target) + first, ring, count - first);
+}
+} // namespace
+
+SharedChannel::~SharedChannel()
+{
+    this->close();
+}
+
+/**
+ * Create a new, empty channel (client side). Fails if a region with this name already exists.
+ * @param name from makeChannelName()
+ * @return TRUE if successful, else FALSE
+ */
+bool SharedChannel::create(const std::string &name)
+{
+    this->close();
+    this->name = name;
+    this->role = ChannelRole::CLIENT;
+    if (!this->map(true))
+    {
+        return false;
+    }
+    new (this->layout) Layout{};
+    this->layout->magic.store(CHANNEL_MAGIC, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Attach to a channel created by the other process (engine side)
+ * @param name as passed by the client
+ * @return TRUE if successful, else FALSE
+ */
+bool SharedChannel::open(const std::string &name)
+{
+    this->close();
+    this->name = name;
+    this->role = ChannelRole::ENGINE;
+    if (!this->map(false))
+    {
+        return false;
+    }
+    if (this->layout->magic.load(std::memory_order_acquire) != CHANNEL_MAGIC ||
+        this->layout->version != CHANNEL_VERSION)
+    {
+        spdlog::error("shared channel {} is not a version {} channel", name, CHANNEL_VERSION);
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Map the region; the creator also sizes it, and removes the name again on close
+ */
+bool SharedChannel::map(const bool createNew)
+{
+    constexpr size_t length = sizeof(Layout);
+#if defined(_WIN32)
+    HANDLE mapping = nullptr;
+    if (createNew)
+    {
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(length),
+                                     this->name.c_str());
+        if (mapping != nullptr && GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            CloseHandle(mapping);
+            mapping = nullptr;
+        }
+    }
+    else
+    {
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, this->name.c_str());
+    }
+    if (mapping == nullptr)
+    {
+        spdlog::error("cannot {} shared memory {}", createNew ? "create" : "open", this->name);
+        return false;
+    }
+    void *view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, length);
+    if (view == nullptr)
+    {
+        CloseHandle(mapping);
+        spdlog::error("MapViewOfFile failed for {}", this->name);
+        return false;
+    }
+    this->mappingHandle = mapping;
+#else
+    const int fd = shm_open(this->name.c_str(), createNew ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0600);
+    if (fd < 0)
+    {
+        spdlog::error("cannot {} shared memory {}", createNew ? "create" : "open", this->name);
+        return false;
+    }
+    if (createNew && ftruncate(fd, static_cast<off_t>(length)) != 0)
+    {
+        ::close(fd);
+        shm_unlink(this->name.c_str());
+        spdlog::error("cannot size shared memory {}", this->name);
+        return false;
+    }
+    void *view = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the region alive
+    if (view == MAP_FAILED)
+    {
+        if (createNew)
+        {
+            shm_unlink(this->name.c_str());
+        }
+        spdlog::error("mmap failed for {}", this->name);
+        return false;
+    }
+#endif
+    this->layout = static_cast<Layout *>(view);
+    return true;
+}
+
+/**
+ * Unmap the region. The client also removes its name, so a restarted engine always gets a fresh channel.
+ */
+void SharedChannel::close()
+{
+    if (this->layout == nullptr)
+    {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(this->layout);
+    CloseHandle(this->mappingHandle);
+    this->mappingHandle = nullptr;
+#else
+    munmap(this->layout, sizeof(Layout));
+    if (this->role == ChannelRole::CLIENT)
+    {
+        shm_unlink(this->name.c_str());
+    }
+#endif
+    this->layout = nullptr;
+}
+
+bool SharedChannel::isOpen() const
+{
+    return this->layout != nullptr;
+}
+
+const std::string &SharedChannel::getName() const
+{
+    return this->name;
+}
+
+/**
+ * Append one message to the outgoing ring
+ * @param type message tag (meaning is up to the caller)
+ * @param payload bytes to copy
+ * @param size number of bytes (at most CHANNEL_MAX_MESSAGE)
+ * @return FALSE if the channel is closed, the message too large, or the ring full (nothing was written)
+ */
+bool SharedChannel::send(const uint16_t type, const void *payload, const uint32_t size)
+{
+    if (this->layout == nullptr || size > CHANNEL_MAX_MESSAGE)
+    {
+        return false;
+    }
+    Ring &ring = this->role == ChannelRole::CLIENT ? this->layout->toEngine : this->layout->toClient;
+    const uint64_t head = ring.head.value.load(std::memory_order_relaxed);
+    const uint64_t tail = ring.tail.value.load(std::memory_order_acquire);
+    const uint64_t needed = recordBytes(size);
+    if (CHANNEL_RING_BYTES - (head - tail) < needed)
+    {
+        return false;
+    }
+    const RecordHeader header{type, 0, size};
+    ringWrite(ring.data.data(), head, &header, sizeof(header));
+    ringWrite(ring.data.data(), head + sizeof(header), payload, size);
+    ring.head.value.store(head + needed, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Take the oldest message from the incoming ring, if any
+ * @param message filled in on success
+ * @return TRUE if a message was read, FALSE if the ring is empty (or the channel closed)
+ */
+bool SharedChannel::receive(ChannelMessage &message)
+{
+    if (this->layout == nullptr)
+    {
+        return false;
+    }
+    Ring &ring = this->role == ChannelRole::CLIENT ? this->layout->toClient : this->layout->toEngine;
+    const uint64_t tail = ring.tail.value.load(std::memory_order_relaxed);
+    const uint64_t head = ring.head.value.load(std::memory_order_acquire);
+    if (head == tail)
+    {
+        return false;
+    }
+    RecordHeader header{};
+    ringRead(ring.data.data(), tail, &header, sizeof(header));
+    message.type = header.type;
+    message.size = std::min(header.size, CHANNEL_MAX_MESSAGE);
+    ringRead(ring.data.data(), tail + sizeof(header), message.bytes.data(), message.size);
+    ring.tail.value.store(tail + recordBytes(header.size), std::memory_order_release);
+    return true;
+}
+
+/**
+ * Tell the other side this process is still alive (call regularly, e.g. every poll)
+ */
+void SharedChannel::beat()
+{
+    if (this->layout != nullptr)
+    {
+        this->layout->heartbeat[static_cast<int>(this->role)].value.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @return the other side's heartbeat counter: if it stops changing, the other process is stuck or gone
+ */
+uint64_t SharedChannel::peerHeartbeat() const
+{
+    if (this->layout == nullptr)
+    {
+        return 0;
+    }
+    const int peer = this->role == ChannelRole::CLIENT ? static_cast<int>(ChannelRole::ENGINE)
+                                                       : static_cast<int>(ChannelRole::CLIENT);
+    return this->layout->heartbeat[peer].value.load(std::memory_order_relaxed);
+}
+
+/**
+ * A name no other channel on this machine uses: process id plus a counter
+ */
+std::string makeChannelName()
+{
+    static std::atomic<uint32_t> counter{0};
+    const uint32_t id = counter.fetch_add(1, std::memory_order_relaxed);
+#if defined(_WIN32)
+    return "Local\\spacecheckers-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(id);
+#else
+    // short: macOS limits shared memory names to 31 characters
+    return "/schk-" + std::to_string(getpid()) + "-" + std::to_string(id);
+#endif
+}
+
+} // namespace chk::engine
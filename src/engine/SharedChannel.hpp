@@ -0,0 +1,118 @@
+// created 2026-10-18
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace chk::engine
+{
+constexpr uint32_t CHANNEL_MAGIC{0x43484353}; // "SCHC" in little-endian
+constexpr uint32_t CHANNEL_VERSION{1};
+constexpr size_t CHANNEL_RING_BYTES{64 * 1024}; // per direction, power of 2
+constexpr uint32_t CHANNEL_MAX_MESSAGE{4096};
+
+/**
+ * Which end of the channel this process holds
+ */
+enum class ChannelRole : uint8_t
+{
+    CLIENT = 0, // created the channel; writes requests, reads replies
+    ENGINE,     // opened it by name; reads requests, writes replies
+};
+
+/**
+ * One received message: a type tag chosen by the caller, and raw bytes
+ */
+struct ChannelMessage
+{
+    uint16_t type = 0;
+    uint32_t size = 0;
+    std::array<uint8_t, CHANNEL_MAX_MESSAGE> bytes{};
+
+    /**
+     * Read the payload as a plain struct (zero-filled if the message is shorter)
+     */
+    template <typename T> [[nodiscard]] T as() const
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= CHANNEL_MAX_MESSAGE);
+        T value{};
+        std::memcpy(&value, this->bytes.data(), std::min<size_t>(this->size, sizeof(T)));
+        return value;
+    }
+};
+
+/**
+ * Two-way message channel between two processes on one machine, in one named shared-memory region.
+ * Each direction is a single-producer / single-consumer ring of length-prefixed records, moved with
+ * two atomic counters: no locks, no system calls, no serialisation beyond a memcpy.
+ * Each side also bumps a heartbeat counter, so the other can tell it is still alive.
+ *
+ * Not thread-safe: callers sending from several threads must serialise `send` themselves.
+ */
+class SharedChannel final
+{
+  public:
+    SharedChannel() = default;
+    ~SharedChannel();
+    SharedChannel(const SharedChannel &) = delete;
+    SharedChannel &operator=(const SharedChannel &) = delete;
+    [[nodiscard]] bool create(const std::string &name);
+    [[nodiscard]] bool open(const std::string &name);
+    void close();
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] const std::string &getName() const;
+    bool send(uint16_t type, const void *payload, uint32_t size);
+    bool receive(ChannelMessage &message);
+    void beat();
+    [[nodiscard]] uint64_t peerHeartbeat() const;
+
+    /**
+     * Send a plain struct as the payload
+     * @return FALSE if the ring is full (nothing was written)
+     */
+    template <typename T> bool send(const uint16_t type, const T &payload)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= CHANNEL_MAX_MESSAGE);
+        return this->send(type, &payload, static_cast<uint32_t>(sizeof(T)));
+    }
+
+  private:
+    struct alignas(64) Counter
+    {
+        std::atomic<uint64_t> value{0};
+    };
+    struct Ring
+    {
+        Counter head; // bytes ever written (producer only)
+        Counter tail; // bytes ever read (consumer only)
+        std::array<uint8_t, CHANNEL_RING_BYTES> data;
+    };
+    struct Layout
+    {
+        std::atomic<uint32_t> magic{0}; // set last by the creator: region is ready
+        uint32_t version = CHANNEL_VERSION;
+        Counter heartbeat[2]; // indexed by ChannelRole
+        Ring toEngine;
+        Ring toClient;
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared counters must be lock-free");
+
+    Layout *layout = nullptr;
+    ChannelRole role = ChannelRole::CLIENT;
+    std::string name{};
+#if defined(_WIN32)
+    void *mappingHandle = nullptr;
+#endif
+
+    [[nodiscard]] bool map(bool createNew);
+};
+
+[[nodiscard]] std::string makeChannelName();
+
+} // namespace chk::engine
@@ -0,0 +1,95 @@
+#include "Strength.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr uint64_t CALIBRATION_NODES{50'000};
+} // namespace
+
+/**
+ * Search limits for a level: its node budget, with the time cap as a safety net only
+ * @param level the difficulty level
+ */
+SearchLimits limitsFor(const StrengthLevel &level)
+{
+    SearchLimits limits{};
+    limits.maxNodes = level.nodes;
+    limits.moveTimeMs = level.maxTimeMs;
+    limits.multiPv = std::max(level.candidates, 1);
+    return limits;
+}
+
+/**
+ * Same level for the MCTS engine: its node budget turned into playouts (at least one), same time cap.
+ * MCTS ranks a single line, so weaker levels are weaker only through their smaller budget
+ * @param level the difficulty level
+ */
+SearchLimits mctsLimitsFor(const StrengthLevel &level)
+{
+    SearchLimits limits{};
+    limits.maxNodes = std::max<uint64_t>(level.nodes / NODES_PER_PLAYOUT, 1);
+    limits.moveTimeMs = level.maxTimeMs;
+    return limits;
+}
+
+/**
+ * Choose the move to play: uniformly among the ranked lines within `scoreMargin` of the best one.
+ * With a zero margin (or a single line) the best move is always played
+ * @param result finished search, run with `limitsFor(level)`
+ * @param level the difficulty level
+ * @param rng random source (only used when there is a choice)
+ * @return move to play, or NULL_MOVE if there is no legal move
+ */
+Move pickMove(const SearchResult &result, const StrengthLevel &level, std::mt19937 &rng)
+{
+    if (result.lines.empty())
+    {
+        return result.bestMove;
+    }
+    const int threshold = result.lines.front().score - std::max(level.scoreMargin, 0);
+    const auto close = std::count_if(result.lines.begin(), result.lines.end(),
+                                     [threshold](const PvLine &line) { return line.score >= threshold; });
+    if (close <= 1)
+    {
+        return result.lines.front().pv.front();
+    }
+    std::uniform_int_distribution<long> pick{0, static_cast<long>(close) - 1};
+    return result.lines[static_cast<size_t>(pick(rng))].pv.front(); // lines are sorted best first
+}
+
+/**
+ * Longest a move can take at this level: the node budget at the given speed, or the hard cap if sooner
+ * @param level the difficulty level
+ * @param nodesPerSecond measured speed of this machine (0 = unknown: cap only)
+ */
+int64_t maxThinkMs(const StrengthLevel &level, const uint64_t nodesPerSecond)
+{
+    if (nodesPerSecond == 0)
+    {
+        return level.maxTimeMs;
+    }
+    const auto budgetMs = static_cast<int64_t>((level.nodes * 1000 + nodesPerSecond - 1) / nodesPerSecond);
+    return std::min(budgetMs, level.maxTimeMs);
+}
+
+/**
+ * Quick speed test of this machine (one core, about 50 ms on a typical laptop)
+ * @return nodes per second of the default searcher
+ */
+uint64_t measureNodesPerSecond()
+{
+    Searcher searcher;
+    SearchLimits limits{};
+    limits.maxNodes = CALIBRATION_NODES;
+    const auto start = std::chrono::steady_clock::now();
+    const SearchResult result = searcher.search(Position::initial(), limits);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto micros = std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), 1);
+    return std::max<uint64_t>(result.stats.nodes * 1'000'000 / static_cast<uint64_t>(micros), 1);
+}
+
+} // namespace chk::engine
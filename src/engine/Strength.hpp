@@ -0,0 +1,45 @@
+// created 2026-10-18
+#pragma once
+
+#include "Search.hpp"
+#include <array>
+#include <cstdint>
+#include <random>
+
+namespace chk::engine
+{
+/**
+ * A difficulty level for the computer opponent. Strength comes from a fixed node budget, not a clock:
+ * the engine plays the same moves on any machine, and stops after the same amount of work.
+ * Weaker levels also rank a few candidates and pick randomly among those close to the best.
+ */
+struct StrengthLevel
+{
+    const char *name;
+    uint64_t nodes;    // search budget per move
+    int candidates;    // root moves ranked (multi-PV); 1 = best move only
+    int scoreMargin;   // a candidate may be played if within this many points of the best
+    int64_t maxTimeMs; // hard cap per move, in case the machine is slower than MIN_EXPECTED_NPS
+};
+
+// slowest machine we plan for (nodes per second, one core): time caps are derived from it
+constexpr uint64_t MIN_EXPECTED_NPS{250'000};
+
+constexpr std::array<StrengthLevel, 5> STRENGTH_LEVELS{{
+    {"Beginner", 400, 4, 150, 400 * 1000 / MIN_EXPECTED_NPS + 10},
+    {"Casual", 3'000, 3, 60, 3'000 * 1000 / MIN_EXPECTED_NPS + 10},
+    {"Club", 25'000, 2, 20, 25'000 * 1000 / MIN_EXPECTED_NPS + 10},
+    {"Expert", 150'000, 1, 0, 150'000 * 1000 / MIN_EXPECTED_NPS + 10},
+    {"Master", 1'000'000, 1, 0, 1'000'000 * 1000 / MIN_EXPECTED_NPS + 10},
+}};
+
+// a random playout from the opening takes about as long as this many alpha-beta nodes
+constexpr uint64_t NODES_PER_PLAYOUT{50};
+
+[[nodiscard]] SearchLimits limitsFor(const StrengthLevel &level);
+[[nodiscard]] SearchLimits mctsLimitsFor(const StrengthLevel &level);
+[[nodiscard]] Move pickMove(const SearchResult &result, const StrengthLevel &level, std::mt19937 &rng);
+[[nodiscard]] int64_t maxThinkMs(const StrengthLevel &level, uint64_t nodesPerSecond);
+[[nodiscard]] uint64_t measureNodesPerSecond();
+
+} // namespace chk::engine
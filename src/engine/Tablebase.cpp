@@ -0,0 +1,412 @@
+#include "Tablebase.hpp"
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+namespace chk::engine
+{
+
+namespace
+{
+// red men can never stand on cells 29~32 (they would be kings), black men never on cells 1~4
+constexpr int MEN_SQUARES{28};
+constexpr int BLACK_MEN_FIRST_SQUARE{4};
+
+/**
+ * Pascal's triangle, BINOMIAL[n][k] = n choose k
+ */
+constexpr std::array<std::array<uint64_t, NUM_SQUARES + 1>, NUM_SQUARES + 1> buildBinomials()
+{
+    std::array<std::array<uint64_t, NUM_SQUARES + 1>, NUM_SQUARES + 1> table{};
+    for (int n = 0; n <= NUM_SQUARES; n++)
+    {
+        table[n][0] = 1;
+        for (int k = 1; k <= n; k++)
+        {
+            table[n][k] = table[n - 1][k - 1] + (k <= n - 1 ? table[n - 1][k] : 0);
+        }
+    }
+    return table;
+}
+
+constexpr auto BINOMIAL = buildBinomials();
+
+/**
+ * Combinatorial (colex) rank of a set of pieces, where each piece's position is counted only
+ * over `allowed` squares, after shifting down by `firstSquare`
+ */
+uint64_t rankPieces(Bitboard pieces, const Bitboard allowed)
+{
+    uint64_t rank = 0;
+    int nth = 1;
+    while (pieces != 0)
+    {
+        const int sq = popLowest(pieces);
+        const int relative = popCount(allowed & (bitOf(sq) - 1));
+        rank += BINOMIAL[relative][nth++];
+    }
+    return rank;
+}
+
+uint64_t readU64(const uint8_t *src)
+{
+    uint64_t value = 0;
+    std::memcpy(&value, src, sizeof(value)); // files are little-endian, same as all supported hosts
+    return value;
+}
+
+uint32_t readU32(const uint8_t *src)
+{
+    uint32_t value = 0;
+    std::memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+uint16_t readU16(const uint8_t *src)
+{
+    uint16_t value = 0;
+    std::memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+template <typename T> void writeRaw(std::ofstream &out, const T value)
+{
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+} // namespace
+
+/**
+ * Number of indices in a slice of this material signature (both sides to move)
+ */
+uint64_t tablebaseSliceSize(const MaterialKey &key)
+{
+    const int freeForKings = NUM_SQUARES - key.redMen - key.blackMen;
+    if (key.redMen > MEN_SQUARES || key.blackMen > MEN_SQUARES || freeForKings < key.redKings + key.blackKings)
+    {
+        return 0;
+    }
+    return BINOMIAL[MEN_SQUARES][key.redMen] * BINOMIAL[MEN_SQUARES][key.blackMen] *
+           BINOMIAL[freeForKings][key.redKings] * BINOMIAL[freeForKings - key.redKings][key.blackKings] * 2;
+}
+
+/**
+ * Map a position to its index inside the slice of its material signature.
+ * Men are ranked first (each colour over the 28 squares it can occupy), then kings over the squares left empty.
+ * @param pos the position
+ * @param key material signature of `pos`
+ * @return index in range [0, tablebaseSliceSize(key))
+ */
+uint64_t tablebaseIndex(const Position &pos, const MaterialKey &key)
+{
+    const Bitboard redMen = pos.red & ~pos.kings;
+    const Bitboard blackMen = pos.black & ~pos.kings;
+    const Bitboard redKings = pos.red & pos.kings;
+    const Bitboard blackKings = pos.black & pos.kings;
+
+    const uint64_t redMenIdx = rankPieces(redMen, ~RED_CROWN_ROW);
+    const uint64_t blackMenIdx = rankPieces(blackMen, ~BLACK_CROWN_ROW);
+    const Bitboard freeForRedKings = ~(redMen | blackMen);
+    const uint64_t redKingsIdx = rankPieces(redKings, freeForRedKings);
+    const uint64_t blackKingsIdx = rankPieces(blackKings, freeForRedKings & ~redKings);
+
+    const int freeForKings = NUM_SQUARES - key.redMen - key.blackMen;
+    uint64_t index = redMenIdx;
+    index = index * BINOMIAL[MEN_SQUARES][key.blackMen] + blackMenIdx;
+    index = index * BINOMIAL[freeForKings][key.redKings] + redKingsIdx;
+    index = index * BINOMIAL[freeForKings - key.redKings][key.blackKings] + blackKingsIdx;
+    return index * 2 + static_cast<uint64_t>(pos.sideToMove);
+}
+
+/**
+ * Compress and save one slice to disk (used by the generator, and by tests)
+ *
+ * @param path destination file
+ * @param key material signature of this slice
+ * @param values one result per index, MUST have exactly `tablebaseSliceSize(key)` items
+ * @param positionsPerBlock positions per compressed block (multiple of 4)
+ * @return TRUE if successful, else FALSE
+ */
+bool writeTablebaseSlice(const std::string &path, const MaterialKey &key, const std::vector<Wdl> &values,
+                         const uint32_t positionsPerBlock)
+{
+    if (values.size() != tablebaseSliceSize(key) || positionsPerBlock == 0 || positionsPerBlock % 4 != 0)
+    {
+        spdlog::error("invalid tablebase slice for {}", path);
+        return false;
+    }
+    const uint64_t numPositions = values.size();
+    const auto numBlocks = static_cast<uint32_t>((numPositions + positionsPerBlock - 1) / positionsPerBlock);
+
+    // pack + compress each block
+    std::vector<std::vector<uint8_t>> blocks;
+    blocks.reserve(numBlocks);
+    for (uint32_t b = 0; b < numBlocks; b++)
+    {
+        const uint64_t first = static_cast<uint64_t>(b) * positionsPerBlock;
+        const uint64_t count = std::min<uint64_t>(positionsPerBlock, numPositions - first);
+        std::vector<uint8_t> packed((count + 3) / 4, 0);
+        for (uint64_t i = 0; i < count; i++)
+        {
+            packed[i / 4] |= static_cast<uint8_t>(static_cast<uint8_t>(values[first + i]) << ((i % 4) * 2));
+        }
+        uLongf destLen = compressBound(static_cast<uLong>(packed.size()));
+        std::vector<uint8_t> compressed(destLen);
+        if (compress2(compressed.data(), &destLen, packed.data(), static_cast<uLong>(packed.size()),
+                      Z_BEST_COMPRESSION) != Z_OK)
+        {
+            spdlog::error("failed to compress tablebase block {} of {}", b, path);
+            return false;
+        }
+        compressed.resize(destLen);
+        blocks.emplace_back(std::move(compressed));
+    }
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if (!out)
+    {
+        spdlog::error("cannot write tablebase file {}", path);
+        return false;
+    }
+    // HEADER
+    writeRaw<uint32_t>(out, TB_MAGIC);
+    writeRaw<uint16_t>(out, TB_VERSION);
+    writeRaw<uint8_t>(out, key.redMen);
+    writeRaw<uint8_t>(out, key.redKings);
+    writeRaw<uint8_t>(out, key.blackMen);
+    writeRaw<uint8_t>(out, key.blackKings);
+    writeRaw<uint16_t>(out, 0);
+    writeRaw<uint32_t>(out, positionsPerBlock);
+    writeRaw<uint64_t>(out, numPositions);
+    writeRaw<uint32_t>(out, numBlocks);
+    writeRaw<uint32_t>(out, 0);
+    // OFFSET TABLE (numBlocks + 1 entries, last one is end of file)
+    uint64_t offset = TB_HEADER_SIZE + (static_cast<uint64_t>(numBlocks) + 1) * sizeof(uint64_t);
+    for (const auto &block : blocks)
+    {
+        writeRaw<uint64_t>(out, offset);
+        offset += block.size();
+    }
+    writeRaw<uint64_t>(out, offset);
+    // BLOCKS
+    for (const auto &block : blocks)
+    {
+        out.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size()));
+    }
+    return static_cast<bool>(out);
+}
+
+/**
+ * Custom constructor
+ * @param cacheMegabytes memory budget for unpacked blocks
+ */
+Tablebase::Tablebase(const size_t cacheMegabytes)
+    : blockCache(std::max<size_t>(1, cacheMegabytes * 1024 * 1024 / (TB_DEFAULT_BLOCK_POSITIONS / 4)))
+{
+}
+
+/**
+ * Map every slice file found in this directory
+ * @param directory folder containing `*.sctb` files
+ * @return number of slices loaded
+ */
+size_t Tablebase::loadDirectory(const std::string &directory)
+{
+    std::error_code ec;
+    size_t loaded = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, ec))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == TB_FILE_EXTENSION)
+        {
+            loaded += this->addSlice(entry.path().string()) ? 1 : 0;
+        }
+    }
+    if (ec)
+    {
+        spdlog::warn("cannot read tablebase directory {}: {}", directory, ec.message());
+    }
+    spdlog::info("loaded {} tablebase slices (up to {} pieces)", loaded, this->maxPieces);
+    return loaded;
+}
+
+/**
+ * Map a single slice file, after validating its header and offset table
+ * @param path location of `.sctb` file
+ * @return TRUE if successful, else FALSE
+ */
+bool Tablebase::addSlice(const std::string &path)
+{
+    auto slice = std::make_unique<Slice>();
+    if (!slice->file.open(path))
+    {
+        return false;
+    }
+    const uint8_t *base = slice->file.data();
+    const size_t fileSize = slice->file.size();
+    if (fileSize < TB_HEADER_SIZE || readU32(base) != TB_MAGIC || readU16(base + 4) != TB_VERSION)
+    {
+        spdlog::error("{} is not a valid tablebase file", path);
+        return false;
+    }
+    slice->key = MaterialKey{base[6], base[7], base[8], base[9]};
+    slice->positionsPerBlock = readU32(base + 12);
+    slice->numPositions = readU64(base + 16);
+    slice->numBlocks = readU32(base + 24);
+
+    const uint64_t expectedBlocks =
+        slice->positionsPerBlock == 0 ? 0 : (slice->numPositions + slice->positionsPerBlock - 1) / slice->positionsPerBlock;
+    const uint64_t tableEnd = TB_HEADER_SIZE + (static_cast<uint64_t>(slice->numBlocks) + 1) * sizeof(uint64_t);
+    if (slice->positionsPerBlock % 4 != 0 || slice->numPositions != tablebaseSliceSize(slice->key) ||
+        slice->numBlocks != expectedBlocks || tableEnd > fileSize ||
+        readU64(base + tableEnd - sizeof(uint64_t)) > fileSize)
+    {
+        spdlog::error("{} is corrupted (bad header or offset table)", path);
+        return false;
+    }
+    if (this->hasSlice(slice->key))
+    {
+        spdlog::warn("duplicate tablebase slice {} ignored", path);
+        return false;
+    }
+    slice->file.adviseRandomAccess();
+    this->maxPieces = std::max(this->maxPieces, slice->key.total());
+    this->slices.emplace(slice->key.packed(), std::move(slice));
+    return true;
+}
+
+/**
+ * Whether a slice for this material signature is loaded
+ */
+bool Tablebase::hasSlice(const MaterialKey &key) const
+{
+    return this->slices.find(key.packed()) != this->slices.end();
+}
+
+/**
+ * Largest number of pieces covered by any loaded slice
+ */
+int Tablebase::getMaxPieces() const
+{
+    return this->maxPieces;
+}
+
+/**
+ * Look up the exact result of this position (thread safe)
+ *
+ * @param pos position to look up
+ * @param stats receives probe and cache counters
+ * @return WIN/LOSS/DRAW for side to move, or empty if not covered by any slice
+ */
+std::optional<Wdl> Tablebase::probe(const Position &pos, EngineStats &stats) const
+{
+    return this->lookup(pos, &stats);
+}
+
+/**
+ * Look up the exact result of this position, without counting it anywhere (thread safe)
+ *
+ * @param pos position to look up
+ * @return WIN/LOSS/DRAW for side to move, or empty if not covered by any slice
+ */
+std::optional<Wdl> Tablebase::probe(const Position &pos) const
+{
+    return this->lookup(pos, nullptr);
+}
+
+/**
+ * Shared body of both `probe` forms
+ * @param stats receives probe and cache counters (may be nullptr)
+ */
+std::optional<Wdl> Tablebase::lookup(const Position &pos, EngineStats *stats) const
+{
+    const auto count = [stats](std::atomic<uint64_t> EngineStats::*counter) {
+        if (stats != nullptr)
+        {
+            bump(stats->*counter);
+        }
+    };
+    const MaterialKey key = MaterialKey::of(pos);
+    if (key.total() > this->maxPieces)
+    {
+        return std::nullopt;
+    }
+    const auto it = this->slices.find(key.packed());
+    if (it == this->slices.end())
+    {
+        return std::nullopt;
+    }
+    if ((pos.red & ~pos.kings & RED_CROWN_ROW) != 0 || (pos.black & ~pos.kings & BLACK_CROWN_ROW) != 0)
+    {
+        return std::nullopt; // a man on its own crown row is illegal, and has no index in the slice
+    }
+    const Slice &slice = *it->second;
+    const uint64_t index = tablebaseIndex(pos, key);
+    if (index >= slice.numPositions)
+    {
+        return std::nullopt;
+    }
+    count(&EngineStats::tbProbes);
+    const auto blockIdx = static_cast<uint32_t>(index / slice.positionsPerBlock);
+    const uint64_t local = index % slice.positionsPerBlock;
+
+    const uint64_t cacheKey = (static_cast<uint64_t>(key.packed()) << 32) | blockIdx;
+    BlockData block = nullptr;
+    if (auto cached = this->blockCache.get(cacheKey); cached.has_value())
+    {
+        count(&EngineStats::tbCacheHits);
+        block = std::move(cached.value());
+    }
+    else
+    {
+        count(&EngineStats::tbCacheMisses);
+        block = this->unpackBlock(slice, blockIdx);
+        if (block == nullptr)
+        {
+            return std::nullopt;
+        }
+        this->blockCache.put(cacheKey, block);
+    }
+
+    const auto value = static_cast<Wdl>(((*block)[local / 4] >> ((local % 4) * 2)) & 0b11);
+    if (value == Wdl::UNKNOWN)
+    {
+        return std::nullopt;
+    }
+    count(&EngineStats::tbHits);
+    return value;
+}
+
+/**
+ * Decompress one block straight out of the mapped file (no lock held, so threads unpack in parallel)
+ * @param slice the slice
+ * @param blockIdx block number
+ * @return unpacked block, or nullptr if data is corrupted
+ */
+Tablebase::BlockData Tablebase::unpackBlock(const Slice &slice, const uint32_t blockIdx) const
+{
+    const uint8_t *base = slice.file.data();
+    const uint8_t *offsets = base + TB_HEADER_SIZE;
+    const uint64_t begin = readU64(offsets + blockIdx * sizeof(uint64_t));
+    const uint64_t end = readU64(offsets + (blockIdx + 1) * sizeof(uint64_t));
+    if (begin > end || end > slice.file.size())
+    {
+        spdlog::error("tablebase block {} has invalid offsets", blockIdx);
+        return nullptr;
+    }
+
+    const uint64_t first = static_cast<uint64_t>(blockIdx) * slice.positionsPerBlock;
+    const uint64_t count = std::min<uint64_t>(slice.positionsPerBlock, slice.numPositions - first);
+    auto unpacked = std::make_shared<std::vector<uint8_t>>((count + 3) / 4);
+    uLongf destLen = static_cast<uLongf>(unpacked->size());
+    const int status = uncompress(unpacked->data(), &destLen, base + begin, static_cast<uLong>(end - begin));
+    if (status != Z_OK || destLen != unpacked->size())
+    {
+        spdlog::error("tablebase block {} failed to decompress (zlib code {})", blockIdx, status);
+        return nullptr;
+    }
+    return unpacked;
+}
+
+} // namespace chk::engine
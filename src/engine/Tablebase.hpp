@@ -0,0 +1,80 @@
+// created 2026-10-18
+#pragma once
+
+#include "../utils/MappedFile.hpp"
+#include "EngineStats.hpp"
+#include "Position.hpp"
+#include "ShardedLruCache.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace chk::engine
+{
+/**
+ * Game-theoretic value of a position, from the side-to-move's point of view
+ */
+enum class Wdl : uint8_t
+{
+    UNKNOWN = 0, // not stored (impossible position)
+    LOSS = 1,
+    DRAW = 2,
+    WIN = 3,
+};
+
+constexpr auto TB_FILE_EXTENSION = ".sctb";
+constexpr uint32_t TB_MAGIC{0x42544353}; // "SCTB" in little-endian
+constexpr uint16_t TB_VERSION{1};
+constexpr uint32_t TB_HEADER_SIZE{32};
+constexpr uint32_t TB_DEFAULT_BLOCK_POSITIONS{16384}; // 4 KiB once unpacked (2 bits per position)
+
+uint64_t tablebaseSliceSize(const MaterialKey &key);
+uint64_t tablebaseIndex(const Position &pos, const MaterialKey &key);
+bool writeTablebaseSlice(const std::string &path, const MaterialKey &key, const std::vector<Wdl> &values,
+                         uint32_t positionsPerBlock = TB_DEFAULT_BLOCK_POSITIONS);
+
+/**
+ * Endgame tablebase prober. Every slice file (one per material signature) is memory-mapped,
+ * and its zlib-compressed blocks are unpacked on demand into a shared LRU cache.
+ * Load all slices BEFORE searching; after that, `probe` is safe to call from any number of threads.
+ */
+class Tablebase final
+{
+  public:
+    explicit Tablebase(size_t cacheMegabytes = 64);
+    Tablebase(const Tablebase &) = delete;
+    Tablebase &operator=(const Tablebase &) = delete;
+    size_t loadDirectory(const std::string &directory);
+    bool addSlice(const std::string &path);
+    [[nodiscard]] std::optional<Wdl> probe(const Position &pos, EngineStats &stats) const;
+    [[nodiscard]] std::optional<Wdl> probe(const Position &pos) const;
+    [[nodiscard]] bool hasSlice(const MaterialKey &key) const;
+    [[nodiscard]] int getMaxPieces() const;
+
+  private:
+    // unpacked block: 4 positions per byte
+    using BlockData = std::shared_ptr<const std::vector<uint8_t>>;
+
+    struct Slice
+    {
+        chk::MappedFile file;
+        MaterialKey key{};
+        uint32_t positionsPerBlock = 0;
+        uint64_t numPositions = 0;
+        uint32_t numBlocks = 0;
+    };
+
+    // material signature (packed) -> slice. Read-only once loading is finished
+    std::unordered_map<uint32_t, std::unique_ptr<Slice>> slices;
+    // (material signature << 32 | block number) -> unpacked block
+    mutable ShardedLruCache<uint64_t, BlockData> blockCache;
+    int maxPieces = 0;
+
+    [[nodiscard]] std::optional<Wdl> lookup(const Position &pos, EngineStats *stats) const;
+    [[nodiscard]] BlockData unpackBlock(const Slice &slice, uint32_t blockIdx) const;
+};
+
+} // namespace chk::engine
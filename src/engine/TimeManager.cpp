@@ -0,0 +1,137 @@
+#include "TimeManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr size_t FEW_MOVES{3};
+constexpr size_t MANY_MOVES{10};
+constexpr double NEXT_ITERATION_GROWTH{2.0}; // the next iteration is assumed to cost at least this many times the last
+
+int64_t scaled(const int64_t ms, const double factor)
+{
+    return static_cast<int64_t>(std::llround(static_cast<double>(ms) * factor));
+}
+} // namespace
+
+/**
+ * Custom constructor
+ * @param config weights of the adjustments
+ */
+TimeManager::TimeManager(const TimeConfig &config) : config(config)
+{
+}
+
+/**
+ * Budget a new move: an even share of the clock plus most of the increment, scaled by how much
+ * choice the root offers. Forced moves never get here (the search answers them at once)
+ * @param root position to move from
+ * @param clock the mover's clock
+ */
+void TimeManager::start(const Position &root, const GameClock &clock)
+{
+    const int movesToGo = clock.movesToGo > 0 ? std::min(clock.movesToGo, TIME_MOVES_TO_GO) : TIME_MOVES_TO_GO;
+    const int64_t usable = std::max<int64_t>(1, clock.remainingMs - this->config.overheadMs);
+    const int64_t base = usable / movesToGo + clock.incrementMs * 3 / 4;
+
+    MoveList moves;
+    generateMoves(root, moves);
+    double factor = 1.0;
+    if (moves.size() <= FEW_MOVES)
+    {
+        factor *= this->config.fewMovesFactor;
+    }
+    else if (moves.size() >= MANY_MOVES)
+    {
+        factor *= this->config.manyMovesFactor;
+    }
+    const bool capture = hasCaptures(root);
+    if (capture && moves.size() <= FEW_MOVES)
+    {
+        factor *= this->config.captureFactor;
+    }
+
+    const auto clockShare = static_cast<int64_t>(static_cast<double>(usable) * TIME_MAX_CLOCK_SHARE);
+    this->maximumMs = std::max<int64_t>(1, std::min(scaled(base, TIME_MAX_STRETCH), clockShare));
+    this->optimumMs = std::clamp<int64_t>(scaled(base, factor), 1, this->maximumMs);
+    this->lastBest = NULL_MOVE;
+    this->lastScore = 0;
+    this->stableIterations = 0;
+    this->decision = TimeDecision{0, 0, this->optimumMs, this->maximumMs, 0, 0, false};
+    spdlog::debug("time: clock {}+{} ms, {} moves{}: optimum {} ms, maximum {} ms", clock.remainingMs,
+                  clock.incrementMs, moves.size(), capture ? " (capture)" : "", this->optimumMs, this->maximumMs);
+}
+
+/**
+ * Judge a completed iteration. A best move that keeps changing or a score that jumps stretches the
+ * optimum (up to the maximum); a best move that stays put shrinks it
+ * @param depth iteration just completed
+ * @param bestMove its best move
+ * @param score its score
+ * @param elapsedMs since the search started
+ * @param iterationMs spent on this iteration alone
+ * @return TRUE to stop now rather than start the next iteration
+ */
+bool TimeManager::onIteration(const int depth, const Move bestMove, const int score, const int64_t elapsedMs,
+                              const int64_t iterationMs)
+{
+    const bool changed = bestMove != this->lastBest;
+    this->stableIterations = changed ? 1 : this->stableIterations + 1;
+    const int swing = this->lastBest == NULL_MOVE ? 0 : std::abs(score - this->lastScore);
+    this->lastBest = bestMove;
+    this->lastScore = score;
+
+    double factor = 1.0;
+    if (depth > 1 && changed)
+    {
+        factor *= this->config.changedFactor;
+    }
+    else if (this->stableIterations >= TIME_STABLE_ITERATIONS)
+    {
+        factor *= this->config.stableFactor;
+    }
+    if (swing > this->config.swingMargin)
+    {
+        factor *= this->config.swingFactor;
+    }
+    if (swing > 2 * this->config.swingMargin)
+    {
+        factor *= this->config.swingFactor;
+    }
+    const int64_t target = std::min(scaled(this->optimumMs, factor), this->maximumMs);
+    // the next iteration could not finish before the hard limit: it would only be thrown away
+    const bool hopeless = elapsedMs + scaled(iterationMs, NEXT_ITERATION_GROWTH) > this->maximumMs;
+    const bool stop = elapsedMs >= target || hopeless;
+    this->decision = TimeDecision{depth, elapsedMs, target, this->maximumMs, this->stableIterations, swing, stop};
+    spdlog::debug("time: depth {} after {} ms: stable {}, swing {} -> target {} ms{}", depth, elapsedMs,
+                  this->stableIterations, swing, target, stop ? (hopeless ? ", stop (next too long)" : ", stop") : "");
+    return stop;
+}
+
+/**
+ * Planned thinking time for the move, before any search feedback
+ */
+int64_t TimeManager::getOptimumMs() const
+{
+    return this->optimumMs;
+}
+
+/**
+ * Hard limit: the search is interrupted there, whatever it is doing
+ */
+int64_t TimeManager::getMaximumMs() const
+{
+    return this->maximumMs;
+}
+
+const TimeDecision &TimeManager::getLastDecision() const
+{
+    return this->decision;
+}
+
+} // namespace chk::engine
@@ -0,0 +1,80 @@
+// created 2026-10-18
+#pragma once
+
+#include "MoveGen.hpp"
+#include <cstdint>
+
+namespace chk::engine
+{
+constexpr int TIME_MOVES_TO_GO{30};          // an unknown remaining game length is taken as this many moves
+constexpr int64_t TIME_OVERHEAD_MS{30};      // kept back each move for the reply to reach the clock
+constexpr double TIME_MAX_STRETCH{4.0};      // hard limit: at most this many times the optimum...
+constexpr double TIME_MAX_CLOCK_SHARE{0.25}; // ...and at most this share of the clock
+constexpr int TIME_STABLE_ITERATIONS{4};     // same best move this many iterations in a row: stable
+
+/**
+ * Clock of the side to move. Zero remaining time means untimed
+ */
+struct GameClock
+{
+    int64_t remainingMs = 0;
+    int64_t incrementMs = 0; // added after each move
+    int movesToGo = 0;       // moves until the next time control (0 = sudden death)
+};
+
+/**
+ * Weights of the complexity adjustments (multipliers of the base share)
+ */
+struct TimeConfig
+{
+    int64_t overheadMs = TIME_OVERHEAD_MS;
+    double fewMovesFactor = 0.7;  // 2 or 3 legal moves: little to choose from
+    double manyMovesFactor = 1.2; // 10 or more legal moves
+    double captureFactor = 0.8;   // root capture is compulsory and there are few of them
+    double stableFactor = 0.6;    // best move unchanged for TIME_STABLE_ITERATIONS iterations
+    double changedFactor = 1.5;   // best move changed in the last iteration
+    int swingMargin = 30;         // score moved more than this between iterations: position is sharp
+    double swingFactor = 1.4;     // ...more than twice as much: squared
+};
+
+/**
+ * One allocation decision, for tuning: what the manager saw and what it made of it
+ */
+struct TimeDecision
+{
+    int depth = 0;         // 0 = the start-of-move budget
+    int64_t elapsedMs = 0;
+    int64_t targetMs = 0;  // stop after an iteration that ends past this
+    int64_t maximumMs = 0; // hard limit for the search
+    int stableIterations = 0;
+    int scoreSwing = 0;
+    bool stop = false;
+};
+
+/**
+ * Splits a game clock into a thinking time per move. At the start of a move it sets an optimum
+ * from the clock and the root (legal moves, compulsory captures) and a hard maximum. After each
+ * completed iteration it stretches or cuts the optimum by how settled the search looks (best
+ * move stability, score swings), and says whether to start another iteration.
+ */
+class TimeManager final
+{
+  public:
+    explicit TimeManager(const TimeConfig &config = TimeConfig{});
+    void start(const Position &root, const GameClock &clock);
+    bool onIteration(int depth, Move bestMove, int score, int64_t elapsedMs, int64_t iterationMs);
+    [[nodiscard]] int64_t getOptimumMs() const;
+    [[nodiscard]] int64_t getMaximumMs() const;
+    [[nodiscard]] const TimeDecision &getLastDecision() const;
+
+  private:
+    TimeConfig config;
+    int64_t optimumMs = 0; // expected thinking time for this move, from the clock and the root
+    int64_t maximumMs = 0;
+    Move lastBest = NULL_MOVE;
+    int lastScore = 0;
+    int stableIterations = 0;
+    TimeDecision decision{};
+};
+
+} // namespace chk::engine
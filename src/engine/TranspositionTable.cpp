@@ -0,0 +1,481 @@
+#include "TranspositionTable.hpp"
+#include "../utils/MappedFile.hpp"
+#include "Search.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <spdlog/spdlog.h>
+#include <vector>
+#include <zlib.h>
+
+namespace chk::engine
+{
+
+namespace
+{
+// data word: score 16 | depth 8 | bound 2 | generation 6 | from 5 | to 5 | captured fold 22
+constexpr int DEPTH_SHIFT{16};
+constexpr int BOUND_SHIFT{24};
+constexpr int GEN_SHIFT{26};
+constexpr int FROM_SHIFT{32};
+constexpr int TO_SHIFT{37};
+constexpr int FOLD_SHIFT{42};
+constexpr uint32_t FOLD_MASK{0x3FFFFF};
+constexpr uint8_t GEN_MASK{0x3F};
+constexpr size_t SAVE_CHUNK_BUCKETS{4096}; // 256 KiB per write
+
+uint32_t foldCaptured(const Bitboard captured)
+{
+    return (captured ^ (captured >> 22)) & FOLD_MASK;
+}
+
+int depthOf(const uint64_t data)
+{
+    return static_cast<int>((data >> DEPTH_SHIFT) & 0xFF);
+}
+
+uint8_t generationOf(const uint64_t data)
+{
+    return static_cast<uint8_t>((data >> GEN_SHIFT) & GEN_MASK);
+}
+
+/**
+ * Update a running CRC32 over a buffer of any size (zlib takes 32-bit lengths)
+ */
+uint32_t updateCrc(uLong crc, const uint8_t *bytes, size_t length)
+{
+    while (length > 0)
+    {
+        const auto step = static_cast<uInt>(std::min<size_t>(length, 1u << 30));
+        crc = crc32(crc, bytes, step);
+        bytes += step;
+        length -= step;
+    }
+    return static_cast<uint32_t>(crc);
+}
+
+template <typename T> T getRaw(const uint8_t *bytes, const size_t offset)
+{
+    T value{};
+    std::memcpy(&value, bytes + offset, sizeof(T));
+    return value;
+}
+
+template <typename T> void putRaw(uint8_t *bytes, const size_t offset, const T value)
+{
+    std::memcpy(bytes + offset, &value, sizeof(T));
+}
+} // namespace
+
+bool TtEntry::hasMove() const
+{
+    return this->from != this->to;
+}
+
+/**
+ * Is this the stored best move?
+ */
+bool TtEntry::matches(const Move &move) const
+{
+    return this->hasMove() && move.from == this->from && move.to == this->to &&
+           foldCaptured(move.captured) == this->capturedFold;
+}
+
+/**
+ * Mate and tablebase scores count plies from the root; in the table they must count from the node
+ * itself, since the same node can be reached at different plies
+ */
+int toTtScore(const int score, const int ply)
+{
+    if (score >= SCORE_TB_WIN - MAX_PLY)
+    {
+        return score + ply;
+    }
+    return score <= -(SCORE_TB_WIN - MAX_PLY) ? score - ply : score;
+}
+
+/**
+ * Inverse of toTtScore
+ */
+int fromTtScore(const int score, const int ply)
+{
+    if (score >= SCORE_TB_WIN - MAX_PLY)
+    {
+        return score - ply;
+    }
+    return score <= -(SCORE_TB_WIN - MAX_PLY) ? score + ply : score;
+}
+
+/**
+ * Custom constructor
+ * @param megabytes table size (rounded down to a power of 2 buckets)
+ * @param hugePages back the table with huge pages when the OS allows it
+ */
+TranspositionTable::TranspositionTable(const size_t megabytes, const bool hugePages) : hugePages(hugePages)
+{
+    this->resize(megabytes);
+}
+
+TranspositionTable::~TranspositionTable()
+{
+    this->waitForSave();
+}
+
+/**
+ * Reallocate the table (all entries are lost). NOT thread-safe: no search may be running
+ * @param megabytes new size, at least 1
+ */
+void TranspositionTable::resize(const size_t megabytes)
+{
+    this->waitForSave();
+    const size_t wanted = std::max<size_t>(megabytes, 1) * 1024 * 1024 / sizeof(Bucket);
+    size_t count = 1;
+    while (count * 2 <= wanted)
+    {
+        count *= 2;
+    }
+    this->buckets = nullptr;
+    this->numBuckets = 0;
+    while (!this->memory.allocate(count * sizeof(Bucket), this->hugePages) && count > 1)
+    {
+        count /= 2; // out of memory: settle for less
+    }
+    this->buckets = static_cast<Bucket *>(this->memory.data());
+    this->numBuckets = this->buckets != nullptr ? count : 0;
+    this->initialise(true);
+    this->generation = 0;
+}
+
+/**
+ * Erase all entries. NOT thread-safe: no search may be running
+ */
+void TranspositionTable::clear()
+{
+    this->waitForSave();
+    this->initialise(false);
+    this->generation = 0;
+}
+
+/**
+ * Mark the start of a new search: entries from earlier searches become preferred victims
+ */
+void TranspositionTable::newSearch()
+{
+    this->generation = static_cast<uint8_t>((this->generation + 1) & GEN_MASK);
+}
+
+/**
+ * Age of the newest entries (bumped by each newSearch, wraps around)
+ */
+uint8_t TranspositionTable::getGeneration() const
+{
+    return this->generation.load(std::memory_order_relaxed);
+}
+
+/**
+ * Look up a position
+ * @param key Zobrist hash of the position
+ * @param entry receives the entry, if found
+ * @return TRUE if found
+ */
+bool TranspositionTable::probe(const uint64_t key, TtEntry &entry) const
+{
+    const Bucket &bucket = this->bucketOf(key);
+    for (const Slot &slot : bucket.slots)
+    {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) != key || data == 0)
+        {
+            continue;
+        }
+        entry.score = static_cast<int16_t>(data & 0xFFFF);
+        entry.depth = depthOf(data);
+        entry.bound = static_cast<TtBound>((data >> BOUND_SHIFT) & 3);
+        entry.from = static_cast<uint8_t>((data >> FROM_SHIFT) & 31);
+        entry.to = static_cast<uint8_t>((data >> TO_SHIFT) & 31);
+        entry.capturedFold = static_cast<uint32_t>(data >> FOLD_SHIFT) & FOLD_MASK;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Save a search result
+ * @param key Zobrist hash of the position
+ * @param score already converted with toTtScore
+ * @param depth remaining depth of the search that produced it
+ * @param bound how score relates to the true score
+ * @param move best move found (NULL_MOVE if none)
+ */
+void TranspositionTable::store(const uint64_t key, const int score, const int depth, const TtBound bound,
+                               const Move &move)
+{
+    uint64_t data = static_cast<uint16_t>(static_cast<int16_t>(score));
+    data |= static_cast<uint64_t>(std::clamp(depth, 0, 255)) << DEPTH_SHIFT;
+    data |= static_cast<uint64_t>(bound) << BOUND_SHIFT;
+    data |= static_cast<uint64_t>(this->generation.load(std::memory_order_relaxed)) << GEN_SHIFT;
+    if (move != NULL_MOVE)
+    {
+        data |= static_cast<uint64_t>(move.from) << FROM_SHIFT;
+        data |= static_cast<uint64_t>(move.to) << TO_SHIFT;
+        data |= static_cast<uint64_t>(foldCaptured(move.captured)) << FOLD_SHIFT;
+    }
+    this->place(key, data);
+}
+
+/**
+ * Put raw entry into its bucket: same position, else an empty slot, else the shallowest / oldest one
+ */
+void TranspositionTable::place(const uint64_t key, uint64_t data)
+{
+    Bucket &bucket = this->bucketOf(key);
+    const uint8_t current = this->generation.load(std::memory_order_relaxed);
+    Slot *victim = &bucket.slots[0];
+    int worst = INT_MAX;
+    for (Slot &slot : bucket.slots)
+    {
+        const uint64_t old = slot.data.load(std::memory_order_relaxed);
+        if (old == 0)
+        {
+            victim = &slot;
+            break;
+        }
+        if ((slot.keyXorData.load(std::memory_order_relaxed) ^ old) == key)
+        {
+            constexpr uint64_t MOVE_BITS{~0ull << FROM_SHIFT};
+            if ((data & MOVE_BITS) == 0)
+            {
+                data |= old & MOVE_BITS; // keep the known best move
+            }
+            victim = &slot;
+            break;
+        }
+        const int age = (current - generationOf(old)) & GEN_MASK;
+        const int value = depthOf(old) - 8 * age;
+        if (value < worst)
+        {
+            worst = value;
+            victim = &slot;
+        }
+    }
+    victim->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
+}
+
+/**
+ * Permille of sampled slots holding an entry of the current search (as reported by UCI "hashfull")
+ */
+int TranspositionTable::hashfull() const
+{
+    const size_t sampled = std::min<size_t>(this->numBuckets, 250);
+    const uint8_t current = this->generation.load(std::memory_order_relaxed);
+    int used = 0;
+    for (size_t b = 0; b < sampled; b++)
+    {
+        for (const Slot &slot : this->buckets[b].slots)
+        {
+            const uint64_t data = slot.data.load(std::memory_order_relaxed);
+            used += data != 0 && generationOf(data) == current ? 1 : 0;
+        }
+    }
+    return static_cast<int>(used * 1000 / (sampled * TT_BUCKET_SLOTS));
+}
+
+size_t TranspositionTable::getSizeBytes() const
+{
+    return this->numBuckets * sizeof(Bucket);
+}
+
+PageKind TranspositionTable::getPageKind() const
+{
+    return this->memory.getKind();
+}
+
+/**
+ * Write the table to disk. Searches may keep running meanwhile: each slot is copied atomically, so the
+ * file may mix old and new entries, but never contains a torn one. Written to "<path>.tmp" first, then
+ * renamed, so an interrupted save never destroys the previous file
+ * @param path destination
+ * @return TRUE if successful, else FALSE
+ */
+bool TranspositionTable::save(const std::string &path) const
+{
+    const std::string tmpPath = path + ".tmp";
+    std::ofstream out{tmpPath, std::ios::binary | std::ios::trunc};
+    uint8_t header[TT_FILE_HEADER_SIZE]{};
+    out.write(reinterpret_cast<const char *>(header), TT_FILE_HEADER_SIZE); // filled in at the end
+
+    std::vector<uint64_t> chunk(SAVE_CHUNK_BUCKETS * TT_BUCKET_SLOTS * 2);
+    uLong crc = crc32(0, nullptr, 0);
+    for (size_t first = 0; first < this->numBuckets && out; first += SAVE_CHUNK_BUCKETS)
+    {
+        const size_t count = std::min(SAVE_CHUNK_BUCKETS, this->numBuckets - first);
+        size_t word = 0;
+        for (size_t b = first; b < first + count; b++)
+        {
+            for (const Slot &slot : this->buckets[b].slots)
+            {
+                const uint64_t data = slot.data.load(std::memory_order_relaxed);
+                const uint64_t keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+                chunk[word++] = keyXorData;
+                chunk[word++] = data;
+            }
+        }
+        const auto *bytes = reinterpret_cast<const uint8_t *>(chunk.data());
+        crc = updateCrc(crc, bytes, word * sizeof(uint64_t));
+        out.write(reinterpret_cast<const char *>(bytes), static_cast<std::streamsize>(word * sizeof(uint64_t)));
+    }
+
+    putRaw<uint32_t>(header, 0, TT_FILE_MAGIC);
+    putRaw<uint16_t>(header, 4, TT_FILE_VERSION);
+    putRaw<uint16_t>(header, 6, TT_BUCKET_SLOTS);
+    putRaw<uint64_t>(header, 8, this->numBuckets);
+    putRaw<uint8_t>(header, 16, this->generation.load(std::memory_order_relaxed));
+    putRaw<uint32_t>(header, 20, static_cast<uint32_t>(crc));
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(header), TT_FILE_HEADER_SIZE);
+    out.close();
+    std::error_code error;
+    if (!out || (std::filesystem::rename(tmpPath, path, error), error))
+    {
+        spdlog::error("cannot save transposition table to {}", path);
+        std::filesystem::remove(tmpPath, error);
+        return false;
+    }
+    spdlog::info("transposition table saved to {} ({} MB)", path, this->getSizeBytes() >> 20);
+    return true;
+}
+
+/**
+ * Start save() on a background thread (waits for any earlier save first). See waitForSave()
+ * @param path destination
+ */
+void TranspositionTable::saveInBackground(const std::string &path)
+{
+    this->waitForSave();
+    this->saver = std::thread([this, path] { this->saveOk = this->save(path); });
+}
+
+/**
+ * Wait for the background save, if any
+ * @return result of the last background save (FALSE if none was made)
+ */
+bool TranspositionTable::waitForSave()
+{
+    if (this->saver.joinable())
+    {
+        this->saver.join();
+    }
+    return this->saveOk;
+}
+
+/**
+ * Replace the contents with a file written by save(). The file is mapped and checked (size, version,
+ * CRC) before anything is copied; a table of another size is rehashed entry by entry.
+ * NOT thread-safe: no search may be running
+ * @param path location of the file
+ * @return TRUE if loaded, FALSE if missing or invalid (table is then left untouched)
+ */
+bool TranspositionTable::load(const std::string &path)
+{
+    this->waitForSave();
+    chk::MappedFile file;
+    if (!file.open(path) || file.size() < TT_FILE_HEADER_SIZE)
+    {
+        spdlog::error("cannot load transposition table from {}", path);
+        return false;
+    }
+    const uint8_t *bytes = file.data();
+    const auto fileBuckets = getRaw<uint64_t>(bytes, 8);
+    const size_t payloadSize = file.size() - TT_FILE_HEADER_SIZE;
+    if (getRaw<uint32_t>(bytes, 0) != TT_FILE_MAGIC || getRaw<uint16_t>(bytes, 4) != TT_FILE_VERSION ||
+        getRaw<uint16_t>(bytes, 6) != TT_BUCKET_SLOTS || fileBuckets == 0 ||
+        payloadSize != fileBuckets * sizeof(Bucket))
+    {
+        spdlog::error("{} is not a valid transposition table file", path);
+        return false;
+    }
+    const uint8_t *payload = bytes + TT_FILE_HEADER_SIZE;
+    if (updateCrc(crc32(0, nullptr, 0), payload, payloadSize) != getRaw<uint32_t>(bytes, 20))
+    {
+        spdlog::error("transposition table file {} is corrupt (CRC mismatch)", path);
+        return false;
+    }
+
+    const auto wordAt = [payload](const size_t idx) { return getRaw<uint64_t>(payload, idx * sizeof(uint64_t)); };
+    const size_t numSlots = fileBuckets * TT_BUCKET_SLOTS;
+    if (fileBuckets == this->numBuckets)
+    {
+        for (size_t s = 0; s < numSlots; s++)
+        {
+            Slot &slot = this->buckets[s / TT_BUCKET_SLOTS].slots[s % TT_BUCKET_SLOTS];
+            slot.keyXorData.store(wordAt(2 * s), std::memory_order_relaxed);
+            slot.data.store(wordAt(2 * s + 1), std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        this->clear();
+        for (size_t s = 0; s < numSlots; s++)
+        {
+            const uint64_t data = wordAt(2 * s + 1);
+            if (data != 0)
+            {
+                this->place(wordAt(2 * s) ^ data, data);
+            }
+        }
+    }
+    this->generation = getRaw<uint8_t>(bytes, 16) & GEN_MASK;
+    spdlog::info("transposition table loaded from {} ({} MB)", path, payloadSize >> 20);
+    return true;
+}
+
+/**
+ * Construct (fresh memory) or empty every bucket, split across threads. On fresh memory this is the
+ * first touch of each page, so on NUMA machines the table ends up spread over the nodes of the threads
+ * instead of all on the node of the thread that allocated it
+ * @param construct TRUE for fresh memory, FALSE to erase live buckets
+ */
+void TranspositionTable::initialise(const bool construct)
+{
+    constexpr size_t BYTES_PER_THREAD{32 * 1024 * 1024}; // smaller tables are not worth a thread
+    const size_t numThreads = std::clamp<size_t>(this->getSizeBytes() / BYTES_PER_THREAD, 1,
+                                                 std::max(1u, std::thread::hardware_concurrency()));
+    const size_t chunk = (this->numBuckets + numThreads - 1) / numThreads;
+    auto work = [this, chunk, construct](const size_t t) {
+        const size_t end = std::min(this->numBuckets, (t + 1) * chunk);
+        for (size_t b = t * chunk; b < end; b++)
+        {
+            if (construct)
+            {
+                new (&this->buckets[b]) Bucket{};
+                continue;
+            }
+            for (Slot &slot : this->buckets[b].slots)
+            {
+                slot.keyXorData.store(0, std::memory_order_relaxed);
+                slot.data.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+    std::vector<std::thread> helpers;
+    for (size_t t = 1; t < numThreads; t++)
+    {
+        helpers.emplace_back(work, t);
+    }
+    work(0);
+    for (std::thread &helper : helpers)
+    {
+        helper.join();
+    }
+}
+
+TranspositionTable::Bucket &TranspositionTable::bucketOf(const uint64_t key) const
+{
+    return this->buckets[key & (this->numBuckets - 1)];
+}
+
+} // namespace chk::engine
@@ -0,0 +1,104 @@
+// created 2026-10-18
+#pragma once
+
+#include "LargePages.hpp"
+#include "MoveGen.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace chk::engine
+{
+constexpr uint32_t TT_FILE_MAGIC{0x54544353}; // "SCTT" in little-endian
+constexpr uint16_t TT_FILE_VERSION{1};
+constexpr size_t TT_FILE_HEADER_SIZE{64};
+constexpr int TT_BUCKET_SLOTS{4}; // one bucket fills a 64-byte cache line
+
+/**
+ * How the stored score relates to the true score
+ */
+enum class TtBound : uint8_t
+{
+    NONE = 0,
+    UPPER, // failed low: true score <= stored
+    LOWER, // failed high: true score >= stored
+    EXACT,
+};
+
+/**
+ * Decoded table entry
+ */
+struct TtEntry
+{
+    int score = 0; // mate / tablebase scores are relative to this node (see toTtScore)
+    int depth = 0;
+    TtBound bound = TtBound::NONE;
+    uint8_t from = 0; // best move, if any (from == to means none)
+    uint8_t to = 0;
+    uint32_t capturedFold = 0; // 22-bit fold of the captured set: tells apart chains with same from & to
+
+    [[nodiscard]] bool hasMove() const;
+    [[nodiscard]] bool matches(const Move &move) const;
+};
+
+[[nodiscard]] int toTtScore(int score, int ply);
+[[nodiscard]] int fromTtScore(int score, int ply);
+
+/**
+ * Shared transposition table. Lockless: each slot stores (key ^ data, data), so a slot torn by two
+ * concurrent writers simply fails the key check. Any number of searchers may probe and store at once.
+ *
+ * Large tables sit on huge pages when available (fewer TLB misses on random probes), and are first
+ * touched by several threads so NUMA machines spread them across nodes.
+ *
+ * The table can be saved to a versioned binary file (optionally on a background thread) and loaded
+ * back with one mapping of the file, validated by size, version and CRC32.
+ */
+class TranspositionTable final
+{
+  public:
+    explicit TranspositionTable(size_t megabytes = 16, bool hugePages = true);
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
+    void resize(size_t megabytes);
+    void clear();
+    void newSearch();
+    [[nodiscard]] uint8_t getGeneration() const;
+    [[nodiscard]] bool probe(uint64_t key, TtEntry &entry) const;
+    void store(uint64_t key, int score, int depth, TtBound bound, const Move &move);
+    [[nodiscard]] int hashfull() const;
+    [[nodiscard]] size_t getSizeBytes() const;
+    [[nodiscard]] PageKind getPageKind() const;
+    [[nodiscard]] bool save(const std::string &path) const;
+    void saveInBackground(const std::string &path);
+    bool waitForSave();
+    [[nodiscard]] bool load(const std::string &path);
+
+  private:
+    struct Slot
+    {
+        std::atomic<uint64_t> keyXorData{0};
+        std::atomic<uint64_t> data{0};
+    };
+    struct alignas(64) Bucket
+    {
+        Slot slots[TT_BUCKET_SLOTS];
+    };
+
+    bool hugePages;
+    LargeBuffer memory;         // buckets live here, zero-filled by the OS
+    Bucket *buckets = nullptr;
+    size_t numBuckets = 0;              // power of 2
+    std::atomic<uint8_t> generation{0}; // bumped per search (6 bits used): stale entries go first
+    std::thread saver;
+    std::atomic_bool saveOk{false};
+
+    [[nodiscard]] Bucket &bucketOf(uint64_t key) const;
+    void place(uint64_t key, uint64_t data);
+    void initialise(bool construct);
+};
+
+} // namespace chk::engine
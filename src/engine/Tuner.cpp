@@ -0,0 +1,325 @@
+#include "Tuner.hpp"
+#include "../utils/MappedFile.hpp"
+#include "Endgame.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+namespace chk::engine
+{
+
+namespace
+{
+constexpr double LN10{2.302585092994046};
+constexpr double ADAM_BETA1{0.9};
+constexpr double ADAM_BETA2{0.999};
+constexpr double ADAM_EPSILON{1e-8};
+
+/**
+ * Per-thread partial sums, padded so threads never write to the same cache line
+ */
+struct alignas(64) Partial
+{
+    std::array<double, NUM_EVAL_TERMS> gradient{};
+    double error = 0.0;
+};
+
+uint32_t readU32(const uint8_t *bytes)
+{
+    return uint32_t{bytes[0]} | uint32_t{bytes[1]} << 8 | uint32_t{bytes[2]} << 16 | uint32_t{bytes[3]} << 24;
+}
+
+void writeU32(uint8_t *bytes, const uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+float resultForRed(const GameResult result)
+{
+    switch (result)
+    {
+    case GameResult::RED_WIN:
+        return 1.0f;
+    case GameResult::BLACK_WIN:
+        return 0.0f;
+    default:
+        return 0.5f;
+    }
+}
+} // namespace
+
+/**
+ * Save labelled positions in the compact binary format (13 bytes each)
+ * @param path destination (overwritten)
+ * @param samples the samples
+ * @return TRUE if successful, else FALSE
+ */
+bool writeSamples(const std::string &path, const std::vector<TuningSample> &samples)
+{
+    std::vector<uint8_t> bytes(SAMPLES_HEADER_SIZE + samples.size() * SAMPLE_RECORD_SIZE, 0);
+    writeU32(bytes.data(), SAMPLES_MAGIC);
+    bytes[4] = static_cast<uint8_t>(SAMPLES_VERSION & 0xFF);
+    bytes[5] = static_cast<uint8_t>(SAMPLES_VERSION >> 8);
+    uint8_t *record = bytes.data() + SAMPLES_HEADER_SIZE;
+    for (const TuningSample &sample : samples)
+    {
+        writeU32(record, sample.pos.red);
+        writeU32(record + 4, sample.pos.black);
+        writeU32(record + 8, sample.pos.kings);
+        record[12] = static_cast<uint8_t>(static_cast<uint8_t>(sample.pos.sideToMove) |
+                                          static_cast<uint8_t>(sample.result) << 1);
+        record += SAMPLE_RECORD_SIZE;
+    }
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(out);
+}
+
+/**
+ * Load a samples file written by writeSamples. The file is memory-mapped, not read into a buffer
+ * @param path location of samples file
+ * @return the samples, or std::nullopt if file is missing or invalid
+ */
+std::optional<std::vector<TuningSample>> readSamples(const std::string &path)
+{
+    chk::MappedFile file;
+    if (!file.open(path) || file.size() < SAMPLES_HEADER_SIZE ||
+        (file.size() - SAMPLES_HEADER_SIZE) % SAMPLE_RECORD_SIZE != 0)
+    {
+        spdlog::error("cannot read tuning samples from {}", path);
+        return std::nullopt;
+    }
+    const uint8_t *data = file.data();
+    const uint16_t version = static_cast<uint16_t>(data[4] | data[5] << 8);
+    if (readU32(data) != SAMPLES_MAGIC || version != SAMPLES_VERSION)
+    {
+        spdlog::error("{} is not a tuning samples file", path);
+        return std::nullopt;
+    }
+    const size_t count = (file.size() - SAMPLES_HEADER_SIZE) / SAMPLE_RECORD_SIZE;
+    std::vector<TuningSample> samples(count);
+    const uint8_t *record = data + SAMPLES_HEADER_SIZE;
+    for (TuningSample &sample : samples)
+    {
+        sample.pos.red = readU32(record);
+        sample.pos.black = readU32(record + 4);
+        sample.pos.kings = readU32(record + 8);
+        sample.pos.sideToMove = (record[12] & 1) != 0 ? Side::BLACK : Side::RED;
+        sample.result = static_cast<GameResult>((record[12] >> 1) & 3);
+        record += SAMPLE_RECORD_SIZE;
+    }
+    return samples;
+}
+
+/**
+ * Custom constructor. Extracts the evaluation features of every sample. Unfinished games are skipped,
+ * and so are known endings: evaluate() refines those (see Endgame.hpp), so they do not fit the linear model
+ * @param samples labelled positions
+ * @param config optimiser settings
+ */
+EvalTuner::EvalTuner(const std::vector<TuningSample> &samples, const TunerConfig &config) : config(config)
+{
+    if (this->config.numThreads <= 0)
+    {
+        this->config.numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    this->rows.reserve(samples.size());
+    for (const TuningSample &sample : samples)
+    {
+        if (sample.result != GameResult::UNKNOWN && endgameKind(sample.pos) == EndgameKind::NONE)
+        {
+            this->rows.push_back(Row{extractFeatures(sample.pos), resultForRed(sample.result)});
+        }
+    }
+    this->scale = this->config.scaleK > 0.0 ? this->config.scaleK : 1.0;
+}
+
+/**
+ * Choose the sigmoid scale K that best predicts the results with these weights (ternary search on log K)
+ * @return the fitted K, also used by later calls
+ */
+double EvalTuner::fitScale(const EvalWeights &weights)
+{
+    Vector w{};
+    std::copy(weights.values.begin(), weights.values.end(), w.begin());
+    double lo = std::log(0.01);
+    double hi = std::log(100.0);
+    for (int step = 0; step < 40; step++)
+    {
+        const double m1 = lo + (hi - lo) / 3.0;
+        const double m2 = hi - (hi - lo) / 3.0;
+        if (this->evaluateBatch(w, std::exp(m1), nullptr) < this->evaluateBatch(w, std::exp(m2), nullptr))
+        {
+            hi = m2;
+        }
+        else
+        {
+            lo = m1;
+        }
+    }
+    this->scale = std::exp((lo + hi) / 2.0);
+    return this->scale;
+}
+
+/**
+ * Mean squared error of the predicted results, with the current scale
+ */
+double EvalTuner::meanError(const EvalWeights &weights) const
+{
+    Vector w{};
+    std::copy(weights.values.begin(), weights.values.end(), w.begin());
+    return this->evaluateBatch(w, this->scale, nullptr);
+}
+
+double EvalTuner::getScale() const
+{
+    return this->scale;
+}
+
+/**
+ * Optimise the weights with full-batch Adam. Adam can overshoot, so the weights with the lowest
+ * error seen (the start and every epoch's step included) are kept, not simply the last ones
+ * @param start initial weights (frozen terms keep their value)
+ * @param onEpoch optional progress callback, called after every epoch
+ * @return best weights found, rounded to integers
+ */
+EvalWeights EvalTuner::run(const EvalWeights &start, const EpochCallback &onEpoch)
+{
+    if (this->config.scaleK <= 0.0)
+    {
+        this->fitScale(start);
+    }
+    Vector weights{};
+    std::copy(start.values.begin(), start.values.end(), weights.begin());
+    Vector firstMoment{};
+    Vector secondMoment{};
+    Vector best = weights;
+    double bestError = std::numeric_limits<double>::infinity();
+    for (int epoch = 1; epoch <= this->config.epochs; epoch++)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        Vector gradient{};
+        const double error = this->evaluateBatch(weights, this->scale, &gradient);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (error < bestError)
+        {
+            bestError = error;
+            best = weights;
+        }
+
+        for (int term = 0; term < NUM_EVAL_TERMS; term++)
+        {
+            if (term == TERM_MAN && this->config.freezeManValue)
+            {
+                continue;
+            }
+            firstMoment[term] = ADAM_BETA1 * firstMoment[term] + (1.0 - ADAM_BETA1) * gradient[term];
+            secondMoment[term] = ADAM_BETA2 * secondMoment[term] + (1.0 - ADAM_BETA2) * gradient[term] * gradient[term];
+            const double mHat = firstMoment[term] / (1.0 - std::pow(ADAM_BETA1, epoch));
+            const double vHat = secondMoment[term] / (1.0 - std::pow(ADAM_BETA2, epoch));
+            weights[term] -= this->config.learningRate * mHat / (std::sqrt(vHat) + ADAM_EPSILON);
+        }
+        if (onEpoch)
+        {
+            TunerEpoch report{epoch, error, seconds > 0.0 ? this->rows.size() / seconds : 0.0, EvalWeights{}};
+            std::transform(weights.begin(), weights.end(), report.weights.values.begin(),
+                           [](const double w) { return static_cast<int32_t>(std::lround(w)); });
+            onEpoch(report);
+        }
+    }
+    if (this->config.epochs > 0 && this->evaluateBatch(weights, this->scale, nullptr) < bestError)
+    {
+        best = weights; // the last step was the best one
+    }
+    EvalWeights result;
+    std::transform(best.begin(), best.end(), result.values.begin(),
+                   [](const double w) { return static_cast<int32_t>(std::lround(w)); });
+    return result;
+}
+
+/**
+ * One parallel pass over all samples
+ * @param weights current (real-valued) weights
+ * @param scaleK sigmoid scale
+ * @param gradient if not null, receives d(error)/d(weight)
+ * @return mean squared error
+ */
+double EvalTuner::evaluateBatch(const Vector &weights, const double scaleK, Vector *gradient) const
+{
+    if (this->rows.empty())
+    {
+        return 0.0;
+    }
+    const size_t numThreads = std::min<size_t>(this->config.numThreads, this->rows.size());
+    std::vector<Partial> partials(numThreads);
+    const size_t chunk = (this->rows.size() + numThreads - 1) / numThreads;
+    const double slope = LN10 * scaleK / 400.0; // d(sigmoid)/d(eval) = slope * p * (1 - p)
+
+    auto work = [&](const size_t t) {
+        Partial &partial = partials[t];
+        const size_t begin = t * chunk;
+        const size_t end = std::min(begin + chunk, this->rows.size());
+        for (size_t i = begin; i < end; i++)
+        {
+            const Row &row = this->rows[i];
+            double eval = 0.0;
+            for (int term = 0; term < NUM_EVAL_TERMS; term++)
+            {
+                eval += weights[term] * row.features[term];
+            }
+            const double predicted = 1.0 / (1.0 + std::exp(-slope * eval));
+            const double diff = row.target - predicted;
+            partial.error += diff * diff;
+            if (gradient != nullptr)
+            {
+                const double factor = -2.0 * diff * slope * predicted * (1.0 - predicted);
+                for (int term = 0; term < NUM_EVAL_TERMS; term++)
+                {
+                    partial.gradient[term] += factor * row.features[term];
+                }
+            }
+        }
+    };
+    std::vector<std::thread> helpers;
+    for (size_t t = 1; t < numThreads; t++)
+    {
+        helpers.emplace_back(work, t);
+    }
+    work(0);
+    for (std::thread &helper : helpers)
+    {
+        helper.join();
+    }
+
+    double error = 0.0;
+    for (const Partial &partial : partials)
+    {
+        error += partial.error;
+        if (gradient != nullptr)
+        {
+            for (int term = 0; term < NUM_EVAL_TERMS; term++)
+            {
+                (*gradient)[term] += partial.gradient[term];
+            }
+        }
+    }
+    const auto n = static_cast<double>(this->rows.size());
+    if (gradient != nullptr)
+    {
+        for (double &value : *gradient)
+        {
+            value /= n;
+        }
+    }
+    return error / n;
+}
+
+} // namespace chk::engine
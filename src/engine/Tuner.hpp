@@ -0,0 +1,88 @@
+// created 2026-10-18
+#pragma once
+
+#include "Evaluation.hpp"
+#include "Position.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace chk::engine
+{
+constexpr uint32_t SAMPLES_MAGIC{0x53544353}; // "SCTS" in little-endian
+constexpr uint16_t SAMPLES_VERSION{1};
+constexpr size_t SAMPLES_HEADER_SIZE{8};      // magic, version, reserved
+constexpr size_t SAMPLE_RECORD_SIZE{13};      // red, black, kings (u32 each), side to move | result << 1
+
+/**
+ * A position labelled with the result of the game it was taken from
+ */
+struct TuningSample
+{
+    Position pos{};
+    GameResult result = GameResult::DRAW;
+};
+
+/**
+ * Tunable optimiser behaviour
+ */
+struct TunerConfig
+{
+    int numThreads = 0;           // 0 = all cores
+    int epochs = 200;             // full passes over the samples
+    double learningRate = 0.5;    // Adam step size, in centi-men
+    double scaleK = 0.0;          // sigmoid scale; 0 = fit it to the starting weights first
+    bool freezeManValue = true;   // keep TERM_MAN fixed, so scores stay in centi-men
+};
+
+/**
+ * Progress after one epoch
+ */
+struct TunerEpoch
+{
+    int epoch = 0;
+    double error = 0.0;        // mean squared error of the predicted result, before this epoch's step
+    double samplesPerSec = 0.0;
+    EvalWeights weights{};     // rounded weights after this epoch's step
+};
+
+[[nodiscard]] bool writeSamples(const std::string &path, const std::vector<TuningSample> &samples);
+[[nodiscard]] std::optional<std::vector<TuningSample>> readSamples(const std::string &path);
+
+/**
+ * Texel-style tuning of the hand-written evaluation: the predicted result of a sample is
+ * sigmoid(K * eval / 400), and the mean squared error against the real result is minimised
+ * with Adam. Outside known endings the evaluation is linear in its weights, so features are
+ * extracted once, and each epoch is a parallel pass with one gradient accumulator per thread.
+ * Positions that evaluate() hands to an endgame evaluator (Endgame.hpp) are not used for tuning.
+ */
+class EvalTuner final
+{
+  public:
+    using EpochCallback = std::function<void(const TunerEpoch &)>;
+
+    EvalTuner(const std::vector<TuningSample> &samples, const TunerConfig &config = TunerConfig{});
+    double fitScale(const EvalWeights &weights);
+    [[nodiscard]] double meanError(const EvalWeights &weights) const;
+    [[nodiscard]] double getScale() const;
+    EvalWeights run(const EvalWeights &start, const EpochCallback &onEpoch = nullptr);
+
+  private:
+    struct Row
+    {
+        EvalFeatures features; // RED minus BLACK
+        float target;          // result for RED: 1, 0.5 or 0
+    };
+    using Vector = std::array<double, NUM_EVAL_TERMS>;
+
+    TunerConfig config;
+    std::vector<Row> rows;
+    double scale = 1.0;
+
+    double evaluateBatch(const Vector &weights, double scaleK, Vector *gradient) const;
+};
+
+} // namespace chk::engine
@@ -0,0 +1,74 @@
+// created 2026-10-18
+#pragma once
+
+#include "Position.hpp"
+#include <array>
+#include <cstdint>
+
+namespace chk::engine
+{
+/**
+ * Zobrist hashing. The keys are generated at COMPILE TIME from a fixed seed, so hashes are
+ * identical across builds and platforms, and may be stored in files (opening book, etc.)
+ */
+namespace zobrist
+{
+enum PieceKind : uint8_t
+{
+    RED_MAN = 0,
+    RED_KING,
+    BLACK_MAN,
+    BLACK_KING,
+};
+
+/**
+ * splitmix64 step: good enough to fill the tables with well-spread bits
+ */
+constexpr uint64_t splitMix64(uint64_t &state)
+{
+    state += 0x9E3779B97F4A7C15ull;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+constexpr std::array<std::array<uint64_t, NUM_SQUARES>, 4> buildPieceKeys()
+{
+    uint64_t state = 0x5350414345434B53ull; // "SPACECKS"
+    std::array<std::array<uint64_t, NUM_SQUARES>, 4> keys{};
+    for (auto &kind : keys)
+    {
+        for (auto &key : kind)
+        {
+            key = splitMix64(state);
+        }
+    }
+    return keys;
+}
+
+constexpr auto PIECE_KEYS = buildPieceKeys();
+constexpr uint64_t BLACK_TO_MOVE{0xA3B1957C3E2D4F61ull};
+
+} // namespace zobrist
+
+/**
+ * Compute hash of this position from scratch
+ */
+inline uint64_t hashPosition(const Position &pos)
+{
+    uint64_t hash = pos.sideToMove == Side::BLACK ? zobrist::BLACK_TO_MOVE : 0;
+    const Bitboard groups[4] = {pos.red & ~pos.kings, pos.red & pos.kings, pos.black & ~pos.kings,
+                                pos.black & pos.kings};
+    for (int kind = 0; kind < 4; kind++)
+    {
+        Bitboard bb = groups[kind];
+        while (bb != 0)
+        {
+            hash ^= zobrist::PIECE_KEYS[kind][popLowest(bb)];
+        }
+    }
+    return hash;
+}
+
+} // namespace chk::engine
@@ -1,20 +1,60 @@
 ﻿#include "CircularBuffer.hpp"
 #include "StartMenu.hpp"
+#include "engine/EngineProcess.hpp"
+#include "engine/Evaluation.hpp"
 #include "managers/LocalGameManager.hpp"
 #include "managers/OnlineGameManager.hpp"
 #include "utils/ResourcePath.hpp"
 
 #include <SFML/Graphics.hpp>
 #include <cassert>
+#include <cstdlib>
+#include <filesystem>
 #include <google/protobuf/stubs/common.h>
+#include <string_view>
 #include <vector>
 
 #include "imgui-SFML.h"
 #include "imgui.h"
 
-int main()
+int main(int argc, char *argv[])
 {
     GOOGLE_PROTOBUF_VERIFY_VERSION;
+    // tuned evaluation weights (from spacecheckers-tune) are optional; else built-in defaults are used
+    const auto weightsPath = chk::getResourcePath(chk::engine::EVAL_WEIGHTS_FILE);
+    if (std::filesystem::exists(weightsPath))
+    {
+        if (const auto weights = chk::engine::loadEvalWeights(weightsPath))
+        {
+            chk::engine::setEvalWeights(weights.value());
+        }
+    }
+    // started by EngineProcess as the computer opponent's engine: serve it, no window
+    if (argc == 3 && std::string_view{argv[1]} == chk::engine::ENGINE_CHANNEL_FLAG)
+    {
+        return chk::engine::serveEngineChannel(argv[2]);
+    }
+    // headless bot: spacecheckers --bot ws://HOST:PORT/game [--level N] [--games N] (no window, no ImGui)
+    if (argc >= 3 && std::string_view{argv[1]} == "--bot")
+    {
+        int level = chk::AUTOPILOT_DEFAULT_LEVEL;
+        int matches = 0; // forever
+        for (int i = 3; i + 1 < argc; i += 2)
+        {
+            const std::string_view option{argv[i]};
+            if (option == "--level")
+            {
+                level = std::atoi(argv[i + 1]);
+            }
+            else if (option == "--games")
+            {
+                matches = std::atoi(argv[i + 1]);
+            }
+        }
+        const int code = chk::runBotMatches(argv[2], level, matches);
+        google::protobuf::ShutdownProtobufLibrary();
+        return code;
+    }
     auto window = sf::RenderWindow{sf::VideoMode{600, 700}, "SpaceCheckers", sf::Style::Titlebar | sf::Style::Close};
     window.setFramerateLimit(60);
     (void)ImGui::SFML::Init(window, false);
@@ -3,13 +3,17 @@
 // Created by Davis on 2023/12/21.
 //
 #include "../GameManager.hpp"
+#include "../engine/MoveGen.hpp"
+#include "imgui.h"
+#include <filesystem>
+#include <fstream>
 
 namespace chk
 {
 
 GameManager::GameManager(sf::RenderWindow *windowPtr) : window(windowPtr)
 {
-    assert(window && "GameManager requires a valid RenderWindow");
+    // nullptr only for headless managers (bot mode): drawBoard and handleEvents are never called then
     this->sourceCell = std::nullopt;
     this->blockList.reserve(chk::NUM_COLS * chk::NUM_COLS);
     // CREATE TWO unique PLAYERS
@@ -17,6 +21,22 @@ GameManager::GameManager(sf::RenderWindow *windowPtr) : window(windowPtr)
     this->playerBlack = std::make_unique<chk::Player>(chk::PlayerType::PLAYER_BLACK);
 }
 
+/**
+ * Keep what the hint engine learnt this session: its table is written to `HINT_HASH_FILE`
+ */
+GameManager::~GameManager()
+{
+    if (this->hintSearch == nullptr)
+    {
+        return;
+    }
+    this->hintSearch->stop(); // the table must not change while it is written
+    if (!this->hintTable->save(chk::HINT_HASH_FILE))
+    {
+        spdlog::warn("cannot save hint table to {}", chk::HINT_HASH_FILE);
+    }
+}
+
 /**
  * Get hashmap of hunter pieceID's to the assigned CaptureTarget
  * @return )pair of forced captures
@@ -224,6 +244,7 @@ void chk::GameManager::doCleanup()
     this->gameOver = true;
     this->alreadyCached = false;
     this->sourceCell = std::nullopt;
+    this->clearHint();
 }
 
 /**
@@ -406,6 +427,294 @@ bool GameManager::isGameOver() const
     return this->gameOver;
 }
 
+/**
+ * Snapshot of the board for the engine. Only valid between turns (not halfway through a capture chain)
+ * @param sideToMove the player whose turn it is
+ * @return engine position (engine square = cell index - 1)
+ */
+chk::engine::Position GameManager::toEnginePosition(const chk::PlayerType sideToMove) const
+{
+    chk::engine::Position pos{0, 0, 0, chk::engine::Side::RED};
+    for (const auto &[cellIdx, pieceId] : this->gameMap)
+    {
+        const chk::engine::Bitboard bit = chk::engine::bitOf(chk::engine::toSquare(cellIdx));
+        const chk::PlayerPtr &owner = this->playerRed->hasThisPiece(pieceId) ? this->playerRed : this->playerBlack;
+        if (!owner->hasThisPiece(pieceId))
+        {
+            continue; // stale entry
+        }
+        (owner == this->playerRed ? pos.red : pos.black) |= bit;
+        if (owner->getOwnPieces().at(pieceId)->getIsKing())
+        {
+            pos.kings |= bit;
+        }
+    }
+    pos.sideToMove = sideToMove == chk::PlayerType::PLAYER_RED ? chk::engine::Side::RED : chk::engine::Side::BLACK;
+    return pos;
+}
+
+/**
+ * Play an engine move on the board, as if its player tapped the piece and then each landing cell
+ * @param side the player making the move
+ * @param pos position before the move
+ * @param move a legal move in `pos`
+ */
+void GameManager::playEngineMove(const chk::PlayerType side, const chk::engine::Position &pos,
+                                 const chk::engine::Move &move)
+{
+    const auto &hunter = side == chk::PlayerType::PLAYER_RED ? this->playerRed : this->playerBlack;
+    const auto &prey = side == chk::PlayerType::PLAYER_RED ? this->playerBlack : this->playerRed;
+    const auto tap = [this, &hunter, &prey](chk::CircularBuffer<int32_t> &buffer, const int cellIdx) {
+        const auto cell = std::find_if(this->blockList.begin(), this->blockList.end(),
+                                       [cellIdx](const chk::Block &block) { return block->getIndex() == cellIdx; });
+        if (cell != this->blockList.end())
+        {
+            this->handleCellTap(hunter, prey, buffer, *cell);
+        }
+    };
+    chk::CircularBuffer<int32_t> buffer{1};
+    int current = chk::engine::toCellIndex(move.from);
+    for (const int square : chk::engine::expandPath(pos, move))
+    {
+        tap(buffer, current); // pick up the piece (again, after each jump)
+        current = chk::engine::toCellIndex(square);
+        tap(buffer, current);
+    }
+    spdlog::info("computer played {}", chk::engine::toNotation(pos, move));
+}
+
+/**
+ * Ask the engine for a hint on the current position. Search runs on a background thread
+ * (never blocks the render loop) and stops after `hintBudgetMs`. With `hintLines` above 1, the
+ * engine ranks that many best moves (multi-PV). The first hint loads the table saved by the previous session
+ * @param sideToMove the player whose turn it is
+ */
+void GameManager::requestHint(const chk::PlayerType sideToMove)
+{
+    if (this->gameOver)
+    {
+        return;
+    }
+    const auto pos = this->toEnginePosition(sideToMove);
+    this->hintPos = pos;
+    chk::engine::MoveList moves;
+    chk::engine::generateMoves(pos, moves);
+    const auto wanted = std::min<size_t>(this->hintLines, moves.size());
+    if (const auto known = this->getHintResult(pos); known.has_value() && known->lines.size() >= wanted)
+    {
+        return; // already analysed (e.g. pondered during opponent's turn)
+    }
+    if (this->hintSearch == nullptr)
+    {
+        this->hintTable = std::make_unique<chk::engine::TranspositionTable>(chk::HINT_HASH_MB);
+        std::error_code error;
+        if (std::filesystem::exists(chk::HINT_HASH_FILE, error) && !this->hintTable->load(chk::HINT_HASH_FILE))
+        {
+            spdlog::warn("cannot load hint table from {}, starting empty", chk::HINT_HASH_FILE);
+        }
+        this->hintSearch = std::make_unique<chk::engine::AsyncSearch>();
+        this->hintSearch->setTranspositionTable(this->hintTable.get());
+    }
+    chk::engine::SearchLimits limits{chk::engine::MAX_PLY - 1, 0, this->hintBudgetMs};
+    limits.multiPv = this->hintLines;
+    this->hintSearch->start(pos, limits);
+}
+
+/**
+ * Best result so far for `pos`, from whichever engine is analysing it
+ * @param pos the position
+ * @return deepest completed iteration, or nullopt if none yet
+ */
+std::optional<chk::engine::SearchResult> GameManager::getHintResult(const chk::engine::Position &pos) const
+{
+    if (this->hintSearch == nullptr)
+    {
+        return std::nullopt;
+    }
+    return this->hintSearch->getLatest(pos);
+}
+
+/**
+ * Call every frame BEFORE drawing cells: paints the hinted source & destination cells, and shows
+ * the ranked list of best moves with their variations. Updates as each deepening iteration finishes.
+ * Hint is dropped once the position changes
+ * @param sideToMove the player whose turn it is
+ */
+void GameManager::drawHint(const chk::PlayerType sideToMove)
+{
+    if (!this->hintPos.has_value())
+    {
+        return;
+    }
+    const auto pos = this->hintPos.value();
+    if (this->toEnginePosition(sideToMove) != pos)
+    {
+        this->clearHint(); // a move was played
+        return;
+    }
+    const auto result = this->getHintResult(pos);
+    std::vector<int> cells{};
+    if (result.has_value() && result->bestMove != chk::engine::NULL_MOVE)
+    {
+        cells = {chk::engine::toCellIndex(result->bestMove.from), chk::engine::toCellIndex(result->bestMove.to)};
+    }
+    for (const auto &cell : this->blockList)
+    {
+        const int idx = cell->getIndex();
+        if (idx == -1 || idx == this->sourceCell)
+        {
+            continue; // leave the player's own selection alone
+        }
+        if (std::find(cells.begin(), cells.end(), idx) != cells.end())
+        {
+            cell->highlightHint();
+        }
+        else if (std::find(this->hintCells.begin(), this->hintCells.end(), idx) != this->hintCells.end())
+        {
+            cell->resetColor(); // hint moved elsewhere
+        }
+    }
+    this->hintCells = cells;
+
+    ImGui::SetNextWindowPos(ImVec2{10.0f, 10.0f}, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2{300.0f, 220.0f}, ImGuiCond_FirstUseEver);
+    bool open = true;
+    if (ImGui::Begin("Engine hint", &open, ImGuiWindowFlags_NoCollapse))
+    {
+        const bool searching = this->hintSearch != nullptr && this->hintSearch->isSearching();
+        if (!result.has_value())
+        {
+            ImGui::TextUnformatted("Thinking...");
+        }
+        else
+        {
+            ImGui::Text("depth %d  %lld ms  %llu nodes %s", result->depth, static_cast<long long>(result->elapsedMs),
+                        static_cast<unsigned long long>(result->stats.nodes), searching ? "..." : "");
+            constexpr auto flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV;
+            if (ImGui::BeginTable("hintLines", 3, flags))
+            {
+                ImGui::TableSetupColumn("#", ImGuiTableColumnFlags_WidthFixed);
+                ImGui::TableSetupColumn("Score", ImGuiTableColumnFlags_WidthFixed);
+                ImGui::TableSetupColumn("Line", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableHeadersRow();
+                for (size_t rank = 0; rank < result->lines.size(); rank++)
+                {
+                    const auto &pvLine = result->lines[rank];
+                    std::string line;
+                    auto linePos = pos;
+                    for (const auto &move : pvLine.pv)
+                    {
+                        line += chk::engine::toNotation(linePos, move) + " ";
+                        linePos = chk::engine::makeMove(linePos, move);
+                    }
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%zu", rank + 1);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%+d", pvLine.score);
+                    ImGui::TableNextColumn();
+                    ImGui::TextWrapped("%s", line.c_str());
+                }
+                ImGui::EndTable();
+            }
+            this->drawSearchStats(pos, result.value());
+        }
+        ImGui::SliderInt("Lines", &this->hintLines, 1, chk::HINT_MAX_LINES);
+        if (ImGui::IsItemDeactivatedAfterEdit())
+        {
+            this->requestHint(sideToMove); // re-rank with the new count (table keeps what was learnt)
+        }
+        ImGui::SliderInt("Time (ms)", &this->hintBudgetMs, 100, 10000);
+        if (searching && ImGui::Button("Stop"))
+        {
+            this->hintSearch->stop();
+        }
+    }
+    ImGui::End();
+    if (!open)
+    {
+        this->clearHint();
+    }
+}
+
+/**
+ * Debug section of the hint panel: where the engine's effort went, per search and per iteration.
+ * "Dump JSON" writes the same numbers to `SEARCH_STATS_FILE` (in the working directory)
+ * @param pos the analysed position
+ * @param result latest iteration
+ */
+void GameManager::drawSearchStats(const chk::engine::Position &pos, const chk::engine::SearchResult &result)
+{
+    if (!ImGui::CollapsingHeader("Search stats"))
+    {
+        return;
+    }
+    const auto &stats = result.stats;
+    ImGui::Text("nodes %llu (quiescence %.0f%%)  %llu nps", static_cast<unsigned long long>(stats.nodes),
+                100.0 * stats.qNodeRatio(), static_cast<unsigned long long>(result.nodesPerSecond()));
+    ImGui::Text("table: %llu probes, %llu hits, %llu cutoffs", static_cast<unsigned long long>(stats.ttProbes),
+                static_cast<unsigned long long>(stats.ttHits), static_cast<unsigned long long>(stats.ttCutoffs));
+    ImGui::Text("first-move cutoffs %.1f%%  branching factor %.2f", 100.0 * stats.firstMoveCutoffRate(),
+                result.branchingFactor());
+    constexpr auto flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("iterations", 4, flags))
+    {
+        ImGui::TableSetupColumn("Depth");
+        ImGui::TableSetupColumn("Score");
+        ImGui::TableSetupColumn("Nodes");
+        ImGui::TableSetupColumn("ms");
+        ImGui::TableHeadersRow();
+        for (const auto &iteration : result.iterations)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", iteration.depth);
+            ImGui::TableNextColumn();
+            ImGui::Text("%+d", iteration.score);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(iteration.nodes));
+            ImGui::TableNextColumn();
+            ImGui::Text("%lld", static_cast<long long>(iteration.elapsedMs));
+        }
+        ImGui::EndTable();
+    }
+    if (ImGui::Button("Dump JSON"))
+    {
+        std::ofstream file{chk::SEARCH_STATS_FILE};
+        file << chk::engine::toJson(pos, result) << '\n';
+        if (file)
+        {
+            spdlog::info("search stats written to {}", chk::SEARCH_STATS_FILE);
+        }
+        else
+        {
+            spdlog::error("cannot write {}", chk::SEARCH_STATS_FILE);
+        }
+    }
+}
+
+/**
+ * Stop the hint search and remove its highlights
+ */
+void GameManager::clearHint()
+{
+    if (this->hintSearch != nullptr)
+    {
+        this->hintSearch->stop();
+    }
+    for (const auto &cell : this->blockList)
+    {
+        const int idx = cell->getIndex();
+        const bool painted = std::find(this->hintCells.begin(), this->hintCells.end(), idx) != this->hintCells.end();
+        if (painted && idx != this->sourceCell)
+        {
+            cell->resetColor();
+        }
+    }
+    this->hintCells.clear();
+    this->hintPos = std::nullopt;
+}
+
 /**
  * Whether the game board contains this cell, AND is within playable range
  * @param cell_idx Cell index
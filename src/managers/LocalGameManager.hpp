@@ -1,14 +1,23 @@
 #pragma once
 
 #include "../GameManager.hpp"
+#include "../engine/AsyncMcts.hpp"
+#include "../engine/AsyncSearch.hpp"
+#include "../engine/EngineProcess.hpp"
+#include "../engine/OpeningBook.hpp"
+#include "../engine/Strength.hpp"
+#include "../utils/ResourcePath.hpp"
+#include "imgui-SFML.h"
+#include "imgui.h"
 #include <array>
+#include <filesystem>
 #include <limits>
 #include <numeric>
 
 namespace chk
 {
 /**
- * This class is responsible for offline play
+ * This class is responsible for offline play: two players on one machine, or one player against the engine
  * @since 2024-04-11
  */
 class LocalGameManager final : public chk::GameManager
@@ -23,7 +32,29 @@ class LocalGameManager final : public chk::GameManager
     void handleEvents(chk::CircularBuffer<int32_t> &buffer) override;
 
   private:
+    // computer opponent's level (index into STRENGTH_LEVELS), or -1 for a human opponent
+    int opponentLevel = -1;
+    // side the computer plays
+    chk::PlayerType opponentSide = chk::PlayerType::PLAYER_BLACK;
+    // computer opponent's search, on its own thread or in a child process (created on first use)
+    std::unique_ptr<chk::engine::SearchRunner> opponentSearch = nullptr;
+    // run the opponent in a separate engine process, so an engine crash cannot end the game
+    bool opponentOutOfProcess = false;
+    // the opponent uses Monte Carlo Tree Search (in this process) instead of alpha-beta
+    bool opponentMcts = false;
+    // position the opponent is thinking about (nullopt: idle)
+    std::optional<chk::engine::Position> opponentPos{};
+    // this machine's speed, for the "up to N ms" estimates (0 until measured)
+    uint64_t nodesPerSecond = 0;
+    std::mt19937 opponentRng{std::random_device{}()};
+    // opening book of the computer opponent (resources/opening.book, if present): it plays book moves at once
+    chk::engine::OpeningBook openingBook;
+
     std::array<int32_t, chk::NUM_PIECES> generateRandomPieceIds();
+    void drawOpponentPanel();
+    void updateOpponent();
+    void ponderHumanMove();
+    [[nodiscard]] bool isOpponentTurn() const;
 };
 
 /**
@@ -32,7 +63,13 @@ class LocalGameManager final : public chk::GameManager
  */
 inline LocalGameManager::LocalGameManager(sf::RenderWindow *windowPtr) : GameManager(windowPtr)
 {
-    // nothing here — players already created by base
+    // players already created by base
+    const auto bookPath = chk::getResourcePath(chk::engine::BOOK_FILE);
+    std::error_code error;
+    if (std::filesystem::exists(bookPath, error))
+    {
+        (void)this->openingBook.open(bookPath);
+    }
 }
 
 /**
@@ -96,6 +133,10 @@ inline void LocalGameManager::drawBoard()
     auto mousePos = sf::Mouse::getPosition(*window);
     static sf::Clock deltaClock;
     const float deltaTime = deltaClock.restart().asSeconds();
+    const auto sideToMove = this->isPlayerRedTurn() ? chk::PlayerType::PLAYER_RED : chk::PlayerType::PLAYER_BLACK;
+    this->drawOpponentPanel();
+    this->updateOpponent();
+    GameManager::drawHint(sideToMove); // engine hint overlay, if requested
 
     // DRAW CHECKERBOARD
     for (const auto &cell : this->getBlockList())
@@ -140,10 +181,21 @@ inline void LocalGameManager::handleEvents(chk::CircularBuffer<int32_t> &buffer)
 {
     for (auto event = sf::Event{}; window->pollEvent(event);)
     {
+        ImGui::SFML::ProcessEvent(*this->window, event);
         if (event.type == sf::Event::Closed)
         {
             window->close();
         }
+        const bool panelClick = event.type == sf::Event::MouseButtonPressed && ImGui::GetIO().WantCaptureMouse;
+        if (this->isOpponentTurn() || panelClick)
+        {
+            continue; // computer is thinking, or click was meant for a panel
+        }
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::H)
+        {
+            const auto side = this->isPlayerRedTurn() ? chk::PlayerType::PLAYER_RED : chk::PlayerType::PLAYER_BLACK;
+            GameManager::requestHint(side);
+        }
         if (event.type == sf::Event::MouseButtonPressed && sf::Mouse::isButtonPressed(sf::Mouse::Left))
         {
             const auto clickedPos = sf::Mouse::getPosition(*window);
@@ -195,4 +247,168 @@ inline std::array<int32_t, chk::NUM_PIECES> LocalGameManager::generateRandomPiec
     return pieceIds;
 }
 
+/**
+ * Whether the computer opponent is to move
+ */
+inline bool LocalGameManager::isOpponentTurn() const
+{
+    const auto sideToMove = this->isPlayerRedTurn() ? chk::PlayerType::PLAYER_RED : chk::PlayerType::PLAYER_BLACK;
+    return this->opponentLevel >= 0 && sideToMove == this->opponentSide && !this->isGameOver();
+}
+
+/**
+ * Panel to pick the opponent: a human, or the engine at one of its levels. Each level shows the longest
+ * it can think per move on this machine (its node budget at the measured speed, never above its hard cap)
+ */
+inline void LocalGameManager::drawOpponentPanel()
+{
+    if (this->nodesPerSecond == 0)
+    {
+        this->nodesPerSecond = chk::engine::measureNodesPerSecond(); // once, ~50 ms
+    }
+    const auto levelLabel = [this](const int idx) {
+        if (idx < 0)
+        {
+            return std::string{"Human"};
+        }
+        const auto &level = chk::engine::STRENGTH_LEVELS[idx];
+        return std::string{level.name} + " (" + std::to_string(level.nodes / 1000) + "k nodes, up to " +
+               std::to_string(chk::engine::maxThinkMs(level, this->nodesPerSecond)) + " ms)";
+    };
+    ImGui::SetNextWindowPos(ImVec2{330.0f, 10.0f}, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Opponent", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        if (ImGui::BeginCombo("##level", levelLabel(this->opponentLevel).c_str()))
+        {
+            for (int idx = -1; idx < static_cast<int>(chk::engine::STRENGTH_LEVELS.size()); idx++)
+            {
+                if (ImGui::Selectable(levelLabel(idx).c_str(), idx == this->opponentLevel))
+                {
+                    this->opponentLevel = idx;
+                    this->opponentPos = std::nullopt; // restart thinking at the new level
+                }
+            }
+            ImGui::EndCombo();
+        }
+        if (this->opponentLevel >= 0)
+        {
+            bool playsRed = this->opponentSide == chk::PlayerType::PLAYER_RED;
+            if (ImGui::Checkbox("Computer plays RED", &playsRed))
+            {
+                this->opponentSide = playsRed ? chk::PlayerType::PLAYER_RED : chk::PlayerType::PLAYER_BLACK;
+                this->opponentPos = std::nullopt;
+            }
+            if (ImGui::Checkbox("Monte Carlo engine", &this->opponentMcts))
+            {
+                this->opponentOutOfProcess = this->opponentOutOfProcess && !this->opponentMcts;
+                this->opponentSearch = nullptr; // recreated on the next move, of the chosen kind
+                this->opponentPos = std::nullopt;
+            }
+            if (!this->opponentMcts && ImGui::Checkbox("Engine in separate process", &this->opponentOutOfProcess))
+            {
+                this->opponentSearch = nullptr; // recreated on the next move, of the chosen kind
+                this->opponentPos = std::nullopt;
+            }
+            const bool thinking = this->opponentSearch != nullptr && this->opponentSearch->isSearching();
+            ImGui::TextUnformatted(thinking ? "Thinking..." : "Your move");
+        }
+    }
+    ImGui::End();
+}
+
+/**
+ * Call every frame: start the opponent's search when it is its turn (or play a book move at once,
+ * while the game is in book), and play its move once the node budget is spent. The search runs on its own thread,
+ * so the render loop never waits for it. The MCTS opponent keeps thinking during the human's turn, and starts
+ * its next search from that tree
+ */
+inline void LocalGameManager::updateOpponent()
+{
+    const auto *mcts = dynamic_cast<chk::engine::AsyncMcts *>(this->opponentSearch.get());
+    if (mcts != nullptr && mcts->isPondering() && (this->opponentLevel < 0 || this->isGameOver()))
+    {
+        this->opponentSearch->stop(); // switched to human, or game over: nothing left to ponder
+    }
+    if (!this->isOpponentTurn())
+    {
+        if (this->opponentPos.has_value() && this->opponentSearch != nullptr)
+        {
+            this->opponentSearch->stop(); // switched to human, or game over
+        }
+        this->opponentPos = std::nullopt;
+        return;
+    }
+    const auto pos = this->toEnginePosition(this->opponentSide);
+    const auto &level = chk::engine::STRENGTH_LEVELS[this->opponentLevel];
+    if (this->opponentPos != pos)
+    {
+        if (const auto bookMove = this->openingBook.pickMove(pos, this->opponentRng))
+        {
+            GameManager::playEngineMove(this->opponentSide, pos, bookMove.value());
+            if (this->isOpponentTurn() && this->toEnginePosition(this->opponentSide) == pos)
+            {
+                spdlog::error("board refused book move, searching instead");
+                this->opponentPos = std::nullopt;
+                this->openingBook.close();
+            }
+            this->ponderHumanMove();
+            return;
+        }
+        if (this->opponentSearch == nullptr && this->opponentMcts)
+        {
+            this->opponentSearch = std::make_unique<chk::engine::AsyncMcts>();
+        }
+        if (this->opponentSearch == nullptr && this->opponentOutOfProcess)
+        {
+            // a copy of this executable, started with ENGINE_CHANNEL_FLAG (see main.cpp)
+            this->opponentSearch = std::make_unique<chk::engine::EngineProcess>(chk::engine::currentExecutablePath());
+        }
+        if (this->opponentSearch == nullptr)
+        {
+            this->opponentSearch = std::make_unique<chk::engine::AsyncSearch>();
+        }
+        this->opponentPos = pos;
+        this->opponentSearch->start(pos, this->opponentMcts ? chk::engine::mctsLimitsFor(level)
+                                                            : chk::engine::limitsFor(level));
+        return;
+    }
+    if (this->opponentSearch->isSearching())
+    {
+        return;
+    }
+    const auto result = this->opponentSearch->getLatest(pos);
+    const auto move = result.has_value() ? chk::engine::pickMove(result.value(), level, this->opponentRng)
+                                         : chk::engine::NULL_MOVE;
+    if (move == chk::engine::NULL_MOVE)
+    {
+        return; // no legal move: nothing to play
+    }
+    this->opponentPos = std::nullopt;
+    GameManager::playEngineMove(this->opponentSide, pos, move);
+    if (this->isOpponentTurn() && this->toEnginePosition(this->opponentSide) == pos)
+    {
+        spdlog::error("board refused computer move {}, handing over to human", chk::engine::toNotation(pos, move));
+        this->opponentLevel = -1;
+        return;
+    }
+    this->ponderHumanMove();
+}
+
+/**
+ * After the computer has moved: let the MCTS opponent grow its tree while the human thinks
+ * (the next `start` stops it, and keeps the subtree of the move they play)
+ */
+inline void LocalGameManager::ponderHumanMove()
+{
+    auto *mcts = dynamic_cast<chk::engine::AsyncMcts *>(this->opponentSearch.get());
+    if (mcts == nullptr || this->isOpponentTurn() || this->isGameOver())
+    {
+        return;
+    }
+    const auto humanSide = this->opponentSide == chk::PlayerType::PLAYER_RED ? chk::PlayerType::PLAYER_BLACK
+                                                                             : chk::PlayerType::PLAYER_RED;
+    mcts->ponder(this->toEnginePosition(humanSide));
+}
+
 } // namespace chk
@@ -2,12 +2,25 @@
 
 #include "../GameManager.hpp"
 #include "../WsClient.hpp"
+#include "../engine/AsyncSearch.hpp"
+#include "../engine/Ponderer.hpp"
+#include "../engine/Strength.hpp"
 #include "../payloads/base_payload.pb.hpp"
 #include "imgui-SFML.h"
+#include <chrono>
+#include <thread>
 
 namespace chk
 {
 using chk::payload::TeamColor;
+// how long the assist engine keeps thinking once the opponent has moved
+constexpr int64_t ASSIST_BUDGET_MS{1500};
+// autopilot level when switched on with the B key (index into STRENGTH_LEVELS): the strongest
+constexpr int AUTOPILOT_DEFAULT_LEVEL{static_cast<int>(chk::engine::STRENGTH_LEVELS.size()) - 1};
+// headless bot: time between two polls of the server (the GUI polls once per frame, at 60 FPS)
+constexpr int64_t BOT_FRAME_MS{16};
+// headless bot: pause before queueing for the next match (or retrying a failed connection)
+constexpr int64_t BOT_REQUEUE_MS{1000};
 
 /**
  * This class is responsible for online gameplay
@@ -16,7 +29,7 @@ using chk::payload::TeamColor;
 class OnlineGameManager final : public chk::GameManager
 {
   public:
-    explicit OnlineGameManager(sf::RenderWindow *windowPtr);
+    explicit OnlineGameManager(sf::RenderWindow *windowPtr, bool headless = false);
     OnlineGameManager() = delete;
 
     // Inherited via GameManager
@@ -24,6 +37,11 @@ class OnlineGameManager final : public chk::GameManager
     void handleEvents(chk::CircularBuffer<int32_t> &circularBuffer) override;
     void drawBoard() override;
 
+    void setAutopilot(int level);
+    void connectTo(std::string_view address);
+    void runHeadlessFrame();
+    [[nodiscard]] bool isMatchOver() const;
+
   protected:
     // Inherited via GameManager
     void handleMovePiece(const chk::PlayerPtr &player, const chk::PlayerPtr &opponent, const Block &destCell,
@@ -32,21 +50,46 @@ class OnlineGameManager final : public chk::GameManager
                             const chk::Block &targetCell) override;
     void handleCellTap(const chk::PlayerPtr &hunter, const chk::PlayerPtr &prey, chk::CircularBuffer<int32_t> &buffer,
                        const chk::Block &cell) override;
+    [[nodiscard]] std::optional<chk::engine::SearchResult> getHintResult(
+        const chk::engine::Position &pos) const override;
 
   private:
     mutable chk::PlayerType myTeam{};
     std::atomic_bool isMyTurn = false;
     std::atomic_bool gameReady = false;
     std::unique_ptr<chk::WsClient> wsClient = nullptr;
+    // analysis/assist mode: engine thinks on opponent's time (toggle with A key). nullptr when off
+    std::unique_ptr<chk::engine::Ponderer> ponderer = nullptr;
+    // autopilot (bot) level, index into STRENGTH_LEVELS, or -1 when a human plays (toggle with B key)
+    int autopilotLevel = -1;
+    // autopilot's search (created on first use)
+    std::unique_ptr<chk::engine::AsyncSearch> autopilotSearch = nullptr;
+    // position the autopilot is thinking about (nullopt: idle)
+    std::optional<chk::engine::Position> autopilotPos{};
+    std::mt19937 autopilotRng{std::random_device{}()};
+    // server ended the match (win, loss, or lost connection)
+    std::atomic_bool matchOver = false;
+    void toggleAssistMode();
+    void toggleAutopilot();
+    void startAutopilotTurn();
+    void updateAutopilot();
+    void ponderOpponentTurn();
+    void onOpponentTurnDone();
     void startMoveListener();
     void startCaptureListener();
     void startDeathListener();
     chk::payload::TeamColor toTeamColor(chk::PlayerType team);
 };
 
-inline OnlineGameManager::OnlineGameManager(sf::RenderWindow *windowPtr) : GameManager(windowPtr)
+/**
+ * Custom constructor
+ * @param windowPtr original window from main.cpp, or nullptr when headless
+ * @param headless TRUE for bot mode: no window nor ImGui, connect with connectTo() and drive with runHeadlessFrame()
+ */
+inline OnlineGameManager::OnlineGameManager(sf::RenderWindow *windowPtr, const bool headless)
+    : GameManager(windowPtr)
 {
-    this->wsClient = std::make_unique<chk::WsClient>();
+    this->wsClient = std::make_unique<chk::WsClient>(headless);
 
     // set Listener for connection success
     this->wsClient->setOnConnectedCallback(
@@ -66,6 +109,10 @@ inline OnlineGameManager::OnlineGameManager(sf::RenderWindow *windowPtr) : GameM
             this->updateMessage(notice);
             this->startDeathListener();
         });
+    if (headless)
+    {
+        this->startDeathListener(); // a bot must also notice a connection that never opened
+    }
 }
 
 /**
@@ -129,6 +176,7 @@ inline void chk::OnlineGameManager::createAllPieces()
             pieceList.clear(); // SAFE! no longer needed.
             this->startMoveListener();
             this->startCaptureListener();
+            this->startAutopilotTurn(); // RED opens
         });
 }
 
@@ -140,6 +188,7 @@ inline void OnlineGameManager::drawBoard()
     const auto mousePos = sf::Mouse::getPosition(*window);
     static sf::Clock deltaClock;
     const float deltaTime = deltaClock.restart().asSeconds();
+    GameManager::drawHint(this->myTeam); // engine hint overlay, if requested (dropped once my turn ends)
 
     // DRAW CHECKERBOARD
     for (const auto &cell : this->getBlockList())
@@ -151,6 +200,7 @@ inline void OnlineGameManager::drawBoard()
     {
         wsClient->runMainLoop();
     }
+    this->updateAutopilot();
     // DRAW RED PIECES
     for (const auto &[id, red_piece] : this->playerRed->getOwnPieces())
     {
@@ -194,6 +244,19 @@ inline void OnlineGameManager::handleEvents(chk::CircularBuffer<int32_t> &buffer
         {
             window->close();
         }
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::A)
+        {
+            this->toggleAssistMode();
+        }
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::B)
+        {
+            this->toggleAutopilot();
+        }
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::H && this->gameReady &&
+            this->isMyTurn)
+        {
+            GameManager::requestHint(this->myTeam);
+        }
         if (event.type == sf::Event::MouseButtonPressed && sf::Mouse::isButtonPressed(sf::Mouse::Left))
         {
             const auto clickedPos = sf::Mouse::getPosition(*window);
@@ -272,6 +335,7 @@ inline void OnlineGameManager::handleMovePiece(const chk::PlayerPtr &player, con
     this->isMyTurn = !this->isMyTurn; // toggle player turns
     this->updateMessage("You have moved to " + std::to_string(destCell->getIndex()) + ". It's " + opponent->getName() +
                         "'s turn.");
+    this->ponderOpponentTurn();
 }
 
 /**
@@ -367,6 +431,7 @@ inline void OnlineGameManager::handleCapturePiece(const chk::PlayerPtr &hunter,
         chk::GameManager::identifyTargets(prey);
         this->isMyTurn = !this->isMyTurn;
         this->updateMessage("It's " + prey->getName() + "'s turn");
+        this->ponderOpponentTurn();
     }
     else
     {
@@ -444,6 +509,183 @@ inline void OnlineGameManager::handleCellTap(const chk::PlayerPtr &hunter, const
     }
 }
 
+/**
+ * Switch analysis/assist mode on or off. When on, the engine keeps searching the predicted reply
+ * while the opponent thinks, so its suggestion is ready (or nearly) as soon as they move
+ */
+inline void OnlineGameManager::toggleAssistMode()
+{
+    if (this->ponderer != nullptr)
+    {
+        this->ponderer = nullptr; // stops the background search
+        this->updateMessage("Assist mode OFF");
+        return;
+    }
+    this->ponderer = std::make_unique<chk::engine::Ponderer>();
+    this->updateMessage("Assist mode ON");
+    if (this->gameReady && !this->isMyTurn)
+    {
+        this->ponderOpponentTurn();
+    }
+}
+
+/**
+ * My turn just ended: start thinking on the opponent's time (if assist mode is on)
+ */
+inline void OnlineGameManager::ponderOpponentTurn()
+{
+    if (this->ponderer == nullptr)
+    {
+        return;
+    }
+    const auto opponent = this->myTeam == PlayerType::PLAYER_RED ? PlayerType::PLAYER_BLACK : PlayerType::PLAYER_RED;
+    this->ponderer->start(GameManager::toEnginePosition(opponent));
+}
+
+/**
+ * Opponent's turn just ended: the autopilot (if on) starts thinking. For assist, a correct prediction continues
+ * as a warm search, a wrong one is discarded
+ */
+inline void OnlineGameManager::onOpponentTurnDone()
+{
+    this->startAutopilotTurn();
+    if (this->ponderer == nullptr)
+    {
+        return;
+    }
+    const auto pos = GameManager::toEnginePosition(this->myTeam);
+    const auto outcome = this->ponderer->onOpponentMove(pos, chk::ASSIST_BUDGET_MS);
+    if (outcome == chk::engine::PonderOutcome::HIT)
+    {
+        const auto latest = this->ponderer->getLatest(pos);
+        spdlog::info("assist: ponder hit, depth {} ready", latest.has_value() ? latest->depth : 0);
+    }
+    else if (outcome == chk::engine::PonderOutcome::MISS)
+    {
+        spdlog::info("assist: ponder miss, searching actual position");
+    }
+}
+
+/**
+ * Let the engine play my side (level = index into STRENGTH_LEVELS), or hand it back to the mouse (-1)
+ * @param level strength level, or -1 for off
+ */
+inline void OnlineGameManager::setAutopilot(const int level)
+{
+    const bool valid = level >= 0 && level < static_cast<int>(chk::engine::STRENGTH_LEVELS.size());
+    this->autopilotLevel = valid ? level : -1;
+    if (this->autopilotSearch != nullptr)
+    {
+        this->autopilotSearch->stop();
+    }
+    this->autopilotPos = std::nullopt;
+    this->startAutopilotTurn(); // my turn already: answer now
+}
+
+/**
+ * Switch the autopilot on (at the strongest level) or off, from the GUI
+ */
+inline void OnlineGameManager::toggleAutopilot()
+{
+    const bool on = this->autopilotLevel < 0;
+    this->setAutopilot(on ? chk::AUTOPILOT_DEFAULT_LEVEL : -1);
+    this->updateMessage(on ? "Autopilot ON" : "Autopilot OFF");
+}
+
+/**
+ * It just became my turn: with the autopilot on, start searching. The move is played by updateAutopilot()
+ */
+inline void OnlineGameManager::startAutopilotTurn()
+{
+    if (this->autopilotLevel < 0 || !this->gameReady || !this->isMyTurn)
+    {
+        return;
+    }
+    if (this->autopilotSearch == nullptr)
+    {
+        this->autopilotSearch = std::make_unique<chk::engine::AsyncSearch>();
+    }
+    const auto pos = GameManager::toEnginePosition(this->myTeam);
+    this->autopilotPos = pos;
+    this->autopilotSearch->start(pos, chk::engine::limitsFor(chk::engine::STRENGTH_LEVELS[this->autopilotLevel]));
+}
+
+/**
+ * Call every frame: once the autopilot's search is done, play its move through handleCellTap, i.e. the same
+ * handleMovePiece/handleCapturePiece path (and server messages) as mouse clicks
+ */
+inline void OnlineGameManager::updateAutopilot()
+{
+    if (!this->autopilotPos.has_value() || this->autopilotSearch->isSearching())
+    {
+        return;
+    }
+    const auto pos = this->autopilotPos.value();
+    this->autopilotPos = std::nullopt;
+    if (!this->gameReady || !this->isMyTurn || GameManager::toEnginePosition(this->myTeam) != pos)
+    {
+        return; // match ended while thinking
+    }
+    const auto &level = chk::engine::STRENGTH_LEVELS[this->autopilotLevel];
+    const auto result = this->autopilotSearch->getLatest(pos);
+    const auto move =
+        result.has_value() ? chk::engine::pickMove(result.value(), level, this->autopilotRng) : chk::engine::NULL_MOVE;
+    if (move == chk::engine::NULL_MOVE)
+    {
+        return; // no legal move: the server ends the match
+    }
+    GameManager::playEngineMove(this->myTeam, pos, move);
+    if (this->gameReady && this->isMyTurn && GameManager::toEnginePosition(this->myTeam) == pos)
+    {
+        spdlog::error("board refused autopilot move {}, autopilot off", chk::engine::toNotation(pos, move));
+        this->autopilotLevel = -1;
+    }
+}
+
+/**
+ * Connect straight to a server, without the connection window (headless bot mode)
+ * @param address server URL, e.g. ws://127.0.0.1:9876/game
+ */
+inline void OnlineGameManager::connectTo(std::string_view address)
+{
+    this->wsClient->connectTo(address);
+}
+
+/**
+ * Headless replacement for the frame loop: exchange messages with the server, then let the autopilot play
+ */
+inline void OnlineGameManager::runHeadlessFrame()
+{
+    this->wsClient->runMainLoop();
+    this->updateAutopilot();
+}
+
+/**
+ * Whether the server has ended this match (win, loss, or lost connection)
+ */
+inline bool OnlineGameManager::isMatchOver() const
+{
+    return this->matchOver;
+}
+
+/**
+ * Prefer the assist engine's result: it may have been searching this position since before the opponent moved.
+ * A hint search already running on `pos` wins though, since it was started to rank more lines than assist gives
+ * @param pos the position
+ */
+inline std::optional<chk::engine::SearchResult> OnlineGameManager::getHintResult(const chk::engine::Position &pos) const
+{
+    if (auto hinted = GameManager::getHintResult(pos); hinted.has_value())
+    {
+        return hinted;
+    }
+    if (this->ponderer != nullptr)
+    {
+        return this->ponderer->getLatest(pos);
+    }
+    return std::nullopt;
+}
+
 /**
  * Listening for "MovePiece" events from server, and update gameBoard
  */
@@ -474,6 +716,7 @@ inline void OnlineGameManager::startMoveListener()
         this->isMyTurn = !this->isMyTurn; // toggle player turns
         this->updateMessage("Opponent moved to " + std::to_string(payload.destination().cell_index()) +
                             ". It's your turn.");
+        this->onOpponentTurnDone();
     });
 }
 
@@ -524,6 +767,7 @@ inline void OnlineGameManager::startCaptureListener()
             chk::GameManager::identifyTargets(myTeam);
             this->isMyTurn = !this->isMyTurn;
             this->updateMessage("It's now your turn!");
+            this->onOpponentTurnDone();
         }
     });
 }
@@ -543,6 +787,8 @@ inline void OnlineGameManager::startDeathListener()
 {
     this->wsClient->setOnDeathCallback([this](std::string_view notice) {
         this->updateMessage(notice);
+        this->matchOver = true;
+        this->ponderer = nullptr;
         this->doCleanup();
         this->isMyTurn = false;
         this->gameReady = false;
@@ -550,10 +796,48 @@ inline void OnlineGameManager::startDeathListener()
 
     this->wsClient->setOnWinLoseCallback([this](std::string_view notice) {
         this->updateMessage(notice);
+        this->matchOver = true;
+        this->ponderer = nullptr;
         this->doCleanup();
         this->isMyTurn = false;
         this->gameReady = false;
     });
 }
 
+/**
+ * Headless bot: queue on the server, play matches with the autopilot, then queue again. No window, no ImGui:
+ * used to keep the server's matchmaking queue stocked and to soak-test it
+ * @param address server URL
+ * @param level strength level (index into STRENGTH_LEVELS)
+ * @param matches number of matches to play (0 = forever)
+ * @return exit code
+ */
+inline int runBotMatches(std::string_view address, const int level, const int matches)
+{
+    if (level < 0 || level >= static_cast<int>(chk::engine::STRENGTH_LEVELS.size()))
+    {
+        spdlog::error("bot: no strength level {} (0..{})", level, chk::engine::STRENGTH_LEVELS.size() - 1);
+        return EXIT_FAILURE;
+    }
+    chk::Piece::setTexturesEnabled(false); // textures need a display
+    const sf::Font font; // cell labels are never drawn
+    for (int played = 0; matches == 0 || played < matches; played++)
+    {
+        chk::OnlineGameManager manager{nullptr, true};
+        manager.drawCheckerboard(font);
+        manager.createAllPieces();
+        manager.setAutopilot(level);
+        manager.connectTo(address);
+        spdlog::info("bot: match {} on {}", played + 1, address);
+        while (!manager.isMatchOver())
+        {
+            manager.runHeadlessFrame();
+            std::this_thread::sleep_for(std::chrono::milliseconds(chk::BOT_FRAME_MS));
+        }
+        spdlog::info("bot: {}", manager.getCurrentMsg());
+        std::this_thread::sleep_for(std::chrono::milliseconds(chk::BOT_REQUEUE_MS));
+    }
+    return EXIT_SUCCESS;
+}
+
 } // namespace chk
@@ -0,0 +1,175 @@
+#include "MappedFile.hpp"
+#include <spdlog/spdlog.h>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace chk
+{
+
+MappedFile::~MappedFile()
+{
+    this->close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        this->close();
+        this->base = std::exchange(other.base, nullptr);
+        this->length = std::exchange(other.length, 0);
+#if defined(_WIN32)
+        this->fileHandle = std::exchange(other.fileHandle, nullptr);
+        this->mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+    }
+    return *this;
+}
+
+/**
+ * Map the whole file into memory (read-only). Any previous mapping is released first.
+ * @param path location of file
+ * @return TRUE if successful, else FALSE
+ */
+bool MappedFile::open(const std::string &path)
+{
+    this->close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        spdlog::error("cannot open file {}", path);
+        return false;
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        spdlog::error("cannot map empty file {}", path);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        spdlog::error("CreateFileMapping failed for {}", path);
+        return false;
+    }
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        spdlog::error("MapViewOfFile failed for {}", path);
+        return false;
+    }
+    this->fileHandle = file;
+    this->mappingHandle = mapping;
+    this->base = static_cast<const uint8_t *>(view);
+    this->length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        spdlog::error("cannot open file {}", path);
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        spdlog::error("cannot map empty file {}", path);
+        return false;
+    }
+    void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // mapping stays valid after closing descriptor
+    if (view == MAP_FAILED)
+    {
+        spdlog::error("mmap failed for {}", path);
+        return false;
+    }
+    this->base = static_cast<const uint8_t *>(view);
+    this->length = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+/**
+ * Release the mapping (safe to call many times)
+ */
+void MappedFile::close()
+{
+    if (this->base == nullptr)
+    {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(this->base);
+    CloseHandle(this->mappingHandle);
+    CloseHandle(this->fileHandle);
+    this->mappingHandle = nullptr;
+    this->fileHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t *>(this->base), this->length);
+#endif
+    this->base = nullptr;
+    this->length = 0;
+}
+
+/**
+ * Hint the OS that reads will be scattered, so it should not read ahead (no-op on Windows, set at open)
+ */
+void MappedFile::adviseRandomAccess() const
+{
+#if !defined(_WIN32)
+    if (this->base != nullptr)
+    {
+        madvise(const_cast<uint8_t *>(this->base), this->length, MADV_RANDOM);
+    }
+#endif
+}
+
+/**
+ * Whether a file is currently mapped
+ * @return TRUE or FALSE
+ */
+bool MappedFile::isOpen() const
+{
+    return this->base != nullptr;
+}
+
+/**
+ * Get start of mapped bytes
+ * @return pointer, or nullptr if not open
+ */
+const uint8_t *MappedFile::data() const
+{
+    return this->base;
+}
+
+/**
+ * Get total bytes mapped
+ */
+size_t MappedFile::size() const
+{
+    return this->length;
+}
+
+} // namespace chk
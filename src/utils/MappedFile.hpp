@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace chk
+{
+/**
+ * Read-only memory mapping of a whole file (RAII). Pages are loaded lazily by the OS,
+ * so even very large files cost nothing until they are actually read.
+ */
+class MappedFile final
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    [[nodiscard]] bool open(const std::string &path);
+    void close();
+    void adviseRandomAccess() const;
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] const uint8_t *data() const;
+    [[nodiscard]] size_t size() const;
+
+  private:
+    const uint8_t *base = nullptr; // start of mapped region
+    size_t length = 0;             // total bytes mapped
+#if defined(_WIN32)
+    void *fileHandle = nullptr;    // HANDLE from CreateFile
+    void *mappingHandle = nullptr; // HANDLE from CreateFileMapping
+#endif
+};
+
+} // namespace chk
@@ -0,0 +1,51 @@
+#include "engine/AsyncSearch.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace chk::engine;
+
+TEST(AsyncSearchTests, Start_ReturnsImmediatelyAndPublishesIterations)
+{
+    AsyncSearch search;
+    const auto before = std::chrono::steady_clock::now();
+    search.start(Position::initial(), SearchLimits{MAX_PLY - 1, 0, 300});
+    EXPECT_LT(std::chrono::steady_clock::now() - before, std::chrono::milliseconds(50));
+
+    int lastDepth = 0;
+    bool deepened = false;
+    while (search.isSearching())
+    {
+        if (const auto latest = search.getLatest(Position::initial()); latest.has_value())
+        {
+            deepened = deepened || (lastDepth > 0 && latest->depth > lastDepth);
+            lastDepth = latest->depth;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(deepened);
+    const auto final = search.getLatest(Position::initial());
+    ASSERT_TRUE(final.has_value());
+    EXPECT_NE(final->bestMove, NULL_MOVE);
+    EXPECT_LT(final->elapsedMs, 1000);
+}
+
+TEST(AsyncSearchTests, GetLatest_OnlyForSearchedPosition)
+{
+    AsyncSearch search;
+    search.start(Position::initial(), SearchLimits{4, 0, 0});
+    MoveList moves;
+    generateMoves(Position::initial(), moves);
+    const Position other = makeMove(Position::initial(), moves[0]);
+    EXPECT_FALSE(search.getLatest(other).has_value());
+}
+
+TEST(AsyncSearchTests, Stop_KeepsLastIteration)
+{
+    AsyncSearch search;
+    search.start(Position::initial(), SearchLimits{MAX_PLY - 1, 0, 0});
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    search.stop();
+    EXPECT_FALSE(search.isSearching());
+    EXPECT_TRUE(search.getLatest(Position::initial()).has_value());
+}
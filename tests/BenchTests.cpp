@@ -0,0 +1,44 @@
+#include "engine/Bench.hpp"
+#include <gtest/gtest.h>
+
+using namespace chk::engine;
+
+TEST(BenchTests, SameConfig_SameNodesAndMoves)
+{
+    BenchConfig config;
+    config.positions = 8;
+    config.depth = 6;
+    const BenchResult first = runBench(config);
+    const BenchResult second = runBench(config);
+    ASSERT_EQ(first.entries.size(), 8u);
+    ASSERT_EQ(second.entries.size(), 8u);
+    for (size_t i = 0; i < first.entries.size(); i++)
+    {
+        EXPECT_EQ(first.entries[i].pos, second.entries[i].pos);
+        EXPECT_EQ(first.entries[i].nodes, second.entries[i].nodes);
+        EXPECT_EQ(first.entries[i].bestMove, second.entries[i].bestMove);
+    }
+    EXPECT_EQ(first.nodes, second.nodes);
+    EXPECT_EQ(first.movesHash, second.movesHash);
+}
+
+TEST(BenchTests, Suite_IsFixedBySeedAndHasNoForcedMoves)
+{
+    const auto suite = benchPositions(BENCH_SEED, BENCH_POSITIONS);
+    ASSERT_EQ(suite.size(), static_cast<size_t>(BENCH_POSITIONS));
+    EXPECT_EQ(suite, benchPositions(BENCH_SEED, BENCH_POSITIONS));
+    EXPECT_NE(suite, benchPositions(BENCH_SEED + 1, BENCH_POSITIONS));
+    for (const Position &pos : suite)
+    {
+        MoveList moves;
+        generateMoves(pos, moves);
+        EXPECT_GT(moves.size(), 1u);
+    }
+}
+
+TEST(BenchTests, DefaultBench_MatchesRecordedSignature)
+{
+    // fails on ANY change to what the search visits: if the change is intended, update BENCH_SIGNATURE
+    const BenchResult bench = runBench();
+    EXPECT_EQ(bench.nodes, BENCH_SIGNATURE);
+}
@@ -0,0 +1,134 @@
+#include "engine/DistributedSelfPlay.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace chk::engine;
+
+namespace
+{
+constexpr uint64_t ENGINES_KEY{42};
+
+SelfPlayConfig smallMatch(const uint32_t games)
+{
+    SelfPlayConfig config;
+    config.numThreads = 1;
+    config.maxGames = games;
+    config.maxGamePlies = 120;
+    config.openings = generateOpenings(8, 4, 40, 3);
+    return config;
+}
+
+EngineSpec smallEngine()
+{
+    EngineSpec engine;
+    engine.limits = SearchLimits{MAX_PLY - 1, 300, 0};
+    return engine;
+}
+} // namespace
+
+TEST(DistributedSelfPlayTests, WrongFingerprint_IsRefused)
+{
+    SelfPlayCoordinator coordinator{smallMatch(2), ENGINES_KEY};
+    ASSERT_TRUE(coordinator.listen());
+    std::thread serve([&coordinator] { coordinator.run(); });
+
+    SelfPlayLink link;
+    ASSERT_TRUE(link.connect("127.0.0.1", coordinator.getPort()));
+    SelfPlayFrame hello;
+    hello.type = SelfPlayMessage::HELLO;
+    hello.fingerprint = selfPlayFingerprint(smallMatch(2), ENGINES_KEY + 1); // other engine options
+    hello.threads = 3;
+    ASSERT_TRUE(link.send(hello));
+    SelfPlayFrame reply;
+    ASSERT_EQ(link.receive(reply, 5000), LinkStatus::FRAME);
+    EXPECT_EQ(reply.type, SelfPlayMessage::STOP);
+    EXPECT_EQ(link.receive(reply, 5000), LinkStatus::CLOSED);
+
+    coordinator.stop();
+    serve.join();
+}
+
+TEST(DistributedSelfPlayTests, DeadWorker_BatchIsPlayedElsewhere)
+{
+    const SelfPlayConfig config = smallMatch(8);
+    CoordinatorConfig net;
+    net.batchGames = 2;
+    SelfPlayCoordinator coordinator{config, ENGINES_KEY, net};
+    ASSERT_TRUE(coordinator.listen());
+    CoordinatorReport report;
+    std::thread serve([&] { report = coordinator.run(); });
+
+    // takes a batch, then dies without a result
+    SelfPlayLink quitter;
+    ASSERT_TRUE(quitter.connect("127.0.0.1", coordinator.getPort()));
+    SelfPlayFrame hello;
+    hello.type = SelfPlayMessage::HELLO;
+    hello.fingerprint = selfPlayFingerprint(config, ENGINES_KEY);
+    hello.threads = 1;
+    ASSERT_TRUE(quitter.send(hello));
+    SelfPlayFrame batch;
+    ASSERT_EQ(quitter.receive(batch, 5000), LinkStatus::FRAME);
+    ASSERT_EQ(batch.type, SelfPlayMessage::BATCH);
+    EXPECT_EQ(batch.games, 2U);
+    quitter.close();
+
+    EXPECT_TRUE(runSelfPlayWorker("127.0.0.1", coordinator.getPort(), smallEngine(), smallEngine(), config,
+                                  ENGINES_KEY));
+    serve.join();
+    EXPECT_EQ(report.match.score.total(), 8U);
+    EXPECT_EQ(report.batchesDone, 4U);
+    EXPECT_EQ(report.batchesRetried, 1U);
+    EXPECT_EQ(report.batchesFailed, 0U);
+    EXPECT_EQ(report.workersSeen, 2U);
+    EXPECT_EQ(report.workersLost, 1U);
+}
+
+#if !defined(_WIN32)
+TEST(DistributedSelfPlayTests, WorkerProcesses_PlayTheSameMatchAsOneProcess)
+{
+    const SelfPlayConfig config = smallMatch(24);
+    CoordinatorConfig net;
+    net.batchGames = 2;
+    SelfPlayCoordinator coordinator{config, ENGINES_KEY, net};
+    ASSERT_TRUE(coordinator.listen());
+
+    constexpr int WORKERS = 3;
+    std::vector<pid_t> children;
+    for (int i = 0; i < WORKERS; i++)
+    {
+        const pid_t pid = fork();
+        ASSERT_NE(pid, -1);
+        if (pid == 0)
+        {
+            const bool ok = runSelfPlayWorker("127.0.0.1", coordinator.getPort(), smallEngine(), smallEngine(),
+                                              config, ENGINES_KEY);
+            _exit(ok ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    const CoordinatorReport report = coordinator.run();
+    for (const pid_t pid : children)
+    {
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    EXPECT_EQ(report.workersSeen, static_cast<uint32_t>(WORKERS));
+    EXPECT_EQ(report.batchesDone, 12U);
+    EXPECT_EQ(report.batchesRetried, 0U);
+
+    // node-limited games do not depend on who plays them
+    SelfPlayConfig local = config;
+    local.numThreads = 2;
+    const SelfPlayReport alone = SelfPlayMatch{smallEngine(), smallEngine(), local}.run();
+    EXPECT_EQ(report.match.score.wins, alone.score.wins);
+    EXPECT_EQ(report.match.score.draws, alone.score.draws);
+    EXPECT_EQ(report.match.score.losses, alone.score.losses);
+    EXPECT_EQ(report.match.nodes, alone.nodes);
+}
+#endif
@@ -0,0 +1,74 @@
+#include "engine/Endgame.hpp"
+#include "engine/Search.hpp"
+#include <gtest/gtest.h>
+
+using namespace chk::engine;
+
+namespace
+{
+// the whole table is built by the compiler
+static_assert(ENDGAME_TABLE[materialIndex(12, 0, 12, 0)] == EndgameKind::NONE);
+static_assert(ENDGAME_TABLE[materialIndex(0, 2, 0, 1)] == EndgameKind::KINGS_WIN);
+static_assert(ENDGAME_TABLE[materialIndex(0, 1, 0, 2)] == EndgameKind::KINGS_WIN);
+static_assert(ENDGAME_TABLE[materialIndex(0, 2, 0, 2)] == EndgameKind::KINGS_DRAW);
+static_assert(ENDGAME_TABLE[materialIndex(3, 0, 2, 0)] == EndgameKind::TRADE_DOWN);
+static_assert(ENDGAME_TABLE[materialIndex(1, 1, 2, 0)] == EndgameKind::NONE); // a king for a man: too close
+static_assert(ENDGAME_TABLE[materialIndex(5, 0, 2, 0)] == EndgameKind::NONE); // past the bucket limit
+
+Position kings(const Bitboard red, const Bitboard black, const Side toMove)
+{
+    return Position{red, black, red | black, toMove};
+}
+} // namespace
+
+TEST(EndgameTests, Dispatch_MiddlegameStaysGeneric)
+{
+    EXPECT_EQ(endgameKind(Position::initial()), EndgameKind::NONE);
+    EXPECT_EQ(evaluate(Position::initial()), 0);
+}
+
+TEST(EndgameTests, KingsWin_RewardsHuntingAndBothSidesAgree)
+{
+    // two RED kings in the middle, the BLACK king in its double corner, or out on the long diagonal
+    const Bitboard hunters = bitOf(squareAt(3, 4)) | bitOf(squareAt(4, 3));
+    const Position cornered = kings(hunters, bitOf(squareAt(0, 1)), Side::RED);
+    const Position exposed = kings(hunters, bitOf(squareAt(2, 5)), Side::RED);
+    ASSERT_EQ(endgameKind(cornered), EndgameKind::KINGS_WIN);
+
+    EXPECT_GE(evaluate(cornered), KING_VALUE + ENDGAME_WIN_BONUS - 10);
+    EXPECT_GT(evaluate(exposed), evaluate(cornered)); // out of the corner and closer: nearer the win
+
+    // same position, BLACK to move: the mirror image of RED's view
+    const Position blackToMove = kings(hunters, bitOf(squareAt(2, 5)), Side::BLACK);
+    EXPECT_EQ(evaluate(blackToMove), -evaluate(exposed));
+}
+
+TEST(EndgameTests, KingsDraw_ScoresNearZero)
+{
+    const Position pos = kings(bitOf(squareAt(3, 4)), bitOf(squareAt(6, 1)), Side::RED);
+    ASSERT_EQ(endgameKind(pos), EndgameKind::KINGS_DRAW);
+    EXPECT_LE(std::abs(evaluate(pos)), 5);
+}
+
+TEST(EndgameTests, TradeDown_FewerPiecesIsBetterForTheSideAhead)
+{
+    // RED men are 3 vs 2, then 2 vs 1 after an exchange: same men-up margin, more of a win
+    const Bitboard red3 = bitOf(squareAt(5, 0)) | bitOf(squareAt(5, 2)) | bitOf(squareAt(5, 4));
+    const Bitboard black2 = bitOf(squareAt(2, 1)) | bitOf(squareAt(2, 3));
+    const Position before{red3, black2, 0, Side::RED};
+    const Position after{red3 & ~bitOf(squareAt(5, 4)), black2 & ~bitOf(squareAt(2, 3)), 0, Side::RED};
+    ASSERT_EQ(endgameKind(before), EndgameKind::TRADE_DOWN);
+    ASSERT_EQ(endgameKind(after), EndgameKind::TRADE_DOWN);
+    EXPECT_GT(evaluate(after), evaluate(before));
+    EXPECT_GT(evaluate(before), 0);
+    EXPECT_LT(evaluate(Position{before.red, before.black, 0, Side::BLACK}), 0);
+}
+
+TEST(EndgameTests, Search_ScoresTwoKingsAgainstOneAsAWin)
+{
+    // generic terms alone would call it one king up; the search sees the won ending
+    Searcher searcher;
+    const Position pos = kings(bitOf(squareAt(7, 0)) | bitOf(squareAt(7, 2)), bitOf(squareAt(0, 1)), Side::RED);
+    const SearchResult result = searcher.search(pos, SearchLimits{8, 0, 0});
+    EXPECT_GE(result.score, KING_VALUE + ENDGAME_WIN_BONUS);
+}
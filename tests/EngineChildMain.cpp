@@ -0,0 +1,14 @@
+// created 2026-10-18
+// Engine process used by EngineProcessTests: `SpaceCheckersEngineChild --engine-channel NAME`
+#include "engine/EngineProcess.hpp"
+#include <cstdlib>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3 || std::string{argv[1]} != chk::engine::ENGINE_CHANNEL_FLAG)
+    {
+        return EXIT_FAILURE;
+    }
+    return chk::engine::serveEngineChannel(argv[2]);
+}
@@ -0,0 +1,135 @@
+#include "engine/EngineProcess.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <csignal>
+#endif
+
+using namespace chk::engine;
+
+namespace
+{
+/**
+ * Poll until the runner is idle (or the deadline passes)
+ */
+bool waitUntilIdle(const SearchRunner &runner, const std::chrono::milliseconds deadline)
+{
+    const auto until = std::chrono::steady_clock::now() + deadline;
+    while (runner.isSearching() && std::chrono::steady_clock::now() < until)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return !runner.isSearching();
+}
+} // namespace
+
+TEST(EngineProcessTests, Channel_CarriesMessagesBothWaysAcrossTheRingEnd)
+{
+    SharedChannel client;
+    SharedChannel engine;
+    const std::string name = makeChannelName();
+    ASSERT_TRUE(client.create(name));
+    ASSERT_TRUE(engine.open(name));
+
+    // odd sizes, many times the ring: records straddle the end and the counters wrap often
+    ChannelMessage message;
+    std::array<uint8_t, 1001> payload{};
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        payload.fill(static_cast<uint8_t>(i));
+        ASSERT_TRUE(client.send(static_cast<uint16_t>(i), payload.data(), 1 + i % 1000));
+        ASSERT_TRUE(engine.receive(message));
+        ASSERT_EQ(message.type, static_cast<uint16_t>(i));
+        ASSERT_EQ(message.size, 1 + i % 1000);
+        EXPECT_EQ(message.bytes[message.size - 1], static_cast<uint8_t>(i));
+        ASSERT_TRUE(engine.send(7, i));
+        ASSERT_TRUE(client.receive(message));
+        EXPECT_EQ(message.as<uint32_t>(), i);
+    }
+    EXPECT_FALSE(engine.receive(message));
+
+    // a full ring refuses (rather than overwrites) until the reader catches up
+    int sent = 0;
+    while (client.send(1, payload.data(), static_cast<uint32_t>(payload.size())))
+    {
+        sent++;
+    }
+    EXPECT_GT(sent, 0);
+    ASSERT_TRUE(engine.receive(message));
+    EXPECT_TRUE(client.send(1, payload.data(), static_cast<uint32_t>(payload.size())));
+
+    const uint64_t before = engine.peerHeartbeat();
+    client.beat();
+    EXPECT_EQ(engine.peerHeartbeat(), before + 1);
+}
+
+TEST(EngineProcessTests, Search_RunsInChildProcess)
+{
+    EngineProcess engine{ENGINE_CHILD_PATH};
+    SearchLimits limits{};
+    limits.maxDepth = 6;
+    limits.multiPv = 2;
+    engine.start(Position::initial(), limits);
+    ASSERT_TRUE(waitUntilIdle(engine, std::chrono::seconds(10)));
+
+    const auto result = engine.getLatest(Position::initial());
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->depth, 6);
+    EXPECT_NE(result->bestMove, NULL_MOVE);
+    ASSERT_EQ(result->lines.size(), 2u);
+    EXPECT_EQ(result->lines.front().pv.front(), result->bestMove);
+    EXPECT_GT(result->stats.nodes, 0u);
+    EXPECT_EQ(engine.getRestarts(), 0u);
+
+    // same answer as searching in this process
+    Searcher searcher;
+    EXPECT_EQ(searcher.search(Position::initial(), limits).score, result->score);
+}
+
+#if !defined(_WIN32)
+TEST(EngineProcessTests, Crash_RestartsEngineAndFinishesSearch)
+{
+    EngineProcess engine{ENGINE_CHILD_PATH};
+    SearchLimits limits{};
+    limits.moveTimeMs = 300;
+    engine.start(Position::initial(), limits);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const int64_t first = engine.getProcessId();
+    ASSERT_NE(first, 0);
+    ASSERT_EQ(kill(static_cast<pid_t>(first), SIGKILL), 0);
+
+    ASSERT_TRUE(waitUntilIdle(engine, std::chrono::seconds(10)));
+    EXPECT_EQ(engine.getRestarts(), 1u);
+    EXPECT_TRUE(engine.isRunning());
+    EXPECT_NE(engine.getProcessId(), first);
+    const auto result = engine.getLatest(Position::initial());
+    ASSERT_TRUE(result.has_value());
+    EXPECT_NE(result->bestMove, NULL_MOVE);
+}
+#endif
+
+TEST(EngineProcessTests, Stop_EndsSearchAndNewSearchReplacesIt)
+{
+    EngineProcess engine{ENGINE_CHILD_PATH};
+    SearchLimits limits{};
+    limits.moveTimeMs = 10'000;
+    engine.start(Position::initial(), limits);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    engine.stop();
+    EXPECT_FALSE(engine.isSearching());
+
+    MoveList moves;
+    generateMoves(Position::initial(), moves);
+    const Position next = makeMove(Position::initial(), moves[0]);
+    limits.moveTimeMs = 0;
+    limits.maxDepth = 4;
+    engine.start(next, limits);
+    ASSERT_TRUE(waitUntilIdle(engine, std::chrono::seconds(10)));
+    EXPECT_FALSE(engine.getLatest(Position::initial()).has_value());
+    const auto result = engine.getLatest(next);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->depth, 4);
+}
@@ -0,0 +1,131 @@
+#include "engine/GameServer.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace chk::engine;
+
+namespace
+{
+/**
+ * Collects replies from the workers
+ */
+struct Replies
+{
+    std::mutex mutex;
+    std::vector<MoveRequest> received;
+
+    size_t count()
+    {
+        std::scoped_lock lock{this->mutex};
+        return this->received.size();
+    }
+
+    bool waitFor(const size_t expected)
+    {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (this->count() < expected && std::chrono::steady_clock::now() < until)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return this->count() >= expected;
+    }
+};
+
+ServerConfig smallServer(const int workers)
+{
+    ServerConfig config;
+    config.workers = workers;
+    config.hashMegabytes = 4;
+    config.maxMoveMs = 300;
+    return config;
+}
+
+MoveRequest requestFor(const uint64_t gameId, const int64_t remainingMs, const Position &pos = Position::initial())
+{
+    MoveRequest request{};
+    request.gameId = gameId;
+    request.pos = pos;
+    request.remainingMs = remainingMs;
+    return request;
+}
+} // namespace
+
+TEST(GameServerTests, Budget_ShareOfClockWithinLimits)
+{
+    Replies replies;
+    GameServer server{smallServer(1), [&replies](const MoveRequest &request, const SearchResult &) {
+                          std::scoped_lock lock{replies.mutex};
+                          replies.received.push_back(request);
+                      }};
+    EXPECT_EQ(server.budgetFor(requestFor(1, 0)), 300);      // untimed: the cap
+    EXPECT_EQ(server.budgetFor(requestFor(1, 3000)), 100);   // 1/30 of the clock
+    EXPECT_EQ(server.budgetFor(requestFor(1, 60'000)), 300); // capped
+    EXPECT_EQ(server.budgetFor(requestFor(1, 8)), 4);        // never more than half of what is left
+    MoveRequest withIncrement = requestFor(1, 3000);
+    withIncrement.incrementMs = 40;
+    EXPECT_EQ(server.budgetFor(withIncrement), 130);
+}
+
+TEST(GameServerTests, ManyGames_AllAnsweredWithinBudget)
+{
+    Replies replies;
+    GameServer server{smallServer(2), [&replies](const MoveRequest &request, const SearchResult &result) {
+                          EXPECT_NE(result.bestMove, NULL_MOVE);
+                          std::scoped_lock lock{replies.mutex};
+                          replies.received.push_back(request);
+                      }};
+    constexpr int games = 12;
+    for (int game = 1; game <= games; game++)
+    {
+        server.submit(requestFor(game, 1200)); // 40 ms each: far more work queued than 2 workers can think
+    }
+    ASSERT_TRUE(replies.waitFor(games));
+    const ServerMetrics metrics = server.getMetrics();
+    EXPECT_EQ(metrics.completed, static_cast<uint64_t>(games));
+    EXPECT_GE(metrics.peakQueued, static_cast<size_t>(games - 2)); // workers may take one each meanwhile
+    EXPECT_LT(metrics.maxMs, 40 + 100); // queued requests shorten their search instead of running late
+}
+
+TEST(GameServerTests, Queue_EarliestDeadlineFirst)
+{
+    Replies replies;
+    GameServer server{smallServer(1), [&replies](const MoveRequest &request, const SearchResult &) {
+                          std::scoped_lock lock{replies.mutex};
+                          replies.received.push_back(request);
+                      }};
+    server.submit(requestFor(1, 0)); // occupies the only worker for 300 ms
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    server.submit(requestFor(2, 0));    // 300 ms budget
+    server.submit(requestFor(3, 1500)); // 50 ms budget: must jump the queue
+    ASSERT_TRUE(replies.waitFor(3));
+    EXPECT_EQ(replies.received[0].gameId, 1u);
+    EXPECT_EQ(replies.received[1].gameId, 3u);
+    EXPECT_EQ(replies.received[2].gameId, 2u);
+}
+
+TEST(GameServerTests, Resubmit_ReplacesAndCancelSilences)
+{
+    Replies replies;
+    GameServer server{smallServer(1), [&replies](const MoveRequest &request, const SearchResult &) {
+                          std::scoped_lock lock{replies.mutex};
+                          replies.received.push_back(request);
+                      }};
+    MoveList moves;
+    generateMoves(Position::initial(), moves);
+    const Position later = makeMove(Position::initial(), moves[0]);
+
+    server.submit(requestFor(1, 0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    server.submit(requestFor(2, 0));
+    server.submit(requestFor(2, 0, later)); // game 2 moved on before it was served
+    server.cancel(1);                       // game 1 ended while its search was running
+    ASSERT_TRUE(replies.waitFor(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(replies.count(), 1u);
+    EXPECT_EQ(replies.received[0].gameId, 2u);
+    EXPECT_EQ(replies.received[0].pos, later);
+    EXPECT_EQ(server.getMetrics().cancelled, 2u);
+}
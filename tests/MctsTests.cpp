@@ -0,0 +1,149 @@
+#include "engine/AsyncMcts.hpp"
+#include "engine/Mcts.hpp"
+#include <algorithm>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace chk::engine;
+
+namespace
+{
+// RED man on cell 14 can jump the last BLACK man on cell 18
+const Position LAST_PIECE_HANGING{bitOf(toSquare(14)), bitOf(toSquare(18)), 0, Side::RED};
+
+bool isLegal(const Position &pos, const Move &move)
+{
+    MoveList legal;
+    generateMoves(pos, legal);
+    return std::find(legal.begin(), legal.end(), move) != legal.end();
+}
+} // namespace
+
+TEST(MctsTests, Search_FindsWinningCapture)
+{
+    MctsSearcher mcts;
+    const MctsResult result = mcts.search(LAST_PIECE_HANGING, SearchLimits{0, 500, 0});
+    EXPECT_TRUE(result.bestMove.isCapture());
+    EXPECT_DOUBLE_EQ(result.winRate, 1.0);
+}
+
+TEST(MctsTests, Search_ParallelReturnsLegalMove)
+{
+    MctsConfig config;
+    config.numThreads = 4;
+    config.policy = PlayoutPolicy::GREEDY;
+    MctsSearcher mcts{config};
+    const MctsResult result = mcts.search(Position::initial(), SearchLimits{0, 2000, 0});
+    EXPECT_TRUE(isLegal(Position::initial(), result.bestMove));
+    EXPECT_GE(result.playouts, 2000u);
+    EXPECT_EQ(result.rootVisits, result.playouts);
+    EXPECT_FALSE(result.pv.empty());
+}
+
+TEST(MctsTests, Search_ReusesSubtreeOfPlayedMoves)
+{
+    MctsSearcher mcts;
+    const MctsResult first = mcts.search(Position::initial(), SearchLimits{0, 5000, 0});
+    ASSERT_GE(first.pv.size(), 2u);
+    const Position afterMine = makeMove(Position::initial(), first.pv[0]);
+    const Position afterReply = makeMove(afterMine, first.pv[1]);
+
+    const MctsResult second = mcts.search(afterReply, SearchLimits{0, 1000, 0});
+    EXPECT_GT(second.reusedNodes, 1u);
+    EXPECT_GT(second.rootVisits, second.playouts);
+    EXPECT_TRUE(isLegal(afterReply, second.bestMove));
+}
+
+TEST(MctsTests, Search_FullArenaStillWorks)
+{
+    MctsConfig config;
+    config.maxTreeNodes = 50;
+    MctsSearcher mcts{config};
+    const MctsResult result = mcts.search(Position::initial(), SearchLimits{0, 1000, 0});
+    EXPECT_LE(result.treeNodes, 50u);
+    EXPECT_TRUE(isLegal(Position::initial(), result.bestMove));
+}
+
+TEST(MctsTests, Search_ExpandsOneNodePerPlayout)
+{
+    MctsConfig config;
+    config.reuseTree = false;
+    MctsSearcher mcts{config};
+    MoveList rootMoves;
+    generateMoves(Position::initial(), rootMoves);
+
+    // first playout: the root's children, nothing below them
+    EXPECT_EQ(mcts.search(Position::initial(), SearchLimits{0, 1, 0}).treeNodes, 1 + rootMoves.size());
+    uint32_t previous = 1;
+    for (uint64_t playouts = 1; playouts <= 40; playouts++)
+    {
+        const uint32_t nodes = mcts.search(Position::initial(), SearchLimits{0, playouts, 0}).treeNodes;
+        EXPECT_LE(nodes - previous, MoveList::MAX_MOVES) << "after " << playouts << " playouts";
+        previous = nodes;
+    }
+}
+
+TEST(MctsTests, Search_ReusedTreeKeepsVisitCounts)
+{
+    MctsSearcher mcts;
+    const MctsResult first = mcts.search(Position::initial(), SearchLimits{0, 3000, 0});
+    const MctsResult again = mcts.search(Position::initial(), SearchLimits{0, 500, 0});
+    EXPECT_EQ(again.rootVisits, first.rootVisits + 500);
+
+    // one ply down: the played move's node becomes the root, with every visit it had
+    const Position afterBest = makeMove(Position::initial(), again.bestMove);
+    const MctsResult below = mcts.search(afterBest, SearchLimits{0, 1, 0});
+    EXPECT_GT(below.reusedNodes, 1u);
+    EXPECT_EQ(below.rootVisits, again.bestVisits + 1);
+}
+
+TEST(MctsTests, AsyncMcts_PondersOnOpponentTime)
+{
+    AsyncMcts engine;
+    engine.start(Position::initial(), SearchLimits{0, 500, 0});
+    while (engine.isSearching())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto played = engine.getLatest(Position::initial());
+    ASSERT_TRUE(played.has_value());
+    ASSERT_TRUE(isLegal(Position::initial(), played->bestMove));
+
+    // the opponent thinks: the tree grows meanwhile, but nothing is published
+    const Position theirTurn = makeMove(Position::initial(), played->bestMove);
+    engine.ponder(theirTurn);
+    EXPECT_TRUE(engine.isPondering());
+    EXPECT_FALSE(engine.isSearching());
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((!engine.getLatestTree().has_value() || engine.getLatestTree()->playouts < 200) &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_FALSE(engine.getLatest(theirTurn).has_value());
+
+    // their reply was searched while they thought about it
+    MoveList replies;
+    generateMoves(theirTurn, replies);
+    const Position ourTurn = makeMove(theirTurn, replies[0]);
+    engine.start(ourTurn, SearchLimits{0, 100, 0});
+    while (engine.isSearching())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_FALSE(engine.isPondering());
+    const auto tree = engine.getLatestTree();
+    ASSERT_TRUE(tree.has_value());
+    EXPECT_GT(tree->reusedNodes, 1u);
+    EXPECT_GT(tree->rootVisits, tree->playouts);
+    EXPECT_TRUE(isLegal(ourTurn, engine.getLatest(ourTurn)->bestMove));
+}
+
+TEST(MctsTests, WinRate_ConvertsToScore)
+{
+    EXPECT_EQ(winRateToScore(0.5), 0);
+    EXPECT_GT(winRateToScore(0.7), 0);
+    EXPECT_EQ(winRateToScore(0.3), -winRateToScore(0.7));
+    EXPECT_LT(winRateToScore(1.0), SCORE_WIN - MAX_PLY); // never shown as a forced win
+}
@@ -0,0 +1,74 @@
+#include "engine/MoveGen.hpp"
+#include "engine/Pdn.hpp"
+#include <gtest/gtest.h>
+
+using namespace chk::engine;
+
+TEST(MoveGenTests, Perft_MatchesKnownValues)
+{
+    // reference values for English draughts from the standard start
+    EXPECT_EQ(perft(Position::initial(), 1), 7u);
+    EXPECT_EQ(perft(Position::initial(), 4), 1469u);
+    EXPECT_EQ(perft(Position::initial(), 7), 179740u);
+}
+
+TEST(MoveGenTests, Capture_IsCompulsory)
+{
+    // RED man on cell 9, BLACK man on cell 14 (diagonally ahead of 9): RED must jump to 18
+    const Position pos{bitOf(toSquare(9)) | bitOf(toSquare(1)), bitOf(toSquare(14)), 0, Side::RED};
+    MoveList list;
+    generateMoves(pos, list);
+    ASSERT_EQ(list.size(), 1u);
+    EXPECT_TRUE(list[0].isCapture());
+    EXPECT_EQ(toNotation(pos, list[0]), "9x18");
+}
+
+TEST(MoveGenTests, ParseMove_RoundTripsNotation)
+{
+    const Position start = Position::initial();
+    const auto move = parseMove(start, "11-15");
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(toNotation(start, move.value()), "11-15");
+    EXPECT_FALSE(parseMove(start, "11-20").has_value());
+}
+
+TEST(MoveGenTests, Fen_RoundTrips)
+{
+    const auto start = parseFen("B:W21-32:B1-12");
+    ASSERT_TRUE(start.has_value());
+    EXPECT_EQ(start.value(), Position::initial());
+
+    const auto pos = parseFen("\"W:WK3,21:B9,K28.\"");
+    ASSERT_TRUE(pos.has_value());
+    EXPECT_EQ(pos->sideToMove, Side::BLACK);
+    EXPECT_EQ(pos->red, bitOf(toSquare(9)) | bitOf(toSquare(28)));
+    EXPECT_EQ(pos->black, bitOf(toSquare(3)) | bitOf(toSquare(21)));
+    EXPECT_EQ(pos->kings, bitOf(toSquare(3)) | bitOf(toSquare(28)));
+    EXPECT_EQ(parseFen(toFen(pos.value())), pos);
+
+    EXPECT_FALSE(parseFen("X:W1:B2").has_value());
+    EXPECT_FALSE(parseFen("B:W1,33:B2").has_value());
+    EXPECT_FALSE(parseFen("B:W1:B1").has_value());
+    EXPECT_FALSE(parseFen("B:W21:B9,30").has_value()); // RED man on its crown row
+    EXPECT_FALSE(parseFen("W:W2,21:B9").has_value());  // BLACK man on its crown row
+    EXPECT_TRUE(parseFen("B:WK2:BK30").has_value());
+}
+
+TEST(MoveGenTests, KingCaptureLoop_EndsOnStartSquareOnce)
+{
+    // RED king on cell 27 jumps 23, 15, 16 and 24 and lands back on 27: one move, whichever way round the loop
+    const Position pos = parseFen("B:W5,15,16,23,24:BK27").value();
+    MoveList list;
+    generateMoves(pos, list);
+    ASSERT_EQ(list.size(), 1u);
+    const Move loop = list[0];
+    EXPECT_EQ(loop.from, toSquare(27));
+    EXPECT_EQ(loop.to, toSquare(27));
+    EXPECT_EQ(popCount(loop.captured), 4);
+
+    const Position next = makeMove(pos, loop);
+    EXPECT_EQ(next.red, bitOf(toSquare(27)));
+    EXPECT_EQ(next.kings, bitOf(toSquare(27)));
+    EXPECT_EQ(next.black, bitOf(toSquare(5)));
+    EXPECT_EQ(perft(pos, 1), 1u);
+}
@@ -0,0 +1,73 @@
+#include "engine/Pdn.hpp"
+#include "engine/Search.hpp"
+#include <gtest/gtest.h>
+
+using namespace chk::engine;
+
+TEST(MoveOrderingTests, Order_HashMoveThenLongerCaptures)
+{
+    // RED king on 14 can take 18 then 27 (double jump), or 17 alone
+    const Position pos = parseFen("B:W17,18,27:BK14").value();
+    MoveList moves;
+    generateMoves(pos, moves);
+    ASSERT_GE(moves.size(), 2u);
+
+    MoveOrderer orderer;
+    orderer.order(pos, moves, NULL_MOVE, 0);
+    EXPECT_EQ(popCount(moves[0].captured), 2);
+    for (size_t i = 1; i < moves.size(); i++)
+    {
+        EXPECT_GE(popCount(moves[i - 1].captured), popCount(moves[i].captured));
+    }
+    const Move shortest = moves[moves.size() - 1];
+    orderer.order(pos, moves, shortest, 0);
+    EXPECT_EQ(moves[0], shortest);
+}
+
+TEST(MoveOrderingTests, Cutoff_QuietMoveBecomesKillerAndGainsHistory)
+{
+    const Position pos = Position::initial();
+    MoveList moves;
+    generateMoves(pos, moves);
+    const Move cutter = moves[moves.size() - 1];
+
+    MoveOrderer orderer;
+    orderer.onCutoff(pos, moves, moves.size() - 1, 6, 3);
+    EXPECT_GT(orderer.getHistory(pos.sideToMove, cutter), 0);
+    EXPECT_LT(orderer.getHistory(pos.sideToMove, moves[0]), 0);
+    orderer.order(pos, moves, NULL_MOVE, 3);
+    EXPECT_EQ(moves[0], cutter);
+
+    // killers are per search, history only fades
+    orderer.newSearch();
+    EXPECT_GT(orderer.getHistory(pos.sideToMove, cutter), 0);
+    OrderingConfig historyOff{};
+    historyOff.history = false;
+    MoveOrderer noHistory{historyOff};
+    noHistory.onCutoff(pos, moves, 0, 6, 3);
+    EXPECT_EQ(noHistory.getHistory(pos.sideToMove, moves[0]), 0);
+}
+
+TEST(MoveOrderingTests, Heuristics_SameScoreWithFewerNodes)
+{
+    // without a table, a full-window search to fixed depth scores the same in any move order
+    SearchConfig plain{};
+    plain.ordering = OrderingConfig{false, false, false, false};
+    Searcher unordered{plain};
+    Searcher ordered;
+    SearchLimits limits{};
+    limits.maxDepth = 8;
+    Position pos = Position::initial();
+    uint64_t unorderedNodes = 0;
+    uint64_t orderedNodes = 0;
+    for (int ply = 0; ply < 6; ply++)
+    {
+        const SearchResult a = unordered.search(pos, limits);
+        const SearchResult b = ordered.search(pos, limits);
+        EXPECT_EQ(a.score, b.score) << "ply " << ply;
+        unorderedNodes += a.stats.nodes;
+        orderedNodes += b.stats.nodes;
+        pos = makeMove(pos, b.bestMove);
+    }
+    EXPECT_LT(orderedNodes, unorderedNodes);
+}
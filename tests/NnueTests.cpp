@@ -0,0 +1,91 @@
+#include "engine/Nnue.hpp"
+#include "engine/Search.hpp"
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace chk::engine;
+
+TEST(NnueTests, DefaultNetwork_InitialPositionIsBalanced)
+{
+    const auto net = NnueNetwork::createDefault();
+    ASSERT_NE(net, nullptr);
+    EXPECT_EQ(net->evaluate(Position::initial()), 0);
+}
+
+TEST(NnueTests, DefaultNetwork_PrefersExtraMaterial)
+{
+    const auto net = NnueNetwork::createDefault();
+    ASSERT_NE(net, nullptr);
+    Position pos = Position::initial();
+    pos.black &= ~bitOf(toSquare(32)); // BLACK is a man short
+    EXPECT_GT(net->evaluate(pos), 0);
+    pos.sideToMove = Side::BLACK;
+    EXPECT_LT(net->evaluate(pos), 0);
+}
+
+TEST(NnueTests, IncrementalUpdate_MatchesRefresh)
+{
+    const auto net = NnueNetwork::createDefault();
+    ASSERT_NE(net, nullptr);
+    std::mt19937 rng{42};
+    for (int game = 0; game < 20; game++)
+    {
+        Position pos = Position::initial();
+        Accumulator acc;
+        net->refresh(pos, acc);
+        for (int ply = 0; ply < 150; ply++)
+        {
+            MoveList moves;
+            generateMoves(pos, moves);
+            if (moves.empty())
+            {
+                break;
+            }
+            const Move move = moves[static_cast<int>(rng() % moves.size())];
+            Accumulator child;
+            net->update(acc, child, pos, move);
+            pos = makeMove(pos, move);
+
+            Accumulator fresh;
+            net->refresh(pos, fresh);
+            ASSERT_EQ(std::memcmp(child.values, fresh.values, sizeof(fresh.values)), 0) << "game " << game;
+            EXPECT_EQ(net->evaluate(child, pos.sideToMove), net->evaluate(pos));
+            acc = child;
+        }
+    }
+}
+
+TEST(NnueTests, SaveAndLoad_RoundTrip)
+{
+    const auto net = NnueNetwork::createDefault();
+    ASSERT_NE(net, nullptr);
+    const std::string path = testing::TempDir() + "nnue_roundtrip.scnn";
+    ASSERT_TRUE(net->save(path));
+
+    const auto loaded = NnueNetwork::load(path);
+    ASSERT_NE(loaded, nullptr);
+    Position pos = Position::initial();
+    pos.red &= ~bitOf(toSquare(9));
+    EXPECT_EQ(loaded->evaluate(pos), net->evaluate(pos));
+    std::remove(path.c_str());
+}
+
+TEST(NnueTests, Load_RejectsBadFile)
+{
+    EXPECT_EQ(NnueNetwork::fromBytes(std::vector<uint8_t>(NNUE_FILE_SIZE, 0)), nullptr);
+    EXPECT_EQ(NnueNetwork::fromBytes(std::vector<uint8_t>(16, 0)), nullptr);
+}
+
+TEST(NnueTests, Search_UsesNetwork)
+{
+    const auto net = NnueNetwork::createDefault();
+    Searcher searcher;
+    searcher.setNetwork(net.get());
+    const SearchResult result = searcher.search(Position::initial(), SearchLimits{6, 0, 0});
+    MoveList legal;
+    generateMoves(Position::initial(), legal);
+    EXPECT_NE(std::find(legal.begin(), legal.end(), result.bestMove), legal.end());
+    EXPECT_EQ(result.depth, 6);
+}
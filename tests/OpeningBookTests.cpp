@@ -0,0 +1,55 @@
+#include "engine/OpeningBook.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace chk::engine;
+
+TEST(OpeningBookTests, BuildFromPdn_ThenLookup)
+{
+    std::istringstream pdn{"[Event \"a\"]\n[Result \"1-0\"]\n1. 11-15 23-19 2. 8-11 22-17 1-0\n\n"
+                           "[Event \"b\"]\n1. 11-15 24-20 {comment} 2. 8-11 0-1\n\n"
+                           "[Event \"c\"]\n1. 9-13 22-18 1/2-1/2\n"};
+    OpeningBookBuilder builder{8};
+    EXPECT_EQ(builder.addPdn(pdn), 3u);
+
+    const auto path = (std::filesystem::temp_directory_path() / "test_book.scbk").string();
+    ASSERT_TRUE(builder.save(path));
+
+    OpeningBook book;
+    ASSERT_TRUE(book.open(path));
+    const Position start = Position::initial();
+    const BookRange range = book.lookup(start);
+    ASSERT_FALSE(range.empty());
+    // 11-15: one win (2) + one loss (0), 9-13: one draw (1)
+    EXPECT_EQ(toNotation(start, range.begin()->toMove()), "11-15");
+    EXPECT_EQ(range.begin()->weight, 2);
+
+    std::mt19937 rng{42};
+    const auto picked = book.pickMove(start, rng);
+    ASSERT_TRUE(picked.has_value());
+    EXPECT_FALSE(book.lookup(makeMove(start, picked.value())).empty());
+    std::filesystem::remove(path);
+}
+
+TEST(OpeningBookTests, AddGame_FromOpeningPosition)
+{
+    const Position opening = makeMove(Position::initial(), parseMove(Position::initial(), "9-13").value());
+    OpeningBookBuilder builder;
+    ASSERT_TRUE(builder.addGame({parseMove(opening, "22-18").value(), parseMove(Position::initial(), "11-15").value()},
+                                GameResult::BLACK_WIN, opening));
+    const auto path = (std::filesystem::temp_directory_path() / "test_opening_book.scbk").string();
+    ASSERT_TRUE(builder.save(path));
+
+    OpeningBook book;
+    ASSERT_TRUE(book.open(path));
+    EXPECT_TRUE(book.lookup(Position::initial()).empty()); // the game started later
+    const BookRange range = book.lookup(opening);
+    ASSERT_FALSE(range.empty());
+    EXPECT_EQ(toNotation(opening, range.begin()->toMove()), "22-18");
+    EXPECT_EQ(range.begin()->weight, 2);
+    book.close();
+    EXPECT_FALSE(book.isOpen());
+    EXPECT_TRUE(book.lookup(opening).empty());
+    std::filesystem::remove(path);
+}
@@ -28,3 +28,14 @@ TEST(PieceTests, MoveSimple_ValidRedMove_ReturnsTrue)
     sf::Vector2f dest{75.0f, 75.0f};
     EXPECT_TRUE(piece.moveSimple(dest));
 }
+
+TEST(PieceTests, MoveCapture_ChainedJumpsInOneFrame_ReturnsTrue)
+{
+    sf::CircleShape circle{0.5 * chk::SIZE_CELL};
+    circle.setPosition(300.0f, 450.0f);
+    chk::Piece piece{circle, chk::PieceType::Red, 1};
+
+    // second jump starts where the first one lands, though no frame has animated the slide yet
+    EXPECT_TRUE(piece.moveCapture(sf::Vector2f{150.0f, 300.0f}));
+    EXPECT_TRUE(piece.moveCapture(sf::Vector2f{0.0f, 150.0f}));
+}
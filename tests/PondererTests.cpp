@@ -0,0 +1,83 @@
+#include "engine/Ponderer.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace chk::engine;
+
+namespace
+{
+/**
+ * Poll until `done` returns true, or give up after 10 seconds
+ */
+template <typename Fn> bool waitFor(Fn &&done)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+} // namespace
+
+TEST(PondererTests, Hit_KeepsWarmSearch)
+{
+    Ponderer ponderer{SearchConfig{}, 20};
+    ponderer.start(Position::initial());
+    ASSERT_TRUE(waitFor([&] { return ponderer.getPrediction().has_value(); }));
+    const Position predicted = ponderer.getPrediction().value();
+
+    EXPECT_EQ(ponderer.onOpponentMove(predicted, 50), PonderOutcome::HIT);
+    ASSERT_TRUE(waitFor([&] { return !ponderer.isSearching(); }));
+    const auto latest = ponderer.getLatest(predicted);
+    ASSERT_TRUE(latest.has_value());
+    EXPECT_NE(latest->bestMove, NULL_MOVE);
+}
+
+TEST(PondererTests, Miss_RestartsOnActualPosition)
+{
+    Ponderer ponderer{SearchConfig{}, 20};
+    ponderer.start(Position::initial());
+    ASSERT_TRUE(waitFor([&] { return ponderer.getPrediction().has_value(); }));
+    const Position predicted = ponderer.getPrediction().value();
+
+    MoveList moves;
+    generateMoves(Position::initial(), moves);
+    Position actual = makeMove(Position::initial(), moves[0]);
+    if (actual == predicted)
+    {
+        actual = makeMove(Position::initial(), moves[1]);
+    }
+    EXPECT_EQ(ponderer.onOpponentMove(actual, 50), PonderOutcome::MISS);
+    EXPECT_FALSE(ponderer.getLatest(predicted).has_value());
+    ASSERT_TRUE(waitFor([&] { return !ponderer.isSearching(); }));
+    const auto latest = ponderer.getLatest(actual);
+    ASSERT_TRUE(latest.has_value());
+    MoveList legal;
+    generateMoves(actual, legal);
+    EXPECT_NE(std::find(legal.begin(), legal.end(), latest->bestMove), legal.end());
+}
+
+TEST(PondererTests, NotPondering_StartsFreshSearch)
+{
+    Ponderer ponderer;
+    EXPECT_EQ(ponderer.onOpponentMove(Position::initial(), 20), PonderOutcome::IDLE);
+    ASSERT_TRUE(waitFor([&] { return !ponderer.isSearching(); }));
+    EXPECT_TRUE(ponderer.getLatest(Position::initial()).has_value());
+}
+
+TEST(PondererTests, Stop_IsPrompt)
+{
+    Ponderer ponderer;
+    ponderer.start(Position::initial());
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const auto before = std::chrono::steady_clock::now();
+    ponderer.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - before, std::chrono::milliseconds(500));
+    EXPECT_FALSE(ponderer.isSearching());
+}
@@ -0,0 +1,90 @@
+#include "engine/Pdn.hpp"
+#include "engine/ProofSearch.hpp"
+#include <gtest/gtest.h>
+
+using namespace chk::engine;
+
+namespace
+{
+ProofConfig smallConfig()
+{
+    ProofConfig config;
+    config.maxNodes = 2'000'000;
+    config.memoryMegabytes = 128;
+    return config;
+}
+} // namespace
+
+TEST(ProofSearchTests, Prove_FindsWinningLine)
+{
+    ProofSearcher searcher{smallConfig()};
+    const Position pos = parseFen("B:WK29:BK14,K18").value(); // 18-22 forces a two-for-one
+    const ProofOutcome outcome = searcher.prove(pos);
+    ASSERT_EQ(outcome.result, ProofResult::PROVEN);
+    EXPECT_EQ(toNotation(pos, outcome.bestMove), "18-22");
+
+    // line is legal, and leaves the defender without a move
+    Position linePos = pos;
+    for (const Move &move : outcome.line)
+    {
+        MoveList legal;
+        generateMoves(linePos, legal);
+        ASSERT_NE(std::find(legal.begin(), legal.end(), move), legal.end());
+        linePos = makeMove(linePos, move);
+    }
+    MoveList replies;
+    generateMoves(linePos, replies);
+    EXPECT_TRUE(replies.empty());
+    EXPECT_EQ(linePos.sideToMove, Side::BLACK);
+}
+
+TEST(ProofSearchTests, Prove_DisprovesDrawsAndLosses)
+{
+    ProofSearcher searcher{smallConfig()};
+    EXPECT_EQ(searcher.prove(parseFen("B:WK29:BK14").value()).result, ProofResult::DISPROVEN);   // king vs king
+    EXPECT_EQ(searcher.prove(parseFen("B:W8,11:B4").value()).result, ProofResult::DISPROVEN);    // no move at all
+    EXPECT_EQ(searcher.prove(parseFen("W:WK1:BK27,K32").value()).result, ProofResult::DISPROVEN); // outnumbered
+    EXPECT_EQ(searcher.prove(parseFen("W:W8,11:B4").value()).result, ProofResult::PROVEN);
+}
+
+TEST(ProofSearchTests, Prove_ReusesSolvedPositionsFromTable)
+{
+    const Position pos = parseFen("B:WK5:BK19,K23,K27").value();
+    ProofSearcher plain{smallConfig()};
+    const ProofOutcome cold = plain.prove(pos);
+    ASSERT_EQ(cold.result, ProofResult::PROVEN);
+
+    TranspositionTable tt{4};
+    ProofSearcher searcher{smallConfig()};
+    searcher.setTranspositionTable(&tt);
+    const ProofOutcome first = searcher.prove(pos);
+    EXPECT_EQ(first.result, ProofResult::PROVEN);
+    EXPECT_GT(first.ttHits, 0U); // transpositions within the tree
+    EXPECT_LT(first.nodes, cold.nodes);
+    const ProofOutcome again = searcher.prove(pos);
+    EXPECT_EQ(again.result, ProofResult::PROVEN);
+    EXPECT_LE(again.nodes, 64U); // root's children are all solved already
+
+    // the other side's question about the same positions is kept apart
+    const Position flipped{pos.red, pos.black, pos.kings, Side::BLACK};
+    EXPECT_EQ(searcher.prove(flipped).result, ProofResult::DISPROVEN);
+}
+
+TEST(ProofSearchTests, Prove_StopsWithinBudgets)
+{
+    const Position pos = parseFen("B:WK1:BK27,K32").value(); // a win, but takes about 2M nodes
+    ProofConfig config = smallConfig();
+    config.maxNodes = 5000;
+    ProofSearcher byNodes{config};
+    const ProofOutcome outcome = byNodes.prove(pos);
+    EXPECT_EQ(outcome.result, ProofResult::UNKNOWN);
+    EXPECT_LT(outcome.nodes, 5100U);
+    EXPECT_GT(outcome.rootProof, 0U);
+
+    config.maxNodes = 0;
+    config.memoryMegabytes = 1;
+    ProofSearcher byMemory{config};
+    const ProofOutcome full = byMemory.prove(pos);
+    EXPECT_EQ(full.result, ProofResult::UNKNOWN);
+    EXPECT_TRUE(full.outOfMemory);
+}
@@ -0,0 +1,190 @@
+#include "engine/OpeningBook.hpp"
+#include "engine/Pdn.hpp"
+#include "engine/Protocol.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace chk::engine;
+
+namespace
+{
+size_t countLines(const std::string &text, const std::string &prefix)
+{
+    size_t count = 0;
+    std::istringstream in{text};
+    for (std::string line; std::getline(in, line);)
+    {
+        count += line.rfind(prefix, 0) == 0 ? 1 : 0;
+    }
+    return count;
+}
+} // namespace
+
+TEST(ProtocolTests, Handshake)
+{
+    std::ostringstream out;
+    EngineProtocol protocol{out};
+    EXPECT_TRUE(protocol.handleLine("uci"));
+    EXPECT_TRUE(protocol.handleLine("isready"));
+    EXPECT_NE(out.str().find("uciok\n"), std::string::npos);
+    EXPECT_NE(out.str().find("readyok\n"), std::string::npos);
+    EXPECT_FALSE(protocol.handleLine("quit"));
+}
+
+TEST(ProtocolTests, Position_AppliesMoves)
+{
+    std::ostringstream out;
+    EngineProtocol protocol{out};
+    protocol.handleLine("position startpos moves 11-15 22-18 15x22");
+    protocol.handleLine("d");
+    Position expected = Position::initial();
+    for (const char *move : {"11-15", "22-18", "15x22"})
+    {
+        expected = makeMove(expected, parseMove(expected, move).value());
+    }
+    EXPECT_NE(out.str().find("fen " + toFen(expected)), std::string::npos);
+}
+
+TEST(ProtocolTests, Go_ReportsInfoAndBestMove)
+{
+    std::ostringstream out;
+    EngineProtocol protocol{out};
+    protocol.handleLine("position fen B:W21-32:B1-12");
+    protocol.handleLine("go depth 4 multipv 3");
+    protocol.waitForSearch();
+    const std::string text = out.str();
+    EXPECT_EQ(countLines(text, "info depth 4 multipv "), 3u);
+    EXPECT_EQ(countLines(text, "bestmove "), 1u);
+    const size_t best = text.find("bestmove ");
+    const std::string move = text.substr(best + 9, text.find_first_of(" \n", best + 9) - best - 9);
+    EXPECT_TRUE(parseMove(Position::initial(), move).has_value());
+
+    protocol.handleLine("stats");
+    EXPECT_EQ(countLines(out.str(), "stats {\"depth\":4,"), 1u);
+}
+
+TEST(ProtocolTests, Stop_EndsInfiniteSearch)
+{
+    std::ostringstream out;
+    EngineProtocol protocol{out};
+    protocol.handleLine("go infinite");
+    protocol.handleLine("stop");
+    EXPECT_EQ(countLines(out.str(), "bestmove "), 1u);
+}
+
+TEST(ProtocolTests, BadInputIsReported)
+{
+    std::ostringstream out;
+    EngineProtocol protocol{out};
+    protocol.handleLine("position startpos moves 11-20");
+    protocol.handleLine("frobnicate");
+    EXPECT_NE(out.str().find("info string illegal move 11-20"), std::string::npos);
+    EXPECT_NE(out.str().find("info string unknown command frobnicate"), std::string::npos);
+}
+
+TEST(ProtocolTests, HashFile_PersistsAcrossSessions)
+{
+    const std::string path = "protocol_hash.bin";
+    std::remove(path.c_str());
+    std::ostringstream first;
+    {
+        EngineProtocol protocol{first};
+        protocol.handleLine("setoption name Hash value 2");
+        protocol.handleLine("setoption name HashFile value " + path);
+        protocol.handleLine("go depth 8");
+        protocol.waitForSearch();
+        EXPECT_FALSE(protocol.handleLine("quit")); // saves
+    }
+    std::ostringstream second;
+    EngineProtocol protocol{second};
+    protocol.handleLine("setoption name Hash value 2");
+    protocol.handleLine("setoption name HashFile value " + path); // loads
+    protocol.handleLine("go depth 8");
+    protocol.waitForSearch();
+    std::remove(path.c_str());
+    EXPECT_EQ(second.str().find("cannot"), std::string::npos);
+
+    // warm session reaches depth 8 with far fewer nodes
+    const auto nodesAtDepth8 = [](const std::string &text) {
+        const size_t info = text.find("info depth 8 ");
+        const size_t nodes = text.find(" nodes ", info) + 7;
+        return std::stoull(text.substr(nodes, text.find(' ', nodes) - nodes));
+    };
+    EXPECT_LT(nodesAtDepth8(second.str()), nodesAtDepth8(first.str()) / 2);
+}
+
+TEST(ProtocolTests, BookFile_PlaysBookMovesWithoutSearching)
+{
+    const std::string path = "protocol_test.book";
+    OpeningBookBuilder builder;
+    const Position start = Position::initial();
+    ASSERT_TRUE(builder.addGame({parseMove(start, "11-15").value()}, GameResult::RED_WIN));
+    ASSERT_TRUE(builder.save(path));
+
+    std::ostringstream out;
+    EngineProtocol protocol{out};
+    protocol.handleLine("setoption name BookFile value " + path);
+    protocol.handleLine("position startpos");
+    protocol.handleLine("go depth 6");
+    protocol.waitForSearch();
+    EXPECT_NE(out.str().find("info string book move\nbestmove 11-15\n"), std::string::npos);
+    EXPECT_EQ(countLines(out.str(), "info depth"), 0u);
+
+    // out of book, or asked for analysis: search as usual
+    protocol.handleLine("position startpos moves 11-15");
+    protocol.handleLine("go depth 3");
+    protocol.waitForSearch();
+    protocol.handleLine("position startpos");
+    protocol.handleLine("go depth 3 multipv 2");
+    protocol.waitForSearch();
+    EXPECT_EQ(countLines(out.str(), "bestmove"), 3u);
+    EXPECT_EQ(countLines(out.str(), "info string book move"), 1u);
+
+    protocol.handleLine("setoption name BookFile value <empty>");
+    protocol.handleLine("go depth 2");
+    protocol.waitForSearch();
+    EXPECT_EQ(countLines(out.str(), "info string book move"), 1u);
+    std::remove(path.c_str());
+}
+
+TEST(ProtocolTests, LogTime_ReportsTimeManagerDecisions)
+{
+    std::ostringstream out;
+    EngineProtocol protocol{out};
+    protocol.handleLine("go time 60000 depth 4");
+    protocol.waitForSearch();
+    EXPECT_EQ(countLines(out.str(), "info string time"), 0u); // off by default
+
+    protocol.handleLine("setoption name LogTime value true");
+    protocol.handleLine("go time 60000 depth 4");
+    protocol.waitForSearch();
+    EXPECT_EQ(countLines(out.str(), "info string time budget optimum "), 1u);
+    EXPECT_EQ(countLines(out.str(), "info string time depth "), 4u);
+    EXPECT_EQ(countLines(out.str(), "info string time depth 4 "), 1u);
+
+    protocol.handleLine("go depth 4"); // no clock: nothing to manage
+    protocol.waitForSearch();
+    EXPECT_EQ(countLines(out.str(), "info string time"), 5u);
+}
+
+TEST(ProtocolTests, EngineMode_SearchesWithMcts)
+{
+    std::ostringstream out;
+    EngineProtocol protocol{out};
+    protocol.handleLine("setoption name EngineMode value mcts");
+    protocol.handleLine("go nodes 2000");
+    protocol.waitForSearch();
+    const std::string text = out.str();
+    EXPECT_GE(countLines(text, "info depth "), 1u);
+    EXPECT_NE(text.find(" nodes 2000 "), std::string::npos); // final report: playouts
+    const size_t best = text.find("bestmove ");
+    ASSERT_NE(best, std::string::npos);
+    const std::string move = text.substr(best + 9, text.find_first_of(" \n", best + 9) - best - 9);
+    EXPECT_TRUE(parseMove(Position::initial(), move).has_value());
+
+    protocol.handleLine("go infinite");
+    protocol.handleLine("stop");
+    protocol.waitForSearch();
+    EXPECT_EQ(countLines(out.str(), "bestmove "), 2u);
+}
@@ -0,0 +1,58 @@
+#include "engine/Search.hpp"
+#include "engine/SearchArena.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace chk::engine;
+
+TEST(SearchArenaTests, Arena_ServesFromBufferAndRewinds)
+{
+    SearchArena arena{4096};
+    std::pmr::vector<Move> moves{arena.resource()};
+    moves.reserve(64);
+    const Move *first = moves.data();
+    EXPECT_EQ(arena.getSpills(), 0U);
+
+    // rewound: the next search gets the same memory again
+    std::pmr::vector<Move>{arena.resource()}.swap(moves);
+    arena.reset();
+    moves.reserve(64);
+    EXPECT_EQ(moves.data(), first);
+
+    // asking for more than the buffer holds still works, from the heap
+    std::pmr::vector<Move> large{arena.resource()};
+    large.reserve(arena.getCapacity());
+    EXPECT_GT(arena.getSpills(), 0U);
+}
+
+TEST(SearchArenaTests, Search_MakesNoHeapAllocationsBetweenIterations)
+{
+    if (!HEAP_ALLOCATIONS_COUNTED)
+    {
+        GTEST_SKIP() << "heap allocations are only counted in debug builds";
+    }
+    const uint64_t before = threadHeapAllocations();
+    const auto counted = std::make_unique<int>(1);
+    ASSERT_GT(threadHeapAllocations(), before);
+
+    TranspositionTable table{1, false};
+    Searcher searcher;
+    searcher.setTranspositionTable(&table);
+    constexpr int DEPTH = 8;
+    std::array<uint64_t, DEPTH + 1> counts{};
+    searcher.setOnIteration([&counts](const SearchResult &result) { counts[result.depth] = threadHeapAllocations(); });
+
+    for (const int multiPv : {1, 3})
+    {
+        SearchLimits limits{DEPTH, 0, 0};
+        limits.multiPv = multiPv;
+        const SearchResult result = searcher.search(Position::initial(), limits);
+        ASSERT_EQ(result.depth, DEPTH);
+        EXPECT_EQ(result.lines.size(), static_cast<size_t>(multiPv));
+        // each iteration after the first: search, PV lines and bookkeeping all without the heap
+        for (int depth = 2; depth <= DEPTH; depth++)
+        {
+            EXPECT_EQ(counts[depth], counts[depth - 1]) << "depth " << depth << ", multipv " << multiPv;
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include "engine/Search.hpp"
+#include <gtest/gtest.h>
+
+using namespace chk::engine;
+
+namespace
+{
+// RED men on cells 1 and 14, BLACK man on cell 22 guarding both squares in front of cell 14
+const Position HANGING_PIECE{bitOf(toSquare(1)) | bitOf(toSquare(14)), bitOf(toSquare(22)), 0, Side::RED};
+} // namespace
+
+TEST(SearchTests, Search_ReturnsLegalMove)
+{
+    Searcher searcher;
+    const SearchResult result = searcher.search(Position::initial(), SearchLimits{6, 0, 0});
+    MoveList legal;
+    generateMoves(Position::initial(), legal);
+    EXPECT_NE(std::find(legal.begin(), legal.end(), result.bestMove), legal.end());
+    EXPECT_EQ(result.depth, 6);
+    EXPECT_FALSE(result.pv.empty());
+}
+
+TEST(SearchTests, Quiescence_SeesPendingCapture)
+{
+    SearchConfig noQuiescence;
+    noQuiescence.useQuiescence = false;
+    Searcher blind{noQuiescence};
+    const SearchResult blindResult = blind.search(HANGING_PIECE, SearchLimits{1, 0, 0});
+    EXPECT_EQ(toNotation(HANGING_PIECE, blindResult.bestMove), "14-18");
+    EXPECT_EQ(blindResult.stats.qNodes, 0u);
+
+    Searcher searcher;
+    const SearchResult result = searcher.search(HANGING_PIECE, SearchLimits{1, 0, 0});
+    EXPECT_EQ(result.bestMove.from, toSquare(1));
+    EXPECT_GT(result.stats.qNodes, 0u);
+}
+
+TEST(SearchTests, Quiescence_RespectsChainLimit)
+{
+    SearchConfig config;
+    config.qsMaxPlies = 0;
+    Searcher searcher{config};
+    const SearchResult result = searcher.search(HANGING_PIECE, SearchLimits{1, 0, 0});
+    EXPECT_GT(result.stats.qDepthLimitHits, 0u);
+    EXPECT_EQ(result.stats.qMaxPlyReached, 0);
+}
+
+TEST(SearchTests, MultiPv_RanksDistinctRootMoves)
+{
+    Searcher searcher;
+    SearchLimits limits{5, 0, 0};
+    limits.multiPv = 3;
+    const SearchResult result = searcher.search(Position::initial(), limits);
+    ASSERT_EQ(result.lines.size(), 3u);
+    EXPECT_EQ(result.lines[0].pv.front(), result.bestMove);
+    EXPECT_EQ(result.lines[0].score, result.score);
+    for (size_t i = 1; i < result.lines.size(); i++)
+    {
+        EXPECT_GE(result.lines[i - 1].score, result.lines[i].score);
+        EXPECT_NE(result.lines[i].pv.front(), result.lines[0].pv.front());
+    }
+    EXPECT_NE(result.lines[1].pv.front(), result.lines[2].pv.front());
+
+    // single-PV best move & score are unchanged by multi-PV
+    Searcher single;
+    const SearchResult plain = single.search(Position::initial(), SearchLimits{5, 0, 0});
+    EXPECT_EQ(plain.score, result.score);
+}
+
+TEST(SearchTests, MultiPv_BoundedLinesMatchFullWindowScores)
+{
+    SearchLimits limits{5, 0, 0};
+    limits.multiPv = 4;
+    Searcher searcher;
+    const SearchResult result = searcher.search(Position::initial(), limits);
+    ASSERT_EQ(result.lines.size(), 4u);
+
+    // every line is searched under the previous line's score, yet must get its exact value
+    MoveList moves;
+    generateMoves(Position::initial(), moves);
+    std::vector<int> expected;
+    for (const Move &move : moves)
+    {
+        Searcher reply;
+        expected.push_back(-reply.search(makeMove(Position::initial(), move), SearchLimits{4, 0, 0}).score);
+    }
+    std::sort(expected.rbegin(), expected.rend());
+    for (size_t i = 0; i < result.lines.size(); i++)
+    {
+        EXPECT_EQ(result.lines[i].score, expected[i]);
+    }
+
+    // a shared table gives the same best line
+    TranspositionTable tt{4};
+    Searcher shared;
+    shared.setTranspositionTable(&tt);
+    const SearchResult warm = shared.search(Position::initial(), limits);
+    ASSERT_EQ(warm.lines.size(), 4u);
+    EXPECT_EQ(warm.score, result.score);
+}
+
+TEST(SearchTests, Stats_CoverEveryIteration)
+{
+    EXPECT_EQ(alignof(SearchStats), 64u); // one cache line per searcher's counters
+    Searcher searcher;
+    const SearchResult result = searcher.search(Position::initial(), SearchLimits{8, 0, 0});
+    ASSERT_EQ(result.iterations.size(), 8u);
+    uint64_t nodes = 0;
+    for (size_t i = 0; i < result.iterations.size(); i++)
+    {
+        EXPECT_EQ(result.iterations[i].depth, static_cast<int>(i) + 1);
+        nodes += result.iterations[i].nodes;
+    }
+    EXPECT_EQ(nodes, result.stats.nodes);
+    EXPECT_GT(result.stats.betaCutoffs, 0u);
+    EXPECT_GT(result.stats.firstMoveCutoffRate(), 0.5);
+    EXPECT_LE(result.stats.firstMoveCutoffRate(), 1.0);
+    EXPECT_GT(result.branchingFactor(), 1.0);
+
+    const std::string json = toJson(Position::initial(), result);
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"nodes\":" + std::to_string(result.stats.nodes)), std::string::npos);
+    EXPECT_NE(json.find("\"pv\":[\"" + toNotation(Position::initial(), result.bestMove) + "\""), std::string::npos);
+    EXPECT_NE(json.find("{\"depth\":8,"), std::string::npos);
+}
+
+TEST(SearchTests, StoppedFirstIteration_KeepsNoFakeScore)
+{
+    Searcher searcher;
+    SearchLimits limits{6, 0, 0};
+    limits.maxNodes = 2; // runs out inside the first root move of depth 1
+    const SearchResult result = searcher.search(HANGING_PIECE, limits);
+    MoveList legal;
+    generateMoves(HANGING_PIECE, legal);
+    EXPECT_EQ(result.depth, 0);
+    EXPECT_TRUE(result.lines.empty());
+    EXPECT_EQ(result.bestMove, legal[0]);
+    ASSERT_EQ(result.pv.size(), 1u);
+    EXPECT_EQ(result.score, evaluate(HANGING_PIECE, getEvalWeights()));
+    EXPECT_NE(result.score, 0);
+}
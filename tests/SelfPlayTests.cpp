@@ -0,0 +1,116 @@
+#include "engine/MoveGen.hpp"
+#include "engine/SelfPlay.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace chk::engine;
+
+TEST(SelfPlayTests, MatchScore_EloAndErrorBars)
+{
+    const MatchScore even{40, 20, 40};
+    EXPECT_DOUBLE_EQ(even.scoreRate(), 0.5);
+    EXPECT_NEAR(even.eloDiff(), 0.0, 1e-9);
+    EXPECT_GT(even.eloError95(), 0.0);
+
+    // 75% score is +190.8 Elo
+    const MatchScore strong{50, 50, 0};
+    EXPECT_NEAR(strong.eloDiff(), 190.85, 0.1);
+
+    // four times the games: roughly half the error
+    const MatchScore more{160, 80, 160};
+    EXPECT_NEAR(more.eloError95() / even.eloError95(), 0.5, 0.02);
+}
+
+TEST(SelfPlayTests, Sprt_DecidesOnlyWithEnoughEvidence)
+{
+    const SprtConfig sprt{true, 0.0, 10.0, 0.05, 0.05};
+    EXPECT_NEAR(sprtUpperBound(sprt), 2.944, 0.001);
+    EXPECT_NEAR(sprtLowerBound(sprt), -2.944, 0.001);
+
+    EXPECT_EQ((MatchScore{6, 8, 5}.sprt(sprt)), SprtDecision::CONTINUE);
+    EXPECT_EQ((MatchScore{600, 300, 300}.sprt(sprt)), SprtDecision::ACCEPT_H1);
+    EXPECT_EQ((MatchScore{300, 300, 600}.sprt(sprt)), SprtDecision::ACCEPT_H0);
+    EXPECT_GT((MatchScore{600, 300, 300}.llr(0.0, 10.0)), (MatchScore{60, 30, 30}.llr(0.0, 10.0)));
+}
+
+TEST(SelfPlayTests, GenerateOpenings_DistinctBalancedAndPlayable)
+{
+    const auto openings = generateOpenings(20, 4, 40, 7);
+    ASSERT_EQ(openings.size(), 20U);
+    for (size_t i = 0; i < openings.size(); i++)
+    {
+        MoveList moves;
+        generateMoves(openings[i], moves);
+        EXPECT_FALSE(moves.empty());
+        for (size_t j = i + 1; j < openings.size(); j++)
+        {
+            EXPECT_NE(openings[i], openings[j]);
+        }
+    }
+    EXPECT_EQ(generateOpenings(20, 4, 40, 7), openings); // same seed, same set
+}
+
+TEST(SelfPlayTests, PlayGame_NoMovesLoses)
+{
+    // RED man on the edge square 3: its only step (7) is taken, and the jump landing (10) too
+    Searcher red;
+    Searcher black;
+    const Position stuck{bitOf(3), bitOf(7) | bitOf(10), 0, Side::RED};
+    MoveList moves;
+    generateMoves(stuck, moves);
+    ASSERT_TRUE(moves.empty());
+    EXPECT_EQ(playGame(stuck, red, SearchLimits{}, black, SearchLimits{}, 100), GameResult::BLACK_WIN);
+}
+
+TEST(SelfPlayTests, Match_PlaysAllGamesAcrossThreads)
+{
+    SelfPlayConfig config;
+    config.numThreads = 4;
+    config.maxGames = 24;
+    config.openings = generateOpenings(6, 4, 40, 1);
+    EngineSpec engine;
+    engine.limits = SearchLimits{MAX_PLY - 1, 500, 0};
+    SelfPlayMatch match{engine, engine, config};
+
+    uint32_t callbacks = 0;
+    uint32_t records = 0;
+    match.setOnGameRecord([&](const Position &opening, const std::vector<Move> &moves, const GameResult result) {
+        records++;
+        EXPECT_NE(result, GameResult::UNKNOWN);
+        Position pos = opening;
+        for (const Move &move : moves)
+        {
+            MoveList legal;
+            generateMoves(pos, legal);
+            ASSERT_NE(std::find(legal.begin(), legal.end(), move), legal.end());
+            pos = makeMove(pos, move);
+        }
+    });
+    const SelfPlayReport report = match.run([&](const SelfPlayReport &) { callbacks++; });
+    EXPECT_EQ(report.score.total(), 24U);
+    EXPECT_EQ(callbacks, 24U);
+    EXPECT_EQ(records, 24U);
+    EXPECT_GT(report.nodes, 0U);
+    EXPECT_GT(report.gamesPerSec(), 0.0);
+    EXPECT_EQ(report.decision, SprtDecision::CONTINUE);
+}
+
+TEST(SelfPlayTests, Match_SprtStopsEarlyForClearlyStrongerEngine)
+{
+    SelfPlayConfig config;
+    config.numThreads = 4;
+    config.maxGames = 2000;
+    config.sprt = SprtConfig{true, 0.0, 50.0, 0.05, 0.05};
+    config.openings = generateOpenings(50, 4, 40, 3);
+    EngineSpec strong;
+    strong.limits = SearchLimits{MAX_PLY - 1, 4000, 0};
+    EngineSpec weak;
+    weak.limits = SearchLimits{1, 0, 0};
+    SelfPlayMatch match{strong, weak, config};
+
+    const SelfPlayReport report = match.run();
+    EXPECT_EQ(report.decision, SprtDecision::ACCEPT_H1);
+    EXPECT_LT(report.score.total(), 2000U);
+    EXPECT_GT(report.score.eloDiff(), 50.0);
+}
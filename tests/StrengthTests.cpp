@@ -0,0 +1,63 @@
+#include "engine/Strength.hpp"
+#include <gtest/gtest.h>
+#include <set>
+
+using namespace chk::engine;
+
+TEST(StrengthTests, Levels_GrowAndCapTime)
+{
+    for (size_t i = 0; i < STRENGTH_LEVELS.size(); i++)
+    {
+        const StrengthLevel &level = STRENGTH_LEVELS[i];
+        EXPECT_GE(level.maxTimeMs, maxThinkMs(level, MIN_EXPECTED_NPS)); // cap never cuts the planned budget
+        if (i > 0)
+        {
+            EXPECT_GT(level.nodes, STRENGTH_LEVELS[i - 1].nodes);
+            EXPECT_LE(level.scoreMargin, STRENGTH_LEVELS[i - 1].scoreMargin);
+        }
+    }
+    const StrengthLevel level{"test", 20'000, 1, 0, 500};
+    EXPECT_EQ(maxThinkMs(level, 1'000'000), 20);
+    EXPECT_EQ(maxThinkMs(level, 10'000), 500); // slow machine: capped
+    EXPECT_EQ(maxThinkMs(level, 0), 500);
+}
+
+TEST(StrengthTests, NodeBudget_IsDeterministic)
+{
+    const StrengthLevel &level = STRENGTH_LEVELS[2];
+    Searcher first;
+    Searcher second;
+    const SearchResult a = first.search(Position::initial(), limitsFor(level));
+    const SearchResult b = second.search(Position::initial(), limitsFor(level));
+    EXPECT_EQ(a.stats.nodes, b.stats.nodes);
+    EXPECT_LE(a.stats.nodes, level.nodes);
+    EXPECT_EQ(a.bestMove, b.bestMove);
+    ASSERT_EQ(a.lines.size(), static_cast<size_t>(level.candidates));
+    for (size_t i = 0; i < a.lines.size(); i++)
+    {
+        EXPECT_EQ(a.lines[i].score, b.lines[i].score);
+    }
+    EXPECT_GT(measureNodesPerSecond(), 1000u);
+}
+
+TEST(StrengthTests, PickMove_StaysWithinMargin)
+{
+    MoveList moves;
+    generateMoves(Position::initial(), moves);
+    SearchResult result;
+    result.lines = {PvLine{50, {moves[0]}}, PvLine{45, {moves[1]}}, PvLine{-100, {moves[2]}}};
+    result.bestMove = moves[0];
+
+    std::mt19937 rng{7};
+    const StrengthLevel strict{"strict", 1000, 3, 0, 100};
+    const StrengthLevel loose{"loose", 1000, 3, 10, 100};
+    std::set<uint8_t> played;
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(pickMove(result, strict, rng), moves[0]);
+        const Move move = pickMove(result, loose, rng);
+        EXPECT_NE(move, moves[2]); // 150 points worse: never
+        played.insert(move == moves[0] ? 0 : 1);
+    }
+    EXPECT_EQ(played.size(), 2u);
+}
@@ -0,0 +1,111 @@
+#include "engine/Tablebase.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace chk::engine;
+
+namespace
+{
+// expected value for a king-vs-king position (arbitrary, but never UNKNOWN)
+Wdl fakeResult(const int redSq, const int blackSq, const Side stm)
+{
+    return static_cast<Wdl>(1 + (redSq + blackSq + static_cast<int>(stm)) % 3);
+}
+} // namespace
+
+TEST(TablebaseTests, Index_IsUniqueAndInRange)
+{
+    const MaterialKey key{1, 0, 1, 1};
+    const uint64_t size = tablebaseSliceSize(key);
+    std::unordered_set<uint64_t> seen;
+    for (int rm = 0; rm < 28; rm++)
+    {
+        for (int bm = 4; bm < 32; bm++)
+        {
+            for (int bk = 0; bk < 32; bk++)
+            {
+                if (rm == bm || bk == rm || bk == bm)
+                {
+                    continue;
+                }
+                const Position pos{bitOf(rm), bitOf(bm) | bitOf(bk), bitOf(bk), Side::BLACK};
+                const uint64_t idx = tablebaseIndex(pos, key);
+                EXPECT_LT(idx, size);
+                EXPECT_TRUE(seen.insert(idx).second);
+            }
+        }
+    }
+}
+
+TEST(TablebaseTests, Probe_ReturnsStoredValues)
+{
+    const MaterialKey key{0, 1, 0, 1};
+    std::vector<Wdl> values(tablebaseSliceSize(key), Wdl::UNKNOWN);
+    for (int r = 0; r < 32; r++)
+    {
+        for (int b = 0; b < 32; b++)
+        {
+            for (const Side stm : {Side::RED, Side::BLACK})
+            {
+                if (r != b)
+                {
+                    const Position pos{bitOf(r), bitOf(b), bitOf(r) | bitOf(b), stm};
+                    values[tablebaseIndex(pos, key)] = fakeResult(r, b, stm);
+                }
+            }
+        }
+    }
+    const auto path = (std::filesystem::temp_directory_path() / "kk_test.sctb").string();
+    ASSERT_TRUE(writeTablebaseSlice(path, key, values, 64));
+
+    Tablebase tb{1};
+    ASSERT_TRUE(tb.addSlice(path));
+    EngineStats stats;
+    for (int r = 0; r < 32; r++)
+    {
+        for (int b = 0; b < 32; b++)
+        {
+            if (r != b)
+            {
+                const Position pos{bitOf(r), bitOf(b), bitOf(r) | bitOf(b), Side::RED};
+                EXPECT_EQ(tb.probe(pos, stats), fakeResult(r, b, Side::RED));
+            }
+        }
+    }
+    // position with more pieces than any slice is NOT probed
+    EXPECT_FALSE(tb.probe(Position::initial(), stats).has_value());
+    EXPECT_EQ(stats.tbProbes.load(), 32u * 31u);
+    EXPECT_GT(stats.tbCacheHitRate(), 0.5);
+    std::filesystem::remove(path);
+}
+
+TEST(TablebaseTests, Probe_RejectsManOnItsCrownRow)
+{
+    Tablebase tb{1};
+    std::vector<std::string> paths;
+    for (const MaterialKey &key : {MaterialKey{1, 0, 0, 1}, MaterialKey{0, 1, 1, 0}})
+    {
+        const std::vector<Wdl> values(tablebaseSliceSize(key), Wdl::WIN);
+        paths.push_back((std::filesystem::temp_directory_path() / ("crown" + std::to_string(paths.size()) + ".sctb"))
+                            .string());
+        ASSERT_TRUE(writeTablebaseSlice(paths.back(), key, values, 64));
+        ASSERT_TRUE(tb.addSlice(paths.back()));
+    }
+    EngineStats stats;
+    EXPECT_EQ(tb.probe(Position{bitOf(toSquare(14)), bitOf(0), bitOf(0), Side::RED}, stats), Wdl::WIN);
+    EXPECT_EQ(tb.probe(Position{bitOf(31), bitOf(toSquare(14)), bitOf(31), Side::RED}, stats), Wdl::WIN);
+
+    // RED man on its crown row: its index falls past the end of the slice
+    const Position redCrowned{bitOf(31), bitOf(0), bitOf(0), Side::RED};
+    EXPECT_GE(tablebaseIndex(redCrowned, MaterialKey::of(redCrowned)), tablebaseSliceSize(MaterialKey::of(redCrowned)));
+    EXPECT_FALSE(tb.probe(redCrowned, stats).has_value());
+    // BLACK man on its crown row
+    EXPECT_FALSE(tb.probe(Position{bitOf(31), bitOf(0), bitOf(31), Side::RED}, stats).has_value());
+    for (const std::string &path : paths)
+    {
+        std::filesystem::remove(path);
+    }
+}
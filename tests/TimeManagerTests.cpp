@@ -0,0 +1,87 @@
+#include "engine/Search.hpp"
+#include "engine/TimeManager.hpp"
+#include <gtest/gtest.h>
+
+using namespace chk::engine;
+
+namespace
+{
+const GameClock MINUTE{60000, 0, 0};
+// a lone RED man against a far BLACK one: two quiet moves to choose from
+const Position TWO_MOVES{bitOf(toSquare(14)), bitOf(toSquare(30)), 0, Side::RED};
+const Move SOME_MOVE{0, toSquare(9), toSquare(13)};
+const Move OTHER_MOVE{0, toSquare(10), toSquare(14)};
+} // namespace
+
+TEST(TimeManagerTests, Start_FewerChoicesGetLessTime)
+{
+    MoveList moves;
+    generateMoves(TWO_MOVES, moves);
+    ASSERT_LE(moves.size(), 3U);
+
+    TimeManager manager;
+    manager.start(Position::initial(), MINUTE);
+    const int64_t opening = manager.getOptimumMs();
+    EXPECT_NEAR(static_cast<double>(opening), (60000.0 - TIME_OVERHEAD_MS) / TIME_MOVES_TO_GO, 2.0);
+    EXPECT_LE(manager.getMaximumMs(), static_cast<int64_t>(60000 * TIME_MAX_CLOCK_SHARE));
+    EXPECT_GT(manager.getMaximumMs(), opening);
+
+    manager.start(TWO_MOVES, MINUTE);
+    EXPECT_LT(manager.getOptimumMs(), opening);
+
+    // the increment is (mostly) spent, a short clock is never overdrawn
+    manager.start(Position::initial(), GameClock{60000, 2000, 0});
+    EXPECT_GT(manager.getOptimumMs(), opening);
+    manager.start(Position::initial(), GameClock{100, 0, 0});
+    EXPECT_LE(manager.getMaximumMs(), 25);
+}
+
+TEST(TimeManagerTests, OnIteration_StableMoveStopsEarlyUnstableThinksLonger)
+{
+    TimeManager manager;
+    manager.start(Position::initial(), MINUTE);
+    const int64_t optimum = manager.getOptimumMs();
+
+    // same move and score every iteration: target shrinks below the optimum
+    for (int depth = 1; depth <= TIME_STABLE_ITERATIONS; depth++)
+    {
+        EXPECT_FALSE(manager.onIteration(depth, SOME_MOVE, 10, depth, 1));
+    }
+    EXPECT_LT(manager.getLastDecision().targetMs, optimum);
+    EXPECT_TRUE(manager.onIteration(TIME_STABLE_ITERATIONS + 1, SOME_MOVE, 10, optimum * 3 / 4, 1));
+
+    // best move flips and the score jumps: the same elapsed time is no longer enough
+    manager.start(Position::initial(), MINUTE);
+    EXPECT_FALSE(manager.onIteration(1, SOME_MOVE, 10, 1, 1));
+    EXPECT_FALSE(manager.onIteration(2, OTHER_MOVE, 120, optimum * 3 / 4, 1));
+    EXPECT_GT(manager.getLastDecision().targetMs, optimum);
+    EXPECT_LE(manager.getLastDecision().targetMs, manager.getMaximumMs());
+    EXPECT_EQ(manager.getLastDecision().scoreSwing, 110);
+}
+
+TEST(TimeManagerTests, OnIteration_SkipsAnIterationThatCannotFinish)
+{
+    TimeManager manager;
+    manager.start(Position::initial(), MINUTE);
+    const int64_t optimum = manager.getOptimumMs();
+    EXPECT_FALSE(manager.onIteration(1, SOME_MOVE, 0, 10, 5));
+    // best move changed: the target is above the optimum, but the next iteration would overrun the maximum
+    EXPECT_TRUE(manager.onIteration(2, OTHER_MOVE, 0, optimum, manager.getMaximumMs() / 2));
+    EXPECT_LT(manager.getLastDecision().elapsedMs, manager.getLastDecision().targetMs);
+}
+
+TEST(TimeManagerTests, Search_WithClockStaysWithinBudget)
+{
+    Searcher searcher;
+    SearchLimits limits{};
+    limits.clock = GameClock{2000, 0, 0};
+    const SearchResult result = searcher.search(Position::initial(), limits);
+    EXPECT_NE(result.bestMove, NULL_MOVE);
+    EXPECT_GT(result.depth, 1);
+    EXPECT_LE(result.elapsedMs, static_cast<int64_t>(2000 * TIME_MAX_CLOCK_SHARE) + 50);
+
+    // a fixed move time wins over the clock
+    limits.moveTimeMs = 20;
+    limits.clock = GameClock{600000, 0, 0};
+    EXPECT_LE(searcher.search(Position::initial(), limits).elapsedMs, 20 + 50);
+}
@@ -0,0 +1,183 @@
+#include "engine/Search.hpp"
+#include "engine/TranspositionTable.hpp"
+#include "engine/Zobrist.hpp"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace chk::engine;
+
+TEST(TranspositionTableTests, StoreThenProbe)
+{
+    TranspositionTable tt{1};
+    MoveList moves;
+    generateMoves(Position::initial(), moves);
+    const uint64_t key = hashPosition(Position::initial());
+
+    TtEntry entry;
+    EXPECT_FALSE(tt.probe(key, entry));
+    tt.store(key, -37, 6, TtBound::LOWER, moves[2]);
+    ASSERT_TRUE(tt.probe(key, entry));
+    EXPECT_EQ(entry.score, -37);
+    EXPECT_EQ(entry.depth, 6);
+    EXPECT_EQ(entry.bound, TtBound::LOWER);
+    EXPECT_TRUE(entry.matches(moves[2]));
+    EXPECT_FALSE(entry.matches(moves[1]));
+
+    // a later result without a move keeps the known best move
+    tt.store(key, 12, 7, TtBound::UPPER, NULL_MOVE);
+    ASSERT_TRUE(tt.probe(key, entry));
+    EXPECT_EQ(entry.score, 12);
+    EXPECT_TRUE(entry.matches(moves[2]));
+
+    tt.clear();
+    EXPECT_FALSE(tt.probe(key, entry));
+}
+
+TEST(TranspositionTableTests, MateScoresAreStoredRelativeToNode)
+{
+    const int mateIn5FromRoot = SCORE_WIN - 5;
+    const int stored = toTtScore(mateIn5FromRoot, 3); // node at ply 3: mate 2 plies below it
+    EXPECT_EQ(stored, SCORE_WIN - 2);
+    EXPECT_EQ(fromTtScore(stored, 7), SCORE_WIN - 9); // same node reached at ply 7
+    EXPECT_EQ(fromTtScore(toTtScore(-SCORE_TB_WIN + 4, 4), 4), -SCORE_TB_WIN + 4);
+    EXPECT_EQ(toTtScore(150, 9), 150);
+}
+
+TEST(TranspositionTableTests, FullBucketEvictsShallowestEntry)
+{
+    TranspositionTable tt{1};
+    const uint64_t numBuckets = tt.getSizeBytes() / 64;
+    // keys with equal low bits share a bucket
+    for (int i = 0; i <= TT_BUCKET_SLOTS; i++)
+    {
+        tt.store((uint64_t(i) + 1) * numBuckets * 7919, 0, i == 2 ? 1 : 10 + i, TtBound::EXACT, NULL_MOVE);
+    }
+    TtEntry entry;
+    EXPECT_FALSE(tt.probe(3 * numBuckets * 7919, entry)); // depth 1 was the victim
+    EXPECT_TRUE(tt.probe(1 * numBuckets * 7919, entry));
+    EXPECT_TRUE(tt.probe(5 * numBuckets * 7919, entry));
+}
+
+TEST(TranspositionTableTests, Search_WarmTableNeedsFewerNodes)
+{
+    TranspositionTable tt{4};
+    Searcher searcher;
+    searcher.setTranspositionTable(&tt);
+    const SearchResult cold = searcher.search(Position::initial(), SearchLimits{9, 0, 0});
+    const SearchResult warm = searcher.search(Position::initial(), SearchLimits{9, 0, 0});
+    EXPECT_EQ(warm.bestMove, cold.bestMove);
+    EXPECT_GT(cold.stats.ttHits, 0U);
+    EXPECT_LT(warm.stats.nodes, cold.stats.nodes / 2);
+    EXPECT_GT(warm.stats.ttCutoffs, 0U);
+    EXPECT_GE(warm.pv.size(), 2U);
+
+    // same answer as a search without the table
+    Searcher plain;
+    EXPECT_EQ(plain.search(Position::initial(), SearchLimits{9, 0, 0}).score, cold.score);
+}
+
+TEST(TranspositionTableTests, SaveAndLoad_RestoresEntries)
+{
+    const std::string path = "tt_test.bin";
+    TranspositionTable tt{2};
+    Searcher searcher;
+    searcher.setTranspositionTable(&tt);
+    const SearchResult cold = searcher.search(Position::initial(), SearchLimits{9, 0, 0});
+    tt.saveInBackground(path);
+    ASSERT_TRUE(tt.waitForSave());
+
+    // same size: bulk copy; other size: rehashed
+    for (const size_t megabytes : {2, 8})
+    {
+        TranspositionTable restored{megabytes};
+        ASSERT_TRUE(restored.load(path));
+        TtEntry entry;
+        ASSERT_TRUE(restored.probe(hashPosition(Position::initial()), entry));
+        EXPECT_TRUE(entry.matches(cold.bestMove));
+        Searcher warm;
+        warm.setTranspositionTable(&restored);
+        EXPECT_LT(warm.search(Position::initial(), SearchLimits{9, 0, 0}).stats.nodes, cold.stats.nodes / 2);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(TranspositionTableTests, Load_RejectsCorruptFiles)
+{
+    const std::string path = "tt_corrupt.bin";
+    TranspositionTable tt{1};
+    tt.store(42, 5, 3, TtBound::EXACT, NULL_MOVE);
+    ASSERT_TRUE(tt.save(path));
+    {
+        std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+        file.seekp(TT_FILE_HEADER_SIZE + 100);
+        file.put('\x7F'); // flip payload: CRC must catch it
+    }
+    TranspositionTable other{1};
+    other.store(7, 1, 1, TtBound::EXACT, NULL_MOVE);
+    EXPECT_FALSE(other.load(path));
+    TtEntry entry;
+    EXPECT_TRUE(other.probe(7, entry)); // left untouched
+    std::remove(path.c_str());
+    EXPECT_FALSE(other.load(path));     // missing
+}
+
+TEST(TranspositionTableTests, LargeBuffer_ZeroFilledWithOrWithoutHugePages)
+{
+    LargeBuffer small;
+    ASSERT_TRUE(small.allocate(4096, true));
+    EXPECT_EQ(small.getKind(), PageKind::NORMAL); // below one huge page: never tried
+
+    LargeBuffer big;
+    ASSERT_TRUE(big.allocate(3 * HUGE_PAGE_SIZE + 1, true)); // huge if possible, else logged fallback
+    ASSERT_GE(big.size(), 3 * HUGE_PAGE_SIZE + 1);
+    const auto *bytes = static_cast<const uint8_t *>(big.data());
+    EXPECT_EQ(bytes[0] | bytes[HUGE_PAGE_SIZE] | bytes[big.size() - 1], 0);
+    if (big.getKind() != PageKind::NORMAL)
+    {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(big.data()) % HUGE_PAGE_SIZE, 0U);
+    }
+
+    TranspositionTable tt{64, true};
+    EXPECT_EQ(tt.getSizeBytes(), 64U << 20);
+    tt.store(99, 7, 2, TtBound::LOWER, NULL_MOVE);
+    TtEntry entry;
+    EXPECT_TRUE(tt.probe(99, entry));
+    tt.clear();
+    EXPECT_FALSE(tt.probe(99, entry));
+}
+
+TEST(TranspositionTableTests, SharedTable_OwnerKeepsGenerationStable)
+{
+    TranspositionTable tt{4};
+    tt.newSearch();
+    const uint8_t generation = tt.getGeneration();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&tt, t] {
+            Searcher searcher;
+            searcher.setTranspositionTable(&tt, false);
+            Position pos = Position::initial();
+            for (int move = 0; move < 8; move++)
+            {
+                const SearchResult result = searcher.search(pos, SearchLimits{4 + t % 2, 0, 0});
+                ASSERT_NE(result.bestMove, NULL_MOVE);
+                pos = makeMove(pos, result.bestMove);
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(tt.getGeneration(), generation); // 32 searches, not one aging step
+
+    // a searcher that owns the table ages it with every search
+    Searcher owner;
+    owner.setTranspositionTable(&tt);
+    owner.search(Position::initial(), SearchLimits{2, 0, 0});
+    EXPECT_EQ(tt.getGeneration(), generation + 1);
+}
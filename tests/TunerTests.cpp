@@ -0,0 +1,152 @@
+#include "engine/Endgame.hpp"
+#include "engine/Evaluation.hpp"
+#include "engine/Tuner.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace chk::engine;
+
+namespace
+{
+/**
+ * Random positions where RED is up `extraKings` kings exactly when it won
+ */
+std::vector<TuningSample> kingAdvantageSamples(const int count)
+{
+    std::mt19937 rng{5};
+    std::vector<TuningSample> samples;
+    for (int i = 0; i < count; i++)
+    {
+        const bool redWins = rng() % 2 == 0;
+        const Bitboard red = 0x00000FFFu & ~bitOf(static_cast<int>(rng() % 12));
+        const Bitboard black = 0xFFF00000u & ~bitOf(20 + static_cast<int>(rng() % 12));
+        const Bitboard kings = redWins ? (red & 0x00000003u) : (black & 0xC0000000u);
+        samples.push_back(TuningSample{Position{red, black, kings, Side::RED},
+                                       redWins ? GameResult::RED_WIN : GameResult::BLACK_WIN});
+    }
+    return samples;
+}
+} // namespace
+
+TEST(TunerTests, DefaultWeights_MatchFeatureDotProduct)
+{
+    EXPECT_EQ(evaluate(Position::initial()), 0);
+    const Position pos{0x00000FFFu, 0xFFF00000u & ~bitOf(31), bitOf(0), Side::BLACK};
+    const EvalFeatures features = extractFeatures(pos);
+    int red = 0;
+    for (int term = 0; term < NUM_EVAL_TERMS; term++)
+    {
+        red += features[term] * getEvalWeights().values[term];
+    }
+    EXPECT_EQ(evaluate(pos), -red);
+    EXPECT_EQ(evaluate(pos, getEvalWeights()), evaluate(pos));
+}
+
+TEST(TunerTests, WeightsFile_RoundTripsAndRejectsGarbage)
+{
+    const std::string path = "tuner_test.weights";
+    EvalWeights weights;
+    weights.values = {100, 173, 5, 2, 7, -3};
+    ASSERT_TRUE(saveEvalWeights(weights, path));
+    const auto loaded = loadEvalWeights(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded.value(), weights);
+
+    std::FILE *file = std::fopen(path.c_str(), "ab");
+    std::fputc(0, file);
+    std::fclose(file);
+    EXPECT_FALSE(loadEvalWeights(path).has_value()); // wrong size
+    std::remove(path.c_str());
+    EXPECT_FALSE(loadEvalWeights(path).has_value()); // missing
+}
+
+TEST(TunerTests, SamplesFile_RoundTrips)
+{
+    const std::string path = "tuner_test.samples";
+    const std::vector<TuningSample> samples = {
+        {Position::initial(), GameResult::DRAW},
+        {Position{0x1u, 0x80000000u, 0x80000000u, Side::BLACK}, GameResult::BLACK_WIN},
+        {Position{0xF0u, 0x0F000000u, 0x10u, Side::RED}, GameResult::RED_WIN},
+    };
+    ASSERT_TRUE(writeSamples(path, samples));
+    const auto loaded = readSamples(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(loaded->size(), samples.size());
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        EXPECT_EQ(loaded->at(i).pos, samples[i].pos);
+        EXPECT_EQ(loaded->at(i).result, samples[i].result);
+    }
+}
+
+TEST(TunerTests, Run_LearnsKingValueAndLowersError)
+{
+    TunerConfig config;
+    config.numThreads = 4;
+    config.epochs = 300;
+    config.learningRate = 2.0;
+    config.scaleK = 1.0;
+    EvalTuner tuner{kingAdvantageSamples(20000), config};
+
+    EvalWeights start;
+    start.values[TERM_KING] = 0;
+    const double startError = tuner.meanError(start);
+    int epochs = 0;
+    const EvalWeights tuned = tuner.run(start, [&](const TunerEpoch &epoch) {
+        epochs++;
+        EXPECT_GT(epoch.samplesPerSec, 0.0);
+    });
+    EXPECT_EQ(epochs, 300);
+    EXPECT_EQ(tuned.values[TERM_MAN], MAN_VALUE); // frozen
+    EXPECT_GT(tuned.values[TERM_KING], 100);
+    EXPECT_LT(tuner.meanError(tuned), startError * 0.5);
+}
+
+TEST(TunerTests, FitScale_PrefersSharperSigmoidForDecisiveData)
+{
+    EvalTuner tuner{kingAdvantageSamples(2000)};
+    const double k = tuner.fitScale(getEvalWeights());
+    EXPECT_GT(k, 1.0);
+    EXPECT_DOUBLE_EQ(tuner.getScale(), k);
+}
+
+TEST(TunerTests, Constructor_SkipsKnownEndings)
+{
+    // kings only, RED a king up: evaluate() scores it with the endgame evaluator, not the weighted terms
+    const Position kingsWin{bitOf(0) | bitOf(1), bitOf(31), bitOf(0) | bitOf(1) | bitOf(31), Side::RED};
+    ASSERT_NE(endgameKind(kingsWin), EndgameKind::NONE);
+    const EvalTuner endingsOnly{std::vector<TuningSample>(100, TuningSample{kingsWin, GameResult::BLACK_WIN})};
+    EXPECT_DOUBLE_EQ(endingsOnly.meanError(getEvalWeights()), 0.0); // nothing left to fit
+
+    std::vector<TuningSample> mixed = kingAdvantageSamples(100);
+    const EvalTuner without{mixed};
+    mixed.insert(mixed.end(), 100, TuningSample{kingsWin, GameResult::BLACK_WIN});
+    EXPECT_DOUBLE_EQ(EvalTuner{mixed}.meanError(getEvalWeights()), without.meanError(getEvalWeights()));
+}
+
+TEST(TunerTests, Run_ReturnsLowestErrorWeights)
+{
+    TunerConfig config;
+    config.numThreads = 2;
+    config.epochs = 30;
+    config.learningRate = 400.0; // far too large: Adam overshoots, so the last epoch is not the best
+    config.scaleK = 1.0;
+    std::vector<TuningSample> samples = kingAdvantageSamples(2000);
+    for (size_t i = 0; i < samples.size(); i += 3)
+    {
+        samples[i].result = samples[i].result == GameResult::RED_WIN ? GameResult::BLACK_WIN : GameResult::RED_WIN;
+    }
+    EvalTuner tuner{samples, config}; // a third of the results flipped: the best fit is not a perfect one
+
+    double lowest = tuner.meanError(getEvalWeights());
+    double last = 0.0;
+    const EvalWeights tuned = tuner.run(getEvalWeights(), [&](const TunerEpoch &epoch) {
+        lowest = std::min(lowest, epoch.error);
+        last = epoch.error;
+    });
+    EXPECT_GT(last, lowest);
+    EXPECT_LE(tuner.meanError(tuned), lowest + 1e-4); // up to rounding to integers
+}
@@ -0,0 +1,167 @@
+// created 2026-10-18
+// Measures evaluation throughput: hand-written eval vs NNUE (full refresh, and incremental update),
+// then transposition table probe throughput on normal vs huge pages
+// usage: spacecheckers-bench [weights.scnn | -] [hash MB, default 1024]
+#include "engine/Evaluation.hpp"
+#include "engine/MoveGen.hpp"
+#include "engine/Nnue.hpp"
+#include "engine/TranspositionTable.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace chk::engine;
+
+namespace
+{
+constexpr int NUM_GAMES{200};
+constexpr int MAX_GAME_PLIES{120};
+constexpr int REPEATS{50};
+constexpr uint64_t TT_PROBES{20'000'000};
+
+/**
+ * A position with the move played from it (so NNUE update can be timed on real moves)
+ */
+struct Sample
+{
+    Position before;
+    Move move;
+};
+
+/**
+ * Random game positions: a realistic mix of openings, middlegames and endings
+ */
+std::vector<Sample> collectSamples()
+{
+    std::mt19937 rng{20261018};
+    std::vector<Sample> samples;
+    for (int game = 0; game < NUM_GAMES; game++)
+    {
+        Position pos = Position::initial();
+        for (int ply = 0; ply < MAX_GAME_PLIES; ply++)
+        {
+            MoveList moves;
+            generateMoves(pos, moves);
+            if (moves.empty())
+            {
+                break;
+            }
+            const Move move = moves[static_cast<int>(rng() % moves.size())];
+            samples.push_back(Sample{pos, move});
+            pos = makeMove(pos, move);
+        }
+    }
+    return samples;
+}
+
+/**
+ * Run `body` over all samples REPEATS times
+ * @return nanoseconds per sample
+ */
+template <typename Fn> double timeIt(const std::vector<Sample> &samples, Fn &&body)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < REPEATS; r++)
+    {
+        for (const Sample &sample : samples)
+        {
+            body(sample);
+        }
+    }
+    const auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / static_cast<double>(samples.size() * REPEATS);
+}
+
+void report(const char *name, const double nsPerOp, const int64_t checksum)
+{
+    std::printf("%-34s %9.1f ns/op %12.0f ops/sec   (checksum %lld)\n", name, nsPerOp, 1e9 / nsPerOp,
+                static_cast<long long>(checksum));
+}
+
+/**
+ * Fill half the table, then time random probes (mostly misses in cache: that is where TLB misses hurt)
+ */
+void benchTable(const size_t megabytes, const bool hugePages)
+{
+    TranspositionTable tt{megabytes, hugePages};
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    const auto nextKey = [&state] {
+        state ^= state << 13; // xorshift64
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+    const size_t fill = tt.getSizeBytes() / 64 * TT_BUCKET_SLOTS / 2;
+    for (size_t i = 0; i < fill; i++)
+    {
+        tt.store(nextKey(), static_cast<int>(i & 0xFF), 4, TtBound::EXACT, NULL_MOVE);
+    }
+    state = 0x9E3779B97F4A7C15ull; // replay: half the probes hit
+    int64_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < TT_PROBES; i++)
+    {
+        TtEntry entry;
+        const uint64_t key = (i & 1) != 0 ? nextKey() : nextKey() ^ 1;
+        checksum += tt.probe(key, entry) ? entry.score : 0;
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    const std::string name = "tt probe, " + std::string{pageKindName(tt.getPageKind())} + " pages";
+    report(name.c_str(), ns / TT_PROBES, checksum);
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const bool defaultNet = argc <= 1 || std::string{argv[1]} == "-";
+    const auto net = defaultNet ? NnueNetwork::createDefault() : NnueNetwork::load(argv[1]);
+    if (net == nullptr)
+    {
+        return 1;
+    }
+    const std::vector<Sample> samples = collectSamples();
+    std::printf("%zu positions x %d repeats, NNUE kernels: %s\n", samples.size(), REPEATS,
+                NnueNetwork::getKernelName());
+
+    // checksums keep the optimiser from dropping the work
+    int64_t checksum = 0;
+    double ns = timeIt(samples, [&](const Sample &s) { checksum += evaluate(s.before); });
+    report("classic evaluate()", ns, checksum);
+
+    checksum = 0;
+    ns = timeIt(samples, [&](const Sample &s) { checksum += net->evaluate(s.before); });
+    report("nnue refresh + evaluate", ns, checksum);
+
+    Accumulator parent;
+    Accumulator child;
+    checksum = 0;
+    ns = timeIt(samples, [&](const Sample &s) {
+        net->update(parent, child, s.before, s.move);
+        checksum += child.values[0][0];
+    });
+    report("nnue accumulator update", ns, checksum);
+
+    checksum = 0;
+    ns = timeIt(samples, [&](const Sample &s) {
+        net->update(parent, child, s.before, s.move);
+        checksum += net->evaluate(child, opposite(s.before.sideToMove));
+    });
+    report("nnue update + evaluate", ns, checksum);
+
+    checksum = 0;
+    ns = timeIt(samples, [&](const Sample &s) {
+        net->refresh(s.before, parent);
+        checksum += parent.values[1][0];
+    });
+    report("nnue refresh only", ns, checksum);
+
+    const size_t hashMb = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+    std::printf("\n%zu MB transposition table, %llu random probes\n", hashMb,
+                static_cast<unsigned long long>(TT_PROBES));
+    benchTable(hashMb, false);
+    benchTable(hashMb, true);
+    return 0;
+}
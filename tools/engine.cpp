@@ -0,0 +1,91 @@
+// created 2026-10-18
+// Headless engine speaking the text protocol (see engine/Protocol.hpp) over stdin/stdout
+// usage: spacecheckers-engine   (loads eval.weights and opening.book from the working directory, if present)
+//        spacecheckers-engine --engine-channel NAME   (serves an EngineProcess client over shared memory instead)
+//        spacecheckers-engine bench [depth]   (deterministic search benchmark: prints the node signature)
+#include "engine/Bench.hpp"
+#include "engine/EngineProcess.hpp"
+#include "engine/Evaluation.hpp"
+#include "engine/OpeningBook.hpp"
+#include "engine/Pdn.hpp"
+#include "engine/Protocol.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+#include <string>
+
+namespace
+{
+/**
+ * Search the bench suite and print per-position nodes, then the signature (total nodes) and speed
+ * @param depth search depth (0 = default)
+ * @return 0 when the default bench matches BENCH_SIGNATURE (or a custom depth was asked for)
+ */
+int runBenchCommand(const int depth)
+{
+    chk::engine::BenchConfig config;
+    if (depth > 0)
+    {
+        config.depth = depth;
+    }
+    const chk::engine::BenchResult bench = chk::engine::runBench(config);
+    for (size_t i = 0; i < bench.entries.size(); i++)
+    {
+        const auto &entry = bench.entries[i];
+        const std::string fen = chk::engine::toFen(entry.pos);
+        const std::string move = chk::engine::toNotation(entry.pos, entry.bestMove);
+        std::printf("%3zu  %-40s  %-8s  depth %2d  score %6d  nodes %10llu\n", i + 1, fen.c_str(), move.c_str(),
+                    entry.depth, entry.score, static_cast<unsigned long long>(entry.nodes));
+    }
+    std::printf("\nNodes searched  : %llu\nMoves hash      : %016llx\nTime (ms)       : %lld\nNodes/second    : %llu\n",
+                static_cast<unsigned long long>(bench.nodes), static_cast<unsigned long long>(bench.movesHash),
+                static_cast<long long>(bench.elapsedMs), static_cast<unsigned long long>(bench.nodesPerSecond()));
+    if (config.depth == chk::engine::BENCH_DEPTH && bench.nodes != chk::engine::BENCH_SIGNATURE)
+    {
+        std::printf("signature changed: expected %llu\n",
+                    static_cast<unsigned long long>(chk::engine::BENCH_SIGNATURE));
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // stdout belongs to the protocol: send all logging to stderr
+    spdlog::set_default_logger(spdlog::stderr_color_mt("engine"));
+    std::ios::sync_with_stdio(false);
+    if (std::filesystem::exists(chk::engine::EVAL_WEIGHTS_FILE))
+    {
+        if (const auto weights = chk::engine::loadEvalWeights(chk::engine::EVAL_WEIGHTS_FILE))
+        {
+            chk::engine::setEvalWeights(weights.value());
+        }
+    }
+
+    if (argc == 3 && std::string{argv[1]} == chk::engine::ENGINE_CHANNEL_FLAG)
+    {
+        return chk::engine::serveEngineChannel(argv[2]);
+    }
+    if (argc >= 2 && std::string{argv[1]} == "bench")
+    {
+        return runBenchCommand(argc >= 3 ? std::atoi(argv[2]) : 0);
+    }
+
+    chk::engine::EngineProtocol protocol{std::cout};
+    if (std::filesystem::exists(chk::engine::BOOK_FILE))
+    {
+        protocol.openBook(chk::engine::BOOK_FILE); // "setoption name BookFile" replaces it
+    }
+    for (std::string line; std::getline(std::cin, line);)
+    {
+        if (!protocol.handleLine(line))
+        {
+            break;
+        }
+    }
+    return 0;
+}
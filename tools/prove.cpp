@@ -0,0 +1,161 @@
+// created 2026-10-18
+// Proof-number solver: proves or disproves a forced win for the side to move
+// usage: spacecheckers-prove [options] FEN...      (PDN FEN, e.g. "B:WK1:BK27,K32")
+//        spacecheckers-prove [options] --bench     (known-solved positions: checks verdicts, reports speed)
+//   --nodes N     tree node budget (default 10000000)
+//   --memory MB   node arena size (default 256)
+//   --plies N     longest line considered (default 120)
+//   --time MS     time budget per position (default: none)
+//   --hash MB     transposition table size, shared by all positions (default 64)
+#include "engine/Pdn.hpp"
+#include "engine/ProofSearch.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace chk::engine;
+
+namespace
+{
+/**
+ * Benchmark position whose verdict is known
+ */
+struct SolvedPosition
+{
+    const char *name;
+    const char *fen;
+    ProofResult expected;
+};
+
+const std::vector<SolvedPosition> BENCH_POSITIONS{
+    {"two-for-one shot", "B:WK29:BK14,K18", ProofResult::PROVEN},
+    {"king hunts last man", "B:W28:B5,K18", ProofResult::PROVEN},
+    {"3 kings vs 2 men", "B:W29,30:BK14,K18,K22", ProofResult::PROVEN},
+    {"3 kings vs king", "B:WK5:BK19,K23,K27", ProofResult::PROVEN},
+    {"2 kings vs king in double corner", "B:WK1:BK27,K32", ProofResult::PROVEN},
+    {"blocked man", "B:W8,11:B4", ProofResult::DISPROVEN},
+    {"king vs king", "B:WK29:BK14", ProofResult::DISPROVEN},
+    {"lone king to move", "W:WK1:BK27,K32", ProofResult::DISPROVEN},
+};
+
+/**
+ * Solve one position and print one line about it
+ */
+ProofOutcome solve(ProofSearcher &searcher, const std::string &label, const Position &pos)
+{
+    const ProofOutcome outcome = searcher.prove(pos);
+    std::string line;
+    Position linePos = pos;
+    for (const Move &move : outcome.line)
+    {
+        line += toNotation(linePos, move) + " ";
+        linePos = makeMove(linePos, move);
+    }
+    const double seconds = outcome.elapsedMs / 1000.0;
+    std::printf("%-34s %-7s %10llu nodes %8llu tt %7lld ms %8.0f knps%s  %s\n", label.c_str(),
+                proofResultName(outcome.result), static_cast<unsigned long long>(outcome.nodes),
+                static_cast<unsigned long long>(outcome.ttHits), static_cast<long long>(outcome.elapsedMs),
+                seconds > 0.0 ? outcome.nodes / seconds / 1000.0 : 0.0, outcome.outOfMemory ? " (memory full)" : "",
+                line.c_str());
+    std::fflush(stdout);
+    return outcome;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    ProofConfig config;
+    size_t hashMegabytes = 64;
+    bool bench = false;
+    std::vector<std::string> fens;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--bench")
+        {
+            bench = true;
+            continue;
+        }
+        if (arg.rfind("--", 0) != 0)
+        {
+            fens.push_back(arg);
+            continue;
+        }
+        if (value == nullptr)
+        {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return EXIT_FAILURE;
+        }
+        if (arg == "--nodes")
+        {
+            config.maxNodes = std::strtoull(value, nullptr, 10);
+        }
+        else if (arg == "--memory")
+        {
+            config.memoryMegabytes = std::strtoull(value, nullptr, 10);
+        }
+        else if (arg == "--plies")
+        {
+            config.maxPlies = std::atoi(value);
+        }
+        else if (arg == "--time")
+        {
+            config.maxTimeMs = std::atoll(value);
+        }
+        else if (arg == "--hash")
+        {
+            hashMegabytes = std::strtoull(value, nullptr, 10);
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return EXIT_FAILURE;
+        }
+        i++;
+    }
+    if (!bench && fens.empty())
+    {
+        std::fprintf(stderr, "usage: spacecheckers-prove [--nodes N] [--memory MB] [--plies N] [--time MS] "
+                             "[--hash MB] (--bench | FEN...)\n");
+        return EXIT_FAILURE;
+    }
+
+    TranspositionTable tt{hashMegabytes};
+    ProofSearcher searcher{config};
+    searcher.setTranspositionTable(&tt);
+    int failures = 0;
+    for (const std::string &fen : fens)
+    {
+        const auto pos = parseFen(fen);
+        if (!pos.has_value())
+        {
+            std::fprintf(stderr, "bad FEN: %s\n", fen.c_str());
+            failures++;
+            continue;
+        }
+        solve(searcher, fen, pos.value());
+    }
+    if (bench)
+    {
+        // cold table for each position, so timings do not depend on order
+        uint64_t totalNodes = 0;
+        int64_t totalMs = 0;
+        for (const SolvedPosition &solved : BENCH_POSITIONS)
+        {
+            tt.clear();
+            const ProofOutcome outcome = solve(searcher, solved.name, parseFen(solved.fen).value());
+            totalNodes += outcome.nodes;
+            totalMs += outcome.elapsedMs;
+            if (outcome.result != solved.expected)
+            {
+                std::printf("  ^ WRONG: expected %s\n", proofResultName(solved.expected));
+                failures++;
+            }
+        }
+        std::printf("total %llu nodes  %lld ms  %.0f knps\n", static_cast<unsigned long long>(totalNodes),
+                    static_cast<long long>(totalMs), totalMs > 0 ? totalNodes / (totalMs / 1000.0) / 1000.0 : 0.0);
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
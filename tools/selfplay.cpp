@@ -0,0 +1,368 @@
+// created 2026-10-18
+// Engine-vs-engine match on all cores, for A/B testing engine changes
+// usage: spacecheckers-selfplay [options]
+//   --games N            maximum games (default 1000)
+//   --threads N          concurrent games (default: all cores)
+//   --nodes N            fixed nodes per move for both engines (default 20000)
+//   --movetime MS        fixed time per move for both engines (replaces --nodes)
+//   --openings N         distinct balanced openings, each played with both colours (default 200)
+//   --opening-plies N    random plies used to make each opening (default 6)
+//   --sprt ELO0 ELO1     stop as soon as SPRT (alpha = beta = 0.05) accepts either hypothesis
+//   --seed N             opening generator seed
+//   --book-out FILE      build an opening book from the games of this match (merged into FILE if it is a book already)
+//   --book-plies N       plies of each game recorded in the book (default 24)
+//   --book-pdn FILE      also record the games of this PDN file in the book (repeatable)
+// distributed: one coordinator scores the match, workers on any host play it; give every process the same
+// options (file paths included) apart from these
+//   --coordinator PORT   hand out batches of games on this TCP port, play none here
+//   --batch N            games per batch (coordinator; default 16)
+//   --worker HOST:PORT   play batches for that coordinator on --threads cores
+// per-engine options, suffix -a (engine under test) or -b (reference):
+//   --nnue-a FILE, --eval-a FILE, --nodes-a N, --movetime-a MS, --no-qs-a, --qs-delta-a N, --qs-plies-a N
+#include "engine/DistributedSelfPlay.hpp"
+#include "engine/OpeningBook.hpp"
+#include "engine/SelfPlay.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace chk::engine;
+
+namespace
+{
+constexpr uint32_t REPORT_EVERY{50}; // games
+constexpr int BOOK_PLIES{24};        // default depth of a book built from the match
+constexpr uint64_t FNV_OFFSET{0xCBF29CE484222325ull};
+constexpr uint64_t FNV_PRIME{0x100000001B3ull};
+
+const char *decisionName(const SprtDecision decision)
+{
+    switch (decision)
+    {
+    case SprtDecision::ACCEPT_H0:
+        return "H0 accepted";
+    case SprtDecision::ACCEPT_H1:
+        return "H1 accepted";
+    default:
+        return "undecided";
+    }
+}
+
+void printReport(const SelfPlayReport &report)
+{
+    const MatchScore &score = report.score;
+    std::printf("games %u  +%u =%u -%u  score %.1f%%  elo %+.1f +/- %.1f  llr %.2f  %.1f games/s  %.0f knps\n",
+                score.total(), score.wins, score.draws, score.losses, 100.0 * score.scoreRate(), score.eloDiff(),
+                score.eloError95(), report.llr, report.gamesPerSec(),
+                report.elapsedSec > 0.0 ? report.nodes / report.elapsedSec / 1000.0 : 0.0);
+    std::fflush(stdout);
+}
+
+void printSprt(const SprtConfig &sprt, const SprtDecision decision)
+{
+    if (sprt.enabled)
+    {
+        std::printf("SPRT [%.1f, %.1f] bounds [%.2f, %.2f]: %s\n", sprt.elo0, sprt.elo1, sprtLowerBound(sprt),
+                    sprtUpperBound(sprt), decisionName(decision));
+    }
+}
+
+void printReport(const CoordinatorReport &report)
+{
+    printReport(report.match);
+    std::printf("batches %u done, %u retried, %u failed  workers %u seen, %u lost, %u active\n",
+                report.batchesDone, report.batchesRetried, report.batchesFailed, report.workersSeen,
+                report.workersLost, report.workersActive);
+    std::fflush(stdout);
+}
+
+/**
+ * Hash of the options that shape the match, for the coordinator and its workers to compare
+ * (--threads and the distributed options themselves may differ between processes)
+ */
+uint64_t matchOptionsKey(const int argc, char *argv[])
+{
+    uint64_t key = FNV_OFFSET;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--threads" || arg == "--coordinator" || arg == "--worker" || arg == "--batch")
+        {
+            i++;
+            continue;
+        }
+        for (const char c : arg + '\0')
+        {
+            key = (key ^ static_cast<uint8_t>(c)) * FNV_PRIME;
+        }
+    }
+    return key;
+}
+
+/**
+ * Start a book builder: the existing book at `path` (if any) and the PDN files are merged in first
+ * @return FALSE if a PDN file cannot be read
+ */
+bool startBook(OpeningBookBuilder &builder, const std::string &path, const std::vector<std::string> &pdnFiles)
+{
+    std::error_code error;
+    if (std::filesystem::exists(path, error))
+    {
+        OpeningBook existing;
+        if (existing.open(path))
+        {
+            builder.addBook(existing);
+        }
+    }
+    for (const std::string &pdnPath : pdnFiles)
+    {
+        std::ifstream in{pdnPath};
+        if (!in)
+        {
+            std::fprintf(stderr, "cannot read %s\n", pdnPath.c_str());
+            return false;
+        }
+        std::printf("%zu games imported from %s\n", builder.addPdn(in), pdnPath.c_str());
+    }
+    return true;
+}
+
+/**
+ * Apply an option ending in -a / -b to that engine
+ * @return FALSE if the option is unknown or misses its value
+ */
+bool applyEngineOption(EngineSpec &engine, const std::string &key, const char *value)
+{
+    if (key == "--no-qs")
+    {
+        engine.config.useQuiescence = false;
+        return true;
+    }
+    if (value == nullptr)
+    {
+        return false;
+    }
+    if (key == "--nnue")
+    {
+        engine.network = NnueNetwork::load(value);
+        return engine.network != nullptr;
+    }
+    if (key == "--eval")
+    {
+        const auto weights = loadEvalWeights(value);
+        engine.evalWeights = weights.has_value() ? std::make_shared<EvalWeights>(weights.value()) : nullptr;
+        return engine.evalWeights != nullptr;
+    }
+    if (key == "--nodes")
+    {
+        engine.limits.maxNodes = std::strtoull(value, nullptr, 10);
+    }
+    else if (key == "--movetime")
+    {
+        engine.limits.moveTimeMs = std::atoll(value);
+        engine.limits.maxNodes = 0;
+    }
+    else if (key == "--qs-delta")
+    {
+        engine.config.qsDeltaMargin = std::atoi(value);
+    }
+    else if (key == "--qs-plies")
+    {
+        engine.config.qsMaxPlies = std::atoi(value);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    SelfPlayConfig config;
+    EngineSpec engineA{"A"};
+    EngineSpec engineB{"B"};
+    int numOpenings = 200;
+    int openingPlies = 6;
+    uint32_t seed = 20261018;
+    CoordinatorConfig net;
+    bool coordinator = false;
+    std::string coordinatorHost;
+    uint16_t coordinatorPort = 0;
+    std::string bookPath;
+    int bookPlies = BOOK_PLIES;
+    std::vector<std::string> bookPdnFiles;
+
+    // shared options first, so per-engine ones can override them whatever the order
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--nodes" && value != nullptr)
+        {
+            engineA.limits.maxNodes = engineB.limits.maxNodes = std::strtoull(value, nullptr, 10);
+        }
+        else if (arg == "--movetime" && value != nullptr)
+        {
+            engineA.limits.moveTimeMs = engineB.limits.moveTimeMs = std::atoll(value);
+            engineA.limits.maxNodes = engineB.limits.maxNodes = 0;
+        }
+    }
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        const bool takesValue = arg != "--no-qs-a" && arg != "--no-qs-b";
+        if (arg == "--games" && value != nullptr)
+        {
+            config.maxGames = static_cast<uint32_t>(std::atoi(value));
+        }
+        else if (arg == "--threads" && value != nullptr)
+        {
+            config.numThreads = std::atoi(value);
+        }
+        else if (arg == "--openings" && value != nullptr)
+        {
+            numOpenings = std::atoi(value);
+        }
+        else if (arg == "--opening-plies" && value != nullptr)
+        {
+            openingPlies = std::atoi(value);
+        }
+        else if (arg == "--seed" && value != nullptr)
+        {
+            seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        }
+        else if (arg == "--coordinator" && value != nullptr)
+        {
+            coordinator = true;
+            net.port = static_cast<uint16_t>(std::atoi(value));
+        }
+        else if (arg == "--batch" && value != nullptr)
+        {
+            net.batchGames = static_cast<uint32_t>(std::atoi(value));
+        }
+        else if (arg == "--worker" && value != nullptr)
+        {
+            const std::string address = value;
+            const size_t colon = address.rfind(':');
+            if (colon == std::string::npos)
+            {
+                std::fprintf(stderr, "--worker wants HOST:PORT\n");
+                return 1;
+            }
+            coordinatorHost = address.substr(0, colon);
+            coordinatorPort = static_cast<uint16_t>(std::atoi(address.c_str() + colon + 1));
+        }
+        else if (arg == "--book-out" && value != nullptr)
+        {
+            bookPath = value;
+        }
+        else if (arg == "--book-plies" && value != nullptr)
+        {
+            bookPlies = std::max(1, std::atoi(value));
+        }
+        else if (arg == "--book-pdn" && value != nullptr)
+        {
+            bookPdnFiles.emplace_back(value);
+        }
+        else if (arg == "--sprt" && i + 2 < argc)
+        {
+            config.sprt.enabled = true;
+            config.sprt.elo0 = std::atof(argv[i + 1]);
+            config.sprt.elo1 = std::atof(argv[i + 2]);
+            i++;
+        }
+        else if (arg == "--nodes" || arg == "--movetime")
+        {
+            // handled above
+        }
+        else if (arg.size() > 2 && (arg.compare(arg.size() - 2, 2, "-a") == 0 ||
+                                    arg.compare(arg.size() - 2, 2, "-b") == 0))
+        {
+            EngineSpec &engine = arg.back() == 'a' ? engineA : engineB;
+            if (!applyEngineOption(engine, arg.substr(0, arg.size() - 2), value))
+            {
+                std::fprintf(stderr, "bad option %s\n", arg.c_str());
+                return 1;
+            }
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return 1;
+        }
+        i += takesValue ? 1 : 0;
+    }
+
+    if (config.numThreads <= 0)
+    {
+        config.numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    config.openings = generateOpenings(numOpenings, openingPlies, 40, seed);
+    const uint64_t optionsKey = matchOptionsKey(argc, argv);
+    if (!bookPath.empty() && (coordinator || !coordinatorHost.empty()))
+    {
+        std::fprintf(stderr, "--book-out needs a local match (no --coordinator / --worker)\n");
+        return 1;
+    }
+    if (!coordinatorHost.empty())
+    {
+        std::printf("worker for %s:%u, %d threads\n", coordinatorHost.c_str(), coordinatorPort, config.numThreads);
+        return runSelfPlayWorker(coordinatorHost, coordinatorPort, engineA, engineB, config, optionsKey) ? 0 : 1;
+    }
+    if (coordinator)
+    {
+        SelfPlayCoordinator server{config, optionsKey, net};
+        if (!server.listen())
+        {
+            return 1;
+        }
+        std::printf("%u games, %zu openings, coordinator on port %u\n", config.maxGames, config.openings.size(),
+                    server.getPort());
+        const uint32_t reportBatches = std::max<uint32_t>(1, REPORT_EVERY / std::max<uint32_t>(1, net.batchGames));
+        const CoordinatorReport report = server.run([reportBatches](const CoordinatorReport &progress) {
+            if (progress.batchesDone % reportBatches == 0)
+            {
+                printReport(progress);
+            }
+        });
+        printReport(report);
+        printSprt(config.sprt, report.match.decision);
+        return report.batchesFailed == 0 ? 0 : 1;
+    }
+    std::printf("%u games, %zu openings, %d threads\n", config.maxGames, config.openings.size(),
+                config.numThreads);
+    SelfPlayMatch match{engineA, engineB, config};
+    OpeningBookBuilder book{bookPlies};
+    if (!bookPath.empty())
+    {
+        if (!startBook(book, bookPath, bookPdnFiles))
+        {
+            return 1;
+        }
+        match.setOnGameRecord(
+            [&book](const Position &opening, const std::vector<Move> &moves, const GameResult result) {
+                book.addGame(moves, result, opening);
+            });
+    }
+    const SelfPlayReport report = match.run([](const SelfPlayReport &progress) {
+        if (progress.score.total() % REPORT_EVERY == 0)
+        {
+            printReport(progress);
+        }
+    });
+    printReport(report);
+    printSprt(config.sprt, report.decision);
+    if (!bookPath.empty() && !book.save(bookPath))
+    {
+        return 1;
+    }
+    return 0;
+}
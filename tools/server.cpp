@@ -0,0 +1,219 @@
+// created 2026-10-18
+// Multi-game engine server: many concurrent games on a fixed pool of search threads, one shared table.
+// Line protocol over stdin/stdout (game ids are any 64-bit numbers chosen by the caller):
+//   move <game> <remainingMs> <incrementMs> <FEN>   -> later "bestmove <game> <move|none> score <S> depth <D>"
+//   cancel <game>                                   drop the game's pending request (no reply)
+//   stats                                           -> "stats <JSON>": throughput, latency percentiles, queue
+//   quit
+// usage: spacecheckers-server [--workers N] [--hash MB] [--max-move MS]
+//        spacecheckers-server [options] --bench     self-play load test at 1..256 concurrent games
+#include "engine/Evaluation.hpp"
+#include "engine/GameServer.hpp"
+#include "engine/Pdn.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+using namespace chk::engine;
+
+namespace
+{
+constexpr int64_t BENCH_CLOCK_MS{3000}; // per game and side: ~100 ms per move
+constexpr int BENCH_PLIES{16};          // moves per game before it is restarted
+constexpr int BENCH_SECONDS{5};         // per concurrency level
+
+std::string toJson(const ServerMetrics &metrics, const int workers)
+{
+    return "{\"completed\":" + std::to_string(metrics.completed) +
+           ",\"movesPerSecond\":" + std::to_string(metrics.movesPerSecond) +
+           ",\"p50Ms\":" + std::to_string(metrics.p50Ms) + ",\"p99Ms\":" + std::to_string(metrics.p99Ms) +
+           ",\"maxMs\":" + std::to_string(metrics.maxMs) + ",\"deadlineMisses\":" +
+           std::to_string(metrics.deadlineMisses) + ",\"cancelled\":" + std::to_string(metrics.cancelled) +
+           ",\"queued\":" + std::to_string(metrics.queued) + ",\"peakQueued\":" + std::to_string(metrics.peakQueued) +
+           ",\"workers\":" + std::to_string(workers) + "}";
+}
+
+/**
+ * Serve the line protocol until "quit" or end of input
+ */
+int serve(const ServerConfig &config)
+{
+    std::mutex outMutex;
+    GameServer server{config, [&outMutex](const MoveRequest &request, const SearchResult &result) {
+                          const std::string move =
+                              result.bestMove == NULL_MOVE ? "none" : toNotation(request.pos, result.bestMove);
+                          std::scoped_lock lock{outMutex};
+                          std::cout << "bestmove " << request.gameId << " " << move << " score " << result.score
+                                    << " depth " << result.depth << std::endl;
+                      }};
+    for (std::string line; std::getline(std::cin, line);)
+    {
+        std::istringstream args{line};
+        std::string command;
+        args >> command;
+        if (command == "move")
+        {
+            MoveRequest request{};
+            args >> request.gameId >> request.remainingMs >> request.incrementMs;
+            if (args.fail())
+            {
+                spdlog::warn("usage: move <game> <remainingMs> <incrementMs> <FEN>");
+                continue;
+            }
+            std::string fen;
+            std::getline(args >> std::ws, fen);
+            const auto pos = parseFen(fen);
+            if (!pos.has_value())
+            {
+                spdlog::warn("bad FEN for game {}: {}", request.gameId, fen);
+                continue;
+            }
+            request.pos = pos.value();
+            server.submit(request);
+        }
+        else if (command == "cancel")
+        {
+            uint64_t gameId = 0;
+            args >> gameId;
+            server.cancel(gameId);
+        }
+        else if (command == "stats")
+        {
+            const std::string json = toJson(server.getMetrics(), server.getWorkerCount());
+            std::scoped_lock lock{outMutex};
+            std::cout << "stats " << json << std::endl;
+        }
+        else if (command == "quit")
+        {
+            break;
+        }
+        else if (!command.empty())
+        {
+            spdlog::warn("unknown command: {}", command);
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Load test: keep `games` self-play games going for a few seconds, each move submitted as soon as the
+ * previous one is answered, and report throughput and latency
+ */
+void benchLevel(const ServerConfig &config, const int games)
+{
+    std::mutex gamesMutex;
+    std::unordered_map<uint64_t, std::pair<Position, int>> state; // position, plies played
+    GameServer *serverPtr = nullptr;
+    const auto next = [&](const uint64_t gameId, const Position &pos) {
+        MoveRequest request{};
+        request.gameId = gameId;
+        request.pos = pos;
+        request.remainingMs = BENCH_CLOCK_MS;
+        serverPtr->submit(request);
+    };
+    GameServer server{config, [&](const MoveRequest &request, const SearchResult &result) {
+                          Position pos = Position::initial();
+                          {
+                              std::scoped_lock lock{gamesMutex};
+                              auto &[current, plies] = state[request.gameId];
+                              if (result.bestMove == NULL_MOVE || ++plies >= BENCH_PLIES)
+                              {
+                                  current = Position::initial(); // game over: start another
+                                  plies = 0;
+                              }
+                              else
+                              {
+                                  current = makeMove(request.pos, result.bestMove);
+                              }
+                              pos = current;
+                          }
+                          next(request.gameId, pos);
+                      }};
+    serverPtr = &server;
+    for (int game = 1; game <= games; game++)
+    {
+        {
+            std::scoped_lock lock{gamesMutex};
+            state[game] = {Position::initial(), 0};
+        }
+        next(static_cast<uint64_t>(game), Position::initial());
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(BENCH_SECONDS));
+    const ServerMetrics metrics = server.getMetrics();
+    std::printf("%6d %10.1f %8lld %8lld %8lld %8llu %8zu\n", games, metrics.movesPerSecond,
+                static_cast<long long>(metrics.p50Ms), static_cast<long long>(metrics.p99Ms),
+                static_cast<long long>(metrics.maxMs), static_cast<unsigned long long>(metrics.deadlineMisses),
+                metrics.peakQueued);
+    std::fflush(stdout);
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // stdout belongs to the protocol: send all logging to stderr
+    spdlog::set_default_logger(spdlog::stderr_color_mt("server"));
+    if (std::filesystem::exists(EVAL_WEIGHTS_FILE))
+    {
+        if (const auto weights = loadEvalWeights(EVAL_WEIGHTS_FILE))
+        {
+            setEvalWeights(weights.value());
+        }
+    }
+    ServerConfig config;
+    bool bench = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--bench")
+        {
+            bench = true;
+            continue;
+        }
+        if (value == nullptr)
+        {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return EXIT_FAILURE;
+        }
+        if (arg == "--workers")
+        {
+            config.workers = std::atoi(value);
+        }
+        else if (arg == "--hash")
+        {
+            config.hashMegabytes = std::strtoull(value, nullptr, 10);
+        }
+        else if (arg == "--max-move")
+        {
+            config.maxMoveMs = std::atoll(value);
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return EXIT_FAILURE;
+        }
+        i++;
+    }
+    if (!bench)
+    {
+        std::ios::sync_with_stdio(false);
+        return serve(config);
+    }
+    std::printf("%6s %10s %8s %8s %8s %8s %8s\n", "games", "moves/s", "p50 ms", "p99 ms", "max ms", "late",
+                "peak q");
+    for (const int games : {1, 4, 16, 64, 256})
+    {
+        benchLevel(config, games);
+    }
+    return EXIT_SUCCESS;
+}
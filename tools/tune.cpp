@@ -0,0 +1,123 @@
+// created 2026-10-18
+// Tunes the hand-written evaluation weights from self-play results
+// usage: spacecheckers-tune gen <samples.bin> [games] [nodes]   play self-play games, save their quiet positions
+//        spacecheckers-tune fit <samples.bin> <out.weights> [epochs]   fit weights; copy the result to
+//                                                                    resources/eval.weights to use it
+#include "engine/MoveGen.hpp"
+#include "engine/SelfPlay.hpp"
+#include "engine/Tuner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace chk::engine;
+
+namespace
+{
+constexpr int SKIP_OPENING_PLIES{8}; // positions right after the opening are too alike
+
+int generate(const std::string &path, const int numGames, const uint64_t nodes)
+{
+    const std::vector<Position> openings = generateOpenings(std::max(1, numGames / 2), 6, 60, 20261018);
+    const int numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::atomic_int nextGame{0};
+    std::mutex samplesMutex;
+    std::vector<TuningSample> samples;
+    const auto startTime = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        Searcher red;
+        Searcher black;
+        const SearchLimits limits{MAX_PLY - 1, nodes, 0};
+        std::vector<Position> positions;
+        for (int game = nextGame++; game < numGames; game = nextGame++)
+        {
+            positions.clear();
+            const Position &opening = openings[(game / 2) % openings.size()];
+            const GameResult result = playGame(opening, red, limits, black, limits, 300, nullptr, &positions);
+            std::scoped_lock lock{samplesMutex};
+            for (size_t ply = SKIP_OPENING_PLIES; ply < positions.size(); ply++)
+            {
+                if (!hasCaptures(positions[ply])) // quiet positions only: eval is meaningless mid-exchange
+                {
+                    samples.push_back(TuningSample{positions[ply], result});
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back(worker);
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    if (!writeSamples(path, samples))
+    {
+        std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        return 1;
+    }
+    std::printf("%d games, %zu samples in %.1f s (%.1f games/s)\n", numGames, samples.size(), seconds,
+                numGames / seconds);
+    return 0;
+}
+
+int fit(const std::string &samplesPath, const std::string &weightsPath, const int epochs)
+{
+    const auto samples = readSamples(samplesPath);
+    if (!samples.has_value())
+    {
+        return 1;
+    }
+    TunerConfig config;
+    config.epochs = epochs;
+    EvalTuner tuner{samples.value(), config};
+    const EvalWeights start = getEvalWeights();
+    std::printf("%zu samples, K = %.3f, start error %.6f\n", samples->size(), tuner.fitScale(start),
+                tuner.meanError(start));
+
+    const EvalWeights tuned = tuner.run(start, [](const TunerEpoch &epoch) {
+        std::printf("epoch %4d  error %.6f  %6.1f M samples/s  weights", epoch.epoch, epoch.error,
+                    epoch.samplesPerSec / 1e6);
+        for (const int32_t value : epoch.weights.values)
+        {
+            std::printf(" %d", value);
+        }
+        std::printf("\n");
+    });
+    std::printf("final error %.6f\n", tuner.meanError(tuned));
+    if (!saveEvalWeights(tuned, weightsPath))
+    {
+        std::fprintf(stderr, "cannot write %s\n", weightsPath.c_str());
+        return 1;
+    }
+    return 0;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "gen" && argc > 2)
+    {
+        const int games = argc > 3 ? std::atoi(argv[3]) : 10000;
+        const uint64_t nodes = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 5000;
+        return generate(argv[2], std::max(1, games), std::max<uint64_t>(1, nodes));
+    }
+    if (mode == "fit" && argc > 3)
+    {
+        return fit(argv[2], argv[3], argc > 4 ? std::max(1, std::atoi(argv[4])) : 200);
+    }
+    std::fprintf(stderr, "usage: %s gen <samples.bin> [games] [nodes]\n"
+                         "       %s fit <samples.bin> <out.weights> [epochs]\n",
+                 argv[0], argv[0]);
+    return 1;
+}